@@ -15,8 +15,22 @@
                     {
                         "sources": [
                             "src/app/irsdk/native/irsdk_node.cc",
+                            "src/app/irsdk/native/replay/irsdk_telemetry_wire.cpp",
+                            "src/app/irsdk/native/replay/irsdk_telemetry_wire.h",
                             "src/app/irsdk/native/lib/irsdk_utils.cpp",
+                            "src/app/irsdk/native/lib/irsdk_buffer_reader.cpp",
+                            "src/app/irsdk/native/lib/irsdk_buffer_reader.h",
                             "src/app/irsdk/native/lib/yaml_parser.cpp",
+                            "src/app/irsdk/native/replay/irsdk_tape.cpp",
+                            "src/app/irsdk/native/replay/irsdk_tape.h",
+                            "src/app/irsdk/native/replay/irsdk_tape_events.cpp",
+                            "src/app/irsdk/native/replay/irsdk_tape_events.h",
+                            "src/app/irsdk/native/replay/irsdk_tape_stream.cpp",
+                            "src/app/irsdk/native/replay/irsdk_tape_stream.h",
+                            "src/app/irsdk/native/replay/irsdk_tape_tee.cpp",
+                            "src/app/irsdk/native/replay/irsdk_tape_tee.h",
+                            "src/app/irsdk/native/replay/irsdk_flight_recorder.cpp",
+                            "src/app/irsdk/native/replay/irsdk_flight_recorder.h",
                             "src/app/irsdk/native/lib/irsdk_defines.h",
                         ]
                     },
@@ -39,24 +53,122 @@
                     {
                         "sources": [
                             "src/app/irsdk/native/irsdk_node.cc",
+                            "src/app/irsdk/native/replay/irsdk_telemetry_wire.cpp",
+                            "src/app/irsdk/native/replay/irsdk_telemetry_wire.h",
                             "src/app/irsdk/native/lib/irsdk_utils.cpp",
+                            "src/app/irsdk/native/lib/irsdk_buffer_reader.cpp",
+                            "src/app/irsdk/native/lib/irsdk_buffer_reader.h",
                             "src/app/irsdk/native/lib/yaml_parser.cpp",
+                            "src/app/irsdk/native/replay/irsdk_tape.cpp",
+                            "src/app/irsdk/native/replay/irsdk_tape.h",
+                            "src/app/irsdk/native/replay/irsdk_tape_events.cpp",
+                            "src/app/irsdk/native/replay/irsdk_tape_events.h",
+                            "src/app/irsdk/native/replay/irsdk_tape_stream.cpp",
+                            "src/app/irsdk/native/replay/irsdk_tape_stream.h",
+                            "src/app/irsdk/native/replay/irsdk_tape_tee.cpp",
+                            "src/app/irsdk/native/replay/irsdk_tape_tee.h",
+                            "src/app/irsdk/native/replay/irsdk_flight_recorder.cpp",
+                            "src/app/irsdk/native/replay/irsdk_flight_recorder.h",
                             "src/app/irsdk/native/lib/irsdk_defines.h",
                         ]
                     },
                 ]
             ],
         },
+        {
+            "target_name": "irsdk_node_posix",
+            "sources": [],
+            "defines": [
+                "NAPI_DISABLE_CPP_EXCEPTIONS",
+                "IRDASHIES_IRSDK_REPLAY_NAMES",
+            ],
+            "include_dirs": [
+                "<!(node -p \"require('node-addon-api').include_dir\")",
+            ],
+            "conditions": [
+                [
+                    "OS!='win'",
+                    {
+                        "sources": [
+                            "src/app/irsdk/native/irsdk_node.cc",
+                            "src/app/irsdk/native/replay/irsdk_telemetry_wire.cpp",
+                            "src/app/irsdk/native/replay/irsdk_telemetry_wire.h",
+                            "src/app/irsdk/native/lib/irsdk_posix_utils.cpp",
+                            "src/app/irsdk/native/lib/irsdk_buffer_reader.cpp",
+                            "src/app/irsdk/native/lib/irsdk_buffer_reader.h",
+                            "src/app/irsdk/native/lib/irsdk_posix_shm.cpp",
+                            "src/app/irsdk/native/lib/irsdk_posix_shm.h",
+                            "src/app/irsdk/native/replay/irsdk_tape.cpp",
+                            "src/app/irsdk/native/replay/irsdk_tape.h",
+                            "src/app/irsdk/native/replay/irsdk_tape_events.cpp",
+                            "src/app/irsdk/native/replay/irsdk_tape_events.h",
+                            "src/app/irsdk/native/replay/irsdk_tape_stream.cpp",
+                            "src/app/irsdk/native/replay/irsdk_tape_stream.h",
+                            "src/app/irsdk/native/replay/irsdk_tape_tee.cpp",
+                            "src/app/irsdk/native/replay/irsdk_tape_tee.h",
+                            "src/app/irsdk/native/replay/irsdk_flight_recorder.cpp",
+                            "src/app/irsdk/native/replay/irsdk_flight_recorder.h",
+                            "src/app/irsdk/native/lib/irsdk_defines.h",
+                        ]
+                    },
+                ],
+                [
+                    "OS=='linux'",
+                    {
+                        "libraries": ["-lrt"],
+                    },
+                ]
+            ],
+        },
         {
             "target_name": "irsdk_tape_node",
             "sources": [
                 "src/app/irsdk/native/irsdk_node.cc",
+                "src/app/irsdk/native/replay/irsdk_telemetry_wire.cpp",
+                "src/app/irsdk/native/replay/irsdk_telemetry_wire.h",
                 "src/app/irsdk/native/replay/irsdk_tape.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape_events.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape_events.h",
+                "src/app/irsdk/native/replay/irsdk_tape_stream.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape_stream.h",
                 "src/app/irsdk/native/replay/irsdk_tape_utils.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape_playback.h",
+                "src/app/irsdk/native/replay/irsdk_latency_histogram.cpp",
+                "src/app/irsdk/native/replay/irsdk_latency_histogram.h",
                 "src/app/irsdk/native/lib/irsdk_defines.h",
             ],
             "defines": [
                 "NAPI_DISABLE_CPP_EXCEPTIONS",
+                "IRDASHIES_TELEMETRY_TAPE",
+            ],
+            "include_dirs": [
+                "<!(node -p \"require('node-addon-api').include_dir\")",
+            ],
+        },
+        {
+            "target_name": "irsdk_ibt_node",
+            "sources": [
+                "src/app/irsdk/native/irsdk_node.cc",
+                "src/app/irsdk/native/replay/irsdk_telemetry_wire.cpp",
+                "src/app/irsdk/native/replay/irsdk_telemetry_wire.h",
+                "src/app/irsdk/native/replay/irsdk_ibt.cpp",
+                "src/app/irsdk/native/replay/irsdk_ibt.h",
+                "src/app/irsdk/native/replay/irsdk_ibt_utils.cpp",
+                "src/app/irsdk/native/replay/irsdk_mapped_file.cpp",
+                "src/app/irsdk/native/replay/irsdk_mapped_file.h",
+                "src/app/irsdk/native/replay/irsdk_tape.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape_events.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape_events.h",
+                "src/app/irsdk/native/replay/irsdk_tape_stream.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape_stream.h",
+                "src/app/irsdk/native/replay/irsdk_tape_playback.h",
+                "src/app/irsdk/native/replay/irsdk_latency_histogram.cpp",
+                "src/app/irsdk/native/replay/irsdk_latency_histogram.h",
+                "src/app/irsdk/native/lib/irsdk_defines.h",
+            ],
+            "defines": [
+                "NAPI_DISABLE_CPP_EXCEPTIONS",
+                "IRDASHIES_TELEMETRY_TAPE",
             ],
             "include_dirs": [
                 "<!(node -p \"require('node-addon-api').include_dir\")",
@@ -64,20 +176,100 @@
         },
         {
             "target_name": "irsdk_replay",
-            "type": "none",
-            "sources": [],
+            "type": "executable",
+            "sources": [
+                "src/app/irsdk/native/replay/irsdk_replay_main.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape.h",
+                "src/app/irsdk/native/replay/irsdk_tape_events.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape_events.h",
+                "src/app/irsdk/native/replay/irsdk_tape_stream.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape_stream.h",
+                "src/app/irsdk/native/replay/irsdk_tape_stats.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape_stats.h",
+                "src/app/irsdk/native/lib/irsdk_defines.h",
+            ],
             "conditions": [
                 [
-                    "OS=='win'",
+                    "OS!='win'",
                     {
-                        "type": "executable",
                         "sources": [
-                            "src/app/irsdk/native/replay/irsdk_replay_main.cpp",
-                            "src/app/irsdk/native/replay/irsdk_tape.cpp",
-                            "src/app/irsdk/native/replay/irsdk_tape.h",
-                            "src/app/irsdk/native/lib/irsdk_defines.h",
+                            "src/app/irsdk/native/lib/irsdk_posix_shm.cpp",
+                            "src/app/irsdk/native/lib/irsdk_posix_shm.h",
                         ]
                     },
+                ],
+                [
+                    "OS=='linux'",
+                    {
+                        "libraries": ["-lrt", "-pthread"],
+                    },
+                ]
+            ],
+        },
+        {
+            "target_name": "irsdk_tape_tool",
+            "type": "executable",
+            "sources": [
+                "src/app/irsdk/native/replay/irsdk_tape_tool_main.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape_columns.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape_columns.h",
+                "src/app/irsdk/native/replay/irsdk_tape_convert.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape_convert.h",
+                "src/app/irsdk/native/replay/irsdk_tape_diff.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape_diff.h",
+                "src/app/irsdk/native/replay/irsdk_tape_events.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape_events.h",
+                "src/app/irsdk/native/replay/irsdk_tape_stream.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape_stream.h",
+                "src/app/irsdk/native/replay/irsdk_ibt.cpp",
+                "src/app/irsdk/native/replay/irsdk_ibt.h",
+                "src/app/irsdk/native/replay/irsdk_mapped_file.cpp",
+                "src/app/irsdk/native/replay/irsdk_mapped_file.h",
+                "src/app/irsdk/native/replay/irsdk_tape.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape.h",
+                "src/app/irsdk/native/replay/irsdk_telemetry_wire.cpp",
+                "src/app/irsdk/native/replay/irsdk_telemetry_wire.h",
+                "src/app/irsdk/native/lib/irsdk_defines.h",
+            ],
+            "conditions": [
+                [
+                    "OS=='linux'",
+                    {
+                        "libraries": ["-pthread"],
+                    },
+                ]
+            ],
+        },
+        {
+            "target_name": "irsdk_var_bench",
+            "type": "executable",
+            "sources": [
+                "src/app/irsdk/native/replay/irsdk_var_bench_main.cpp",
+                "src/app/irsdk/native/lib/irsdk_client.cpp",
+                "src/app/irsdk/native/lib/irsdk_client.h",
+                "src/app/irsdk/native/lib/yaml_parser.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape.h",
+                "src/app/irsdk/native/replay/irsdk_tape_events.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape_events.h",
+                "src/app/irsdk/native/replay/irsdk_tape_stream.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape_stream.h",
+                "src/app/irsdk/native/replay/irsdk_tape_utils.cpp",
+                "src/app/irsdk/native/replay/irsdk_tape_playback.h",
+                "src/app/irsdk/native/replay/irsdk_latency_histogram.cpp",
+                "src/app/irsdk/native/replay/irsdk_latency_histogram.h",
+                "src/app/irsdk/native/lib/irsdk_defines.h",
+            ],
+            "defines": [
+                "IRDASHIES_TELEMETRY_TAPE",
+            ],
+            "conditions": [
+                [
+                    "OS=='linux'",
+                    {
+                        "libraries": ["-pthread"],
+                    },
                 ]
             ],
         }
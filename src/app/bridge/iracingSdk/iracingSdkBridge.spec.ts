@@ -4,6 +4,7 @@ import type { Session } from '@irdashies/types';
 const mockGetSessionData = vi.hoisted(() => vi.fn());
 const mockWaitForData = vi.hoisted(() => vi.fn());
 const mockStopSDK = vi.hoisted(() => vi.fn());
+const mockSetTelemetrySubscription = vi.hoisted(() => vi.fn());
 const mockSdkState = vi.hoisted(() => ({
   sessionVersion: 1,
   sessionStatusOK: true,
@@ -25,11 +26,13 @@ vi.mock('../../irsdk', () => ({
     getTelemetry = vi.fn().mockReturnValue(null);
     getSessionData = mockGetSessionData;
     stopSDK = mockStopSDK;
+    setTelemetrySubscription = mockSetTelemetrySubscription;
   },
 }));
 
 vi.mock('../../perfMetrics', () => ({
   TelemetryPerfMetrics: class {
+    static telemetry = ['FrameRate'];
     startReporting = vi.fn();
     stopReporting = vi.fn();
     markStart = vi.fn();
@@ -62,6 +65,7 @@ describe('publishIRacingSDKEvents session polling', () => {
     mockWaitForData.mockReset();
     mockWaitForData.mockReturnValue(true);
     mockStopSDK.mockReset();
+    mockSetTelemetrySubscription.mockReset();
     mockSdkState.sessionVersion = 1;
     mockSdkState.sessionStatusOK = true;
   });
@@ -192,4 +196,30 @@ describe('publishIRacingSDKEvents session polling', () => {
     expect(callback).toHaveBeenCalledWith(session);
     bridge.stop();
   });
+
+  it('subscribes to the telemetry its consumers read', async () => {
+    const subscription = () => mockSetTelemetrySubscription.mock.lastCall?.[0];
+    const bridge = await publishIRacingSDKEvents(
+      createOverlayManager() as never
+    );
+
+    expect(subscription()).toEqual(
+      expect.arrayContaining(['FrameRate', 'SessionNum', 'Speed'])
+    );
+    expect(subscription()).not.toContain('CarIdxRPM');
+
+    const unsubscribeDeclared = bridge.onTelemetry(vi.fn(), ['CarIdxRPM']);
+    expect(subscription()).toContain('CarIdxRPM');
+
+    // A callback that does not say what it reads gets every variable.
+    const unsubscribeAll = bridge.onTelemetry(vi.fn());
+    expect(subscription()).toBeNull();
+
+    unsubscribeAll?.();
+    expect(subscription()).toContain('CarIdxRPM');
+    unsubscribeDeclared?.();
+    expect(subscription()).not.toContain('CarIdxRPM');
+
+    bridge.stop();
+  });
 });
@@ -12,7 +12,10 @@ import {
   type Telemetry,
 } from '@irdashies/types';
 import logger from '../../logger';
-import type { SessionLifecycle } from '../../sessionLifecycle';
+import {
+  SESSION_LIFECYCLE_TELEMETRY,
+  type SessionLifecycle,
+} from '../../sessionLifecycle';
 import type { ChannelBus } from '../channelBridge';
 import { createDefaultProcessorHost } from '../../processors/processorRegistry';
 
@@ -170,11 +173,21 @@ export async function publishIRacingSDKEvents(
   let lastRunningState: boolean | undefined = undefined;
   let latestSession: Session | null = null;
 
-  const telemetryCallbacks = new Set<(value: Telemetry) => void>();
+  // Each callback with the variables it declared it reads, if any.
+  const telemetryCallbacks = new Map<
+    (value: Telemetry) => void,
+    readonly (keyof Telemetry)[] | undefined
+  >();
   const sessionCallbacks = new Set<(value: Session) => void>();
   const runningStateCallbacks = new Set<(value: boolean) => void>();
+  // Whether inspector telemetry goes out as compact wire messages, decided on
+  // the first publish. A new window has no decoder state, so it asks for a
+  // keyframe rather than waiting for the next periodic one.
+  let inspectorWire: boolean | undefined = undefined;
+  let inspectorKeyframeDue = true;
 
   overlayManager.onOverlayReady((id) => {
+    inspectorKeyframeDue = true;
     logger.info(
       '[iracingSdkBridge] New window ready, sending initial data: ',
       id
@@ -192,6 +205,29 @@ export async function publishIRacingSDKEvents(
   const sdk = new IRacingSDK();
   sdk.autoEnableTelemetry = true;
   await sdk.ready();
+
+  // The SDK only copies the variables the bridge's own consumers read, unless
+  // a callback that did not declare its variables wants the whole frame.
+  const bridgeTelemetry: readonly (keyof Telemetry)[] = [
+    ...TELEMETRY_ALLOWLIST,
+    ...SESSION_LIFECYCLE_TELEMETRY,
+    ...TelemetryPerfMetrics.telemetry,
+    ...(processorHost?.telemetry() ?? []),
+  ];
+  const updateTelemetrySubscription = () => {
+    let variables: Set<keyof Telemetry> | null = perfRawTelemetryEnabled
+      ? null
+      : new Set(bridgeTelemetry);
+    for (const declared of telemetryCallbacks.values()) {
+      if (!declared) {
+        variables = null;
+        break;
+      }
+      declared.forEach((variable) => variables?.add(variable));
+    }
+    sdk.setTelemetrySubscription(variables && [...variables]);
+  };
+  updateTelemetrySubscription();
   if (
     perfRunConfig.enabled &&
     (process.env.IRDASHIES_IRSDK_REPLAY === '1' || isTapeReplay)
@@ -278,7 +314,15 @@ export async function publishIRacingSDKEvents(
           ) {
             lastInspectorTelemetryPublishTime = tickTime;
             perfMetrics.markStart('telemetryProjection');
-            const rendererTelemetry = telemetryForRenderer(telemetry);
+            inspectorWire ??=
+              !perfRawTelemetryEnabled &&
+              sdk.setTelemetryWireChannels([...TELEMETRY_ALLOWLIST]);
+            const wireMessage = inspectorWire
+              ? sdk.encodeTelemetryWire(inspectorKeyframeDue)
+              : null;
+            if (wireMessage) inspectorKeyframeDue = false;
+            const rendererTelemetry =
+              wireMessage ?? telemetryForRenderer(telemetry);
             perfMetrics.markEnd('telemetryProjection');
             perfMetrics.markStart('broadcast');
             overlayManager.publishMessage(
@@ -288,7 +332,9 @@ export async function publishIRacingSDKEvents(
             perfMetrics.markEnd('broadcast');
           }
           perfMetrics.markStart('telemetryCallbacks');
-          telemetryCallbacks.forEach((callback) => callback(telemetry));
+          telemetryCallbacks.forEach((_variables, callback) =>
+            callback(telemetry)
+          );
           perfMetrics.markEnd('telemetryCallbacks');
         }
 
@@ -332,10 +378,11 @@ export async function publishIRacingSDKEvents(
   })();
 
   return {
-    onTelemetry: (callback: (value: Telemetry) => void) => {
-      telemetryCallbacks.add(callback);
+    onTelemetry: (callback, variables) => {
+      telemetryCallbacks.set(callback, variables);
+      updateTelemetrySubscription();
       return () => {
-        telemetryCallbacks.delete(callback);
+        if (telemetryCallbacks.delete(callback)) updateTelemetrySubscription();
       };
     },
     onSessionData: (callback: (value: Session) => void) => {
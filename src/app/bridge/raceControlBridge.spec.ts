@@ -59,6 +59,7 @@ const createRuntime = () => {
   const runtime: IncidentRuntimeHandle = {
     onSession: vi.fn(),
     onFrame: vi.fn(),
+    telemetry: [],
     updateEnabled: vi.fn(),
     updateThresholds: vi.fn(),
     getCurrentSessionId: vi.fn(() => '1'),
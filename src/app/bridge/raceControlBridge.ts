@@ -18,6 +18,8 @@ import logger from '../logger';
 export interface IncidentRuntimeHandle {
   onSession: (session: Session) => void;
   onFrame: (frame: Telemetry) => void;
+  /** Telemetry variables onFrame reads. */
+  readonly telemetry: readonly (keyof Telemetry)[];
   updateEnabled: (enabled: boolean) => void;
   updateThresholds: (thresholds: IncidentThresholds) => void;
   getCurrentSessionId: () => string;
@@ -143,8 +145,10 @@ export const setupRaceControlBridge = (
       bridge.onSessionData((session) => runtime.onSession(session)) ??
       undefined;
     unsubscribeTelemetry =
-      bridge.onTelemetry((telemetry) => runtime.onFrame(telemetry)) ??
-      undefined;
+      bridge.onTelemetry(
+        (telemetry) => runtime.onFrame(telemetry),
+        runtime.telemetry
+      ) ?? undefined;
   };
 
   wireToTelemetryBridge();
@@ -33,6 +33,7 @@ import {
   type RendererDataStream,
 } from './rendererDataSubscriptions';
 import { createSubscriptionBridgeClient, defineBridge } from './defineBridge';
+import { TelemetryWireDecoder } from '../../shared/telemetryWire';
 
 export function exposeBridge() {
   if (isRendererPerfMetricsEnabled()) {
@@ -95,7 +96,18 @@ export function exposeBridge() {
   });
   defineBridge<TelemetryInspectorBridge>('telemetryInspectorBridge', {
     onTelemetry: (callback: (value: Telemetry) => void) => {
-      const handler = (_: Electron.IpcRendererEvent, value: Telemetry) => {
+      // The live bridge sends compact wire messages; the mock sends objects.
+      const decoder = new TelemetryWireDecoder();
+      const handler = (
+        _: Electron.IpcRendererEvent,
+        message: Telemetry | ArrayBuffer | Uint8Array
+      ) => {
+        const value =
+          message instanceof ArrayBuffer || ArrayBuffer.isView(message)
+            ? (decoder.decode(message) as Telemetry | null)
+            : message;
+        // Deltas received before the next keyframe
+        if (!value) return;
         if (!isRendererPerfMetricsEnabled()) {
           callback(value);
           return;
@@ -16,6 +16,136 @@ import {
 
 type TelemetryTypesDict = Record<string, number>;
 
+export interface PlaybackLatencySummary {
+  count: number;
+  minMs: number;
+  meanMs: number;
+  p50Ms: number;
+  p90Ms: number;
+  p99Ms: number;
+  p999Ms: number;
+  maxMs: number;
+}
+
+export interface PlaybackStats {
+  // Publish time minus each frame's scheduled time
+  lateness: PlaybackLatencySummary;
+  // Time between consecutive published frames
+  frameInterval: PlaybackLatencySummary;
+}
+
+export type TelemetryEventKind =
+  | 'lap'
+  | 'session'
+  | 'flags'
+  | 'pitEntry'
+  | 'pitExit';
+
+export interface TelemetryEvent {
+  kind: TelemetryEventKind;
+  // Lap, SessionNum, or SessionFlags; pit events carry the Lap
+  value: number;
+  // Recorded time of the frame where the event is first visible
+  seconds: number;
+  sourceTick: number;
+}
+
+export interface TelemetryTeeStats {
+  recording: boolean;
+  // Tape being written; empty between connections
+  path: string;
+  tapes: number;
+  frames: number;
+  // Frames skipped while the writer was behind, recorded as gaps
+  droppedFrames: number;
+  // Last write error; empty when none
+  error: string;
+}
+
+export interface FlightRecorderStats {
+  recording: boolean;
+  frames: number;
+  // Time between the oldest and newest frame held
+  seconds: number;
+  bytes: number;
+  budgetBytes: number;
+}
+
+export interface FlightRecorderDump {
+  path: string;
+  frames: number;
+}
+
+export type WaitResult = 'data' | 'signaled' | 'timeout' | 'disconnected';
+
+// 'stale' means the sim reports connected but has stopped ticking, as when a
+// replay is paused
+export type ConnectionState = 'connected' | 'stale' | 'disconnected';
+
+export interface WaitStats {
+  // Why the latest waitForData call returned
+  last: WaitResult;
+  // How often each reason ended a wait
+  data: number;
+  signaled: number;
+  timeouts: number;
+  disconnects: number;
+  // Calls that returned true, each after one copy of the frame
+  frames: number;
+}
+
+export interface TelemetryReadStats {
+  // Copies tried per buffer before falling back to an older one
+  attempts: number;
+  reads: number;
+  // Copies the sim overwrote while they ran
+  tornReads: number;
+  retries: number;
+  // Reads served from an older buffer than the newest
+  fallbacks: number;
+  // Calls that found no newer tick
+  staleReads: number;
+  // Calls where every newer buffer tore
+  failedReads: number;
+}
+
+// A variable's metadata, without its value
+export interface TelemetryVariableInfo {
+  name: string;
+  description: string;
+  unit: string;
+  countAsTime: boolean;
+  length: number;
+  varType: number;
+  // Byte offset of the variable's values in TelemetryValues.data
+  offset: number;
+}
+
+export interface TelemetrySchema {
+  // Changes whenever the layout or the subscription does
+  version: number;
+  variables: TelemetryVariableInfo[];
+}
+
+export interface TelemetryValues {
+  // The schema version the data is laid out by
+  version: number;
+  // Each variable's values at its schema offset; null before the first frame
+  data: ArrayBuffer | null;
+}
+
+// One object per schema version whose arrays waitForData rewrites in place.
+// state[0] counts the frames written; state[1] drops to 0 once the schema
+// moves on and a new view has to be fetched.
+export interface TelemetryView {
+  version: number;
+  state: Uint32Array;
+  values: Record<
+    string,
+    Uint8Array | Int32Array | Float32Array | Float64Array
+  >;
+}
+
 export interface INativeSDK {
   readonly currDataVersion: number;
   enableLogging: boolean;
@@ -27,14 +157,65 @@ export interface INativeSDK {
 
   // State
   isRunning(): boolean;
+  // Cached by waitForData; absent from mocks
+  getConnectionState?(): ConnectionState;
   waitForData(timeout?: number): boolean;
+  // Why waitForData calls returned; absent from mocks
+  getWaitStats?(): WaitStats;
   getSessionData(): string; // full yaml
   getTelemetryData(): TelemetryVarList;
+  // getTelemetryData split into metadata, fetched again only when its
+  // version changes, and the values of each frame; absent from mocks
+  getTelemetrySchema?(): TelemetrySchema;
+  getTelemetryValues?(): TelemetryValues;
+  // null before the first frame; absent from mocks
+  getTelemetryView?(): TelemetryView | null;
 
   getTelemetryVariable<T extends boolean | number | string>(
     indexOrName: number | string
   ): TelemetryVariable<T[]>;
 
+  // Limits waitForData to copying the named variables, and the telemetry
+  // getters to reporting them. Unknown names are ignored; null subscribes to
+  // everything again.
+  setTelemetrySubscription?(names: string[] | null): boolean;
+
+  // Compact IPC messages of the named variables, or all reported ones for
+  // null, decoded by TelemetryWireDecoder from @irdashies/shared. Each
+  // message only carries what changed since the one before; a keyframe
+  // carries everything and is also sent every 20 messages. encode returns
+  // null before the first frame; both are absent from mocks.
+  setTelemetryWireChannels?(names: string[] | null): boolean;
+  encodeTelemetryWire?(keyframe?: boolean): ArrayBuffer | null;
+
+  // Tape playback controls, only present on the tape-backed addon
+  setTelemetryPaused?(paused: boolean): boolean;
+  stepTelemetry?(frames: number): boolean;
+  seekTelemetry?(seconds: number): boolean;
+  getTelemetryEvents?(): TelemetryEvent[];
+  // Flags events match on any shared bit; the other kinds match exactly
+  seekTelemetryEvent?(kind: TelemetryEventKind, value: number): boolean;
+  getPlaybackStats?(): PlaybackStats;
+
+  // Live tee, only present on the live addons. Each connection is recorded
+  // to its own tape in the directory.
+  startTelemetryTee?(directory: string): boolean;
+  stopTelemetryTee?(): boolean;
+  getTelemetryTeeStats?(): TelemetryTeeStats;
+
+  // Flight recorder, only present on the live addons. Keeps the last
+  // `seconds` of telemetry within `megabytes`, and writes it to a tape on
+  // demand without blocking waitForData.
+  startFlightRecorder?(seconds?: number, megabytes?: number): boolean;
+  stopFlightRecorder?(): boolean;
+  dumpFlightRecorder?(path: string): Promise<FlightRecorderDump>;
+  getFlightRecorderStats?(): FlightRecorderStats;
+
+  // Shared-memory read counters, only present on the live addons. Counts
+  // are kept for the process since the addon loaded.
+  setTelemetryReadAttempts?(attempts: number): boolean;
+  getTelemetryReadStats?(): TelemetryReadStats;
+
   // Broadcast command overloads
   // This is handled in the cpp side so no need to mess with it in js
   broadcast(
@@ -115,16 +296,41 @@ export class NativeSDK implements INativeSDK {
   // State
   public isRunning(): boolean;
 
+  public getConnectionState?(): ConnectionState;
+
   public waitForData(timeout?: number): boolean;
 
   public getSessionData(): string; // full yaml
 
   public getTelemetryData(): TelemetryVarList;
 
+  public getTelemetrySchema?(): TelemetrySchema;
+
+  public getTelemetryValues?(): TelemetryValues;
+
+  public getTelemetryView?(): TelemetryView | null;
+
+  public setTelemetryWireChannels?(names: string[] | null): boolean;
+
+  public encodeTelemetryWire?(keyframe?: boolean): ArrayBuffer | null;
+
   public getTelemetryVariable<T extends number | boolean | string>(
     indexOrName: number | string
   ): TelemetryVariable<T[]>;
 
+  // Tape playback controls, only present on the tape-backed addon
+  public setTelemetryPaused?(paused: boolean): boolean;
+
+  public stepTelemetry?(frames: number): boolean;
+
+  public seekTelemetry?(seconds: number): boolean;
+
+  public getTelemetryEvents?(): TelemetryEvent[];
+
+  public seekTelemetryEvent?(kind: TelemetryEventKind, value: number): boolean;
+
+  public getPlaybackStats?(): PlaybackStats;
+
   // Private helpers
   public __getTelemetryTypes(): TelemetryTypesDict;
 
@@ -0,0 +1,174 @@
+import { createRequire } from 'node:module';
+import { mkdtemp, rm, writeFile } from 'node:fs/promises';
+import { tmpdir } from 'node:os';
+import { fileURLToPath } from 'node:url';
+import path from 'node:path';
+
+import {
+  afterAll,
+  afterEach,
+  beforeAll,
+  beforeEach,
+  describe,
+  expect,
+  it,
+} from 'vitest';
+
+import type { INativeSDK } from './index';
+
+const SDK_HEADER_SIZE = 112;
+const DISK_HEADER_SIZE = 32;
+const VARIABLE_HEADER_SIZE = 144;
+const SAMPLE_SIZE = 16;
+
+function createVariableHeader(
+  type: number,
+  offset: number,
+  name: string,
+  unit: string
+): Buffer {
+  const header = Buffer.alloc(VARIABLE_HEADER_SIZE);
+  header.writeInt32LE(type, 0);
+  header.writeInt32LE(offset, 4);
+  header.writeInt32LE(1, 8);
+  header.write(name, 16, 31, 'ascii');
+  header.write(unit, 112, 31, 'ascii');
+  return header;
+}
+
+function createSample(index: number): Buffer {
+  const sample = Buffer.alloc(SAMPLE_SIZE);
+  sample.writeDoubleLE(10 + index / 60, 0);
+  sample.writeInt32LE(100 + index, 8);
+  sample.writeFloatLE(50 + index, 12);
+  return sample;
+}
+
+function createIbtFixture(sampleCount: number): Buffer {
+  const variables = Buffer.concat([
+    createVariableHeader(5, 0, 'SessionTime', 's'),
+    createVariableHeader(2, 8, 'SessionTick', ''),
+    createVariableHeader(4, 12, 'Speed', 'm/s'),
+  ]);
+  const variableOffset = SDK_HEADER_SIZE + DISK_HEADER_SIZE;
+  const session = Buffer.alloc(256);
+  session.write('---\nWeekendInfo:\n TrackName: Disk Log Track\n...\n', 'ascii');
+  const sessionOffset = variableOffset + variables.length;
+  const sampleOffset = sessionOffset + session.length;
+
+  const sdkHeader = Buffer.alloc(SDK_HEADER_SIZE);
+  sdkHeader.writeInt32LE(2, 0);
+  sdkHeader.writeInt32LE(1, 4);
+  sdkHeader.writeInt32LE(60, 8);
+  sdkHeader.writeInt32LE(0, 12);
+  sdkHeader.writeInt32LE(session.length, 16);
+  sdkHeader.writeInt32LE(sessionOffset, 20);
+  sdkHeader.writeInt32LE(3, 24);
+  sdkHeader.writeInt32LE(variableOffset, 28);
+  sdkHeader.writeInt32LE(1, 32);
+  sdkHeader.writeInt32LE(SAMPLE_SIZE, 36);
+  sdkHeader.writeInt32LE(0, 48);
+  sdkHeader.writeInt32LE(sampleOffset, 52);
+
+  const diskHeader = Buffer.alloc(DISK_HEADER_SIZE);
+  diskHeader.writeDoubleLE(10, 8);
+  diskHeader.writeDoubleLE(10 + sampleCount / 60, 16);
+  diskHeader.writeInt32LE(sampleCount, 28);
+
+  const samples = Array.from({ length: sampleCount }, (_, index) =>
+    createSample(index)
+  );
+  return Buffer.concat([sdkHeader, diskHeader, variables, session, ...samples]);
+}
+
+const floatValue = (value: unknown): number =>
+  new Float32Array(value as ArrayBuffer)[0];
+const intValue = (value: unknown): number =>
+  new Int32Array(value as ArrayBuffer)[0];
+const addonPath = path.resolve(
+  path.dirname(fileURLToPath(import.meta.url)),
+  '..',
+  '..',
+  '..',
+  '..',
+  'build',
+  'Release',
+  'irsdk_ibt_node.node'
+);
+
+function loadAddon(): { iRacingSdkNode: new () => INativeSDK } {
+  const require = createRequire(import.meta.url);
+  return require(addonPath) as { iRacingSdkNode: new () => INativeSDK };
+}
+
+describe('.ibt-backed native SDK', () => {
+  let temporaryDirectory: string;
+  let ibtPath: string;
+
+  beforeAll(async () => {
+    temporaryDirectory = await mkdtemp(
+      path.join(tmpdir(), 'irdashies-ibt-node-')
+    );
+    ibtPath = path.join(temporaryDirectory, 'synthetic.ibt');
+    await writeFile(ibtPath, createIbtFixture(5));
+  });
+
+  beforeEach(() => {
+    process.env.IRDASHIES_TELEMETRY_IBT = ibtPath;
+  });
+
+  afterEach(() => {
+    delete process.env.IRDASHIES_TELEMETRY_IBT;
+    delete process.env.IRDASHIES_TELEMETRY_REPLAY_LOOP;
+    delete process.env.IRDASHIES_TELEMETRY_REPLAY_SPEED;
+  });
+
+  afterAll(async () => {
+    await rm(temporaryDirectory, { recursive: true, force: true });
+  });
+
+  it('delivers every sample in order when unpaced', () => {
+    const addon = loadAddon();
+    const sdk = new addon.iRacingSdkNode();
+
+    try {
+      expect(sdk.startSDK()).toBe(true);
+      for (let index = 0; index < 5; index++) {
+        expect(sdk.waitForData(20)).toBe(true);
+        const telemetry = sdk.getTelemetryData();
+        expect(intValue(telemetry.SessionTick.value)).toBe(100 + index);
+        expect(floatValue(telemetry.Speed.value)).toBeCloseTo(50 + index, 5);
+      }
+      expect(sdk.getSessionData()).toContain('TrackName: Disk Log Track');
+      expect(sdk.waitForData(20)).toBe(false);
+      expect(sdk.isRunning()).toBe(false);
+    } finally {
+      sdk.stopSDK();
+    }
+  });
+
+  it('seeks and steps to arbitrary samples', () => {
+    process.env.IRDASHIES_TELEMETRY_REPLAY_SPEED = '1';
+
+    const addon = loadAddon();
+    const sdk = new addon.iRacingSdkNode();
+
+    try {
+      expect(sdk.startSDK()).toBe(true);
+      expect(sdk.setTelemetryPaused?.(true)).toBe(true);
+
+      expect(sdk.seekTelemetry?.(3 / 60)).toBe(true);
+      expect(sdk.waitForData(20)).toBe(true);
+      expect(floatValue(sdk.getTelemetryData().Speed.value)).toBeCloseTo(53, 5);
+
+      expect(sdk.stepTelemetry?.(-2)).toBe(true);
+      expect(sdk.waitForData(20)).toBe(true);
+      expect(floatValue(sdk.getTelemetryData().Speed.value)).toBeCloseTo(51, 5);
+
+      expect(sdk.waitForData(5)).toBe(false);
+      expect(sdk.isRunning()).toBe(true);
+    } finally {
+      sdk.stopSDK();
+    }
+  });
+});
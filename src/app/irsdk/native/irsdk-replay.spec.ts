@@ -4,7 +4,7 @@ import {
   type ChildProcessWithoutNullStreams,
 } from 'node:child_process';
 import { once } from 'node:events';
-import { mkdtemp, rm } from 'node:fs/promises';
+import { mkdtemp, readdir, rm } from 'node:fs/promises';
 import { createRequire } from 'node:module';
 import { tmpdir } from 'node:os';
 import path from 'node:path';
@@ -12,11 +12,21 @@ import { promisify } from 'node:util';
 
 import { afterEach, describe, expect, it } from 'vitest';
 
-import type { INativeSDK } from './index';
+import type { INativeSDK, TelemetryReadStats } from './index';
+import { TelemetryWireDecoder } from '../../../shared/telemetryWire';
 
 const execFileAsync = promisify(execFile);
-const describeOnWindows =
-  process.platform === 'win32' ? describe : describe.skip;
+// Windows replays through named file mappings and the isolated build of the
+// production addon; other platforms use the POSIX shared-memory publisher and
+// backend, which share the same header layout and buffer rotation.
+const isWindows = process.platform === 'win32';
+const replayExecutableName = isWindows ? 'irsdk_replay.exe' : 'irsdk_replay';
+const replayAddonName = isWindows
+  ? 'irsdk_node_replay.node'
+  : 'irsdk_node_posix.node';
+// The recorder reads the production object names, which a running sim owns on
+// Windows, so recorder round trips run against the POSIX publisher only.
+const itOnPosix = isWindows ? it.skip : it;
 
 class ProcessOutput {
   private output = '';
@@ -77,6 +87,13 @@ const doubleValue = (value: unknown): number =>
 const intValue = (value: unknown): number =>
   new Int32Array(value as ArrayBuffer)[0];
 
+interface RecordedReport {
+  frames: number;
+  frameBytes: number;
+  gapRecords: number;
+  variables: { name: string; count: number; min: number; max: number }[];
+}
+
 const sendCommand = (
   child: ChildProcessWithoutNullStreams,
   command: string
@@ -91,7 +108,7 @@ const sendCommand = (
     });
   });
 
-describeOnWindows('iRacing native record/replay boundary', () => {
+describe('iRacing native record/replay boundary', () => {
   let publisher: ChildProcessWithoutNullStreams | undefined;
   let temporaryDirectory: string | undefined;
 
@@ -116,7 +133,7 @@ describeOnWindows('iRacing native record/replay boundary', () => {
         process.cwd(),
         'build',
         'Release',
-        'irsdk_replay.exe'
+        replayExecutableName
       );
       temporaryDirectory = await mkdtemp(
         path.join(tmpdir(), 'irdashies-irsdk-replay-')
@@ -137,7 +154,7 @@ describeOnWindows('iRacing native record/replay boundary', () => {
           process.cwd(),
           'build',
           'Release',
-          'irsdk_node_replay.node'
+          replayAddonName
         )
       ) as {
         iRacingSdkNode: new () => INativeSDK;
@@ -159,18 +176,25 @@ describeOnWindows('iRacing native record/replay boundary', () => {
         );
         expect(intValue(initialTelemetry.SessionTick.value)).toBe(100);
         expect(floatValue(initialTelemetry.Speed.value)).toBeCloseTo(50);
+        expect(sdk.getConnectionState?.()).toBe('connected');
+        const view = sdk.getTelemetryView?.();
+        expect(view?.state[1]).toBe(1);
+        expect(view?.values.Speed[0]).toBeCloseTo(50);
+        const viewFrames = view?.state[0] ?? 0;
 
-        // The replay test addon uses a two-second connection timeout. Polling
-        // the same paused tick beyond that timeout must keep it connected.
+        // Polling the same paused tick keeps it connected. After a second
+        // without a new tick the cached state turns stale.
         const pauseUntil = performance.now() + 2_200;
         while (performance.now() < pauseUntil) {
           expect(sdk.waitForData(100)).toBe(false);
           expect(sdk.isRunning()).toBe(true);
         }
+        expect(sdk.getConnectionState?.()).toBe('stale');
 
         await sendCommand(publisher, 'next');
         await output.waitFor(/FRAME 2 101/, 15_000);
         expect(sdk.waitForData(100)).toBe(true);
+        expect(sdk.getConnectionState?.()).toBe('connected');
 
         const telemetry = sdk.getTelemetryData();
         expect(doubleValue(telemetry.SessionTime.value)).toBeCloseTo(
@@ -179,41 +203,636 @@ describeOnWindows('iRacing native record/replay boundary', () => {
         );
         expect(intValue(telemetry.SessionTick.value)).toBe(101);
         expect(floatValue(telemetry.Speed.value)).toBeCloseTo(51);
+
+        // The view is the same object, rewritten in place by the new frame.
+        expect(sdk.getTelemetryView?.()).toBe(view);
+        expect(view?.state[0]).toBe(viewFrames + 1);
+        expect(view?.values.Speed[0]).toBeCloseTo(51);
+
+        // The values-only call packs the same frame by the schema's offsets.
+        const schema = sdk.getTelemetrySchema?.();
+        const values = sdk.getTelemetryValues?.();
+        expect(values?.version).toBe(schema?.version);
+        const speed = schema?.variables.find(
+          (variable) => variable.name === 'Speed'
+        );
+        expect(speed).toMatchObject({ unit: 'm/s', varType: 4, length: 1 });
         expect(
-          Array.from(
-            new Float32Array(
-              telemetry.CarIdxLapDistPct.value as unknown as ArrayBuffer
-            )
+          new Float32Array(
+            values?.data ?? new ArrayBuffer(4),
+            speed?.offset,
+            1
+          )[0]
+        ).toBeCloseTo(51);
+        // Every car slot is published; the empty ones read -1.
+        const positions = Array.from(
+          new Float32Array(
+            telemetry.CarIdxLapDistPct.value as unknown as ArrayBuffer
           )
-        ).toEqual([
+        );
+        expect(positions).toHaveLength(64);
+        expect(positions.slice(0, 4)).toEqual([
           expect.closeTo(0.11, 5),
           expect.closeTo(0.21, 5),
           expect.closeTo(0.31, 5),
+          -1,
         ]);
 
         const firstSession = sdk.getSessionData();
         expect(firstSession).toContain('TrackName: Replay Test Track');
         expect(sdk.currDataVersion).toBe(1);
 
+        // A subscription copies and reports only the named variables.
+        expect(sdk.setTelemetrySubscription?.(['Speed', 'SessionTick'])).toBe(
+          true
+        );
         await sendCommand(publisher, 'next');
         await output.waitFor(/FRAME 3 102/, 15_000);
         expect(sdk.waitForData(100)).toBe(true);
-        expect(floatValue(sdk.getTelemetryData().Speed.value)).toBeCloseTo(52);
+        const subscribed = sdk.getTelemetryData();
+        expect(Object.keys(subscribed).sort()).toEqual([
+          'SessionTick',
+          'Speed',
+        ]);
+        expect(floatValue(subscribed.Speed.value)).toBeCloseTo(52);
+        expect(intValue(subscribed.SessionTick.value)).toBe(102);
+        expect(sdk.getTelemetryVariable('SessionTime')).toEqual({});
+        // The new schema retires the old view for one with its variables.
+        expect(view?.state[1]).toBe(0);
+        const subscribedView = sdk.getTelemetryView?.();
+        expect(Object.keys(subscribedView?.values ?? {}).sort()).toEqual([
+          'SessionTick',
+          'Speed',
+        ]);
+        expect(subscribedView?.values.Speed[0]).toBeCloseTo(52);
+
+        // A wire message carries only the chosen channels, and repeating the
+        // same frame leaves every value out.
+        expect(sdk.setTelemetryWireChannels?.(['Speed'])).toBe(true);
+        const decoder = new TelemetryWireDecoder();
+        const keyframe = sdk.encodeTelemetryWire?.() as ArrayBuffer;
+        expect(decoder.decode(keyframe)).toEqual({ Speed: { value: [52] } });
+        // Four header bytes, the channel count, the channel (1 + 5 + 1 + 1),
+        // the channel bitmap and the float's four bytes.
+        expect(keyframe.byteLength).toBe(18);
+        const repeat = sdk.encodeTelemetryWire?.() as ArrayBuffer;
+        // Only the header and an empty bitmap.
+        expect(repeat.byteLength).toBe(5);
+        expect(decoder.decode(repeat)).toEqual({ Speed: { value: [52] } });
+        expect(sdk.setTelemetryWireChannels?.(null)).toBe(true);
+        expect(sdk.setTelemetrySubscription?.(null)).toBe(true);
         expect(sdk.getSessionData()).toContain('SessionNum: 0');
         expect(sdk.currDataVersion).toBe(2);
 
+        // The paused publisher never rewrote a buffer during a copy.
+        const readStats = sdk.getTelemetryReadStats?.();
+        expect(readStats).toMatchObject({
+          attempts: 2,
+          tornReads: 0,
+          failedReads: 0,
+        });
+        expect(readStats?.reads).toBeGreaterThanOrEqual(3);
+        expect(readStats?.staleReads).toBeGreaterThan(0);
+
         await sendCommand(publisher, 'next');
         await output.waitFor(/DONE 3/);
         expect(sdk.waitForData(100)).toBe(false);
         expect(sdk.isRunning()).toBe(false);
+        expect(sdk.getConnectionState?.()).toBe('disconnected');
+      } catch (error) {
+        throw new Error(
+          `${String(error)}\nPublisher output:\n${output.all()}`,
+          { cause: error }
+        );
+      } finally {
+        sdk.stopSDK();
+      }
+    }
+  );
+
+  // Killed processes leave their POSIX objects linked, where Windows frees a
+  // mapping with its last handle.
+  itOnPosix(
+    'drops a killed publisher and maps its replacement',
+    { timeout: 20_000 },
+    async () => {
+      const executable = path.resolve(
+        process.cwd(),
+        'build',
+        'Release',
+        replayExecutableName
+      );
+      temporaryDirectory = await mkdtemp(
+        path.join(tmpdir(), 'irdashies-irsdk-replay-')
+      );
+      const tapePath = path.join(temporaryDirectory, 'synthetic.irdt');
+      await execFileAsync(executable, ['fixture', '--output', tapePath]);
+
+      // Each publisher is stepped to its first frame before it is used.
+      const playArgs = ['play', '--input', tapePath, '--step'];
+      const publish = async (
+        child: ChildProcessWithoutNullStreams
+      ): Promise<void> => {
+        publisher = child;
+        const output = new ProcessOutput(child);
+        await output.waitFor(/READY/);
+        await sendCommand(child, 'next');
+        await output.waitFor(/FRAME 1 100/, 15_000);
+      };
+      const killed = spawn(executable, playArgs, { stdio: 'pipe' });
+      await publish(killed);
+
+      const require = createRequire(import.meta.url);
+      const replayAddon = require(
+        path.resolve(process.cwd(), 'build', 'Release', replayAddonName)
+      ) as {
+        iRacingSdkNode: new () => INativeSDK;
+      };
+      const sdk = new replayAddon.iRacingSdkNode();
+      try {
+        expect(sdk.startSDK()).toBe(true);
+        expect(sdk.waitForData(100)).toBe(true);
+        expect(sdk.getConnectionState?.()).toBe('connected');
+
+        // SIGKILL skips the publisher's cleanup, so its header still reads
+        // connected and its objects stay behind.
+        publisher = undefined;
+        const closed = once(killed, 'close');
+        killed.kill('SIGKILL');
+        await closed;
+
+        // The dead publisher is noticed once its ticks have been stale.
+        const giveUpAt = performance.now() + 3_000;
+        while (
+          sdk.getConnectionState?.() !== 'disconnected' &&
+          performance.now() < giveUpAt
+        ) {
+          expect(sdk.waitForData(100)).toBe(false);
+        }
+        expect(sdk.getConnectionState?.()).toBe('disconnected');
+        expect(sdk.getWaitStats?.().last).toBe('disconnected');
+        expect(sdk.waitForData(100)).toBe(false);
+
+        // A new publisher under the same names is mapped without a restart.
+        await publish(spawn(executable, playArgs, { stdio: 'pipe' }));
+        expect(sdk.waitForData(1_000)).toBe(true);
+        expect(sdk.getConnectionState?.()).toBe('connected');
+        expect(intValue(sdk.getTelemetryData().SessionTick.value)).toBe(100);
+      } finally {
+        sdk.stopSDK();
+      }
+    }
+  );
+
+  it(
+    'copies each delivered frame once and reports why waits return',
+    { timeout: 20_000 },
+    async () => {
+      const executable = path.resolve(
+        process.cwd(),
+        'build',
+        'Release',
+        replayExecutableName
+      );
+      temporaryDirectory = await mkdtemp(
+        path.join(tmpdir(), 'irdashies-irsdk-replay-')
+      );
+      const tapePath = path.join(temporaryDirectory, 'synthetic.irdt');
+
+      await execFileAsync(executable, ['fixture', '--output', tapePath]);
+
+      publisher = spawn(executable, ['play', '--input', tapePath, '--step'], {
+        stdio: 'pipe',
+      });
+      const output = new ProcessOutput(publisher);
+      await output.waitFor(/READY/);
+
+      const require = createRequire(import.meta.url);
+      const replayAddon = require(
+        path.resolve(
+          process.cwd(),
+          'build',
+          'Release',
+          replayAddonName
+        )
+      ) as {
+        iRacingSdkNode: new () => INativeSDK;
+      };
+      const sdk = new replayAddon.iRacingSdkNode();
+      try {
+        const before = sdk.getTelemetryReadStats?.();
+        expect(sdk.startSDK()).toBe(true);
+
+        for (const [frame, tick] of [
+          [1, 100],
+          [2, 101],
+          [3, 102],
+        ]) {
+          await sendCommand(publisher, 'next');
+          await output.waitFor(new RegExp(`FRAME ${frame} ${tick}`), 15_000);
+          expect(sdk.waitForData(100)).toBe(true);
+          // Waits on a tick the app already has copy nothing. The Windows
+          // event can still hold the signal for the frame just read.
+          expect(sdk.waitForData(20)).toBe(false);
+          expect(['signaled', 'timeout']).toContain(
+            sdk.getWaitStats?.().last
+          );
+        }
+        await sendCommand(publisher, 'next');
+        await output.waitFor(/DONE 3/);
+        expect(sdk.waitForData(100)).toBe(false);
+
+        const waits = sdk.getWaitStats?.();
+        expect(waits).toMatchObject({
+          last: 'disconnected',
+          data: 3,
+          frames: 3,
+        });
+        expect((waits?.signaled ?? 0) + (waits?.timeouts ?? 0)).toBe(3);
+
+        const after = sdk.getTelemetryReadStats?.();
+        const copies = (stats?: TelemetryReadStats): number =>
+          (stats?.reads ?? 0) + (stats?.tornReads ?? 0);
+        expect((copies(after) - copies(before)) / (waits?.frames ?? 0)).toBe(1);
+      } catch (error) {
+        throw new Error(
+          `${String(error)}\nPublisher output:\n${output.all()}`,
+          { cause: error }
+        );
+      } finally {
+        sdk.stopSDK();
+      }
+    }
+  );
+
+  it(
+    'records the frames waitForData copies to tapes',
+    { timeout: 20_000 },
+    async () => {
+      const executable = path.resolve(
+        process.cwd(),
+        'build',
+        'Release',
+        replayExecutableName
+      );
+      temporaryDirectory = await mkdtemp(
+        path.join(tmpdir(), 'irdashies-irsdk-replay-')
+      );
+      const tapePath = path.join(temporaryDirectory, 'synthetic.irdt');
+      const teeDirectory = path.join(temporaryDirectory, 'tee');
+
+      await execFileAsync(executable, ['fixture', '--output', tapePath]);
+
+      publisher = spawn(executable, ['play', '--input', tapePath, '--step'], {
+        stdio: 'pipe',
+      });
+      const output = new ProcessOutput(publisher);
+      await output.waitFor(/READY/);
+
+      const require = createRequire(import.meta.url);
+      const replayAddon = require(
+        path.resolve(
+          process.cwd(),
+          'build',
+          'Release',
+          replayAddonName
+        )
+      ) as {
+        iRacingSdkNode: new () => INativeSDK;
+      };
+      const sdk = new replayAddon.iRacingSdkNode();
+      try {
+        expect(sdk.startTelemetryTee?.(teeDirectory)).toBe(true);
+        expect(sdk.startFlightRecorder?.(60, 16)).toBe(true);
+        expect(sdk.startSDK()).toBe(true);
+
+        for (const [frame, tick] of [
+          [1, 100],
+          [2, 101],
+          [3, 102],
+        ]) {
+          await sendCommand(publisher, 'next');
+          await output.waitFor(new RegExp(`FRAME ${frame} ${tick}`), 15_000);
+          expect(sdk.waitForData(100)).toBe(true);
+        }
+        await sendCommand(publisher, 'next');
+        await output.waitFor(/DONE 3/);
+        expect(sdk.waitForData(100)).toBe(false);
+
+        expect(sdk.stopTelemetryTee?.()).toBe(true);
+        const stats = sdk.getTelemetryTeeStats?.();
+        expect(stats).toMatchObject({
+          recording: false,
+          tapes: 1,
+          frames: 3,
+          droppedFrames: 0,
+          error: '',
+        });
+
+        const [teePath] = await readdir(teeDirectory);
+        const { stdout } = await execFileAsync(executable, [
+          'inspect',
+          '--input',
+          path.join(teeDirectory, teePath),
+          '--json',
+        ]);
+        expect(JSON.parse(stdout)).toMatchObject({
+          frames: 3,
+          sessionUpdates: 2,
+          gapRecords: 0,
+        });
+
+        // The flight recorder kept the same frames in memory.
+        const dumpPath = path.join(temporaryDirectory, 'window.irdt');
+        await expect(sdk.dumpFlightRecorder?.(dumpPath)).resolves.toEqual({
+          path: dumpPath,
+          frames: 3,
+        });
+        const { stdout: dumped } = await execFileAsync(executable, [
+          'inspect',
+          '--input',
+          dumpPath,
+          '--json',
+        ]);
+        expect(JSON.parse(dumped)).toMatchObject({
+          frames: 3,
+          sessionUpdates: 2,
+        });
       } catch (error) {
         throw new Error(
           `${String(error)}\nPublisher output:\n${output.all()}`,
           { cause: error }
         );
       } finally {
+        sdk.stopTelemetryTee?.();
+        sdk.stopFlightRecorder?.();
         sdk.stopSDK();
       }
     }
   );
+
+  it(
+    'reports the same per-variable statistics at any job count',
+    { timeout: 20_000 },
+    async () => {
+      const executable = path.resolve(
+        process.cwd(),
+        'build',
+        'Release',
+        replayExecutableName
+      );
+      temporaryDirectory = await mkdtemp(
+        path.join(tmpdir(), 'irdashies-irsdk-replay-')
+      );
+      const tapePath = path.join(temporaryDirectory, 'synthetic.irdt');
+      await execFileAsync(executable, ['fixture', '--output', tapePath]);
+
+      const inspect = async (
+        jobs: string
+      ): Promise<{ variables: Record<string, unknown>[] }> => {
+        const { stdout } = await execFileAsync(executable, [
+          'inspect',
+          '--input',
+          tapePath,
+          '--json',
+          '--jobs',
+          jobs,
+        ]);
+        return JSON.parse(stdout);
+      };
+      const single = await inspect('1');
+      expect(single).toMatchObject({ frames: 3, sessionUpdates: 2 });
+      const byName = new Map(
+        single.variables.map((variable) => [variable.name, variable])
+      );
+      expect(byName.get('Speed')).toEqual({
+        name: 'Speed',
+        unit: 'm/s',
+        type: 'float',
+        count: 1,
+        samples: 3,
+        nanCount: 0,
+        min: 50,
+        max: 52,
+        mean: 51,
+        stddev: expect.closeTo(Math.sqrt(2 / 3), 9),
+        changes: 2,
+        firstChangeSeconds: expect.closeTo(1 / 60, 6),
+        lastChangeSeconds: expect.closeTo(2 / 60, 6),
+      });
+      // Array entries are reduced together, including the 61 empty car
+      // slots that read -1.
+      expect(byName.get('CarIdxLapDistPct')).toMatchObject({
+        count: 64,
+        samples: 192,
+        min: -1,
+        max: expect.closeTo(0.32, 6),
+        mean: expect.closeTo((1.89 - 183) / 192, 6),
+      });
+      // Bit fields have a range but no mean, and constants never change.
+      expect(byName.get('SessionFlags')).toMatchObject({
+        mean: null,
+        stddev: null,
+        changes: 1,
+      });
+      expect(byName.get('IsOnTrack')).toMatchObject({
+        changes: 0,
+        firstChangeSeconds: null,
+        lastChangeSeconds: null,
+      });
+
+      // Partitions are merged, so only the rounding of the running sums may
+      // differ between job counts.
+      const partitioned = await inspect('3');
+      expect(partitioned.variables).toHaveLength(single.variables.length);
+      for (const [index, variable] of single.variables.entries()) {
+        const { mean, stddev, ...exact } = variable;
+        expect(partitioned.variables[index]).toMatchObject(exact);
+        for (const [key, value] of Object.entries({ mean, stddev })) {
+          expect(partitioned.variables[index][key]).toEqual(
+            typeof value === 'number' ? expect.closeTo(value, 9) : value
+          );
+        }
+      }
+
+      const { stdout: table } = await execFileAsync(executable, [
+        'inspect',
+        '--input',
+        tapePath,
+      ]);
+      expect(table).toMatch(/^Frames: 3$/m);
+      expect(table).toMatch(/^CarIdxLapDistPct\[64\]\s+-1\s+0\.32\s/m);
+    }
+  );
+
+  it(
+    'hands every tape frame to several consumer threads in order',
+    { timeout: 20_000 },
+    async () => {
+      const executable = path.resolve(
+        process.cwd(),
+        'build',
+        'Release',
+        replayExecutableName
+      );
+      const bench = path.resolve(
+        process.cwd(),
+        'build',
+        'Release',
+        isWindows ? 'irsdk_var_bench.exe' : 'irsdk_var_bench'
+      );
+      temporaryDirectory = await mkdtemp(
+        path.join(tmpdir(), 'irdashies-irsdk-replay-')
+      );
+      const tapePath = path.join(temporaryDirectory, 'synthetic.irdt');
+      await execFileAsync(executable, ['fixture', '--output', tapePath]);
+
+      // Each thread waits through its own irsdkClient on the shared reader
+      // and reads through handles shared by all of them. The bench fails
+      // when a thread sees a tick go backwards, gets no frame, or disagrees
+      // with another thread about a frame's values.
+      const { stdout } = await execFileAsync(bench, [
+        '--input',
+        tapePath,
+        '--threads',
+        '4',
+      ]);
+      expect(stdout).toMatch(/^4 threads read 3 frames, ticks 100 to 102,/m);
+    }
+  );
+
+  // Plays the fixture with production names, records it back with the given
+  // extra arguments, and inspects the recorded tape.
+  const recordFixture = async (
+    recordArguments: string[]
+  ): Promise<{ log: string; report: RecordedReport }> => {
+    const executable = path.resolve(
+      process.cwd(),
+      'build',
+      'Release',
+      replayExecutableName
+    );
+    temporaryDirectory = await mkdtemp(
+      path.join(tmpdir(), 'irdashies-irsdk-replay-')
+    );
+    const tapePath = path.join(temporaryDirectory, 'synthetic.irdt');
+    const recordedPath = path.join(temporaryDirectory, 'recorded.irdt');
+
+    await execFileAsync(executable, ['fixture', '--output', tapePath]);
+
+    publisher = spawn(
+      executable,
+      ['play', '--input', tapePath, '--step', '--iracing-names'],
+      { stdio: 'pipe' }
+    );
+    const output = new ProcessOutput(publisher);
+    await output.waitFor(/READY/);
+
+    const recorder = spawn(
+      executable,
+      [
+        'record',
+        '--output',
+        recordedPath,
+        '--duration',
+        '15',
+        ...recordArguments,
+      ],
+      { stdio: 'pipe' }
+    );
+    const recorderOutput = new ProcessOutput(recorder);
+    const recorderClosed = once(recorder, 'close');
+    try {
+      // The publisher connects with its first frame, which the recorder
+      // treats as already published when it starts.
+      await recorderOutput.waitFor(/Waiting for iRacing shared memory/);
+      await sendCommand(publisher, 'next');
+      await output.waitFor(/FRAME 1 100/, 15_000);
+      await recorderOutput.waitFor(/Recording \d+/);
+      for (const [frame, tick] of [
+        [2, 101],
+        [3, 102],
+      ]) {
+        await sendCommand(publisher, 'next');
+        await output.waitFor(new RegExp(`FRAME ${frame} ${tick}`), 15_000);
+      }
+      // Playback ending disconnects, which ends the recording.
+      await sendCommand(publisher, 'next');
+      await output.waitFor(/DONE 3/);
+      const [exitCode] = await recorderClosed;
+      expect(exitCode).toBe(0);
+
+      const { stdout } = await execFileAsync(executable, [
+        'inspect',
+        '--input',
+        recordedPath,
+        '--json',
+      ]);
+      return {
+        log: recorderOutput.all(),
+        report: JSON.parse(stdout) as RecordedReport,
+      };
+    } catch (error) {
+      throw new Error(
+        `${String(error)}\nPublisher output:\n${output.all()}\n` +
+          `Recorder output:\n${recorderOutput.all()}`,
+        { cause: error }
+      );
+    } finally {
+      if (recorder.exitCode === null) {
+        recorder.kill();
+        await recorderClosed;
+      }
+    }
+  };
+
+  itOnPosix(
+    'records a POSIX replay back through shared memory',
+    { timeout: 20_000 },
+    async () => {
+      const { log, report } = await recordFixture([]);
+
+      expect(log).toContain('Recording 7 variables, 288 bytes per frame');
+      expect(log).toContain(
+        'Capture complete: 2 frames, 0 missed source ticks'
+      );
+      expect(report).toMatchObject({ frames: 2, gapRecords: 0 });
+      expect(
+        report.variables.find(({ name }) => name === 'SessionTick')
+      ).toMatchObject({ min: 101, max: 102 });
+      expect(
+        report.variables.find(({ name }) => name === 'Speed')
+      ).toMatchObject({ min: 51, max: 52 });
+    }
+  );
+
+  itOnPosix(
+    'records only the allowlisted variables with --vars',
+    { timeout: 20_000 },
+    async () => {
+      const { log, report } = await recordFixture([
+        '--vars',
+        'Speed,CarIdxLapDistPct,SessionTick',
+      ]);
+
+      // The subset keeps the source order in a frame padded to 16 bytes.
+      expect(log).toContain(
+        'Recording 3 of 7 variables, 272 of 288 bytes per frame'
+      );
+      expect(report).toMatchObject({ frames: 2, frameBytes: 272 });
+      expect(
+        report.variables.map(({ name, count }) => [name, count])
+      ).toEqual([
+        ['SessionTick', 1],
+        ['Speed', 1],
+        ['CarIdxLapDistPct', 64],
+      ]);
+      expect(
+        report.variables.find(({ name }) => name === 'CarIdxLapDistPct')
+      ).toMatchObject({
+        min: -1,
+        max: expect.closeTo(0.32, 5),
+      });
+    }
+  );
 });
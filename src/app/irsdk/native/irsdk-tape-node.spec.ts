@@ -95,11 +95,13 @@ function createFrame(index: number): Buffer {
 interface TapeFixtureOptions {
   includeEndRecord?: boolean;
   qpcFrequency?: bigint;
+  secondSession?: boolean;
 }
 
 function createTapeFixture({
   includeEndRecord = true,
   qpcFrequency = 60n,
+  secondSession = false,
 }: TapeFixtureOptions = {}): Buffer {
   const variables = [
     createVariableHeader({
@@ -185,8 +187,23 @@ function createTapeFixture({
     createRecord(2, 0n, -1, 1, session),
     createRecord(1, 0n, 100, 0, createFrame(0)),
     createRecord(1, 1n, 101, 0, createFrame(1)),
-    createRecord(1, 2n, 102, 0, createFrame(2)),
   ];
+  if (secondSession) {
+    records.push(
+      createRecord(
+        2,
+        2n,
+        101,
+        2,
+        Buffer.from(
+          '---\nWeekendInfo:\n TrackName: Replay Test Track\n' +
+            'SessionInfo:\n Sessions:\n - SessionNum: 0\n...\n',
+          'ascii'
+        )
+      )
+    );
+  }
+  records.push(createRecord(1, 2n, 102, 0, createFrame(2)));
   if (includeEndRecord) {
     records.push(createRecord(5, 3n, 102, 0));
   }
@@ -341,4 +358,70 @@ describe('tape-backed native SDK', () => {
       sdk.stopSDK();
     }
   });
+
+  it('scrubs to indexed frames and restores their session revision', async () => {
+    await writeFile(tapePath, createTapeFixture({ secondSession: true }));
+
+    process.env.IRDASHIES_TELEMETRY_REPLAY = tapePath;
+
+    const addon = loadAddon();
+    const sdk = new addon.iRacingSdkNode();
+
+    try {
+      expect(sdk.startSDK()).toBe(true);
+
+      let speed = 0;
+      while (speed < 52) {
+        expect(sdk.waitForData(20)).toBe(true);
+        speed = floatValue(sdk.getTelemetryData().Speed.value);
+      }
+      expect(sdk.getSessionData()).toContain('SessionNum: 0');
+
+      expect(sdk.setTelemetryPaused?.(true)).toBe(true);
+      expect(sdk.stepTelemetry?.(-2)).toBe(true);
+      expect(sdk.waitForData(20)).toBe(true);
+      expect(floatValue(sdk.getTelemetryData().Speed.value)).toBeCloseTo(50, 5);
+      expect(sdk.getSessionData()).not.toContain('SessionNum: 0');
+
+      // A paused tape stays connected without publishing further frames.
+      expect(sdk.waitForData(5)).toBe(false);
+      expect(sdk.isRunning()).toBe(true);
+
+      expect(sdk.seekTelemetry?.(1)).toBe(true);
+      expect(sdk.waitForData(20)).toBe(true);
+      expect(floatValue(sdk.getTelemetryData().Speed.value)).toBeCloseTo(52, 5);
+      expect(sdk.getSessionData()).toContain('SessionNum: 0');
+    } finally {
+      sdk.stopSDK();
+    }
+  });
+
+  it('reports publish lateness and frame intervals', async () => {
+    await writeFile(tapePath, createTapeFixture());
+
+    process.env.IRDASHIES_TELEMETRY_REPLAY = tapePath;
+
+    const addon = loadAddon();
+    const sdk = new addon.iRacingSdkNode();
+
+    try {
+      expect(sdk.startSDK()).toBe(true);
+
+      let speed = 0;
+      while (speed < 52) {
+        expect(sdk.waitForData(20)).toBe(true);
+        speed = floatValue(sdk.getTelemetryData().Speed.value);
+      }
+
+      const stats = sdk.getPlaybackStats?.();
+      expect(stats?.lateness.count).toBe(3);
+      expect(stats?.frameInterval.count).toBe(2);
+      expect(stats?.lateness.minMs).toBeGreaterThanOrEqual(0);
+      expect(stats?.lateness.p50Ms).toBeLessThanOrEqual(
+        stats?.lateness.maxMs ?? 0
+      );
+    } finally {
+      sdk.stopSDK();
+    }
+  });
 });
@@ -0,0 +1,675 @@
+import { execFile } from 'node:child_process';
+import { mkdtemp, readFile, rm, writeFile } from 'node:fs/promises';
+import { tmpdir } from 'node:os';
+import path from 'node:path';
+import { promisify } from 'node:util';
+
+import { afterEach, describe, expect, it } from 'vitest';
+
+import recordedTelemetry from '../../../../test-data/1747384033336/telemetry.json';
+import { TelemetryWireDecoder } from '../../../shared/telemetryWire';
+
+const execFileAsync = promisify(execFile);
+const isWindows = process.platform === 'win32';
+const executablePath = (name: string): string =>
+  path.resolve(
+    process.cwd(),
+    'build',
+    'Release',
+    isWindows ? `${name}.exe` : name
+  );
+const replayExecutable = executablePath('irsdk_replay');
+const tapeToolExecutable = executablePath('irsdk_tape_tool');
+
+interface ToolResult {
+  code: number;
+  stdout: string;
+  stderr: string;
+}
+
+// Runs the tape tool and resolves with its exit code instead of rejecting, so
+// a diff that reports differences can be checked like one that does not.
+const runTapeTool = async (args: string[]): Promise<ToolResult> => {
+  try {
+    const { stdout, stderr } = await execFileAsync(tapeToolExecutable, args);
+    return { code: 0, stdout, stderr };
+  } catch (error) {
+    const failure = error as {
+      code?: number;
+      stdout?: string;
+      stderr?: string;
+    };
+    return {
+      code: typeof failure.code === 'number' ? failure.code : -1,
+      stdout: failure.stdout ?? '',
+      stderr: failure.stderr ?? '',
+    };
+  }
+};
+
+interface InspectReport {
+  frames: number;
+  frameBytes: number;
+  sessionUpdates: number;
+  variables: { name: string; count: number; min: number; max: number }[];
+}
+
+const inspectTape = async (tapePath: string): Promise<InspectReport> => {
+  const { stdout } = await execFileAsync(replayExecutable, [
+    'inspect',
+    '--input',
+    tapePath,
+    '--json',
+  ]);
+  return JSON.parse(stdout) as InspectReport;
+};
+
+interface ColumnFile {
+  rowCount: number;
+  chunkCount: number;
+  columns: { name: string; type: number; count: number; rows: number[][] }[];
+  // [chunk][column] min/max pairs
+  chunkStats: [number, number][][];
+}
+
+// Reads an .irdc back into per-column rows, following the layout in
+// irsdk_tape_columns.h. Only the float and double columns the spec exports
+// are decoded.
+const readColumnFile = (file: Buffer): ColumnFile => {
+  const view = new DataView(file.buffer, file.byteOffset, file.byteLength);
+  const fileHeaderSize = view.getUint32(12, true);
+  const columnHeaderSize = view.getUint32(16, true);
+  const columnCount = view.getUint32(20, true);
+  const chunkRows = view.getUint32(24, true);
+  const rowCount = Number(view.getBigUint64(32, true));
+  const chunkCount = Number(view.getBigUint64(40, true));
+  const dataOffset = Number(view.getBigUint64(48, true));
+  const statsOffset = Number(view.getBigUint64(56, true));
+
+  const columns: ColumnFile['columns'] = [];
+  for (let i = 0; i < columnCount; i++) {
+    const at = fileHeaderSize + i * columnHeaderSize;
+    const name = file.toString('latin1', at, at + 32).replace(/\0.*$/s, '');
+    columns.push({
+      name,
+      type: view.getUint32(at + 64, true),
+      count: view.getUint32(at + 68, true),
+      rows: [],
+    });
+  }
+  const elementSize = (type: number): number => (type === 5 ? 8 : 4);
+  const rowBytes = columns.reduce(
+    (total, column) => total + column.count * elementSize(column.type),
+    0
+  );
+
+  for (let chunk = 0; chunk < chunkCount; chunk++) {
+    const rows = Math.min(chunkRows, rowCount - chunk * chunkRows);
+    let at = dataOffset + chunk * chunkRows * rowBytes;
+    for (const column of columns) {
+      const size = elementSize(column.type);
+      for (let row = 0; row < rows; row++) {
+        const values: number[] = [];
+        for (let entry = 0; entry < column.count; entry++) {
+          values.push(
+            size === 8 ? view.getFloat64(at, true) : view.getFloat32(at, true)
+          );
+          at += size;
+        }
+        column.rows.push(values);
+      }
+    }
+  }
+
+  const chunkStats: ColumnFile['chunkStats'] = [];
+  for (let chunk = 0; chunk < chunkCount; chunk++) {
+    const stats: [number, number][] = [];
+    for (let column = 0; column < columnCount; column++) {
+      const at = statsOffset + (chunk * columnCount + column) * 16;
+      stats.push([view.getFloat64(at, true), view.getFloat64(at + 8, true)]);
+    }
+    chunkStats.push(stats);
+  }
+  return { rowCount, chunkCount, columns, chunkStats };
+};
+
+interface RecordedVariable {
+  name: string;
+  description: string;
+  unit: string;
+  countAsTime: boolean;
+  length: number;
+  varType: number;
+  value: (number | boolean)[];
+}
+
+// A frame recorded in a live session, in schema order.
+const recordedVariables = Object.values(
+  recordedTelemetry as Record<string, RecordedVariable>
+);
+
+// irsdk_VarType sizes
+const TYPE_BYTES = [1, 1, 4, 4, 4, 8];
+
+// A value as a frame stores it and the decoder returns it.
+const storedValue = (
+  varType: number,
+  value: number | boolean
+): number | boolean => {
+  switch (varType) {
+    case 1:
+      return Boolean(value);
+    case 4:
+      return Math.fround(Number(value));
+    case 5:
+      return Number(value);
+    default:
+      return Math.trunc(Number(value));
+  }
+};
+
+// Channels that move with the car between the telemetry inspector's 10 Hz
+// messages, and how far each swings from its recorded value.
+const MOVING_CHANNELS: Record<string, number> = {
+  Speed: 8,
+  VelocityX: 8,
+  VelocityY: 0.5,
+  VelocityZ: 0.3,
+  RPM: 700,
+  Engine0_RPM: 700,
+  Throttle: 0.5,
+  ThrottleRaw: 0.5,
+  Brake: 0.4,
+  BrakeRaw: 0.4,
+  SteeringWheelAngle: 0.8,
+  SteeringWheelTorque: 6,
+  SteeringWheelPctTorque: 0.2,
+  SteeringWheelPctTorqueSign: 0.2,
+  SteeringWheelPctTorqueSignStops: 0.2,
+  Yaw: 0.4,
+  YawNorth: 0.4,
+  YawRate: 0.3,
+  Pitch: 0.01,
+  PitchRate: 0.02,
+  Roll: 0.02,
+  RollRate: 0.05,
+  LatAccel: 12,
+  LongAccel: 8,
+  VertAccel: 2,
+  ManifoldPress: 0.6,
+  LFshockDefl: 0.01,
+  RFshockDefl: 0.01,
+  LRshockDefl: 0.01,
+  RRshockDefl: 0.01,
+  LFshockVel: 0.05,
+  RFshockVel: 0.05,
+  LRshockVel: 0.05,
+  RRshockVel: 0.05,
+  CarDistAhead: 5,
+  CarDistBehind: 5,
+  FrameRate: 1,
+  CpuUsageFG: 0.05,
+  CpuUsageBG: 0.05,
+  GpuUsage: 0.05,
+  CarIdxSteer: 0.3,
+  CarIdxRPM: 600,
+};
+
+// Rebuilds a minute of a race, 600 frames at 10 Hz, around a frame recorded
+// in a live session: the clocks run, every car moves around the lap, and the
+// player's inputs, engine, and motion channels move with noise the way a
+// sensor's do. Channels outside that keep their recorded values, as most of
+// a real frame does. Returns each frame's values in the snapshot's order.
+const raceFrames = (): (number | boolean)[][][] => {
+  const index = (name: string): number =>
+    recordedVariables.findIndex((variable) => variable.name === name);
+  const onTrack = (
+    recordedVariables[index('CarIdxLapDistPct')].value as number[]
+  ).map((pct) => pct >= 0);
+  const lapTimes = (
+    recordedVariables[index('CarIdxLastLapTime')].value as number[]
+  ).map((time, car) => (time > 0 ? time : 100 + car / 4));
+
+  let seed = 1;
+  const noise = (): number => {
+    seed = (seed * 48271) % 0x7fffffff;
+    return seed / 0x7fffffff - 0.5;
+  };
+  const moving = Object.entries(MOVING_CHANNELS).map(
+    ([name, swing]) => [index(name), swing] as const
+  );
+  const subSteps = recordedVariables
+    .map((variable, at) => [variable, at] as const)
+    .filter(([variable]) => variable.name.endsWith('_ST'));
+
+  const frames: (number | boolean)[][][] = [];
+  let values = recordedVariables.map((variable) => [...variable.value]);
+  const add = (name: string, step: number): void => {
+    const entries = values[index(name)] as number[];
+    entries[0] += step;
+  };
+  for (let frame = 0; frame < 600; frame++) {
+    const time = frame / 10;
+    values = values.map((entries) => [...entries]);
+    if (frame > 0) {
+      add('SessionTime', 0.1);
+      add('SessionTimeRemain', -0.1);
+      add('SessionTimeOfDay', 0.1);
+      add('SessionTick', 6);
+      add('LapCurrentLapTime', 0.1);
+      add('FuelLevel', -0.0025);
+      add('FuelLevelPct', -0.000025);
+      add('LapDeltaToSessionBestLap', 0.002 * noise());
+      add('LapDeltaToSessionLastlLap', 0.002 * noise());
+      const pcts = values[index('CarIdxLapDistPct')] as number[];
+      const laps = values[index('CarIdxLap')] as number[];
+      const estTimes = values[index('CarIdxEstTime')] as number[];
+      for (let car = 0; car < pcts.length; car++) {
+        if (!onTrack[car]) continue;
+        pcts[car] += 0.1 / lapTimes[car];
+        estTimes[car] += 0.1;
+        if (pcts[car] >= 1) {
+          pcts[car] -= 1;
+          estTimes[car] = 0;
+          laps[car] += 1;
+        }
+      }
+    }
+    for (const [at, swing] of moving) {
+      const recorded = recordedVariables[at].value as number[];
+      values[at] = recorded.map((value, entry) =>
+        recordedVariables[at].name.startsWith('CarIdx') && !onTrack[entry]
+          ? value
+          : value +
+            swing * (Math.sin(time * (0.7 + entry / 9) + at) + noise() / 10)
+      );
+    }
+    for (const [variable, at] of subSteps) {
+      const swing = MOVING_CHANNELS[variable.name.slice(0, -3)] ?? 0.1;
+      values[at] = variable.value.map(
+        (value, entry) =>
+          (value as number) +
+          swing * (Math.sin(time + entry / 360 + at) + noise() / 10)
+      );
+    }
+    frames.push(values);
+  }
+  return frames;
+};
+
+// Writes the snapshot's variables and the given frames as an .ibt log.
+const writeRecordedIbt = async (
+  ibtPath: string,
+  frames: (number | boolean)[][][]
+): Promise<void> => {
+  const headers: Buffer[] = [];
+  const offsets: number[] = [];
+  let bufLen = 0;
+  for (const variable of recordedVariables) {
+    const header = Buffer.alloc(144);
+    header.writeInt32LE(variable.varType, 0);
+    header.writeInt32LE(bufLen, 4);
+    header.writeInt32LE(variable.length, 8);
+    header.writeUInt8(variable.countAsTime ? 1 : 0, 12);
+    header.write(variable.name, 16, 31, 'ascii');
+    header.write(variable.description, 48, 63, 'ascii');
+    header.write(variable.unit, 112, 31, 'ascii');
+    headers.push(header);
+    offsets.push(bufLen);
+    bufLen += TYPE_BYTES[variable.varType] * variable.length;
+  }
+
+  const samples = frames.map((values) => {
+    const sample = Buffer.alloc(bufLen);
+    recordedVariables.forEach(({ varType }, at) => {
+      const size = TYPE_BYTES[varType];
+      values[at].forEach((value, entry) => {
+        const position = offsets[at] + entry * size;
+        if (varType === 4) sample.writeFloatLE(Number(value), position);
+        else if (varType === 5) sample.writeDoubleLE(Number(value), position);
+        else if (size === 4) sample.writeInt32LE(Number(value), position);
+        else sample.writeUInt8(Number(value), position);
+      });
+    });
+    return sample;
+  });
+
+  const session = Buffer.alloc(256);
+  session.write('---\nWeekendInfo:\n TrackName: Recorded Track\n...\n');
+  const variableOffset = 112 + 32;
+  const sessionOffset = variableOffset + headers.length * 144;
+  const sdkHeader = Buffer.alloc(112);
+  sdkHeader.writeInt32LE(2, 0);
+  sdkHeader.writeInt32LE(1, 4);
+  sdkHeader.writeInt32LE(60, 8);
+  sdkHeader.writeInt32LE(session.length, 16);
+  sdkHeader.writeInt32LE(sessionOffset, 20);
+  sdkHeader.writeInt32LE(headers.length, 24);
+  sdkHeader.writeInt32LE(variableOffset, 28);
+  sdkHeader.writeInt32LE(1, 32);
+  sdkHeader.writeInt32LE(bufLen, 36);
+  sdkHeader.writeInt32LE(sessionOffset + session.length, 52);
+  const diskHeader = Buffer.alloc(32);
+  diskHeader.writeInt32LE(frames.length, 28);
+  await writeFile(
+    ibtPath,
+    Buffer.concat([sdkHeader, diskHeader, ...headers, session, ...samples])
+  );
+};
+
+// Splits an irsdk_tape_tool wire output into its messages.
+const wireMessages = (file: Buffer): Uint8Array[] => {
+  const messages: Uint8Array[] = [];
+  for (let at = 0; at < file.length; ) {
+    const length = file.readUInt32LE(at);
+    messages.push(file.subarray(at + 4, at + 4 + length));
+    at += 4 + length;
+  }
+  return messages;
+};
+
+describe('irsdk_tape_tool', () => {
+  let temporaryDirectory: string | undefined;
+
+  afterEach(async () => {
+    if (temporaryDirectory) {
+      await rm(temporaryDirectory, { recursive: true, force: true });
+    }
+    temporaryDirectory = undefined;
+  });
+
+  // The fixture holds three frames at ticks 100-102 with Speed 50-52.
+  const createFixture = async (): Promise<string> => {
+    temporaryDirectory = await mkdtemp(
+      path.join(tmpdir(), 'irdashies-irsdk-tape-tool-')
+    );
+    const tapePath = path.join(temporaryDirectory, 'synthetic.irdt');
+    await execFileAsync(replayExecutable, ['fixture', '--output', tapePath]);
+    return tapePath;
+  };
+
+  it(
+    'converts a tape to .ibt and back without changing its frames',
+    { timeout: 20_000 },
+    async () => {
+      const tapePath = await createFixture();
+      const directory = path.dirname(tapePath);
+      const ibtDirectory = path.join(directory, 'ibt');
+      const roundTripDirectory = path.join(directory, 'round-trip');
+
+      const toIbt = await runTapeTool([
+        'convert',
+        '--output-dir',
+        ibtDirectory,
+        tapePath,
+      ]);
+      expect(toIbt.code).toBe(0);
+      expect(toIbt.stdout).toContain('synthetic.ibt (3 frames)');
+
+      const toTape = await runTapeTool([
+        'convert',
+        '--output-dir',
+        roundTripDirectory,
+        path.join(ibtDirectory, 'synthetic.ibt'),
+      ]);
+      expect(toTape.code).toBe(0);
+      expect(toTape.stdout).toContain('synthetic.irdt (3 frames)');
+
+      const roundTripPath = path.join(roundTripDirectory, 'synthetic.irdt');
+      const report = await inspectTape(roundTripPath);
+      expect(report).toMatchObject({ frames: 3, frameBytes: 288 });
+      expect(
+        report.variables.find((variable) => variable.name === 'Speed')
+      ).toMatchObject({ min: 50, max: 52 });
+
+      // Frames converted from an .ibt keep the SessionTick they were published
+      // at, so they align by tick with the original capture.
+      for (const align of ['tick', 'time']) {
+        const diff = await runTapeTool([
+          'diff',
+          tapePath,
+          roundTripPath,
+          '--align',
+          align,
+        ]);
+        expect(diff.stdout).toContain('3 aligned, 0 only in first');
+        expect(diff.stdout).toContain('Tapes match');
+        expect(diff.code).toBe(0);
+      }
+    }
+  );
+
+  it('reports the inputs it cannot convert', async () => {
+    const tapePath = await createFixture();
+    const truncatedPath = path.join(path.dirname(tapePath), 'truncated.ibt');
+    await writeFile(truncatedPath, 'not telemetry');
+
+    const unsupported = await runTapeTool(['convert', 'notes.txt']);
+    expect(unsupported.code).toBe(2);
+    expect(unsupported.stderr).toContain('accepts .ibt and .irdt inputs');
+
+    const truncated = await runTapeTool(['convert', truncatedPath, tapePath]);
+    expect(truncated.code).toBe(1);
+    expect(truncated.stderr).toContain('1 of 2 conversions failed');
+  });
+
+  it(
+    'exports allowlisted variables as chunked columns',
+    { timeout: 20_000 },
+    async () => {
+      const tapePath = await createFixture();
+      const directory = path.dirname(tapePath);
+
+      const outputs: Buffer[] = [];
+      for (const jobs of ['1', '3']) {
+        const outputPath = path.join(directory, `columns-${jobs}.irdc`);
+        const result = await runTapeTool([
+          'export',
+          '--input',
+          tapePath,
+          '--output',
+          outputPath,
+          '--vars',
+          'CarIdxLapDistPct,Speed',
+          '--chunk-rows',
+          '2',
+          '--jobs',
+          jobs,
+        ]);
+        expect(result.code).toBe(0);
+        expect(result.stdout).toContain('3 frames x 3 columns in 2 chunks');
+        outputs.push(await readFile(outputPath));
+      }
+      // Chunks land at fixed offsets, so the worker count cannot change them.
+      expect(outputs[1].equals(outputs[0])).toBe(true);
+
+      const columns = readColumnFile(outputs[0]);
+      expect(outputs[0].toString('latin1', 0, 7)).toBe('IRDCOLS');
+      expect(columns).toMatchObject({ rowCount: 3, chunkCount: 2 });
+      // Variables keep schema order behind the tape time column.
+      expect(columns.columns.map(({ name, count }) => [name, count])).toEqual([
+        ['_TapeTime', 1],
+        ['Speed', 1],
+        ['CarIdxLapDistPct', 64],
+      ]);
+
+      const [tapeTime, speed, lapDistPct] = columns.columns;
+      expect(tapeTime.rows.map(([seconds]) => seconds)).toEqual([
+        0,
+        expect.closeTo(1 / 60, 6),
+        expect.closeTo(2 / 60, 6),
+      ]);
+      expect(speed.rows).toEqual([[50], [51], [52]]);
+      expect(lapDistPct.rows[2]).toHaveLength(64);
+      expect(lapDistPct.rows[2].slice(0, 4)).toEqual([
+        expect.closeTo(0.12, 6),
+        expect.closeTo(0.22, 6),
+        expect.closeTo(0.32, 6),
+        -1,
+      ]);
+
+      // The second chunk holds only the last frame.
+      expect(columns.chunkStats[0][1]).toEqual([50, 51]);
+      expect(columns.chunkStats[1][1]).toEqual([52, 52]);
+      expect(columns.chunkStats[0][2]).toEqual([-1, expect.closeTo(0.31, 6)]);
+    }
+  );
+
+  it('rejects an export allowlist naming an unknown variable', async () => {
+    const tapePath = await createFixture();
+
+    const result = await runTapeTool([
+      'export',
+      '--input',
+      tapePath,
+      '--vars',
+      'Speed,NotAVariable',
+    ]);
+    expect(result.code).not.toBe(0);
+    expect(result.stderr).toContain('NotAVariable');
+  });
+
+  // Writes an .ibt copy of the fixture with edits applied to its bytes and
+  // converts it back, the way a re-recorded session would arrive.
+  const editedTape = async (
+    tapePath: string,
+    edit: (ibt: Buffer) => void
+  ): Promise<string> => {
+    const directory = path.dirname(tapePath);
+    const ibtPath = path.join(directory, 'edited.ibt');
+    const toIbt = await runTapeTool([
+      'convert',
+      '--output-dir',
+      directory,
+      tapePath,
+    ]);
+    expect(toIbt.code).toBe(0);
+    const ibt = await readFile(path.join(directory, 'synthetic.ibt'));
+    edit(ibt);
+    await writeFile(ibtPath, ibt);
+    expect((await runTapeTool(['convert', ibtPath])).code).toBe(0);
+    return path.join(directory, 'edited.irdt');
+  };
+
+  const replaceOnce = (ibt: Buffer, from: Buffer, to: Buffer): void => {
+    const at = ibt.indexOf(from);
+    expect(at).toBeGreaterThanOrEqual(0);
+    expect(ibt.indexOf(from, at + 1)).toBe(-1);
+    to.copy(ibt, at);
+  };
+
+  const float32 = (value: number): Buffer => {
+    const bytes = Buffer.alloc(4);
+    bytes.writeFloatLE(value);
+    return bytes;
+  };
+
+  it(
+    'reports the first divergence between two tapes',
+    { timeout: 20_000 },
+    async () => {
+      const tapePath = await createFixture();
+
+      const same = await runTapeTool(['diff', tapePath, tapePath]);
+      expect(same.code).toBe(0);
+      expect(same.stdout).toContain('Tapes match');
+
+      // Speed is 51 only in the second frame.
+      const editedPath = await editedTape(tapePath, (ibt) =>
+        replaceOnce(ibt, float32(51), float32(51.25))
+      );
+      for (const jobs of ['1', '2']) {
+        const diff = await runTapeTool([
+          'diff',
+          tapePath,
+          editedPath,
+          '--jobs',
+          jobs,
+        ]);
+        expect(diff.code).toBe(1);
+        expect(diff.stdout).toContain('Divergent frames: 1');
+        expect(diff.stdout).toContain(
+          'First divergence: tick 101 / 101 at 0.0166667 s / 0.0166667 s, ' +
+            'Speed 51 vs 51.25'
+        );
+        expect(diff.stdout).toMatch(/^ {2}Speed: 1 frames$/m);
+      }
+
+      const tolerated = await runTapeTool([
+        'diff',
+        tapePath,
+        editedPath,
+        '--float-tolerance',
+        '0.5',
+      ]);
+      expect(tolerated.code).toBe(0);
+      expect(tolerated.stdout).toContain('Tapes match');
+    }
+  );
+
+  it('reports variables only one tape has', { timeout: 20_000 }, async () => {
+    const tapePath = await createFixture();
+    const editedPath = await editedTape(tapePath, (ibt) =>
+      replaceOnce(ibt, Buffer.from('IsOnTrack\0'), Buffer.from('OnPitRoad\0'))
+    );
+
+    const diff = await runTapeTool(['diff', tapePath, editedPath]);
+    expect(diff.code).toBe(1);
+    expect(diff.stdout).toContain('3 aligned, 0 only in first');
+    expect(diff.stdout).toContain('Schema: IsOnTrack: only in the first tape');
+    expect(diff.stdout).toContain('Schema: OnPitRoad: only in the second tape');
+    expect(diff.stdout).not.toContain('Divergent frames');
+  });
+
+  it(
+    'encodes a race in under a tenth of its JSON size',
+    { timeout: 60_000 },
+    async () => {
+      temporaryDirectory = await mkdtemp(
+        path.join(tmpdir(), 'irdashies-irsdk-tape-tool-')
+      );
+      const ibtPath = path.join(temporaryDirectory, 'race.ibt');
+      const frames = raceFrames();
+      await writeRecordedIbt(ibtPath, frames);
+      expect((await runTapeTool(['convert', ibtPath])).code).toBe(0);
+
+      const wirePath = path.join(temporaryDirectory, 'race.irdw');
+      const result = await runTapeTool([
+        'wire',
+        '--input',
+        path.join(temporaryDirectory, 'race.irdt'),
+        '--output',
+        wirePath,
+      ]);
+      expect(result.code).toBe(0);
+      expect(result.stdout).toContain('Encoded 600 frames');
+
+      // Every message decodes to the frame it was built from.
+      const messages = wireMessages(await readFile(wirePath));
+      expect(messages).toHaveLength(600);
+      const decoder = new TelemetryWireDecoder();
+      let wireBytes = 0;
+      let jsonBytes = 0;
+      messages.forEach((message, frame) => {
+        const telemetry = decoder.decode(message) as Record<
+          string,
+          { value: unknown[] }
+        >;
+        expect(telemetry).not.toBeNull();
+        expect(
+          recordedVariables.map(({ name }) => telemetry[name].value)
+        ).toEqual(
+          recordedVariables.map(({ varType }, at) =>
+            frames[frame][at].map((value) => storedValue(varType, value))
+          )
+        );
+        wireBytes += message.length;
+        jsonBytes += Buffer.byteLength(JSON.stringify(telemetry));
+      });
+
+      // The objects the bridge sent before also carried each variable's
+      // name, description, and unit, so the values alone undercount them.
+      expect(wireBytes * 10).toBeLessThan(jsonBytes);
+    }
+  );
+});
@@ -1,6 +1,15 @@
 #include "./irsdk_node.h"
 #include "./lib/yaml_parser.h"
 
+#include <algorithm>
+
+#ifdef IRDASHIES_TELEMETRY_TAPE
+#include "./replay/irsdk_tape_events.h"
+#include "./replay/irsdk_tape_playback.h"
+#else
+#include <cstdlib>
+#endif
+
 /*
 Nan::SetPrototypeMethod(tmpl, "getSessionData", GetSessionData);
 Nan::SetPrototypeMethod(tmpl, "getSessionVersionNum", GetSessionVersionNum);
@@ -14,7 +23,7 @@ Nan::SetPrototypeMethod(tmpl, "__getTelemetryTypes", __GetTelemetryTypes);
 // ---------------------------
 Napi::Object iRacingSdkNode::Init(Napi::Env env, Napi::Object exports)
 {
-  Napi::Function func = DefineClass(env, "iRacingSdkNode", {
+  std::vector<Napi::ClassPropertyDescriptor<iRacingSdkNode>> properties = {
     // Properties
     // Runtime-pointer overloads, not the templated forms which ICE on MSVC/VS 2026.
     InstanceAccessor("currDataVersion", &iRacingSdkNode::GetCurrSessionDataVersion, nullptr),
@@ -24,16 +33,45 @@ Napi::Object iRacingSdkNode::Init(Napi::Env env, Napi::Object exports)
     InstanceMethod("startSDK", &iRacingSdkNode::StartSdk),
     InstanceMethod("stopSDK", &iRacingSdkNode::StopSdk),
     InstanceMethod("waitForData", &iRacingSdkNode::WaitForData),
+    InstanceMethod("getWaitStats", &iRacingSdkNode::GetWaitStats),
     InstanceMethod("broadcast", &iRacingSdkNode::BroadcastMessage),
     // Getters
     InstanceMethod("isRunning", &iRacingSdkNode::IsRunning),
+    InstanceMethod("getConnectionState", &iRacingSdkNode::GetConnectionState),
     InstanceMethod("getSessionVersionNum", &iRacingSdkNode::GetSessionVersionNum),
     InstanceMethod("getSessionData", &iRacingSdkNode::GetSessionData),
     InstanceMethod("getTelemetryData", &iRacingSdkNode::GetTelemetryData),
+    InstanceMethod("getTelemetrySchema", &iRacingSdkNode::GetTelemetrySchema),
+    InstanceMethod("getTelemetryValues", &iRacingSdkNode::GetTelemetryValues),
+    InstanceMethod("getTelemetryView", &iRacingSdkNode::GetTelemetryView),
+    InstanceMethod("encodeTelemetryWire", &iRacingSdkNode::EncodeTelemetryWire),
     InstanceMethod("getTelemetryVariable", &iRacingSdkNode::GetTelemetryVar),
+    InstanceMethod("setTelemetrySubscription", &iRacingSdkNode::SetTelemetrySubscription),
+    InstanceMethod("setTelemetryWireChannels", &iRacingSdkNode::SetTelemetryWireChannels),
     // Helpers
     InstanceMethod("__getTelemetryTypes", &iRacingSdkNode::__GetTelemetryTypes)
-  });
+  };
+#ifdef IRDASHIES_TELEMETRY_TAPE
+  // Tape playback controls only exist on the tape-backed addon.
+  properties.push_back(InstanceMethod("setTelemetryPaused", &iRacingSdkNode::SetTelemetryPaused));
+  properties.push_back(InstanceMethod("stepTelemetry", &iRacingSdkNode::StepTelemetry));
+  properties.push_back(InstanceMethod("seekTelemetry", &iRacingSdkNode::SeekTelemetry));
+  properties.push_back(InstanceMethod("getTelemetryEvents", &iRacingSdkNode::GetTelemetryEvents));
+  properties.push_back(InstanceMethod("seekTelemetryEvent", &iRacingSdkNode::SeekTelemetryEvent));
+  properties.push_back(InstanceMethod("getPlaybackStats", &iRacingSdkNode::GetPlaybackStats));
+#else
+  // Recording what waitForData copies only makes sense against a live sim.
+  properties.push_back(InstanceMethod("startTelemetryTee", &iRacingSdkNode::StartTelemetryTee));
+  properties.push_back(InstanceMethod("stopTelemetryTee", &iRacingSdkNode::StopTelemetryTee));
+  properties.push_back(InstanceMethod("getTelemetryTeeStats", &iRacingSdkNode::GetTelemetryTeeStats));
+  properties.push_back(InstanceMethod("startFlightRecorder", &iRacingSdkNode::StartFlightRecorder));
+  properties.push_back(InstanceMethod("stopFlightRecorder", &iRacingSdkNode::StopFlightRecorder));
+  properties.push_back(InstanceMethod("dumpFlightRecorder", &iRacingSdkNode::DumpFlightRecorder));
+  properties.push_back(InstanceMethod("getFlightRecorderStats", &iRacingSdkNode::GetFlightRecorderStats));
+  properties.push_back(InstanceMethod("setTelemetryReadAttempts", &iRacingSdkNode::SetTelemetryReadAttempts));
+  properties.push_back(InstanceMethod("getTelemetryReadStats", &iRacingSdkNode::GetTelemetryReadStats));
+#endif
+  Napi::Function func = DefineClass(env, "iRacingSdkNode", properties);
 
   Napi::FunctionReference* constructor = new Napi::FunctionReference();
   *constructor = Napi::Persistent(func);
@@ -43,6 +81,15 @@ Napi::Object iRacingSdkNode::Init(Napi::Env env, Napi::Object exports)
   return exports;
 }
 
+#ifndef IRDASHIES_TELEMETRY_TAPE
+// Node does not always finalize wrapped objects at exit, so the tee's tape is
+// also finished from an environment cleanup hook.
+static void StopTeeAtExit(void *tee)
+{
+  static_cast<irdashies::irsdk_replay::TapeTee *>(tee)->stop();
+}
+#endif
+
 iRacingSdkNode::iRacingSdkNode(const Napi::CallbackInfo &info)
   : Napi::ObjectWrap<iRacingSdkNode>(info)
   , _loggingEnabled(false)
@@ -51,8 +98,42 @@ iRacingSdkNode::iRacingSdkNode(const Napi::CallbackInfo &info)
   , _sessionStatusID(0)
   , _lastSessionCt(-1)
   , _sessionData(NULL)
+  , _lastWait(irsdk_waitDisconnected)
+  , _waitResults{}
+  , _framesDelivered(0)
+  , _subscribed(false)
+  , _subscriptionStatusID(-1)
+  , _sparseReads(false)
+  , _schemaBytes(0)
+  , _schemaVersion(0)
+  , _schemaDirty(true)
+  , _schemaStatusID(-1)
+  , _viewState(NULL)
+  , _viewValues(NULL)
+  , _viewVersion(-1)
+  , _wireAll(true)
+  , _wireDirty(true)
+  , _wireSchemaVersion(-1)
+  , _wireVersion(0)
 {
   printf("Initializing cpp class instance...\n");
+#ifndef IRDASHIES_TELEMETRY_TAPE
+  napi_add_env_cleanup_hook(info.Env(), StopTeeAtExit, &this->_tee);
+  const char* teeDirectory = std::getenv("IRDASHIES_TELEMETRY_TEE");
+  if (teeDirectory != NULL && teeDirectory[0] != '\0') {
+    std::string error;
+    if (!this->_tee.start(std::filesystem::u8path(teeDirectory), error)) {
+      printf("Could not start telemetry tee: %s\n", error.c_str());
+    }
+  }
+#endif
+}
+
+iRacingSdkNode::~iRacingSdkNode()
+{
+#ifndef IRDASHIES_TELEMETRY_TAPE
+  napi_remove_env_cleanup_hook(this->Env(), StopTeeAtExit, &this->_tee);
+#endif
 }
 
 // ---------------------------
@@ -99,6 +180,7 @@ Napi::Value iRacingSdkNode::StartSdk(const Napi::CallbackInfo &info)
 
 Napi::Value iRacingSdkNode::StopSdk(const Napi::CallbackInfo &info)
 {
+  this->RetireView();
   irsdk_shutdown();
   return Napi::Boolean::New(info.Env(), true);
 }
@@ -115,54 +197,69 @@ Napi::Value iRacingSdkNode::WaitForData(const Napi::CallbackInfo &info)
   }
 
   if (!irsdk_isConnected() && !irsdk_startup()) {
+    this->_lastWait = irsdk_waitDisconnected;
+    this->_waitResults[irsdk_waitDisconnected]++;
     return Napi::Boolean::New(info.Env(), false);
   }
 
   const irsdk_header* header = irsdk_getHeader();
+  this->ApplySubscription(header);
 
-  // Allocate buffer before waiting (so waitForDataReady can populate it)
-  if (header && !this->_data) {
-    if (this->_loggingEnabled) printf("Initial buffer allocation\n");
-    this->_data = new char[header->bufLen];
-    this->_bufLineLen = header->bufLen;
-  }
-
-  // Wait for start of session or new data (buffer will be populated here)
-  bool dataReady = irsdk_waitForDataReady(timeout, this->_data);
-  if (dataReady && header)
+  // Wait on the header alone, so the buffer can be sized for the new tick
+  // before the one copy out of shared memory
+  const irsdk_waitResult waitResult = irsdk_waitForNewTick(timeout);
+  this->_lastWait = waitResult;
+  this->_waitResults[waitResult]++;
+  header = irsdk_getHeader();
+  if (waitResult == irsdk_waitNewData && header)
   {
     if (this->_loggingEnabled) printf("Got data from iRacing SDK\n");
 
+    if (!this->_data)
+    {
+      if (this->_loggingEnabled) printf("Initial buffer allocation\n");
+      this->_bufLineLen = header->bufLen;
+      // Zero-filled, since a subscription only copies its own ranges
+      this->_data = new char[this->_bufLineLen]();
+
+      // Increment connection counter, since a reconnect may lay the same
+      // buffer length out differently
+      this->_sessionStatusID++;
+      this->_lastSessionCt = -1;
+      this->ApplySubscription(header);
+    }
     // Check if data changed length (need to reallocate)
-    if (this->_bufLineLen != header->bufLen)
+    else if (this->_bufLineLen != header->bufLen)
     {
       if (this->_loggingEnabled) printf("Data changed length, reallocating\n");
 
       // Reallocate buffer for new size
-      if (this->_data) delete[] this->_data;
+      delete[] this->_data;
       this->_bufLineLen = header->bufLen;
-      this->_data = new char[this->_bufLineLen];
+      this->_data = new char[this->_bufLineLen]();
 
       // Increment connection counter
       this->_sessionStatusID++;
       this->_lastSessionCt = -1;
-
-      // Fetch data into the newly allocated buffer
-      if (irsdk_getNewData(this->_data))
-      {
-        if (this->_loggingEnabled) printf("New data retrieved after reallocation\n");
-        return Napi::Boolean::New(info.Env(), true);
-      }
+      this->ApplySubscription(header);
     }
-    else if (this->_data)
+
+    if (irsdk_getNewData(this->_data))
     {
       if (this->_loggingEnabled) printf("Data ready for processing\n");
+      this->_framesDelivered++;
+      this->CaptureFrame(header);
+      this->WriteView();
       return Napi::Boolean::New(info.Env(), true);
     }
   }
   else if (!irsdk_isConnected())
   {
     if (this->_loggingEnabled) printf("Session ended. Cleaning up.\n");
+#ifndef IRDASHIES_TELEMETRY_TAPE
+    this->_tee.disconnect();
+    this->_flightRecorder.disconnect();
+#endif
 
     // Session ended
     if (this->_data) delete[] this->_data;
@@ -176,6 +273,30 @@ Napi::Value iRacingSdkNode::WaitForData(const Napi::CallbackInfo &info)
   return Napi::Boolean::New(info.Env(), false);
 }
 
+static const char *WaitResultName(irsdk_waitResult result)
+{
+  switch (result)
+  {
+  case irsdk_waitNewData: return "data";
+  case irsdk_waitSignaled: return "signaled";
+  case irsdk_waitTimeout: return "timeout";
+  case irsdk_waitDisconnected: return "disconnected";
+  }
+  return "disconnected";
+}
+
+Napi::Value iRacingSdkNode::GetWaitStats(const Napi::CallbackInfo &info)
+{
+  Napi::Object result = Napi::Object::New(info.Env());
+  result.Set("last", Napi::String::New(info.Env(), WaitResultName(this->_lastWait)));
+  result.Set("data", Napi::Number::New(info.Env(), static_cast<double>(this->_waitResults[irsdk_waitNewData])));
+  result.Set("signaled", Napi::Number::New(info.Env(), static_cast<double>(this->_waitResults[irsdk_waitSignaled])));
+  result.Set("timeouts", Napi::Number::New(info.Env(), static_cast<double>(this->_waitResults[irsdk_waitTimeout])));
+  result.Set("disconnects", Napi::Number::New(info.Env(), static_cast<double>(this->_waitResults[irsdk_waitDisconnected])));
+  result.Set("frames", Napi::Number::New(info.Env(), static_cast<double>(this->_framesDelivered)));
+  return result;
+}
+
 Napi::Value iRacingSdkNode::BroadcastMessage(const Napi::CallbackInfo &info)
 {
   auto env = info.Env();
@@ -260,6 +381,438 @@ Napi::Value iRacingSdkNode::BroadcastMessage(const Napi::CallbackInfo &info)
   return Napi::Boolean::New(env, true);
 }
 
+#ifdef IRDASHIES_TELEMETRY_TAPE
+// Tape playback controls
+Napi::Value iRacingSdkNode::SetTelemetryPaused(const Napi::CallbackInfo &info)
+{
+  if (info.Length() <= 0 || !info[0].IsBoolean()) {
+    return Napi::Boolean::New(info.Env(), false);
+  }
+
+  std::string error;
+  bool result = irdashies::irsdk_replay::setPlaybackPaused(info[0].As<Napi::Boolean>().Value(), error);
+  if (!result) printf("Could not pause telemetry tape: %s\n", error.c_str());
+  return Napi::Boolean::New(info.Env(), result);
+}
+
+Napi::Value iRacingSdkNode::StepTelemetry(const Napi::CallbackInfo &info)
+{
+  if (info.Length() <= 0 || !info[0].IsNumber()) {
+    return Napi::Boolean::New(info.Env(), false);
+  }
+
+  std::string error;
+  bool result = irdashies::irsdk_replay::stepPlayback(info[0].As<Napi::Number>().Int32Value(), error);
+  if (!result) printf("Could not step telemetry tape: %s\n", error.c_str());
+  return Napi::Boolean::New(info.Env(), result);
+}
+
+Napi::Value iRacingSdkNode::SeekTelemetry(const Napi::CallbackInfo &info)
+{
+  if (info.Length() <= 0 || !info[0].IsNumber()) {
+    return Napi::Boolean::New(info.Env(), false);
+  }
+
+  std::string error;
+  bool result = irdashies::irsdk_replay::seekPlayback(info[0].As<Napi::Number>().DoubleValue(), error);
+  if (!result) printf("Could not seek telemetry tape: %s\n", error.c_str());
+  return Napi::Boolean::New(info.Env(), result);
+}
+
+Napi::Value iRacingSdkNode::GetTelemetryEvents(const Napi::CallbackInfo &info)
+{
+  std::vector<irdashies::irsdk_replay::PlaybackEvent> events;
+  std::string error;
+  if (!irdashies::irsdk_replay::playbackEvents(events, error)) {
+    printf("Could not read telemetry events: %s\n", error.c_str());
+    return Napi::Array::New(info.Env());
+  }
+
+  Napi::Array result = Napi::Array::New(info.Env(), events.size());
+  for (size_t i = 0; i < events.size(); i++) {
+    Napi::Object event = Napi::Object::New(info.Env());
+    event.Set("kind", Napi::String::New(info.Env(), irdashies::irsdk_replay::tapeEventKindName(events[i].kind)));
+    event.Set("value", Napi::Number::New(info.Env(), events[i].value));
+    event.Set("seconds", Napi::Number::New(info.Env(), events[i].seconds));
+    event.Set("sourceTick", Napi::Number::New(info.Env(), events[i].sourceTick));
+    result.Set(static_cast<uint32_t>(i), event);
+  }
+  return result;
+}
+
+Napi::Value iRacingSdkNode::SeekTelemetryEvent(const Napi::CallbackInfo &info)
+{
+  irdashies::irsdk_replay::TapeEventKind kind;
+  if (info.Length() <= 1 || !info[0].IsString() || !info[1].IsNumber() ||
+      !irdashies::irsdk_replay::parseTapeEventKind(info[0].As<Napi::String>().Utf8Value(), kind)) {
+    return Napi::Boolean::New(info.Env(), false);
+  }
+
+  std::string error;
+  bool result = irdashies::irsdk_replay::seekPlaybackEvent(kind, info[1].As<Napi::Number>().Int32Value(), error);
+  if (!result) printf("Could not seek telemetry tape: %s\n", error.c_str());
+  return Napi::Boolean::New(info.Env(), result);
+}
+
+static Napi::Object latencySummaryToObject(Napi::Env env, const irdashies::irsdk_replay::LatencySummary &summary)
+{
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("count", Napi::Number::New(env, static_cast<double>(summary.count)));
+  result.Set("minMs", Napi::Number::New(env, summary.minNs / 1e6));
+  result.Set("meanMs", Napi::Number::New(env, summary.meanNs / 1e6));
+  result.Set("p50Ms", Napi::Number::New(env, summary.p50Ns / 1e6));
+  result.Set("p90Ms", Napi::Number::New(env, summary.p90Ns / 1e6));
+  result.Set("p99Ms", Napi::Number::New(env, summary.p99Ns / 1e6));
+  result.Set("p999Ms", Napi::Number::New(env, summary.p999Ns / 1e6));
+  result.Set("maxMs", Napi::Number::New(env, summary.maxNs / 1e6));
+  return result;
+}
+
+Napi::Value iRacingSdkNode::GetPlaybackStats(const Napi::CallbackInfo &info)
+{
+  const auto stats = irdashies::irsdk_replay::playbackStats();
+  Napi::Object result = Napi::Object::New(info.Env());
+  result.Set("lateness", latencySummaryToObject(info.Env(), stats.lateness));
+  result.Set("frameInterval", latencySummaryToObject(info.Env(), stats.frameInterval));
+  return result;
+}
+#else
+// Live tee
+Napi::Value iRacingSdkNode::StartTelemetryTee(const Napi::CallbackInfo &info)
+{
+  if (info.Length() <= 0 || !info[0].IsString()) {
+    return Napi::Boolean::New(info.Env(), false);
+  }
+
+  std::string error;
+  bool result = this->_tee.start(std::filesystem::u8path(info[0].As<Napi::String>().Utf8Value()), error);
+  if (!result) printf("Could not start telemetry tee: %s\n", error.c_str());
+  return Napi::Boolean::New(info.Env(), result);
+}
+
+Napi::Value iRacingSdkNode::StopTelemetryTee(const Napi::CallbackInfo &info)
+{
+  bool wasRunning = this->_tee.running();
+  this->_tee.stop();
+  return Napi::Boolean::New(info.Env(), wasRunning);
+}
+
+Napi::Value iRacingSdkNode::GetTelemetryTeeStats(const Napi::CallbackInfo &info)
+{
+  const auto stats = this->_tee.stats();
+  Napi::Object result = Napi::Object::New(info.Env());
+  result.Set("recording", Napi::Boolean::New(info.Env(), this->_tee.running()));
+  result.Set("path", Napi::String::New(info.Env(), stats.path));
+  result.Set("tapes", Napi::Number::New(info.Env(), static_cast<double>(stats.tapes)));
+  result.Set("frames", Napi::Number::New(info.Env(), static_cast<double>(stats.frames)));
+  result.Set("droppedFrames", Napi::Number::New(info.Env(), static_cast<double>(stats.droppedFrames)));
+  result.Set("error", Napi::String::New(info.Env(), stats.error));
+  return result;
+}
+
+// Flight recorder
+Napi::Value iRacingSdkNode::StartFlightRecorder(const Napi::CallbackInfo &info)
+{
+  double seconds = irdashies::irsdk_replay::kDefaultFlightRecorderSeconds;
+  double megabytes = irdashies::irsdk_replay::kDefaultFlightRecorderBytes / (1024.0 * 1024.0);
+  if (info.Length() > 0 && info[0].IsNumber()) seconds = info[0].As<Napi::Number>().DoubleValue();
+  if (info.Length() > 1 && info[1].IsNumber()) megabytes = info[1].As<Napi::Number>().DoubleValue();
+  if (!(seconds > 0) || !(megabytes > 0) || megabytes > 4096) {
+    return Napi::Boolean::New(info.Env(), false);
+  }
+
+  this->_flightRecorder.configure(seconds, static_cast<size_t>(megabytes * 1024 * 1024));
+  return Napi::Boolean::New(info.Env(), true);
+}
+
+Napi::Value iRacingSdkNode::StopFlightRecorder(const Napi::CallbackInfo &info)
+{
+  bool wasRunning = this->_flightRecorder.running();
+  this->_flightRecorder.stop();
+  return Napi::Boolean::New(info.Env(), wasRunning);
+}
+
+// Writes a flight recorder window on the libuv thread pool, so a dump never
+// holds up waitForData.
+class FlightRecorderDump : public Napi::AsyncWorker
+{
+public:
+  FlightRecorderDump(Napi::Env env, irdashies::irsdk_replay::FlightRecorderWindow window, std::string path)
+    : Napi::AsyncWorker(env)
+    , _deferred(Napi::Promise::Deferred::New(env))
+    , _window(std::move(window))
+    , _path(std::move(path))
+    , _frames(0)
+  {
+  }
+
+  Napi::Promise Promise() const { return _deferred.Promise(); }
+
+protected:
+  void Execute() override
+  {
+    std::string error;
+    if (!_window.write(std::filesystem::u8path(_path), _frames, error)) SetError(error);
+  }
+
+  void OnOK() override
+  {
+    Napi::Object result = Napi::Object::New(Env());
+    result.Set("path", Napi::String::New(Env(), _path));
+    result.Set("frames", Napi::Number::New(Env(), static_cast<double>(_frames)));
+    _deferred.Resolve(result);
+  }
+
+  void OnError(const Napi::Error &error) override
+  {
+    _deferred.Reject(error.Value());
+  }
+
+private:
+  Napi::Promise::Deferred _deferred;
+  irdashies::irsdk_replay::FlightRecorderWindow _window;
+  std::string _path;
+  uint64_t _frames;
+};
+
+Napi::Value iRacingSdkNode::DumpFlightRecorder(const Napi::CallbackInfo &info)
+{
+  auto env = info.Env();
+  if (info.Length() <= 0 || !info[0].IsString()) {
+    auto deferred = Napi::Promise::Deferred::New(env);
+    deferred.Reject(Napi::Error::New(env, "dumpFlightRecorder needs an output path").Value());
+    return deferred.Promise();
+  }
+
+  auto *dump = new FlightRecorderDump(env, this->_flightRecorder.snapshot(), info[0].As<Napi::String>().Utf8Value());
+  auto promise = dump->Promise();
+  dump->Queue();
+  return promise;
+}
+
+Napi::Value iRacingSdkNode::GetFlightRecorderStats(const Napi::CallbackInfo &info)
+{
+  const auto stats = this->_flightRecorder.stats();
+  Napi::Object result = Napi::Object::New(info.Env());
+  result.Set("recording", Napi::Boolean::New(info.Env(), this->_flightRecorder.running()));
+  result.Set("frames", Napi::Number::New(info.Env(), static_cast<double>(stats.frames)));
+  result.Set("seconds", Napi::Number::New(info.Env(), stats.seconds));
+  result.Set("bytes", Napi::Number::New(info.Env(), static_cast<double>(stats.bytes)));
+  result.Set("budgetBytes", Napi::Number::New(info.Env(), static_cast<double>(stats.budgetBytes)));
+  return result;
+}
+
+// Shared-memory reads
+Napi::Value iRacingSdkNode::SetTelemetryReadAttempts(const Napi::CallbackInfo &info)
+{
+  if (info.Length() <= 0 || !info[0].IsNumber()) {
+    return Napi::Boolean::New(info.Env(), false);
+  }
+
+  const int attempts = info[0].As<Napi::Number>().Int32Value();
+  if (attempts < 1 || attempts > IRSDK_MAX_READ_ATTEMPTS) {
+    return Napi::Boolean::New(info.Env(), false);
+  }
+  irsdk_setReadAttempts(attempts);
+  return Napi::Boolean::New(info.Env(), true);
+}
+
+Napi::Value iRacingSdkNode::GetTelemetryReadStats(const Napi::CallbackInfo &info)
+{
+  irsdk_readStats stats;
+  irsdk_getReadStats(&stats);
+  Napi::Object result = Napi::Object::New(info.Env());
+  result.Set("attempts", Napi::Number::New(info.Env(), irsdk_getReadAttempts()));
+  result.Set("reads", Napi::Number::New(info.Env(), static_cast<double>(stats.reads)));
+  result.Set("tornReads", Napi::Number::New(info.Env(), static_cast<double>(stats.tornReads)));
+  result.Set("retries", Napi::Number::New(info.Env(), static_cast<double>(stats.retries)));
+  result.Set("fallbacks", Napi::Number::New(info.Env(), static_cast<double>(stats.fallbacks)));
+  result.Set("staleReads", Napi::Number::New(info.Env(), static_cast<double>(stats.staleReads)));
+  result.Set("failedReads", Napi::Number::New(info.Env(), static_cast<double>(stats.failedReads)));
+  return result;
+}
+#endif
+
+// Hands the frame waitForData just copied to the tee and the flight
+// recorder, when either is running.
+void iRacingSdkNode::CaptureFrame(const irsdk_header* header)
+{
+#ifndef IRDASHIES_TELEMETRY_TAPE
+  if (!this->_tee.running() && !this->_flightRecorder.running()) return;
+  const irsdk_varHeader* variables = irsdk_getVarHeaderPtr();
+  const char* sessionInfo = irsdk_getSessionInfoStr();
+  const int tick = irsdk_getLastTickCount();
+  this->_tee.frame(*header, variables, sessionInfo, this->_data, tick);
+  this->_flightRecorder.frame(*header, variables, sessionInfo, this->_data, tick);
+#else
+  (void)header;
+#endif
+}
+
+// Subscription
+// Variables closer together than this are copied as one range: a few extra
+// bytes cost less than another memcpy, and they usually share a cache line.
+static const int kReadRangeMergeGap = 64;
+
+// Sorted byte ranges covering the given variables, merged until they fit in
+// IRSDK_MAX_READ_RANGES.
+static std::vector<irsdk_bufRange> CoalesceVarRanges(const std::vector<int> &vars)
+{
+  std::vector<irsdk_bufRange> spans;
+  for (int index : vars) {
+    const irsdk_varHeader *var = irsdk_getVarHeaderEntry(index);
+    spans.push_back({var->offset, var->count * irsdk_VarTypeBytes[var->type]});
+  }
+  std::sort(spans.begin(), spans.end(), [](const irsdk_bufRange &a, const irsdk_bufRange &b) {
+    return a.offset < b.offset;
+  });
+
+  std::vector<irsdk_bufRange> ranges;
+  for (long long gap = kReadRangeMergeGap;; gap *= 2) {
+    ranges.clear();
+    for (const auto &span : spans) {
+      if (!ranges.empty()) {
+        irsdk_bufRange &last = ranges.back();
+        const long long end = (long long)last.offset + last.len;
+        if (span.offset <= end + gap) {
+          last.len = (int)(std::max(end, (long long)span.offset + span.len) - last.offset);
+          continue;
+        }
+      }
+      ranges.push_back(span);
+    }
+    if (ranges.size() <= (size_t)IRSDK_MAX_READ_RANGES) return ranges;
+  }
+}
+
+// A header from shared memory is not trusted to stay inside the buffer.
+static bool VarFitsBuffer(const irsdk_varHeader *var, int bufLen)
+{
+  return var->type >= 0 && var->type < irsdk_ETCount && var->count > 0 && var->offset >= 0 &&
+    (long long)var->offset + (long long)var->count * irsdk_VarTypeBytes[var->type] <= bufLen;
+}
+
+// Resolves the subscription against the current layout, and limits what
+// waitForData copies to the subscribed variables. The tee and the flight
+// recorder record whole frames, so while either runs every byte is copied.
+void iRacingSdkNode::ApplySubscription(const irsdk_header* header)
+{
+  if (this->_subscribed && header && this->_subscriptionStatusID != this->_sessionStatusID)
+  {
+    this->_subscribedVars.clear();
+    this->_subscribedMask.assign(header->numVars > 0 ? header->numVars : 0, 0);
+    for (const auto &name : this->_subscription) {
+      const int index = irsdk_varNameToIndex(name.c_str());
+      const irsdk_varHeader *var = irsdk_getVarHeaderEntry(index);
+      // Unknown names are skipped; not every car publishes every variable.
+      if (var == nullptr || this->_subscribedMask[index] || !VarFitsBuffer(var, header->bufLen)) continue;
+      this->_subscribedMask[index] = 1;
+      this->_subscribedVars.push_back(index);
+    }
+    this->_readRanges = CoalesceVarRanges(this->_subscribedVars);
+    this->_subscriptionStatusID = this->_sessionStatusID;
+
+    if (this->_loggingEnabled) {
+      printf("Subscribed to %zu variables in %zu ranges\n", this->_subscribedVars.size(), this->_readRanges.size());
+    }
+#ifndef IRDASHIES_TELEMETRY_TAPE
+    if (this->_sparseReads) irsdk_setReadRanges(NULL, 0);
+    this->_sparseReads = false;
+#endif
+  }
+
+#ifndef IRDASHIES_TELEMETRY_TAPE
+  const bool sparse = this->_subscribed && !this->_readRanges.empty() &&
+    !this->_tee.running() && !this->_flightRecorder.running();
+  if (sparse != this->_sparseReads) {
+    if (sparse) {
+      this->_sparseReads = irsdk_setReadRanges(this->_readRanges.data(), (int)this->_readRanges.size());
+    } else {
+      irsdk_setReadRanges(NULL, 0);
+      this->_sparseReads = false;
+    }
+  }
+#endif
+}
+
+Napi::Value iRacingSdkNode::SetTelemetrySubscription(const Napi::CallbackInfo &info)
+{
+  std::vector<std::string> names;
+  const bool subscribe = info.Length() > 0 && info[0].IsArray();
+  if (subscribe) {
+    Napi::Array list = info[0].As<Napi::Array>();
+    for (uint32_t i = 0; i < list.Length(); i++) {
+      Napi::Value name = list.Get(i);
+      if (!name.IsString()) return Napi::Boolean::New(info.Env(), false);
+      names.push_back(name.As<Napi::String>().Utf8Value());
+    }
+  } else if (info.Length() > 0 && !info[0].IsNull() && !info[0].IsUndefined()) {
+    return Napi::Boolean::New(info.Env(), false);
+  }
+
+  this->_subscribed = subscribe;
+  this->_subscription = std::move(names);
+  this->_subscribedVars.clear();
+  this->_subscribedMask.clear();
+  this->_readRanges.clear();
+  this->_subscriptionStatusID = -1;
+  this->_schemaDirty = true;
+  this->ApplySubscription(irsdk_getHeader());
+  return Napi::Boolean::New(info.Env(), true);
+}
+
+// Unlike a subscription this leaves what waitForData copies alone; it only
+// picks what encodeTelemetryWire() sends. Names outside the subscription are
+// left out.
+Napi::Value iRacingSdkNode::SetTelemetryWireChannels(const Napi::CallbackInfo &info)
+{
+  std::vector<std::string> names;
+  const bool all = info.Length() <= 0 || info[0].IsNull() || info[0].IsUndefined();
+  if (!all) {
+    if (!info[0].IsArray()) return Napi::Boolean::New(info.Env(), false);
+    Napi::Array list = info[0].As<Napi::Array>();
+    for (uint32_t i = 0; i < list.Length(); i++) {
+      Napi::Value name = list.Get(i);
+      if (!name.IsString()) return Napi::Boolean::New(info.Env(), false);
+      names.push_back(name.As<Napi::String>().Utf8Value());
+    }
+  }
+
+  this->_wireAll = all;
+  this->_wireNames = std::move(names);
+  this->_wireDirty = true;
+  return Napi::Boolean::New(info.Env(), true);
+}
+
+// Lays the reported variables out back to back, each at a multiple of its
+// type size. The layout is resolved once per _sessionStatusID and again after
+// a subscription change, and each resolve bumps the schema version.
+void iRacingSdkNode::ResolveSchema(const irsdk_header* header)
+{
+  if (header == nullptr) return;
+  this->ApplySubscription(header);
+  if (!this->_schemaDirty && this->_schemaStatusID == this->_sessionStatusID) {
+    return;
+  }
+
+  this->_schema.clear();
+  int offset = 0;
+  const int count = this->_subscribed ? (int)this->_subscribedVars.size() : header->numVars;
+  for (int i = 0; i < count; i++) {
+    const int index = this->_subscribed ? this->_subscribedVars[i] : i;
+    const irsdk_varHeader *var = irsdk_getVarHeaderEntry(index);
+    if (var == nullptr || !VarFitsBuffer(var, header->bufLen)) continue;
+    const int size = irsdk_VarTypeBytes[var->type];
+    offset = (offset + size - 1) / size * size;
+    this->_schema.push_back({index, var->offset, offset, var->count * size});
+    offset += var->count * size;
+  }
+  this->_schemaBytes = offset;
+  this->_schemaStatusID = this->_sessionStatusID;
+  this->_schemaDirty = false;
+  this->_schemaVersion++;
+}
+
 // SDK State Getters
 Napi::Value iRacingSdkNode::IsRunning(const Napi::CallbackInfo &info)
 {
@@ -267,6 +820,18 @@ Napi::Value iRacingSdkNode::IsRunning(const Napi::CallbackInfo &info)
   return Napi::Boolean::New(info.Env(), result);
 }
 
+Napi::Value iRacingSdkNode::GetConnectionState(const Napi::CallbackInfo &info)
+{
+  const char *name = "disconnected";
+  switch (irsdk_getConnectionState())
+  {
+  case irsdk_connConnected: name = "connected"; break;
+  case irsdk_connStale: name = "stale"; break;
+  case irsdk_connDisconnected: break;
+  }
+  return Napi::String::New(info.Env(), name);
+}
+
 Napi::Value iRacingSdkNode::GetSessionVersionNum(const Napi::CallbackInfo &info)
 {
   int sessVer = irsdk_getSessionInfoStrUpdate();
@@ -475,9 +1040,9 @@ Napi::Value iRacingSdkNode::GetTelemetryData(const Napi::CallbackInfo &info)
     return telemVars;
   }
 
-  int count = header->numVars;
+  int count = this->_subscribed ? (int)this->_subscribedVars.size() : header->numVars;
   for (int i = 0; i < count; i++) {
-    auto telemVariable = this->GetTelemetryVarByIndex(env, i);
+    auto telemVariable = this->GetTelemetryVarByIndex(env, this->_subscribed ? this->_subscribedVars[i] : i);
     if (telemVariable.IsObject() && telemVariable.Has("name")) {
       telemVars.Set(telemVariable.Get("name"), telemVariable);
     }
@@ -486,6 +1051,173 @@ Napi::Value iRacingSdkNode::GetTelemetryData(const Napi::CallbackInfo &info)
   return telemVars;
 }
 
+Napi::Value iRacingSdkNode::GetTelemetrySchema(const Napi::CallbackInfo &info)
+{
+  auto env = info.Env();
+  this->ResolveSchema(irsdk_getHeader());
+
+  auto variables = Napi::Array::New(env, this->_schema.size());
+  for (size_t i = 0; i < this->_schema.size(); i++) {
+    const irsdk_varHeader *var = irsdk_getVarHeaderEntry(this->_schema[i].index);
+    auto entry = Napi::Object::New(env);
+    entry.Set("name", var->name);
+    entry.Set("description", var->desc);
+    entry.Set("unit", var->unit);
+    entry.Set("countAsTime", var->countAsTime);
+    entry.Set("length", var->count);
+    entry.Set("varType", var->type);
+    entry.Set("offset", this->_schema[i].offset);
+    variables.Set(static_cast<uint32_t>(i), entry);
+  }
+
+  auto result = Napi::Object::New(env);
+  result.Set("version", this->_schemaVersion);
+  result.Set("variables", variables);
+  return result;
+}
+
+// The values of the schema's variables in one buffer, without the names and
+// descriptions getTelemetryData() sets on every variable of every tick.
+Napi::Value iRacingSdkNode::GetTelemetryValues(const Napi::CallbackInfo &info)
+{
+  auto env = info.Env();
+  const irsdk_header* header = irsdk_getHeader();
+  this->ResolveSchema(header);
+
+  auto result = Napi::Object::New(env);
+  result.Set("version", this->_schemaVersion);
+  if (header == nullptr || this->_data == nullptr || this->_bufLineLen != header->bufLen) {
+    result.Set("data", env.Null());
+    return result;
+  }
+
+  auto data = Napi::ArrayBuffer::New(env, this->_schemaBytes);
+  char *values = static_cast<char *>(data.Data());
+  for (const auto &entry : this->_schema) {
+    memcpy(values + entry.offset, this->_data + entry.source, entry.bytes);
+  }
+  result.Set("data", data);
+  return result;
+}
+
+// One message for IPC, a fraction of the size of getTelemetryData()'s
+// objects: values unchanged since the last message are left out, and the
+// channel names travel only in keyframes. See irsdk_telemetry_wire.h.
+Napi::Value iRacingSdkNode::EncodeTelemetryWire(const Napi::CallbackInfo &info)
+{
+  auto env = info.Env();
+  const irsdk_header* header = irsdk_getHeader();
+  if (header == nullptr || this->_data == nullptr || this->_bufLineLen != header->bufLen) {
+    return env.Null();
+  }
+
+  this->ResolveSchema(header);
+  if (this->_wireDirty || this->_wireSchemaVersion != this->_schemaVersion) {
+    std::vector<irdashies::irsdk_replay::TelemetryWireChannel> channels;
+    for (const auto &entry : this->_schema) {
+      const irsdk_varHeader *var = irsdk_getVarHeaderEntry(entry.index);
+      if (!this->_wireAll &&
+          std::find(this->_wireNames.begin(), this->_wireNames.end(), var->name) == this->_wireNames.end()) {
+        continue;
+      }
+      channels.push_back({var->name, var->type, var->count, entry.source});
+    }
+    this->_wire.setChannels(++this->_wireVersion, std::move(channels));
+    this->_wireSchemaVersion = this->_schemaVersion;
+    this->_wireDirty = false;
+  }
+
+  const bool keyframe = info.Length() > 0 && info[0].IsBoolean() && info[0].As<Napi::Boolean>().Value();
+  this->_wire.encode(this->_data, keyframe, this->_wireMessage);
+  if (this->_wireMessage.empty()) return env.Null();
+  auto message = Napi::ArrayBuffer::New(env, this->_wireMessage.size());
+  memcpy(message.Data(), this->_wireMessage.data(), this->_wireMessage.size());
+  return message;
+}
+
+// Two state words ahead of the values keep every value at its alignment:
+// the frames written, and 1 while waitForData still rewrites the view.
+static const size_t kViewStateBytes = 2 * sizeof(uint32_t);
+
+// One object per schema version. Its properties are set once, in schema
+// order, so the shape never changes while JS reads it.
+Napi::Value iRacingSdkNode::GetTelemetryView(const Napi::CallbackInfo &info)
+{
+  auto env = info.Env();
+  const irsdk_header* header = irsdk_getHeader();
+  if (header == nullptr) return env.Null();
+  this->ResolveSchema(header);
+  if (!this->_view.IsEmpty() && this->_viewVersion == this->_schemaVersion) {
+    return this->_view.Value();
+  }
+  this->RetireView();
+
+  auto buffer = Napi::ArrayBuffer::New(env, kViewStateBytes + this->_schemaBytes);
+  memset(buffer.Data(), 0, buffer.ByteLength());
+  auto values = Napi::Object::New(env);
+  for (const auto &entry : this->_schema) {
+    const irsdk_varHeader *var = irsdk_getVarHeaderEntry(entry.index);
+    const size_t offset = kViewStateBytes + entry.offset;
+    switch (var->type) {
+    case irsdk_int:
+    case irsdk_bitField:
+      values.Set(var->name, Napi::Int32Array::New(env, var->count, buffer, offset));
+      break;
+    case irsdk_float:
+      values.Set(var->name, Napi::Float32Array::New(env, var->count, buffer, offset));
+      break;
+    case irsdk_double:
+      values.Set(var->name, Napi::Float64Array::New(env, var->count, buffer, offset));
+      break;
+    default:
+      values.Set(var->name, Napi::Uint8Array::New(env, var->count, buffer, offset));
+      break;
+    }
+  }
+
+  auto view = Napi::Object::New(env);
+  view.Set("version", this->_schemaVersion);
+  view.Set("state", Napi::Uint32Array::New(env, 2, buffer, 0));
+  view.Set("values", values);
+
+  this->_view = Napi::Persistent(view);
+  this->_viewBuffer = Napi::Persistent(buffer);
+  this->_viewState = static_cast<uint32_t *>(buffer.Data());
+  this->_viewValues = static_cast<char *>(buffer.Data()) + kViewStateBytes;
+  this->_viewVersion = this->_schemaVersion;
+  this->_viewState[1] = 1;
+  this->WriteView();
+  return view;
+}
+
+void iRacingSdkNode::WriteView()
+{
+  if (this->_viewState == NULL || this->_data == NULL) return;
+  const irsdk_header* header = irsdk_getHeader();
+  if (header == nullptr || this->_bufLineLen != header->bufLen) return;
+
+  this->ResolveSchema(header);
+  if (this->_viewVersion != this->_schemaVersion) {
+    this->RetireView();
+    return;
+  }
+  for (const auto &entry : this->_schema) {
+    memcpy(this->_viewValues + entry.offset, this->_data + entry.source, entry.bytes);
+  }
+  this->_viewState[0]++;
+}
+
+// Tells whoever still holds the view to ask for a new one.
+void iRacingSdkNode::RetireView()
+{
+  if (this->_viewState != NULL) this->_viewState[1] = 0;
+  this->_view.Reset();
+  this->_viewBuffer.Reset();
+  this->_viewState = NULL;
+  this->_viewValues = NULL;
+  this->_viewVersion = -1;
+}
+
 // Helpers
 Napi::Value iRacingSdkNode::__GetTelemetryTypes(const Napi::CallbackInfo &info)
 {
@@ -555,6 +1287,13 @@ Napi::Object iRacingSdkNode::GetTelemetryVarByIndex(const Napi::Env env, int ind
     return telemVar;
   }
 
+  // Only the subscribed variables are copied out of shared memory, so the
+  // bytes of any other may be stale.
+  if (this->_subscribed &&
+      (static_cast<size_t>(index) >= this->_subscribedMask.size() || !this->_subscribedMask[index])) {
+    return telemVar;
+  }
+
   // Create entry object
   telemVar.Set("countAsTime", headerVar->countAsTime);
   telemVar.Set("length", headerVar->count);
@@ -2,14 +2,24 @@
 #define IRSDK_NODE_H
 
 #include <napi.h>
+#include <cstdint>
+#include <string>
+#include <vector>
 #include "./lib/irsdk_defines.h"
 #include "./lib/irsdk_client.h"
+#include "./replay/irsdk_telemetry_wire.h"
+
+#ifndef IRDASHIES_TELEMETRY_TAPE
+#include "./replay/irsdk_flight_recorder.h"
+#include "./replay/irsdk_tape_tee.h"
+#endif
 
 class iRacingSdkNode : public Napi::ObjectWrap<iRacingSdkNode>
 {
 public:
     static Napi::Object Init(Napi::Env env, Napi::Object exports);
     iRacingSdkNode(const Napi::CallbackInfo& info);
+    ~iRacingSdkNode();
 
 private:
     // Properties
@@ -22,12 +32,43 @@ private:
     Napi::Value StartSdk(const Napi::CallbackInfo &info);
     Napi::Value StopSdk(const Napi::CallbackInfo &info);
     Napi::Value WaitForData(const Napi::CallbackInfo &info);
+    Napi::Value GetWaitStats(const Napi::CallbackInfo &info);
     Napi::Value BroadcastMessage(const Napi::CallbackInfo &info);
+#ifdef IRDASHIES_TELEMETRY_TAPE
+    // Tape playback
+    Napi::Value SetTelemetryPaused(const Napi::CallbackInfo &info);
+    Napi::Value StepTelemetry(const Napi::CallbackInfo &info);
+    Napi::Value SeekTelemetry(const Napi::CallbackInfo &info);
+    Napi::Value GetTelemetryEvents(const Napi::CallbackInfo &info);
+    Napi::Value SeekTelemetryEvent(const Napi::CallbackInfo &info);
+    Napi::Value GetPlaybackStats(const Napi::CallbackInfo &info);
+#else
+    // Live tee
+    Napi::Value StartTelemetryTee(const Napi::CallbackInfo &info);
+    Napi::Value StopTelemetryTee(const Napi::CallbackInfo &info);
+    Napi::Value GetTelemetryTeeStats(const Napi::CallbackInfo &info);
+    // Flight recorder
+    Napi::Value StartFlightRecorder(const Napi::CallbackInfo &info);
+    Napi::Value StopFlightRecorder(const Napi::CallbackInfo &info);
+    Napi::Value DumpFlightRecorder(const Napi::CallbackInfo &info);
+    Napi::Value GetFlightRecorderStats(const Napi::CallbackInfo &info);
+    // Shared-memory reads
+    Napi::Value SetTelemetryReadAttempts(const Napi::CallbackInfo &info);
+    Napi::Value GetTelemetryReadStats(const Napi::CallbackInfo &info);
+#endif
     // Getters
     Napi::Value IsRunning(const Napi::CallbackInfo &info);
+    Napi::Value GetConnectionState(const Napi::CallbackInfo &info);
     Napi::Value GetSessionVersionNum(const Napi::CallbackInfo &info);
     Napi::Value GetSessionData(const Napi::CallbackInfo &info);
     Napi::Value GetTelemetryData(const Napi::CallbackInfo &info);
+    Napi::Value GetTelemetrySchema(const Napi::CallbackInfo &info);
+    Napi::Value GetTelemetryValues(const Napi::CallbackInfo &info);
+    Napi::Value GetTelemetryView(const Napi::CallbackInfo &info);
+    Napi::Value EncodeTelemetryWire(const Napi::CallbackInfo &info);
+    // Subscription
+    Napi::Value SetTelemetrySubscription(const Napi::CallbackInfo &info);
+    Napi::Value SetTelemetryWireChannels(const Napi::CallbackInfo &info);
     // Helpers
     Napi::Value __GetTelemetryTypes(const Napi::CallbackInfo &info);
     Napi::Value GetTelemetryVar(const Napi::CallbackInfo &info);
@@ -38,6 +79,11 @@ private:
     double GetTelemetryDouble(int entry, int index);
     Napi::Object GetTelemetryVarByIndex(const Napi::Env env, int index);
     Napi::Object GetTelemetryVar(const Napi::Env env, const char *varName);
+    void CaptureFrame(const irsdk_header* header);
+    void ApplySubscription(const irsdk_header* header);
+    void ResolveSchema(const irsdk_header* header);
+    void WriteView();
+    void RetireView();
 
     bool _loggingEnabled;
     char* _data;
@@ -45,6 +91,48 @@ private:
     int _sessionStatusID;
     int _lastSessionCt;
     const char* _sessionData;
+    // Why each waitForData call returned, indexed by irsdk_waitResult
+    irsdk_waitResult _lastWait;
+    uint64_t _waitResults[irsdk_waitDisconnected + 1];
+    uint64_t _framesDelivered;
+    // Variables the app asked for; all of them while _subscribed is false.
+    bool _subscribed;
+    std::vector<std::string> _subscription;
+    // The subscription resolved against the connection it was resolved for.
+    int _subscriptionStatusID;
+    std::vector<int> _subscribedVars;
+    std::vector<char> _subscribedMask;
+    std::vector<irsdk_bufRange> _readRanges;
+    bool _sparseReads;
+    // What getTelemetrySchema() describes and getTelemetryValues() packs:
+    // each variable's index, source offset, packed offset and byte size.
+    struct SchemaEntry { int index; int source; int offset; int bytes; };
+    std::vector<SchemaEntry> _schema;
+    int _schemaBytes;
+    int _schemaVersion;
+    bool _schemaDirty;
+    int _schemaStatusID;
+    // Persistent object from getTelemetryView(), rewritten by each waitForData
+    // while its version matches the schema's. The buffer is referenced on its
+    // own so JS cannot drop it from under the writes.
+    Napi::ObjectReference _view;
+    Napi::Reference<Napi::ArrayBuffer> _viewBuffer;
+    uint32_t* _viewState;
+    char* _viewValues;
+    int _viewVersion;
+    // Channels encodeTelemetryWire() packs, out of the schema's variables;
+    // all of them while _wireAll is true.
+    bool _wireAll;
+    std::vector<std::string> _wireNames;
+    bool _wireDirty;
+    int _wireSchemaVersion;
+    uint32_t _wireVersion;
+    irdashies::irsdk_replay::TelemetryWireEncoder _wire;
+    std::vector<uint8_t> _wireMessage;
+#ifndef IRDASHIES_TELEMETRY_TAPE
+    irdashies::irsdk_replay::TapeTee _tee;
+    irdashies::irsdk_replay::FlightRecorder _flightRecorder;
+#endif
 };
 
 #endif
@@ -0,0 +1,228 @@
+// Reader state shared by both shared-memory backends, see irsdk_buffer_reader.h.
+
+#include <atomic>
+#include <chrono>
+#include <limits.h>
+#include <string.h>
+
+#include "irsdk_buffer_reader.h"
+
+static const char *pSharedMem = NULL;
+static const irsdk_header *pHeader = NULL;
+
+static int lastTickCount = INT_MAX;
+
+// Subscribed parts of the buffer, see irsdk_setReadRanges()
+static irsdk_bufRange readRanges[IRSDK_MAX_READ_RANGES];
+static int readRangeCount = 0;
+static int readRangeEnd = 0;
+
+static int readAttempts = IRSDK_DEFAULT_READ_ATTEMPTS;
+
+// irsdk_getReadStats() may run on another thread than the reads, so the
+// counters are atomics. They are independent tallies, so relaxed is enough.
+struct readCounters
+{
+	std::atomic<unsigned long long> reads{0};
+	std::atomic<unsigned long long> tornReads{0};
+	std::atomic<unsigned long long> retries{0};
+	std::atomic<unsigned long long> fallbacks{0};
+	std::atomic<unsigned long long> staleReads{0};
+	std::atomic<unsigned long long> failedReads{0};
+};
+static readCounters readStats;
+
+static void countRead(std::atomic<unsigned long long> &counter)
+{
+	counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Kept by the header checks in the waits and reads, so irsdk_isConnected()
+// and irsdk_getConnectionState() never read the clock themselves.
+static irsdk_connectionState connectionState = irsdk_connDisconnected;
+static double lastTickTime = 0;
+static const double staleTimeout = 1.0; // seconds without a new tick before a connected sim is stale
+
+static double monotonicSeconds()
+{
+	return std::chrono::duration<double>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void irsdk_attachSharedMem(const char *sharedMem)
+{
+	pSharedMem = sharedMem;
+	pHeader = (const irsdk_header *)sharedMem;
+	lastTickCount = INT_MAX;
+	connectionState = irsdk_connDisconnected;
+}
+
+// Copies one buffer out of shared memory, or only the read ranges of it.
+static void copyDataBuffer(char *data, const char *buffer)
+{
+	if(readRangeCount == 0 || readRangeEnd > pHeader->bufLen)
+	{
+		memcpy(data, buffer, pHeader->bufLen);
+		return;
+	}
+
+	for(int i=0; i<readRangeCount; i++)
+		memcpy(data + readRanges[i].offset, buffer + readRanges[i].offset, readRanges[i].len);
+}
+
+// Copies the newest buffer newer than lastTickCount, checking its tick before
+// and after. A changed tick means the sim rewrote the buffer during the copy.
+// After readAttempts torn copies, falls back to the newest of the remaining
+// buffers, which the sim finished more recently than the one it is writing.
+bool irsdk_copyNewestBuffer(char *data)
+{
+	bool tried[IRSDK_MAX_BUFS] = {};
+	for(int candidate = 0; candidate < pHeader->numBuf; candidate++)
+	{
+		int buf = -1;
+		for(int i=0; i<pHeader->numBuf; i++)
+		{
+			const int tick = pHeader->varBuf[i].tickCount;
+			if(tried[i] || (lastTickCount != INT_MAX && tick <= lastTickCount))
+				continue;
+			if(buf < 0 || pHeader->varBuf[buf].tickCount < tick)
+				buf = i;
+		}
+		if(buf < 0)
+			break;
+		tried[buf] = true;
+
+		for(int attempt = 0; attempt < readAttempts; attempt++)
+		{
+			if(attempt > 0)
+				countRead(readStats.retries);
+
+			const int tickBefore = pHeader->varBuf[buf].tickCount;
+			std::atomic_thread_fence(std::memory_order_acquire);
+			copyDataBuffer(data, pSharedMem + pHeader->varBuf[buf].bufOffset);
+			// x86 keeps these loads in order on its own; weaker memory
+			// models need the fence before re-reading the tick.
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if(tickBefore == pHeader->varBuf[buf].tickCount)
+			{
+				countRead(readStats.reads);
+				if(candidate > 0)
+					countRead(readStats.fallbacks);
+				lastTickCount = tickBefore;
+				return true;
+			}
+			countRead(readStats.tornReads);
+		}
+	}
+
+	countRead(readStats.failedReads);
+	return false;
+}
+
+int irsdk_newestUnseenBuffer()
+{
+	// if sim is not active, then no new data
+	if(!(pHeader->status & irsdk_stConnected))
+	{
+		lastTickCount = INT_MAX;
+		connectionState = irsdk_connDisconnected;
+		return -1;
+	}
+
+	const double now = monotonicSeconds();
+
+	int latest = 0;
+	for(int i=1; i<pHeader->numBuf; i++)
+		if(pHeader->varBuf[latest].tickCount < pHeader->varBuf[i].tickCount)
+		   latest = i;
+
+	// Seed the current buffer on first connection, even when the sim is
+	// paused and will not produce a newer tick until playback resumes.
+	// Subsequent reads still require a genuinely newer tick.
+	if(lastTickCount == INT_MAX || lastTickCount < pHeader->varBuf[latest].tickCount)
+	{
+		lastTickTime = now;
+		connectionState = irsdk_connConnected;
+		return latest;
+	}
+
+	// if older than last recieved, than reset, we probably disconnected
+	if(lastTickCount >  pHeader->varBuf[latest].tickCount)
+		lastTickCount =  pHeader->varBuf[latest].tickCount;
+
+	// A paused replay can keep publishing the same tick indefinitely. The
+	// connected header is still a valid heartbeat, so that is stale rather
+	// than disconnected.
+	if(now - lastTickTime >= staleTimeout)
+		connectionState = irsdk_connStale;
+
+	// else the same, and nothing changed this tick
+	return -1;
+}
+
+void irsdk_markBufferSeen(int buf)
+{
+	lastTickCount = pHeader->varBuf[buf].tickCount;
+}
+
+void irsdk_countStaleRead()
+{
+	countRead(readStats.staleReads);
+}
+
+irsdk_connectionState irsdk_getConnectionState()
+{
+	return pHeader ? connectionState : irsdk_connDisconnected;
+}
+
+int irsdk_getLastTickCount()
+{
+	return lastTickCount == INT_MAX ? -1 : lastTickCount;
+}
+
+bool irsdk_setReadRanges(const irsdk_bufRange *ranges, int count)
+{
+	if(count < 0 || count > IRSDK_MAX_READ_RANGES || (count > 0 && !ranges))
+		return false;
+
+	int end = 0;
+	for(int i=0; i<count; i++)
+	{
+		if(ranges[i].offset < end || ranges[i].len <= 0 || ranges[i].len > INT_MAX - ranges[i].offset)
+			return false;
+		end = ranges[i].offset + ranges[i].len;
+	}
+
+	for(int i=0; i<count; i++)
+		readRanges[i] = ranges[i];
+	readRangeCount = count;
+	readRangeEnd = end;
+	return true;
+}
+
+void irsdk_setReadAttempts(int attempts)
+{
+	if(attempts < 1)
+		attempts = 1;
+	if(attempts > IRSDK_MAX_READ_ATTEMPTS)
+		attempts = IRSDK_MAX_READ_ATTEMPTS;
+	readAttempts = attempts;
+}
+
+int irsdk_getReadAttempts()
+{
+	return readAttempts;
+}
+
+void irsdk_getReadStats(irsdk_readStats *stats)
+{
+	if(!stats)
+		return;
+
+	stats->reads = readStats.reads.load(std::memory_order_relaxed);
+	stats->tornReads = readStats.tornReads.load(std::memory_order_relaxed);
+	stats->retries = readStats.retries.load(std::memory_order_relaxed);
+	stats->fallbacks = readStats.fallbacks.load(std::memory_order_relaxed);
+	stats->staleReads = readStats.staleReads.load(std::memory_order_relaxed);
+	stats->failedReads = readStats.failedReads.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,31 @@
+#ifndef IRSDK_BUFFER_READER_H
+#define IRSDK_BUFFER_READER_H
+
+// Buffer selection and torn-read-safe copying shared by the Windows
+// (irsdk_utils.cpp) and POSIX (irsdk_posix_utils.cpp) backends. A backend maps
+// the sim's shared memory and attaches it here. The tick bookkeeping,
+// connection state, read ranges, and read statistics behind irsdk_getNewData()
+// live in irsdk_buffer_reader.cpp, so both backends deliver frames the same way.
+
+#include "irsdk_defines.h"
+
+// Points the reader at a mapped irsdk_header, or detaches it with NULL. Either
+// forgets the last tick copied and marks the sim disconnected.
+void irsdk_attachSharedMem(const char *sharedMem);
+
+// The newest buffer when it holds a tick newer than the last one copied, else
+// -1. Reading the header is cheap, so waits poll this and only copy once it
+// finds a new tick. Also updates the connection state.
+int irsdk_newestUnseenBuffer();
+
+// Copies the newest buffer newer than the last tick copied, honouring the read
+// ranges, and records its tick. False when every copy was torn.
+bool irsdk_copyNewestBuffer(char *data);
+
+// Records a buffer's tick as copied without copying it.
+void irsdk_markBufferSeen(int buf);
+
+// Counts a poll that found no new tick while the sim was connected.
+void irsdk_countStaleRead();
+
+#endif //IRSDK_BUFFER_READER_H
@@ -29,53 +29,170 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string.h>
 
 #include <assert.h>
+#include <chrono>
 #include "irsdk_defines.h"
 #include "yaml_parser.h"
 #include "irsdk_client.h"
 
 #pragma warning(disable:4996)
 
-irsdkClient& irsdkClient::instance()
+irsdkSharedReader& irsdkSharedReader::instance()
 {
-	static irsdkClient INSTANCE;
+	static irsdkSharedReader INSTANCE;
 	return INSTANCE;
 }
 
-bool irsdkClient::waitForData(int timeoutMS)
+std::shared_ptr<const irsdkFrame> irsdkSharedReader::waitForFrame(const std::shared_ptr<const irsdkFrame> &after, int timeoutMS)
 {
-	// wait for start of session or new data
-	if(irsdk_waitForDataReady(timeoutMS, m_data) && irsdk_getHeader())
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMS > 0 ? timeoutMS : 0);
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	for(;;)
 	{
-		// if new connection, or data changed lenght then init
-		if(!m_data || m_nData != irsdk_getHeader()->bufLen)
+		// a newer frame, or the session ended since the caller's frame
+		if(m_latest != after)
+			return m_latest;
+
+		if(!m_pumping)
 		{
-			// allocate memory to hold incoming data from sim
-			if(m_data) delete [] m_data;
-			m_nData = irsdk_getHeader()->bufLen;
-			m_data = new char[m_nData];
+			// nobody is reading the sim, so this thread does
+			m_pumping = true;
+			lock.unlock();
+
+			int remaining = (int)std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+			bool connected = false;
+			std::shared_ptr<irsdkFrame> frame = readFrame(remaining > 0 ? remaining : 0, connected);
+
+			lock.lock();
+			m_pumping = false;
+			m_connected = connected;
+			if(frame)
+				m_latest = frame;
+			else if(!connected)
+				m_latest.reset();
+			m_published.notify_all();
+			return m_latest;
+		}
 
-			// indicate a new connection
-			m_statusID++;
+		// another thread is reading, take what it publishes. If it times out
+		// without a frame, loop around and read for the time that is left.
+		if(m_published.wait_until(lock, deadline) == std::cv_status::timeout)
+			return m_latest;
+	}
+}
 
-			// reset session info str status
-			m_lastSessionCt = -1;
+std::shared_ptr<irsdkFrame> irsdkSharedReader::readFrame(int timeoutMS, bool &connected)
+{
+	irsdk_waitResult result = irsdk_waitForNewTick(timeoutMS);
+	const irsdk_header *header = irsdk_getHeader();
 
-			// and try to fill in the data
-			if(irsdk_getNewData(m_data))
-				return true;
-		}
-		else if(m_data)
+	connected = result != irsdk_waitDisconnected && header && irsdk_isConnected();
+	if(!connected)
+	{
+		// session ended, start over with the next one
+		m_vars.reset();
+		m_sessionStr.reset();
+		m_nData = 0;
+		m_sessionCt = -1;
+		return NULL;
+	}
+
+	if(result != irsdk_waitNewData)
+		return NULL;
+
+	// if new connection, or data changed lenght then init
+	if(!m_vars || m_nData != header->bufLen || (int)m_vars->size() != header->numVars)
+	{
+		std::shared_ptr<std::vector<irsdk_varHeader> > vars = std::make_shared<std::vector<irsdk_varHeader> >();
+		for(int i = 0; i < header->numVars; i++)
 		{
-			// else we are allready initialized, and data is ready for processing
-			return true;
+			const irsdk_varHeader *vh = irsdk_getVarHeaderEntry(i);
+			if(vh)
+				vars->push_back(*vh);
 		}
+		m_vars = vars;
+		m_nData = header->bufLen;
+
+		// indicate a new connection
+		m_statusID++;
+
+		// reset session info str status
+		m_sessionCt = -1;
+		m_sessionStr.reset();
+	}
+
+	// copy the session string once per update, frames share it
+	int sessionCt = irsdk_getSessionInfoStrUpdate();
+	if(!m_sessionStr || sessionCt != m_sessionCt)
+	{
+		const char *str = irsdk_getSessionInfoStr();
+		m_sessionStr = std::make_shared<const std::string>(str ? str : "");
+		m_sessionCt = sessionCt;
+	}
+
+	std::shared_ptr<irsdkFrame> frame = std::make_shared<irsdkFrame>();
+	frame->data.resize(m_nData);
+	if(m_nData <= 0 || !irsdk_getNewData(&frame->data[0]))
+		return NULL;
+
+	frame->statusID = m_statusID;
+	frame->sessionCt = m_sessionCt;
+	frame->vars = m_vars;
+	frame->sessionStr = m_sessionStr;
+	return frame;
+}
+
+std::shared_ptr<const irsdkFrame> irsdkSharedReader::latest()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_latest;
+}
+
+bool irsdkSharedReader::isConnected()
+{
+	return m_connected;
+}
+
+void irsdkSharedReader::shutdown()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while(m_pumping)
+		m_published.wait(lock);
+
+	irsdk_shutdown();
+	m_latest.reset();
+	m_connected = false;
+	m_vars.reset();
+	m_sessionStr.reset();
+	m_nData = 0;
+	m_sessionCt = -1;
+}
+
+//----------------------------------
+
+irsdkClient& irsdkClient::instance()
+{
+	static thread_local irsdkClient INSTANCE;
+	return INSTANCE;
+}
+
+bool irsdkClient::waitForData(int timeoutMS)
+{
+	// wait for start of session or new data
+	std::shared_ptr<const irsdkFrame> frame = irsdkSharedReader::instance().waitForFrame(m_frame, timeoutMS);
+	if(frame && frame != m_frame)
+	{
+		// reset session info str status on a new connection
+		if(!m_frame || m_frame->statusID != frame->statusID)
+			m_lastSessionCt = -1;
+
+		m_frame = frame;
+		return true;
 	}
-	else if(!isConnected())
+	else if(!frame)
 	{
 		// else session ended
-		if(m_data)
-			delete[] m_data;
-		m_data = NULL;
+		m_frame.reset();
 
 		// reset session info str status
 		m_lastSessionCt = -1;
@@ -84,27 +201,29 @@ bool irsdkClient::waitForData(int timeoutMS)
 	return false;
 }
 
-void irsdkClient::shutdown()
+bool irsdkClient::isConnected()
 {
-	irsdk_shutdown();
-	if(m_data)
-		delete[] m_data;
-	m_data = NULL;
-
-	// reset session info str status
-	m_lastSessionCt = -1;
+	return m_frame != NULL && irsdkSharedReader::instance().isConnected();
 }
 
-bool irsdkClient::isConnected()
+const irsdk_varHeader *irsdkClient::getVarHeader(int idx)
 {
-	return m_data != NULL && irsdk_isConnected();
+	if(m_frame && idx >= 0 && idx < (int)m_frame->vars->size())
+		return &(*m_frame->vars)[idx];
+
+	return NULL;
 }
 
 int irsdkClient::getVarIdx(const char*name)
 {
-	if(isConnected())
+	if(m_frame && name)
 	{
-		return irsdk_varNameToIndex(name);
+		const std::vector<irsdk_varHeader> &vars = *m_frame->vars;
+		for(int idx = 0; idx < (int)vars.size(); idx++)
+		{
+			if(0 == strncmp(name, vars[idx].name, IRSDK_MAX_STRING))
+				return idx;
+		}
 	}
 
 	return -1;
@@ -112,9 +231,9 @@ int irsdkClient::getVarIdx(const char*name)
 
 int /*irsdk_VarType*/ irsdkClient::getVarType(int idx)
 {
-	if(isConnected())
+	if(m_frame)
 	{
-		const irsdk_varHeader *vh = irsdk_getVarHeaderEntry(idx);
+		const irsdk_varHeader *vh = getVarHeader(idx);
 		if(vh)
 		{
 			return vh->type;
@@ -131,9 +250,9 @@ int /*irsdk_VarType*/ irsdkClient::getVarType(int idx)
 
 int irsdkClient::getVarCount(int idx)
 {
-	if(isConnected())
+	if(m_frame)
 	{
-		const irsdk_varHeader *vh = irsdk_getVarHeaderEntry(idx);
+		const irsdk_varHeader *vh = getVarHeader(idx);
 		if(vh)
 		{
 			return vh->count;
@@ -150,14 +269,14 @@ int irsdkClient::getVarCount(int idx)
 
 bool irsdkClient::getVarBool(int idx, int entry)
 {
-	if(isConnected())
+	if(m_frame)
 	{
-		const irsdk_varHeader *vh = irsdk_getVarHeaderEntry(idx);
+		const irsdk_varHeader *vh = getVarHeader(idx);
 		if(vh)
 		{
 			if(entry >= 0 && entry < vh->count)
 			{
-				const char * data = m_data + vh->offset;
+				const char * data = &m_frame->data[0] + vh->offset;
 				switch(vh->type)
 				{
 				// 1 byte
@@ -203,14 +322,14 @@ bool irsdkClient::getVarBool(int idx, int entry)
 
 int irsdkClient::getVarInt(int idx, int entry)
 {
-	if(isConnected())
+	if(m_frame)
 	{
-		const irsdk_varHeader *vh = irsdk_getVarHeaderEntry(idx);
+		const irsdk_varHeader *vh = getVarHeader(idx);
 		if(vh)
 		{
 			if(entry >= 0 && entry < vh->count)
 			{
-				const char * data = m_data + vh->offset;
+				const char * data = &m_frame->data[0] + vh->offset;
 				switch(vh->type)
 				{
 				// 1 byte
@@ -253,14 +372,14 @@ int irsdkClient::getVarInt(int idx, int entry)
 
 float irsdkClient::getVarFloat(int idx, int entry)
 {
-	if(isConnected())
+	if(m_frame)
 	{
-		const irsdk_varHeader *vh = irsdk_getVarHeaderEntry(idx);
+		const irsdk_varHeader *vh = getVarHeader(idx);
 		if(vh)
 		{
 			if(entry >= 0 && entry < vh->count)
 			{
-				const char * data = m_data + vh->offset;
+				const char * data = &m_frame->data[0] + vh->offset;
 				switch(vh->type)
 				{
 				// 1 byte
@@ -303,14 +422,14 @@ float irsdkClient::getVarFloat(int idx, int entry)
 
 double irsdkClient::getVarDouble(int idx, int entry)
 {
-	if(isConnected())
+	if(m_frame)
 	{
-		const irsdk_varHeader *vh = irsdk_getVarHeaderEntry(idx);
+		const irsdk_varHeader *vh = getVarHeader(idx);
 		if(vh)
 		{
 			if(entry >= 0 && entry < vh->count)
 			{
-				const char * data = m_data + vh->offset;
+				const char * data = &m_frame->data[0] + vh->offset;
 				switch(vh->type)
 				{
 				// 1 byte
@@ -354,14 +473,14 @@ double irsdkClient::getVarDouble(int idx, int entry)
 //path is in the form of "DriverInfo:Drivers:CarIdx:{%d}UserName:"
 int irsdkClient::getSessionStrVal(const char *path, char *val, int valLen)
 {
-	if(isConnected() && path && val && valLen > 0)
+	if(m_frame && path && val && valLen > 0)
 	{
 		// track changes in string
 		m_lastSessionCt = getSessionCt(); 
 
 		const char *tVal = NULL;
 		int tValLen = 0;
-		if(parseYaml(irsdk_getSessionInfoStr(), path, &tVal, &tValLen))
+		if(parseYaml(m_frame->sessionStr->c_str(), path, &tVal, &tValLen))
 		{
 			// dont overflow out buffer
 			int len = tValLen;
@@ -386,10 +505,10 @@ int irsdkClient::getSessionStrVal(const char *path, char *val, int valLen)
 // get the whole string
 const char* irsdkClient::getSessionStr() 
 { 
-	if(isConnected())
+	if(m_frame)
 	{
 		m_lastSessionCt = getSessionCt(); 
-		return irsdk_getSessionInfoStr(); 
+		return m_frame->sessionStr->c_str(); 
 	}
 
 	return NULL;
@@ -398,14 +517,21 @@ const char* irsdkClient::getSessionStr()
 
 //----------------------------------
 
+// irsdkCVar keeps the status ID and the index it resolved under in one word,
+// so a thread never pairs one thread's status ID with another's index.
+static long long packIdx(int statusID, int idx)
+{
+	return (long long)(((unsigned long long)(unsigned int)statusID << 32) | (unsigned int)idx);
+}
+
 irsdkCVar::irsdkCVar()
-	: m_idx(-1)
-	, m_statusID(-1)
+	: m_idx(packIdx(-1, -1))
 {
 	m_name[0] = '\0';
 }
 
 irsdkCVar::irsdkCVar(const char *name)
+	: m_idx(packIdx(-1, -1))
 {
 	m_name[0] = '\0';
 	setVarName(name);
@@ -415,8 +541,7 @@ void irsdkCVar::setVarName(const char *name)
 {
 	if(!name || 0 != strncmp(name, m_name, sizeof(m_name)))
 	{
-		m_idx = -1;
-		m_statusID = -1;
+		m_idx = packIdx(-1, -1);
 
 		if(name)
 		{
@@ -428,68 +553,121 @@ void irsdkCVar::setVarName(const char *name)
 	}
 }
 
-bool irsdkCVar::checkIdx()
+bool irsdkCVar::checkIdx(int &idx)
 {
-	if(irsdkClient::instance().isConnected())
+	irsdkClient &client = irsdkClient::instance();
+	long long cached = m_idx;
+
+	if(client.isConnected())
 	{
-		if(m_statusID != irsdkClient::instance().getStatusID())
+		int statusID = client.getStatusID();
+		if((int)(cached >> 32) != statusID)
 		{
-			m_statusID = irsdkClient::instance().getStatusID();
-			m_idx = irsdkClient::instance().getVarIdx(m_name);
+			cached = packIdx(statusID, client.getVarIdx(m_name));
+			m_idx = cached;
 		}
 
+		idx = (int)(unsigned int)cached;
 		return true;
 	}
 
+	idx = (int)(unsigned int)cached;
 	return false;
 }
 
 int /*irsdk_VarType*/ irsdkCVar::getType()
 {
-	if(checkIdx())
-		return irsdkClient::instance().getVarType(m_idx);
+	int idx;
+	if(checkIdx(idx))
+		return irsdkClient::instance().getVarType(idx);
 	return 0;
 }
 
 int irsdkCVar::getCount()
 {
-	if(checkIdx())
-		return irsdkClient::instance().getVarCount(m_idx);
+	int idx;
+	if(checkIdx(idx))
+		return irsdkClient::instance().getVarCount(idx);
 	return 0;
 }
 
 bool irsdkCVar::isValid()
 {
-	checkIdx();
-	return (m_idx > -1);
+	int idx;
+	checkIdx(idx);
+	return (idx > -1);
 }
 
 
 bool irsdkCVar::getBool(int entry)
 {
-	if(checkIdx())
-		return irsdkClient::instance().getVarBool(m_idx, entry);
+	int idx;
+	if(checkIdx(idx))
+		return irsdkClient::instance().getVarBool(idx, entry);
 	return false;
 }
 
 int irsdkCVar::getInt(int entry)
 {
-	if(checkIdx())
-		return irsdkClient::instance().getVarInt(m_idx, entry);
+	int idx;
+	if(checkIdx(idx))
+		return irsdkClient::instance().getVarInt(idx, entry);
 	return 0;
 }
 
 float irsdkCVar::getFloat(int entry)
 {
-	if(checkIdx())
-		return irsdkClient::instance().getVarFloat(m_idx, entry);
+	int idx;
+	if(checkIdx(idx))
+		return irsdkClient::instance().getVarFloat(idx, entry);
 	return 0.0f;
 }
 
 double irsdkCVar::getDouble(int entry)
 {
-	if(checkIdx())
-		return irsdkClient::instance().getVarDouble(m_idx, entry);
+	int idx;
+	if(checkIdx(idx))
+		return irsdkClient::instance().getVarDouble(idx, entry);
 	return 0.0;
 }
 
+//----------------------------------
+
+irsdkVarBase::irsdkVarBase(const char *name, int type, int count)
+	: m_type(type)
+	, m_count(count)
+	, m_offset(packIdx(-1, -1))
+{
+	m_name[0] = '\0';
+	if(name)
+	{
+		strncpy(m_name, name, max_string);
+		m_name[max_string-1] = '\0';
+	}
+}
+
+long long irsdkVarBase::resolve(const irsdkFrame *frame)
+{
+	int offset = -1;
+
+	const std::vector<irsdk_varHeader> &vars = *frame->vars;
+	for(int idx = 0; idx < (int)vars.size(); idx++)
+	{
+		const irsdk_varHeader &vh = vars[idx];
+		if(0 == strncmp(m_name, vh.name, IRSDK_MAX_STRING))
+		{
+			// leave it invalid if it has another type or fewer entries than asked for
+			if((vh.type == m_type || (m_type == irsdk_int && vh.type == irsdk_bitField)) && vh.count >= m_count)
+			{
+				long long end = vh.offset + (long long)irsdk_VarTypeBytes[vh.type] * m_count;
+				if(vh.offset >= 0 && end <= (long long)frame->data.size())
+					offset = vh.offset;
+			}
+			break;
+		}
+	}
+
+	long long cached = packIdx(frame->statusID, offset);
+	m_offset.store(cached, std::memory_order_relaxed);
+	return cached;
+}
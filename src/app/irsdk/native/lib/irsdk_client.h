@@ -28,12 +28,83 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef IRSDKCLIENT_H
 #define IRSDKCLIENT_H
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// One copy of the sim's telemetry. Frames are never modified once published,
+// so any number of threads can hold and read the same one.
+struct irsdkFrame
+{
+	int statusID;   // connection the frame belongs to, see irsdkClient::getStatusID()
+	int sessionCt;  // session info update the frame was copied under
+
+	// shared by every frame of one connection
+	std::shared_ptr<const std::vector<irsdk_varHeader> > vars;
+	// shared by every frame of one session info update
+	std::shared_ptr<const std::string> sessionStr;
+
+	std::vector<char> data;
+};
+
+// Owns the connection to the sim and the copy out of shared memory. The
+// irsdk_* calls it makes are not thread-safe, so only one thread at a time
+// pumps new data; threads that call waitForData() meanwhile wait for the
+// frame that thread publishes instead of reading shared memory themselves.
+class irsdkSharedReader
+{
+public:
+	static irsdkSharedReader& instance();
+
+	// Waits until a frame newer than 'after' is published, pumping the sim
+	// when no other thread is. Returns the newest frame, which is 'after' on
+	// a timeout and NULL while disconnected.
+	std::shared_ptr<const irsdkFrame> waitForFrame(const std::shared_ptr<const irsdkFrame> &after, int timeoutMS);
+
+	std::shared_ptr<const irsdkFrame> latest();
+	bool isConnected();
+
+	void shutdown();
+
+protected:
+	irsdkSharedReader()
+		: m_pumping(false)
+		, m_connected(false)
+		, m_statusID(0)
+		, m_nData(0)
+		, m_sessionCt(-1)
+	{ }
+
+	~irsdkSharedReader() { shutdown(); }
+
+	// Only called by the pumping thread, without m_mutex held.
+	std::shared_ptr<irsdkFrame> readFrame(int timeoutMS, bool &connected);
+
+	std::mutex m_mutex;
+	std::condition_variable m_published;
+	std::shared_ptr<const irsdkFrame> m_latest;
+	bool m_pumping;
+	std::atomic<bool> m_connected;
+
+	// Pumping thread state
+	int m_statusID;
+	int m_nData;
+	int m_sessionCt;
+	std::shared_ptr<const std::vector<irsdk_varHeader> > m_vars;
+	std::shared_ptr<const std::string> m_sessionStr;
+};
+
 // A C++ wrapper around the irsdk calls that takes care of the details of maintaining a connection.
 // reads out the data into a cache so you don't have to worry about timming
+// Each thread gets its own client, a view over the frame it last received
+// from irsdkSharedReader, so several threads can consume telemetry at once.
 class irsdkClient
 {
 public:
-	// singleton
+	// one per thread
 	static irsdkClient& instance();
 
 	// wait for live data, or if a .ibt file is open
@@ -41,7 +112,12 @@ public:
 	bool waitForData(int timeoutMS = 16);
 
 	bool isConnected();
-	int getStatusID() { return m_statusID; }
+	int getStatusID() { return m_frame ? m_frame->statusID : 0; }
+
+	// frame the getters below read, held until the next waitForData()
+	std::shared_ptr<const irsdkFrame> getFrame() { return m_frame; }
+	// same frame without taking a reference, for irsdkVar's reads
+	const irsdkFrame *getFramePtr() const { return m_frame.get(); }
 
 	int getVarIdx(const char*name);
 
@@ -71,7 +147,7 @@ public:
 	//---
 
 	// value that increments with each update to string
-	int getSessionCt() { return irsdk_getSessionInfoStrUpdate(); }
+	int getSessionCt() { return m_frame ? m_frame->sessionCt : -1; }
 
 	// has string changed since we last read any values from it
 	bool wasSessionStrUpdated() { return m_lastSessionCt != getSessionCt(); } 
@@ -86,28 +162,22 @@ public:
 protected:
 
 	irsdkClient()
-		: m_data(NULL)
-		, m_nData(0)
-		, m_statusID(0)
-		, m_lastSessionCt(-1)
+		: m_lastSessionCt(-1)
 	{ }
 
-	~irsdkClient() { shutdown(); }
+	const irsdk_varHeader *getVarHeader(int idx);
 
-	void shutdown();
-
-	char *m_data;
-	int m_nData;
-	int m_statusID;
+	// the frame being read, NULL while disconnected
+	std::shared_ptr<const irsdkFrame> m_frame;
 
 	int m_lastSessionCt;
-
-	static irsdkClient *m_instance;
 };
 
 
 // helper class to keep track of our variables index
 // Create a global instance of this and it will take care of the details for you.
+// It reads through the calling thread's irsdkClient, and its cached index is
+// safe to share between threads. Only setVarName() must not race with readers.
 class irsdkCVar
 {
 public:
@@ -128,12 +198,87 @@ public:
 	double getDouble(int entry = 0);
 
 protected:
-	bool checkIdx();
+	bool checkIdx(int &idx);
 
 	static const int max_string = 32; //IRSDK_MAX_STRING
 	char m_name[max_string];
-	int m_idx;
-	int m_statusID;
+	// status ID in the high half, variable index in the low half
+	std::atomic<long long> m_idx;
+};
+
+
+// maps a C++ type to the irsdk_VarType irsdkVar expects for it
+template<typename T> struct irsdkVarType;
+template<> struct irsdkVarType<char> { static const int value = irsdk_char; };
+template<> struct irsdkVarType<bool> { static const int value = irsdk_bool; };
+template<> struct irsdkVarType<int> { static const int value = irsdk_int; };
+template<> struct irsdkVarType<float> { static const int value = irsdk_float; };
+template<> struct irsdkVarType<double> { static const int value = irsdk_double; };
+
+class irsdkVarBase
+{
+protected:
+	irsdkVarBase(const char *name, int type, int count);
+
+	// start of the variable in the calling thread's frame, NULL if there is
+	// no frame or the variable is missing or of another type or shorter
+	const char *data()
+	{
+		const irsdkFrame *frame = irsdkClient::instance().getFramePtr();
+		if(!frame)
+			return NULL;
+
+		long long cached = m_offset.load(std::memory_order_relaxed);
+		if((int)(cached >> 32) != frame->statusID)
+			cached = resolve(frame);
+
+		int offset = (int)(unsigned int)cached;
+		if(offset < 0)
+			return NULL;
+		return &frame->data[0] + offset;
+	}
+
+	long long resolve(const irsdkFrame *frame);
+
+	static const int max_string = 32; //IRSDK_MAX_STRING
+	char m_name[max_string];
+	int m_type;
+	int m_count;
+	// status ID in the high half, offset in the low half
+	std::atomic<long long> m_offset;
+};
+
+// Typed alternative to irsdkCVar. The offset is looked up and the type and
+// count checked once per status ID; after that a read is one load from the
+// calling thread's frame, with no conversion. T must be the variable's own
+// type (int also matches bitfields), and Count no more than its entries, so
+// irsdkVar<float, IRSDK_MAX_CARS> reads CarIdxLapDistPct. Like irsdkCVar, a
+// global instance can be shared between threads.
+template<typename T, int Count = 1>
+class irsdkVar : public irsdkVarBase
+{
+public:
+	static const int count = Count;
+
+	irsdkVar(const char *name)
+		: irsdkVarBase(name, irsdkVarType<T>::value, Count)
+	{ }
+
+	bool isValid() { return data() != NULL; }
+
+	// entry is the array offset, or 0 if not an array element
+	// returns 0 if the variable is not available
+	T get(int entry = 0)
+	{
+		const char *d = data();
+		if(d && entry >= 0 && entry < Count)
+			return ((const T*)d)[entry];
+		return T();
+	}
+
+	// all Count entries, valid until the calling thread's next waitForData()
+	// returns NULL if the variable is not available
+	const T *span() { return (const T*)data(); }
 };
 
 #endif // IRSDKCLIENT_H
@@ -108,6 +108,9 @@ static const int IRSDK_MAX_STRING = 32;
 // descriptions can be longer than max_string!
 static const int IRSDK_MAX_DESC = 64; 
 
+// entries in the CarIdx* arrays, one per car slot in the session
+static const int IRSDK_MAX_CARS = 64;
+
 // define markers for unlimited session lap and time
 static const int IRSDK_UNLIMITED_LAPS = 32767;
 static const float IRSDK_UNLIMITED_TIME = 604800.0f;
@@ -399,12 +402,75 @@ void irsdk_shutdown();
 
 bool irsdk_getNewData(char *data);
 bool irsdk_waitForDataReady(int timeOut, char *data);
+
+// Why irsdk_waitForNewTick() returned
+enum irsdk_waitResult
+{
+	irsdk_waitNewData = 0,   // a tick newer than the last copy is ready
+	irsdk_waitSignaled,      // the sim signaled, but without a newer tick
+	irsdk_waitTimeout,       // nothing was signaled before the timeout
+	irsdk_waitDisconnected,  // no sim, or it is not connected
+};
+
+// Waits like irsdk_waitForDataReady() but only reads the header, so a caller
+// can size its buffer before copying the new tick once with irsdk_getNewData().
+irsdk_waitResult irsdk_waitForNewTick(int timeOut);
 bool irsdk_isConnected();
 
+enum irsdk_connectionState
+{
+	irsdk_connDisconnected = 0,
+	irsdk_connConnected,     // new ticks are arriving
+	irsdk_connStale          // the sim reports connected, but has stopped ticking
+};
+
+// Updated only when a wait or read checks the header, so this and
+// irsdk_isConnected() are cheap enough to call per variable.
+irsdk_connectionState irsdk_getConnectionState();
+
 const irsdk_header *irsdk_getHeader();
 const char *irsdk_getData(int index);
 const char *irsdk_getSessionInfoStr();
 int irsdk_getSessionInfoStrUpdate(); // incrementing index that indicates new session info string
+int irsdk_getLastTickCount(); // tick of the data last copied by irsdk_getNewData, -1 before any
+
+// Byte range of a telemetry buffer, see irsdk_setReadRanges()
+struct irsdk_bufRange
+{
+	int offset;
+	int len;
+};
+
+static const int IRSDK_MAX_READ_RANGES = 256;
+
+// Limit the copy done by irsdk_getNewData() and irsdk_waitForDataReady() to
+// these ranges of the buffer, with the same tick check as a full copy. Bytes
+// outside them are left as they were in the caller's buffer. Ranges must be
+// sorted, non-overlapping, and non-empty; a range past the current bufLen
+// falls back to a full copy. Pass a count of 0 to copy whole buffers again.
+// Returns false, and keeps the previous ranges, when the list is rejected.
+bool irsdk_setReadRanges(const irsdk_bufRange *ranges, int count);
+
+// Counters kept by irsdk_getNewData() since startup. irsdk_getReadStats() may
+// be called from any thread; each counter is read atomically.
+struct irsdk_readStats
+{
+	unsigned long long reads;       // buffers copied out intact
+	unsigned long long tornReads;   // copies the sim overwrote while they ran
+	unsigned long long retries;     // copies repeated after a torn read
+	unsigned long long fallbacks;   // reads served from an older buffer than the newest
+	unsigned long long staleReads;  // calls that found no newer tick to copy
+	unsigned long long failedReads; // calls where every candidate buffer tore
+};
+
+static const int IRSDK_DEFAULT_READ_ATTEMPTS = 2;
+static const int IRSDK_MAX_READ_ATTEMPTS = 16;
+
+// Copies tried per buffer before irsdk_getNewData() falls back to the next
+// newest one. Clamped to [1, IRSDK_MAX_READ_ATTEMPTS].
+void irsdk_setReadAttempts(int attempts);
+int irsdk_getReadAttempts();
+void irsdk_getReadStats(irsdk_readStats *stats);
 
 const irsdk_varHeader *irsdk_getVarHeaderPtr();
 const irsdk_varHeader *irsdk_getVarHeaderEntry(int index);
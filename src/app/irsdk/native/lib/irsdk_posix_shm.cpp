@@ -0,0 +1,231 @@
+#include "./irsdk_posix_shm.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace irdashies::irsdk_posix {
+namespace {
+
+std::string posixError(const char* operation) {
+  return std::string(operation) + " failed: " + std::strerror(errno);
+}
+
+#if defined(__linux__)
+std::uint32_t* futexWord(const std::atomic<std::uint32_t>& word) {
+  return reinterpret_cast<std::uint32_t*>(
+      const_cast<std::atomic<std::uint32_t>*>(&word));
+}
+#endif
+
+}  // namespace
+
+SharedMapping::~SharedMapping() {
+  close();
+}
+
+bool SharedMapping::create(
+    const char* name,
+    std::uint64_t size,
+    bool& existed,
+    std::string& error) {
+  existed = false;
+  if (data_ != nullptr) {
+    error = "Shared-memory object is already mapped";
+    return false;
+  }
+
+  const int descriptor = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (descriptor < 0) {
+    existed = errno == EEXIST;
+    error = posixError("shm_open");
+    return false;
+  }
+  if (ftruncate(descriptor, static_cast<off_t>(size)) != 0) {
+    error = posixError("ftruncate");
+    ::close(descriptor);
+    shm_unlink(name);
+    return false;
+  }
+
+  void* mapping = mmap(
+      nullptr,
+      static_cast<std::size_t>(size),
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED,
+      descriptor,
+      0);
+  ::close(descriptor);
+  if (mapping == MAP_FAILED) {
+    error = posixError("mmap");
+    shm_unlink(name);
+    return false;
+  }
+
+  name_ = name;
+  data_ = static_cast<char*>(mapping);
+  size_ = size;
+  owner_ = true;
+  return true;
+}
+
+bool SharedMapping::open(
+    const char* name,
+    bool writable,
+    std::string& error) {
+  if (data_ != nullptr) {
+    error = "Shared-memory object is already mapped";
+    return false;
+  }
+
+  const int descriptor = shm_open(name, writable ? O_RDWR : O_RDONLY, 0);
+  if (descriptor < 0) {
+    error = posixError("shm_open");
+    return false;
+  }
+  struct stat status {};
+  if (fstat(descriptor, &status) != 0 || status.st_size <= 0) {
+    error = "Shared-memory object has no size";
+    ::close(descriptor);
+    return false;
+  }
+
+  void* mapping = mmap(
+      nullptr,
+      static_cast<std::size_t>(status.st_size),
+      writable ? PROT_READ | PROT_WRITE : PROT_READ,
+      MAP_SHARED,
+      descriptor,
+      0);
+  ::close(descriptor);
+  if (mapping == MAP_FAILED) {
+    error = posixError("mmap");
+    return false;
+  }
+
+  name_ = name;
+  data_ = static_cast<char*>(mapping);
+  size_ = static_cast<std::uint64_t>(status.st_size);
+  owner_ = false;
+  return true;
+}
+
+void SharedMapping::close() {
+  if (data_ != nullptr) {
+    munmap(data_, static_cast<std::size_t>(size_));
+  }
+  if (owner_) {
+    shm_unlink(name_.c_str());
+  }
+  name_.clear();
+  data_ = nullptr;
+  size_ = 0;
+  owner_ = false;
+}
+
+std::uint64_t monotonicNanoseconds() {
+  timespec now{};
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<std::uint64_t>(now.tv_sec) * 1000000000ULL +
+      static_cast<std::uint64_t>(now.tv_nsec);
+}
+
+void signalDataValid(DataValidEvent& event) {
+  event.signalNanoseconds.store(
+      monotonicNanoseconds(), std::memory_order_relaxed);
+  event.sequence.fetch_add(1, std::memory_order_seq_cst);
+#if defined(__linux__)
+  // Cross-process waiters, so this must not use FUTEX_PRIVATE_FLAG.
+  syscall(
+      SYS_futex,
+      futexWord(event.sequence),
+      FUTEX_WAKE,
+      INT32_MAX,
+      nullptr,
+      nullptr,
+      0);
+#endif
+}
+
+bool waitForDataValid(
+    const DataValidEvent& event,
+    std::uint32_t observed,
+    int timeoutMs) {
+  if (event.sequence.load(std::memory_order_acquire) != observed) {
+    return true;
+  }
+  if (timeoutMs <= 0) {
+    return false;
+  }
+
+  const auto deadline = std::chrono::steady_clock::now() +
+      std::chrono::milliseconds(timeoutMs);
+  while (event.sequence.load(std::memory_order_acquire) == observed) {
+    const auto remaining = deadline - std::chrono::steady_clock::now();
+    if (remaining <= std::chrono::steady_clock::duration::zero()) {
+      return false;
+    }
+#if defined(__linux__)
+    const auto nanoseconds =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(remaining)
+            .count();
+    timespec timeout{};
+    timeout.tv_sec = static_cast<time_t>(nanoseconds / 1000000000LL);
+    timeout.tv_nsec = static_cast<long>(nanoseconds % 1000000000LL);
+    // EAGAIN (value already changed), EINTR and ETIMEDOUT all fall through
+    // to the sequence check above.
+    syscall(
+        SYS_futex,
+        futexWord(event.sequence),
+        FUTEX_WAIT,
+        observed,
+        &timeout,
+        nullptr,
+        0);
+#else
+    // No portable cross-process futex; poll at the SDK's own timer grain.
+    std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+        remaining, std::chrono::milliseconds(1)));
+#endif
+  }
+  return true;
+}
+
+bool publisherRunning(const DataValidEvent& event) {
+  const pid_t owner = event.publisherPid;
+  return owner > 0 && (kill(owner, 0) == 0 || errno == EPERM);
+}
+
+bool unlinkAbandonedObjects(const char* mappingName, const char* eventName) {
+  SharedMapping eventObject;
+  std::string error;
+  if (eventObject.open(eventName, false, error) &&
+      eventObject.size() >= sizeof(DataValidEvent)) {
+    const auto* event =
+        reinterpret_cast<const DataValidEvent*>(eventObject.data());
+    if (publisherRunning(*event)) {
+      return false;
+    }
+  }
+  eventObject.close();
+
+  shm_unlink(mappingName);
+  shm_unlink(eventName);
+  return true;
+}
+
+}  // namespace irdashies::irsdk_posix
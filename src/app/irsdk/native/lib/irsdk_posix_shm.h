@@ -0,0 +1,92 @@
+#ifndef IRDASHIES_IRSDK_POSIX_SHM_H
+#define IRDASHIES_IRSDK_POSIX_SHM_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// POSIX counterparts of the Windows objects in irsdk_shared_objects.h. The
+// mapping holds the same irsdk_header layout as the Windows file mapping; the
+// data-valid event is a second small object holding a futex word.
+#define IRDASHIES_IRSDK_POSIX_PRODUCTION_MAPPING_NAME "/IRSDKMemMapFileName"
+#define IRDASHIES_IRSDK_POSIX_PRODUCTION_EVENT_NAME "/IRSDKDataValidEvent"
+#define IRDASHIES_IRSDK_POSIX_REPLAY_MAPPING_NAME \
+  "/IRDashiesReplayMemMapFileName"
+#define IRDASHIES_IRSDK_POSIX_REPLAY_EVENT_NAME \
+  "/IRDashiesReplayDataValidEvent"
+
+namespace irdashies::irsdk_posix {
+
+// Publishers increment sequence and wake every waiter. Readers remember the
+// sequence they last saw, so a signal between two waits is never lost.
+struct DataValidEvent {
+  std::atomic<std::uint32_t> sequence;
+  std::int32_t publisherPid;
+  // CLOCK_MONOTONIC time of the latest signal, for cross-process latency.
+  std::atomic<std::uint64_t> signalNanoseconds;
+};
+
+static_assert(
+    std::atomic<std::uint32_t>::is_always_lock_free &&
+        std::atomic<std::uint64_t>::is_always_lock_free,
+    "Shared-memory notification requires lock-free atomics");
+static_assert(sizeof(DataValidEvent) == 16, "DataValidEvent layout changed");
+
+class SharedMapping {
+ public:
+  SharedMapping() = default;
+  SharedMapping(const SharedMapping&) = delete;
+  SharedMapping& operator=(const SharedMapping&) = delete;
+  ~SharedMapping();
+
+  // Creates a new zero-filled object. The creator unlinks the name on close.
+  // existed is set when the name is already taken.
+  bool create(
+      const char* name,
+      std::uint64_t size,
+      bool& existed,
+      std::string& error);
+
+  // Maps an existing object at its current size.
+  bool open(const char* name, bool writable, std::string& error);
+
+  void close();
+
+  char* data() const {
+    return data_;
+  }
+
+  std::uint64_t size() const {
+    return size_;
+  }
+
+ private:
+  std::string name_;
+  char* data_ = nullptr;
+  std::uint64_t size_ = 0;
+  bool owner_ = false;
+};
+
+std::uint64_t monotonicNanoseconds();
+
+void signalDataValid(DataValidEvent& event);
+
+// Sleeps until the sequence differs from observed or the timeout expires.
+// Returns true when a signal arrived.
+bool waitForDataValid(
+    const DataValidEvent& event,
+    std::uint32_t observed,
+    int timeoutMs);
+
+// True while the process that created the event is alive. A reader holding a
+// mapping whose publisher has exited should remap, since a new publisher will
+// have created fresh objects under the same names.
+bool publisherRunning(const DataValidEvent& event);
+
+// Removes a mapping/event pair left behind by a publisher that exited without
+// unlinking it. Returns false when the owning process is still running.
+bool unlinkAbandonedObjects(const char* mappingName, const char* eventName);
+
+}  // namespace irdashies::irsdk_posix
+
+#endif
@@ -0,0 +1,348 @@
+// POSIX counterpart of irsdk_utils.cpp. It keeps the same function surface and
+// shares the tick bookkeeping and torn-read retry in irsdk_buffer_reader.cpp,
+// but maps the shm_open objects created by the POSIX replay publisher (see
+// irsdk_posix_shm.h) instead of the Windows file mapping and event. Broadcast
+// messages have no POSIX transport.
+
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "irsdk_defines.h"
+#include "irsdk_buffer_reader.h"
+#include "irsdk_posix_shm.h"
+
+namespace posix_shm = irdashies::irsdk_posix;
+
+#ifdef IRDASHIES_IRSDK_REPLAY_NAMES
+#define IRSDK_POSIX_MEMMAPFILENAME IRDASHIES_IRSDK_POSIX_REPLAY_MAPPING_NAME
+#define IRSDK_POSIX_DATAVALIDEVENTNAME IRDASHIES_IRSDK_POSIX_REPLAY_EVENT_NAME
+#else
+#define IRSDK_POSIX_MEMMAPFILENAME IRDASHIES_IRSDK_POSIX_PRODUCTION_MAPPING_NAME
+#define IRSDK_POSIX_DATAVALIDEVENTNAME IRDASHIES_IRSDK_POSIX_PRODUCTION_EVENT_NAME
+#endif
+
+// Local memory
+
+static posix_shm::SharedMapping memMapFile;
+static posix_shm::SharedMapping dataValidEventFile;
+static const posix_shm::DataValidEvent *pDataValidEvent = NULL;
+
+static const char *pSharedMem = NULL;
+static const irsdk_header *pHeader = NULL;
+
+static bool isInitialized = false;
+
+// The Windows mapping is sized by its creator and never read past the header's
+// own offsets; here the size comes from fstat, so check the header against it
+// before handing out pointers into the mapping.
+static bool headerFitsMapping(const irsdk_header *header, unsigned long long size)
+{
+	if(size < sizeof(irsdk_header))
+		return false;
+	if(header->numBuf < 1 || header->numBuf > IRSDK_MAX_BUFS || header->bufLen <= 0 || header->numVars < 0)
+		return false;
+
+	const unsigned long long varEnd = (unsigned long long)header->varHeaderOffset +
+		(unsigned long long)header->numVars * sizeof(irsdk_varHeader);
+	if(header->varHeaderOffset < 0 || varEnd > size)
+		return false;
+
+	for(int i=0; i<header->numBuf; i++)
+	{
+		const int offset = header->varBuf[i].bufOffset;
+		if(offset < 0 || (unsigned long long)offset + (unsigned long long)header->bufLen > size)
+			return false;
+	}
+
+	return header->sessionInfoOffset >= 0 &&
+		(unsigned long long)header->sessionInfoOffset < size;
+}
+
+// While ticks arrive the publisher is plainly running. Once they stop, go back
+// through startup so a publisher that died is dropped and a new one is mapped.
+static bool startedWithLivePublisher()
+{
+	if(isInitialized && irsdk_getConnectionState() == irsdk_connConnected)
+		return true;
+	return irsdk_startup();
+}
+
+// Function Implementations
+
+bool irsdk_startup()
+{
+	// A publisher that exits unlinks its names; a new one creates fresh objects
+	// under the same names, so drop a mapping whose publisher is gone. One that
+	// was killed leaves its header marked connected, so don't trust the bit.
+	if(pDataValidEvent && !posix_shm::publisherRunning(*pDataValidEvent))
+		irsdk_shutdown();
+
+	std::string error;
+	if(!memMapFile.data())
+	{
+		memMapFile.open(IRSDK_POSIX_MEMMAPFILENAME, false, error);
+	}
+
+	if(memMapFile.data())
+	{
+		if(!pSharedMem)
+		{
+			if(headerFitsMapping((const irsdk_header *)memMapFile.data(), memMapFile.size()))
+			{
+				pSharedMem = memMapFile.data();
+				pHeader = (const irsdk_header *)pSharedMem;
+			}
+			else
+				memMapFile.close();
+		}
+
+		if(pSharedMem)
+		{
+			if(!pDataValidEvent)
+			{
+				// A killed publisher leaves its objects behind until the next
+				// one unlinks them; attaching would hand out its last frame.
+				if(dataValidEventFile.open(IRSDK_POSIX_DATAVALIDEVENTNAME, false, error) &&
+					dataValidEventFile.size() >= sizeof(posix_shm::DataValidEvent) &&
+					posix_shm::publisherRunning(*(const posix_shm::DataValidEvent *)dataValidEventFile.data()))
+				{
+					pDataValidEvent = (const posix_shm::DataValidEvent *)dataValidEventFile.data();
+				}
+				else
+				{
+					dataValidEventFile.close();
+					memMapFile.close();
+					pSharedMem = NULL;
+					pHeader = NULL;
+				}
+			}
+
+			if(pDataValidEvent)
+			{
+				// Objects opened since the last call start over from the
+				// current tick.
+				if(!isInitialized)
+					irsdk_attachSharedMem(pSharedMem);
+				isInitialized = true;
+				return isInitialized;
+			}
+			//else printf("Error opening event: %s\n", error.c_str());
+		}
+		//else printf("Error mapping file: %s\n", error.c_str());
+	}
+	//else printf("Error opening file: %s\n", error.c_str());
+
+	isInitialized = false;
+	return isInitialized;
+}
+
+void irsdk_shutdown()
+{
+	dataValidEventFile.close();
+	memMapFile.close();
+
+	pDataValidEvent = NULL;
+	pSharedMem = NULL;
+	pHeader = NULL;
+
+	isInitialized = false;
+	irsdk_attachSharedMem(NULL);
+}
+
+bool irsdk_getNewData(char *data)
+{
+	if(startedWithLivePublisher())
+	{
+		const int latest = irsdk_newestUnseenBuffer();
+		if(latest >= 0)
+		{
+			// if asked to retrieve the data
+			if(data)
+			{
+				// if false, the data changed out from under every copy
+				return irsdk_copyNewestBuffer(data);
+			}
+			else
+			{
+				irsdk_markBufferSeen(latest);
+				return true;
+			}
+		}
+		else if(pHeader->status & irsdk_stConnected)
+			irsdk_countStaleRead();
+	}
+
+	return false;
+}
+
+irsdk_waitResult irsdk_waitForNewTick(int timeOut)
+{
+	if(startedWithLivePublisher())
+	{
+		// Unlike an auto-reset event, the sequence does not remember a signal
+		// on its own, so sample it before checking for data.
+		const unsigned int observed = pDataValidEvent->sequence.load(std::memory_order_acquire);
+
+		// just to be sure, check before we sleep
+		if(irsdk_newestUnseenBuffer() >= 0)
+			return irsdk_waitNewData;
+
+		// sleep till signaled
+		const bool signaled = posix_shm::waitForDataValid(*pDataValidEvent, observed, timeOut);
+
+		// we woke up, so check for data
+		if(irsdk_newestUnseenBuffer() >= 0)
+			return irsdk_waitNewData;
+		if(!(pHeader->status & irsdk_stConnected))
+			return irsdk_waitDisconnected;
+		return signaled ? irsdk_waitSignaled : irsdk_waitTimeout;
+	}
+
+	// sleep if error
+	if(timeOut > 0)
+		usleep((useconds_t)timeOut * 1000);
+
+	return irsdk_waitDisconnected;
+}
+
+bool irsdk_waitForDataReady(int timeOut, char *data)
+{
+	// only pay for the copy once the header shows a new tick
+	if(irsdk_waitForNewTick(timeOut) == irsdk_waitNewData)
+		return irsdk_getNewData(data);
+
+	return false;
+}
+
+bool irsdk_isConnected()
+{
+	return irsdk_getConnectionState() != irsdk_connDisconnected;
+}
+
+const irsdk_header *irsdk_getHeader()
+{
+	if(isInitialized)
+	{
+		return pHeader;
+	}
+
+	return NULL;
+}
+
+// direct access to the data buffer
+// Warnign! This buffer is volitile so read it out fast!
+// Use the cached copy from irsdk_waitForDataReady() or irsdk_getNewData() instead
+const char *irsdk_getData(int index)
+{
+	if(isInitialized)
+	{
+		return pSharedMem + pHeader->varBuf[index].bufOffset;
+	}
+
+	return NULL;
+}
+
+const char *irsdk_getSessionInfoStr()
+{
+	if(isInitialized)
+	{
+		return pSharedMem + pHeader->sessionInfoOffset;
+	}
+	return NULL;
+}
+
+int irsdk_getSessionInfoStrUpdate()
+{
+	if(isInitialized)
+	{
+		return pHeader->sessionInfoUpdate;
+	}
+	return -1;
+}
+
+const irsdk_varHeader *irsdk_getVarHeaderPtr()
+{
+	if(isInitialized)
+	{
+		return ((irsdk_varHeader*)(pSharedMem + pHeader->varHeaderOffset));
+	}
+	return NULL;
+}
+
+const irsdk_varHeader *irsdk_getVarHeaderEntry(int index)
+{
+	if(isInitialized)
+	{
+		if(index >= 0 && index < pHeader->numVars)
+		{
+			return &((irsdk_varHeader*)(pSharedMem + pHeader->varHeaderOffset))[index];
+		}
+	}
+	return NULL;
+}
+
+// Note: this is a linear search, so cache the results
+int irsdk_varNameToIndex(const char *name)
+{
+	const irsdk_varHeader *pVar;
+
+	if(name && isInitialized)
+	{
+		for(int index=0; index<pHeader->numVars; index++)
+		{
+			pVar = irsdk_getVarHeaderEntry(index);
+			if(pVar && 0 == strncmp(name, pVar->name, IRSDK_MAX_STRING))
+			{
+				return index;
+			}
+		}
+	}
+
+	return -1;
+}
+
+int irsdk_varNameToOffset(const char *name)
+{
+	const irsdk_varHeader *pVar;
+
+	if(name && isInitialized)
+	{
+		for(int index=0; index<pHeader->numVars; index++)
+		{
+			pVar = irsdk_getVarHeaderEntry(index);
+			if(pVar && 0 == strncmp(name, pVar->name, IRSDK_MAX_STRING))
+			{
+				return pVar->offset;
+			}
+		}
+	}
+
+	return -1;
+}
+
+// No window-message broadcast on POSIX; camera and replay commands are dropped
+// just as they are during tape playback.
+void irsdk_broadcastMsg(irsdk_BroadcastMsg, int, int, int) {}
+void irsdk_broadcastMsg(irsdk_BroadcastMsg, int, int) {}
+void irsdk_broadcastMsg(irsdk_BroadcastMsg, int, float) {}
+
+int irsdk_padCarNum(int num, int zero)
+{
+	int retVal = num;
+	int numPlace = 1;
+	if(num > 99)
+		numPlace = 3;
+	else if(num > 9)
+		numPlace = 2;
+	if(zero)
+	{
+		numPlace += zero;
+		retVal = num + 1000*numPlace;
+	}
+
+	return retVal;
+}
@@ -45,6 +45,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include "irsdk_defines.h"
+#include "irsdk_buffer_reader.h"
 
 // for timeBeginPeriod()
 #pragma comment(lib, "Winmm")
@@ -59,16 +60,8 @@ static HANDLE hMemMapFile = NULL;
 static const char *pSharedMem = NULL;
 static const irsdk_header *pHeader = NULL;
 
-static int lastTickCount = INT_MAX;
 static bool isInitialized = false;
 
-#ifdef IRDASHIES_IRSDK_REPLAY_NAMES
-static const double timeout = 2.0; // Keep replay integration tests fast.
-#else
-static const double timeout = 30.0; // timeout after 30 seconds with no communication
-#endif
-static time_t lastValidTime = 0;
-
 // Function Implementations
 
 bool irsdk_startup()
@@ -76,7 +69,6 @@ bool irsdk_startup()
 	if(!hMemMapFile)
 	{
 		hMemMapFile = OpenFileMapping( FILE_MAP_READ, FALSE, IRSDK_MEMMAPFILENAME);
-		lastTickCount = INT_MAX;
 	}
 
 	if(hMemMapFile)
@@ -85,7 +77,6 @@ bool irsdk_startup()
 		{
 			pSharedMem = (const char *)MapViewOfFile(hMemMapFile, FILE_MAP_READ, 0, 0, 0);
 			pHeader = (irsdk_header *)pSharedMem;
-			lastTickCount = INT_MAX;
 		}
 
 		if(pSharedMem)
@@ -93,11 +84,14 @@ bool irsdk_startup()
 			if(!hDataValidEvent)
 			{
 				hDataValidEvent = OpenEvent(SYNCHRONIZE, false, IRSDK_DATAVALIDEVENTNAME);
-				lastTickCount = INT_MAX;
 			}
 
 			if(hDataValidEvent)
 			{
+				// Objects opened since the last call start over from the
+				// current tick.
+				if(!isInitialized)
+					irsdk_attachSharedMem(pSharedMem);
 				isInitialized = true;
 				return isInitialized;
 			}
@@ -128,7 +122,7 @@ void irsdk_shutdown()
 	hMemMapFile = NULL;
 
 	isInitialized = false;
-	lastTickCount = INT_MAX;
+	irsdk_attachSharedMem(NULL);
 }
 
 bool irsdk_getNewData(char *data)
@@ -139,67 +133,29 @@ bool irsdk_getNewData(char *data)
 		_ASSERTE(NULL != pHeader);
 #endif
 
-		// if sim is not active, then no new data
-		if(!(pHeader->status & irsdk_stConnected))
-		{
-			lastTickCount = INT_MAX;
-			return false;
-		}
-
-		// A paused replay can keep publishing the same tick indefinitely. The
-		// connected header is still a valid heartbeat even when there is no new
-		// telemetry buffer to copy.
-		lastValidTime = time(NULL);
-
-		int latest = 0;
-		for(int i=1; i<pHeader->numBuf; i++)
-			if(pHeader->varBuf[latest].tickCount < pHeader->varBuf[i].tickCount)
-			   latest = i;	
-
-		// Seed the current buffer on first connection, even when the sim is
-		// paused and will not produce a newer tick until playback resumes.
-		// Subsequent reads still require a genuinely newer tick.
-		if(lastTickCount == INT_MAX || lastTickCount < pHeader->varBuf[latest].tickCount)
+		const int latest = irsdk_newestUnseenBuffer();
+		if(latest >= 0)
 		{
 			// if asked to retrieve the data
 			if(data)
 			{
-				// try twice to get the data out
-				for(int count = 0; count < 2; count++)
-				{
-					int curTickCount =  pHeader->varBuf[latest].tickCount;
-					memcpy(data, pSharedMem + pHeader->varBuf[latest].bufOffset, pHeader->bufLen);
-					if(curTickCount ==  pHeader->varBuf[latest].tickCount)
-					{
-						lastTickCount = curTickCount;
-						lastValidTime = time(NULL);
-						return true;
-					}
-				}
-				// if here, the data changed out from under us.
-				return false;
+				// if false, the data changed out from under every copy
+				return irsdk_copyNewestBuffer(data);
 			}
 			else
 			{
-				lastTickCount =  pHeader->varBuf[latest].tickCount;
-				lastValidTime = time(NULL);
+				irsdk_markBufferSeen(latest);
 				return true;
 			}
 		}
-		// if older than last recieved, than reset, we probably disconnected
-		else if(lastTickCount >  pHeader->varBuf[latest].tickCount)
-		{
-			lastTickCount =  pHeader->varBuf[latest].tickCount;
-			return false;
-		}
-		// else the same, and nothing changed this tick
+		else if(pHeader->status & irsdk_stConnected)
+			irsdk_countStaleRead();
 	}
 
 	return false;
 }
 
-
-bool irsdk_waitForDataReady(int timeOut, char *data)
+irsdk_waitResult irsdk_waitForNewTick(int timeOut)
 {
 #ifdef _MSC_VER
 	_ASSERTE(timeOut >= 0);
@@ -208,37 +164,41 @@ bool irsdk_waitForDataReady(int timeOut, char *data)
 	if(isInitialized || irsdk_startup())
 	{
 		// just to be sure, check before we sleep
-		if(irsdk_getNewData(data))
-			return true;
+		if(irsdk_newestUnseenBuffer() >= 0)
+			return irsdk_waitNewData;
 
 		// sleep till signaled
-		WaitForSingleObject(hDataValidEvent, timeOut);
+		const bool signaled = WaitForSingleObject(hDataValidEvent, timeOut) == WAIT_OBJECT_0;
 
 		// we woke up, so check for data
-		if(irsdk_getNewData(data))
-			return true;
-		else
-			return false;
+		if(irsdk_newestUnseenBuffer() >= 0)
+			return irsdk_waitNewData;
+		if(!(pHeader->status & irsdk_stConnected))
+			return irsdk_waitDisconnected;
+		return signaled ? irsdk_waitSignaled : irsdk_waitTimeout;
 	}
 
 	// sleep if error
 	if(timeOut > 0)
 		Sleep(timeOut);
 
-	return false;
+	return irsdk_waitDisconnected;
 }
 
-bool irsdk_isConnected()
+bool irsdk_waitForDataReady(int timeOut, char *data)
 {
-	if(isInitialized)
-	{
-		int elapsed = (int)difftime(time(NULL), lastValidTime);
-		return (pHeader->status & irsdk_stConnected) > 0 && elapsed < timeout;
-	}
+	// only pay for the copy once the header shows a new tick
+	if(irsdk_waitForNewTick(timeOut) == irsdk_waitNewData)
+		return irsdk_getNewData(data);
 
 	return false;
 }
 
+bool irsdk_isConnected()
+{
+	return irsdk_getConnectionState() != irsdk_connDisconnected;
+}
+
 const irsdk_header *irsdk_getHeader()
 {
 	if(isInitialized)
@@ -0,0 +1,479 @@
+#include "./irsdk_flight_recorder.h"
+
+#include <cstring>
+#include <limits>
+#include <system_error>
+
+#include "./irsdk_tape.h"
+#include "./irsdk_tape_events.h"
+
+namespace irdashies::irsdk_replay {
+namespace {
+
+constexpr std::uint64_t kNanosecondsPerSecond = 1000000000ULL;
+
+// Changed bytes closer together than a span header are stored as one span.
+constexpr std::size_t kSpanMergeBytes = 8;
+
+enum class EntryKind : std::uint8_t {
+  // A full frame; every group starts with one.
+  Keyframe = 1,
+  // Spans of the frame that differ from the previous one, each a
+  // DeltaSpan followed by its bytes.
+  Delta = 2,
+  SessionInfo = 3,
+  Disconnect = 4,
+};
+
+struct EntryHeader {
+  EntryKind kind;
+  std::uint8_t reserved[3];
+  std::int32_t tick;
+  std::int32_t value;
+  std::uint32_t size;
+  std::uint64_t elapsedTicks;
+};
+
+struct DeltaSpan {
+  std::uint32_t offset;
+  std::uint32_t length;
+};
+
+void appendBytes(std::vector<char>& out, const void* data, std::size_t size) {
+  const auto* bytes = static_cast<const char*>(data);
+  out.insert(out.end(), bytes, bytes + size);
+}
+
+void encodeDelta(
+    const char* previous,
+    const char* current,
+    std::size_t size,
+    std::vector<char>& out) {
+  std::size_t i = 0;
+  while (i < size) {
+    while (i + 8 <= size && std::memcmp(previous + i, current + i, 8) == 0) {
+      i += 8;
+    }
+    while (i < size && previous[i] == current[i]) {
+      ++i;
+    }
+    if (i >= size) {
+      break;
+    }
+
+    const std::size_t begin = i;
+    std::size_t end = i + 1;
+    for (std::size_t j = end; j < size && j - end < kSpanMergeBytes; ++j) {
+      if (previous[j] != current[j]) {
+        end = j + 1;
+      }
+    }
+    const DeltaSpan span{
+        static_cast<std::uint32_t>(begin),
+        static_cast<std::uint32_t>(end - begin)};
+    appendBytes(out, &span, sizeof(span));
+    appendBytes(out, current + begin, end - begin);
+    i = end;
+  }
+}
+
+bool applyDelta(const char* delta, std::size_t size, std::vector<char>& frame) {
+  std::size_t position = 0;
+  while (position < size) {
+    DeltaSpan span{};
+    if (size - position < sizeof(span)) {
+      return false;
+    }
+    std::memcpy(&span, delta + position, sizeof(span));
+    position += sizeof(span);
+    if (span.length > size - position || span.offset > frame.size() ||
+        span.length > frame.size() - span.offset) {
+      return false;
+    }
+    std::memcpy(frame.data() + span.offset, delta + position, span.length);
+    position += span.length;
+  }
+  return true;
+}
+
+}  // namespace
+
+struct FlightRecorderGroup {
+  // Session revision in effect when the group was opened.
+  std::shared_ptr<const std::vector<char>> session;
+  int sessionUpdate = 0;
+  // EntryHeader records, each followed by its payload.
+  std::vector<char> entries;
+  std::uint64_t firstElapsedTicks = 0;
+  std::uint64_t lastElapsedTicks = 0;
+  std::uint32_t frames = 0;
+  bool disconnected = false;
+
+  void append(
+      EntryKind kind,
+      std::uint64_t elapsedTicks,
+      std::int32_t tick,
+      std::int32_t value,
+      const void* payload,
+      std::size_t size) {
+    if (entries.empty()) {
+      firstElapsedTicks = elapsedTicks;
+    }
+    lastElapsedTicks = elapsedTicks;
+    EntryHeader header{};
+    header.kind = kind;
+    header.tick = tick;
+    header.value = value;
+    header.size = static_cast<std::uint32_t>(size);
+    header.elapsedTicks = elapsedTicks;
+    appendBytes(entries, &header, sizeof(header));
+    if (size > 0) {
+      appendBytes(entries, payload, size);
+    }
+  }
+};
+
+bool FlightRecorderWindow::write(
+    const std::filesystem::path& path,
+    std::uint64_t& frames,
+    std::string& error) const {
+  frames = 0;
+  if (groups_.empty()) {
+    error = "The flight recorder holds no frames";
+    return false;
+  }
+
+  std::uint64_t mappingSize = 0;
+  if (!validateSdkLayout(header_, variables_, mappingSize, error)) {
+    return false;
+  }
+  TapeWriter writer;
+  writer.enableFrameRepeats();
+  if (!writer.open(
+          path, header_, variables_, mappingSize, kNanosecondsPerSecond,
+          error)) {
+    return false;
+  }
+
+  const auto& first = *groups_.front();
+  const auto base = first.firstElapsedTicks;
+  auto includeSession = [&](std::size_t size) {
+    mappingSize = std::max(
+        mappingSize,
+        static_cast<std::uint64_t>(header_.sessionInfoOffset) + size);
+  };
+  if (first.session != nullptr) {
+    if (!writer.append(
+            RecordKind::SessionInfo,
+            0,
+            -1,
+            first.sessionUpdate,
+            first.session->empty() ? nullptr : first.session->data(),
+            static_cast<std::uint32_t>(first.session->size()),
+            error)) {
+      return false;
+    }
+    includeSession(first.session->size());
+  }
+
+  TapeEventDetector eventDetector(variables_);
+  std::vector<TapeEvent> events;
+  std::vector<char> frame(static_cast<std::size_t>(header_.bufLen));
+  std::int32_t lastTick = std::numeric_limits<std::int32_t>::min();
+  std::uint64_t lastElapsed = 0;
+  bool disconnected = false;
+
+  for (const auto& group : groups_) {
+    const auto& entries = group->entries;
+    std::size_t position = 0;
+    while (position < entries.size()) {
+      EntryHeader entry{};
+      std::memcpy(&entry, entries.data() + position, sizeof(entry));
+      const char* payload = entries.data() + position + sizeof(entry);
+      position += sizeof(entry) + entry.size;
+      const auto elapsed = entry.elapsedTicks - base;
+      lastElapsed = elapsed;
+
+      bool written = true;
+      switch (entry.kind) {
+        case EntryKind::Keyframe:
+        case EntryKind::Delta: {
+          if (entry.kind == EntryKind::Keyframe) {
+            std::memcpy(frame.data(), payload, frame.size());
+          } else if (!applyDelta(payload, entry.size, frame)) {
+            error = "Flight recorder frame delta is corrupt";
+            return false;
+          }
+          if (lastTick != std::numeric_limits<std::int32_t>::min() &&
+              entry.tick <= lastTick) {
+            break;
+          }
+          if (lastTick != std::numeric_limits<std::int32_t>::min() &&
+              entry.tick > lastTick + 1 &&
+              !writer.append(
+                  RecordKind::Gap,
+                  elapsed,
+                  entry.tick,
+                  entry.tick - lastTick - 1,
+                  nullptr,
+                  0,
+                  error)) {
+            return false;
+          }
+          const auto frameOffset = writer.nextRecordOffset();
+          written = writer.append(
+              RecordKind::Frame,
+              elapsed,
+              entry.tick,
+              entry.value,
+              frame.data(),
+              static_cast<std::uint32_t>(frame.size()),
+              error);
+          eventDetector.observe(
+              frame.data(), frameOffset, elapsed, entry.tick, events);
+          lastTick = entry.tick;
+          ++frames;
+          break;
+        }
+        case EntryKind::SessionInfo:
+          written = writer.append(
+              RecordKind::SessionInfo,
+              elapsed,
+              lastTick == std::numeric_limits<std::int32_t>::min()
+                  ? -1
+                  : lastTick,
+              entry.value,
+              entry.size == 0 ? nullptr : payload,
+              entry.size,
+              error);
+          includeSession(entry.size);
+          break;
+        case EntryKind::Disconnect:
+          written = writer.append(
+              RecordKind::Disconnect,
+              elapsed,
+              lastTick,
+              0,
+              nullptr,
+              0,
+              error);
+          disconnected = true;
+          break;
+      }
+      if (!written) {
+        return false;
+      }
+    }
+  }
+
+  return writer.append(
+             RecordKind::End,
+             lastElapsed,
+             lastTick,
+             disconnected ? 1 : 0,
+             nullptr,
+             0,
+             error) &&
+      writer.appendEventIndex(events, lastElapsed, error) &&
+      writer.finish(mappingSize, error);
+}
+
+FlightRecorder::FlightRecorder() = default;
+
+FlightRecorder::~FlightRecorder() = default;
+
+void FlightRecorder::configure(double seconds, std::size_t budgetBytes) {
+  seconds_ = seconds;
+  budgetBytes_ = budgetBytes;
+  if (!running_) {
+    running_ = true;
+    start_ = std::chrono::steady_clock::now();
+  }
+  trim();
+}
+
+void FlightRecorder::stop() {
+  clear();
+  running_ = false;
+}
+
+void FlightRecorder::frame(
+    const irsdk_header& header,
+    const irsdk_varHeader* variables,
+    const char* sessionInfo,
+    const char* frame,
+    int tick) {
+  if (!running_ || frame == nullptr) {
+    return;
+  }
+
+  irsdk_header current{};
+  std::memcpy(&current, &header, sizeof(current));
+  // A new connection, or a new layout, starts a new window. The previous one
+  // stays dumpable until then, so a disconnect keeps its lead-up.
+  if (active_ &&
+      (!sameFrameLayout(layout_, current) ||
+       (!groups_.empty() && groups_.back()->disconnected))) {
+    clear();
+  }
+  if (!active_) {
+    if (variables == nullptr || current.numVars <= 0 ||
+        current.numVars > 4096 || current.bufLen <= 0) {
+      return;
+    }
+    active_ = true;
+    layout_ = current;
+    variables_.assign(variables, variables + current.numVars);
+    session_.reset();
+    sessionUpdate_ = std::numeric_limits<int>::min();
+  }
+
+  const auto elapsedTicks = elapsedNanoseconds();
+  if (open_ == nullptr) {
+    open_ = std::make_unique<FlightRecorderGroup>();
+    open_->session = session_;
+    open_->sessionUpdate = sessionUpdate_;
+  }
+  const auto sizeBefore = open_->entries.size();
+
+  if (current.sessionInfoUpdate != sessionUpdate_ && sessionInfo != nullptr &&
+      current.sessionInfoLen >= 0 &&
+      static_cast<std::uint32_t>(current.sessionInfoLen) <= kMaxPayloadSize) {
+    session_ = std::make_shared<const std::vector<char>>(
+        sessionInfo, sessionInfo + current.sessionInfoLen);
+    sessionUpdate_ = current.sessionInfoUpdate;
+    open_->append(
+        EntryKind::SessionInfo,
+        elapsedTicks,
+        tick,
+        sessionUpdate_,
+        session_->data(),
+        session_->size());
+  }
+
+  int latest = 0;
+  for (int i = 1; i < current.numBuf && i < IRSDK_MAX_BUFS; ++i) {
+    if (current.varBuf[i].tickCount > current.varBuf[latest].tickCount) {
+      latest = i;
+    }
+  }
+  const auto size = static_cast<std::size_t>(current.bufLen);
+  if (open_->frames == 0 || previous_.size() != size) {
+    open_->append(EntryKind::Keyframe, elapsedTicks, tick, latest, frame, size);
+  } else {
+    delta_.clear();
+    encodeDelta(previous_.data(), frame, size, delta_);
+    open_->append(
+        EntryKind::Delta,
+        elapsedTicks,
+        tick,
+        latest,
+        delta_.data(),
+        delta_.size());
+  }
+  previous_.assign(frame, frame + size);
+  ++open_->frames;
+  ++frames_;
+  bytes_ += open_->entries.size() - sizeBefore;
+
+  if (open_->frames >= kFlightRecorderGroupFrames) {
+    seal();
+  }
+  trim();
+}
+
+void FlightRecorder::disconnect() {
+  if (!running_ || !active_ ||
+      (!groups_.empty() && groups_.back()->disconnected)) {
+    return;
+  }
+  if (open_ == nullptr) {
+    if (groups_.empty()) {
+      return;
+    }
+    open_ = std::make_unique<FlightRecorderGroup>();
+    open_->session = session_;
+    open_->sessionUpdate = sessionUpdate_;
+  }
+  const auto sizeBefore = open_->entries.size();
+  open_->append(
+      EntryKind::Disconnect, elapsedNanoseconds(), 0, 0, nullptr, 0);
+  open_->disconnected = true;
+  bytes_ += open_->entries.size() - sizeBefore;
+  seal();
+}
+
+FlightRecorderWindow FlightRecorder::snapshot() {
+  seal();
+  FlightRecorderWindow window;
+  if (!active_) {
+    return window;
+  }
+  window.header_ = layout_;
+  window.variables_ = variables_;
+  window.groups_.assign(groups_.begin(), groups_.end());
+  return window;
+}
+
+FlightRecorderStats FlightRecorder::stats() const {
+  FlightRecorderStats result;
+  result.frames = frames_;
+  result.bytes = bytes_;
+  result.budgetBytes = budgetBytes_;
+  if (!groups_.empty() || open_ != nullptr) {
+    const auto first = groups_.empty()
+        ? open_->firstElapsedTicks
+        : groups_.front()->firstElapsedTicks;
+    const auto last = open_ != nullptr
+        ? open_->lastElapsedTicks
+        : groups_.back()->lastElapsedTicks;
+    result.seconds = static_cast<double>(last - first) /
+        static_cast<double>(kNanosecondsPerSecond);
+  }
+  return result;
+}
+
+void FlightRecorder::clear() {
+  active_ = false;
+  previous_.clear();
+  session_.reset();
+  groups_.clear();
+  open_.reset();
+  bytes_ = 0;
+  frames_ = 0;
+}
+
+void FlightRecorder::seal() {
+  if (open_ == nullptr || open_->entries.empty()) {
+    return;
+  }
+  groups_.push_back(std::shared_ptr<const FlightRecorderGroup>(
+      open_.release()));
+  previous_.clear();
+}
+
+// Whole groups leave from the front once the window is over budget or their
+// newest frame has aged out. The open group always stays.
+void FlightRecorder::trim() {
+  const auto newest = open_ != nullptr
+      ? open_->lastElapsedTicks
+      : (groups_.empty() ? 0 : groups_.back()->lastElapsedTicks);
+  const auto window =
+      static_cast<std::uint64_t>(seconds_ * kNanosecondsPerSecond);
+  while (!groups_.empty() &&
+         (bytes_ > budgetBytes_ ||
+          newest - groups_.front()->lastElapsedTicks > window)) {
+    bytes_ -= groups_.front()->entries.size();
+    frames_ -= groups_.front()->frames;
+    groups_.pop_front();
+  }
+}
+
+std::uint64_t FlightRecorder::elapsedNanoseconds() const {
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start_)
+          .count());
+}
+
+}  // namespace irdashies::irsdk_replay
@@ -0,0 +1,114 @@
+#ifndef IRDASHIES_IRSDK_FLIGHT_RECORDER_H
+#define IRDASHIES_IRSDK_FLIGHT_RECORDER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../lib/irsdk_defines.h"
+
+namespace irdashies::irsdk_replay {
+
+constexpr double kDefaultFlightRecorderSeconds = 300;
+constexpr std::size_t kDefaultFlightRecorderBytes = 64U * 1024U * 1024U;
+
+// Frames per group. Each group starts with a full keyframe and stores the
+// rest as deltas, so the window is trimmed one group at a time.
+constexpr std::uint32_t kFlightRecorderGroupFrames = 300;
+
+struct FlightRecorderGroup;
+
+struct FlightRecorderStats {
+  std::uint64_t frames = 0;
+  // Time between the oldest and newest frame held.
+  double seconds = 0;
+  std::size_t bytes = 0;
+  std::size_t budgetBytes = 0;
+};
+
+// A frozen copy of the recorder's window. It shares the recorder's sealed
+// groups rather than copying them, so taking one is cheap, and it can be
+// written on another thread while the recorder keeps going.
+class FlightRecorderWindow {
+ public:
+  bool empty() const {
+    return groups_.empty();
+  }
+
+  // Writes the window as a complete tape: session info, frames with gaps
+  // and disconnects, an End record, and an event index. Elapsed time starts
+  // at the oldest frame.
+  bool write(
+      const std::filesystem::path& path,
+      std::uint64_t& frames,
+      std::string& error) const;
+
+ private:
+  friend class FlightRecorder;
+
+  irsdk_header header_{};
+  std::vector<irsdk_varHeader> variables_;
+  std::vector<std::shared_ptr<const FlightRecorderGroup>> groups_;
+};
+
+// Keeps the most recent frames and session revisions the addon copied, within
+// both a time window and a memory budget. Frames are stored as the byte spans
+// that changed since the previous frame. Not thread-safe: frame(),
+// disconnect(), and snapshot() belong to the telemetry thread.
+class FlightRecorder {
+ public:
+  FlightRecorder();
+  ~FlightRecorder();
+
+  void configure(double seconds, std::size_t budgetBytes);
+  bool running() const {
+    return running_;
+  }
+  // Drops the window and stops recording.
+  void stop();
+
+  // Same arguments as TapeTee::frame. A layout change starts a new window.
+  void frame(
+      const irsdk_header& header,
+      const irsdk_varHeader* variables,
+      const char* sessionInfo,
+      const char* frame,
+      int tick);
+  void disconnect();
+
+  FlightRecorderWindow snapshot();
+  FlightRecorderStats stats() const;
+
+ private:
+  void clear();
+  void seal();
+  void trim();
+  std::uint64_t elapsedNanoseconds() const;
+
+  bool running_ = false;
+  double seconds_ = kDefaultFlightRecorderSeconds;
+  std::size_t budgetBytes_ = kDefaultFlightRecorderBytes;
+  std::chrono::steady_clock::time_point start_;
+
+  bool active_ = false;
+  irsdk_header layout_{};
+  std::vector<irsdk_varHeader> variables_;
+  std::shared_ptr<const std::vector<char>> session_;
+  int sessionUpdate_ = 0;
+  std::vector<char> previous_;
+  std::vector<char> delta_;
+
+  std::deque<std::shared_ptr<const FlightRecorderGroup>> groups_;
+  std::unique_ptr<FlightRecorderGroup> open_;
+  std::size_t bytes_ = 0;
+  std::uint64_t frames_ = 0;
+};
+
+}  // namespace irdashies::irsdk_replay
+
+#endif
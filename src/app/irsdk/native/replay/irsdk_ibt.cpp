@@ -0,0 +1,130 @@
+#include "./irsdk_ibt.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "./irsdk_tape.h"
+
+namespace irdashies::irsdk_replay {
+
+bool IbtReader::open(
+    const std::filesystem::path& path,
+    std::string& error) {
+  close();
+  if (!file_.open(path, error)) {
+    return false;
+  }
+  if (!file_.contains(0, sizeof(irsdk_header) + sizeof(irsdk_diskSubHeader))) {
+    error = "File is too small to be an iRacing telemetry log";
+    close();
+    return false;
+  }
+
+  std::memcpy(&header_, file_.data(), sizeof(header_));
+  std::memcpy(
+      &diskHeader_,
+      file_.data() + sizeof(irsdk_header),
+      sizeof(diskHeader_));
+
+  if (header_.numVars <= 0 || header_.numVars > 4096 ||
+      header_.varHeaderOffset < 0 ||
+      !file_.contains(
+          static_cast<std::uint64_t>(header_.varHeaderOffset),
+          static_cast<std::uint64_t>(header_.numVars) *
+              sizeof(irsdk_varHeader))) {
+    error = "Invalid .ibt variable headers";
+    close();
+    return false;
+  }
+  variables_.resize(static_cast<std::size_t>(header_.numVars));
+  std::memcpy(
+      variables_.data(),
+      file_.data() + header_.varHeaderOffset,
+      variables_.size() * sizeof(irsdk_varHeader));
+
+  // Disk logs carry a single buffer; the shared-memory layout checks apply to
+  // its first sample.
+  std::uint64_t requiredSize = 0;
+  if (header_.numBuf != 1) {
+    error = "An .ibt file must have exactly one sample buffer";
+    close();
+    return false;
+  }
+  if (!validateSdkLayout(header_, variables_, requiredSize, error)) {
+    close();
+    return false;
+  }
+  if (requiredSize > file_.size()) {
+    error = "The .ibt file is truncated";
+    close();
+    return false;
+  }
+
+  samplesOffset_ = static_cast<std::uint64_t>(header_.varBuf[0].bufOffset);
+  const auto stride = static_cast<std::uint64_t>(header_.bufLen);
+  const auto available = (file_.size() - samplesOffset_) / stride;
+  // A log closed by a crash leaves sessionRecordCount at zero; the samples
+  // that reached disk are still usable.
+  sampleCount_ = static_cast<std::size_t>(
+      diskHeader_.sessionRecordCount > 0
+          ? std::min<std::uint64_t>(
+                available,
+                static_cast<std::uint64_t>(diskHeader_.sessionRecordCount))
+          : available);
+  return true;
+}
+
+void IbtReader::close() {
+  file_.close();
+  header_ = {};
+  diskHeader_ = {};
+  variables_.clear();
+  samplesOffset_ = 0;
+  sampleCount_ = 0;
+}
+
+const char* IbtReader::sessionInfo() const {
+  return file_.data() == nullptr
+      ? nullptr
+      : file_.data() + header_.sessionInfoOffset;
+}
+
+std::size_t IbtReader::sessionInfoLength() const {
+  const char* text = sessionInfo();
+  if (text == nullptr) {
+    return 0;
+  }
+  // sessionInfoLen counts the reserved area; the YAML ends at the first NUL.
+  const auto reserved = static_cast<std::size_t>(header_.sessionInfoLen);
+  const auto* end = static_cast<const char*>(std::memchr(text, '\0', reserved));
+  return end == nullptr ? reserved : static_cast<std::size_t>(end - text);
+}
+
+const char* IbtReader::sample(std::size_t index) const {
+  if (index >= sampleCount_) {
+    return nullptr;
+  }
+  return file_.data() + samplesOffset_ +
+      static_cast<std::uint64_t>(index) *
+          static_cast<std::uint64_t>(header_.bufLen);
+}
+
+double IbtReader::sampleSeconds(std::size_t index) const {
+  return static_cast<double>(index) / static_cast<double>(header_.tickRate);
+}
+
+std::size_t IbtReader::sampleAt(double seconds) const {
+  if (sampleCount_ == 0 || !(seconds > 0)) {
+    return 0;
+  }
+  // The tolerance keeps a time computed from a sample index, such as
+  // 3.0 / 60 * 60, from rounding down to the previous sample.
+  const double position =
+      std::floor(seconds * static_cast<double>(header_.tickRate) + 1e-6);
+  return position >= static_cast<double>(sampleCount_ - 1)
+      ? sampleCount_ - 1
+      : static_cast<std::size_t>(position);
+}
+
+}  // namespace irdashies::irsdk_replay
@@ -0,0 +1,64 @@
+#ifndef IRDASHIES_IRSDK_IBT_H
+#define IRDASHIES_IRSDK_IBT_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "../lib/irsdk_defines.h"
+#include "./irsdk_mapped_file.h"
+
+namespace irdashies::irsdk_replay {
+
+// Memory-mapped reader for iRacing's disk telemetry (.ibt). The file holds an
+// irsdk_header, an irsdk_diskSubHeader, the variable headers and session
+// string at the header's offsets, then fixed-stride bufLen samples starting
+// at varBuf[0].bufOffset.
+class IbtReader {
+ public:
+  bool open(const std::filesystem::path& path, std::string& error);
+  void close();
+
+  const irsdk_header& header() const {
+    return header_;
+  }
+
+  const irsdk_diskSubHeader& diskHeader() const {
+    return diskHeader_;
+  }
+
+  const std::vector<irsdk_varHeader>& variables() const {
+    return variables_;
+  }
+
+  // The embedded session YAML. It is not guaranteed to be NUL-terminated.
+  const char* sessionInfo() const;
+  std::size_t sessionInfoLength() const;
+
+  std::size_t sampleCount() const {
+    return sampleCount_;
+  }
+
+  // Samples are fixed-stride, so any index is a pointer computation into the
+  // mapping. Returns nullptr past the last sample.
+  const char* sample(std::size_t index) const;
+
+  // Recorded time of a sample, measured from the first one at tickRate.
+  double sampleSeconds(std::size_t index) const;
+
+  // Last sample at or before the given recorded time.
+  std::size_t sampleAt(double seconds) const;
+
+ private:
+  MappedFile file_;
+  irsdk_header header_{};
+  irsdk_diskSubHeader diskHeader_{};
+  std::vector<irsdk_varHeader> variables_;
+  std::uint64_t samplesOffset_ = 0;
+  std::size_t sampleCount_ = 0;
+};
+
+}  // namespace irdashies::irsdk_replay
+
+#endif
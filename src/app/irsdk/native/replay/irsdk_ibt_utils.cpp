@@ -0,0 +1,527 @@
+#include "./irsdk_ibt.h"
+#include "./irsdk_tape_events.h"
+#include "./irsdk_tape_playback.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace replay = irdashies::irsdk_replay;
+
+namespace {
+
+constexpr std::size_t kNoSample = std::numeric_limits<std::size_t>::max();
+
+enum class PlaybackState {
+  Stopped,
+  Playing,
+  NeedsDisconnectSignal,
+  ReadyToLoop,
+  Finished,
+  Failed,
+};
+
+std::unique_ptr<replay::IbtReader> ibt;
+irsdk_header header{};
+std::vector<char> frame;
+std::vector<char> session;
+std::size_t nextSample = 0;
+std::size_t publishedSample = kNoSample;
+PlaybackState state = PlaybackState::Stopped;
+std::chrono::steady_clock::time_point playbackStart;
+// Zero delivers one sample per read as fast as the consumer asks.
+double playbackSpeed = 0;
+bool loopPlayback = false;
+bool seekFramePending = false;
+// Set when irsdk_waitForNewTick() published a frame that irsdk_getNewData()
+// has not copied out yet.
+bool frameWaiting = false;
+bool paused = false;
+
+// Events found by scanning every sample on the first event query. An .ibt
+// has no record offsets, so recordOffset and elapsedTicks hold the sample
+// index.
+std::vector<replay::TapeEvent> events;
+bool eventsScanned = false;
+
+replay::LatencyHistogram publishLateness;
+replay::LatencyHistogram frameInterval;
+std::chrono::steady_clock::time_point lastFramePublish;
+bool hasLastFramePublish = false;
+
+bool parsePlaybackOptions(std::string& error) {
+  const char* speedText = std::getenv("IRDASHIES_TELEMETRY_REPLAY_SPEED");
+  if (speedText != nullptr && speedText[0] != '\0') {
+    char* end = nullptr;
+    const double parsed = std::strtod(speedText, &end);
+    if (end == speedText || end == nullptr || *end != '\0' ||
+        !std::isfinite(parsed) || parsed < 0.25 || parsed > 100.0) {
+      error = "IRDASHIES_TELEMETRY_REPLAY_SPEED must be between 0.25 and 100";
+      return false;
+    }
+    playbackSpeed = parsed;
+  } else {
+    playbackSpeed = 0;
+  }
+
+  const char* loopText = std::getenv("IRDASHIES_TELEMETRY_REPLAY_LOOP");
+  loopPlayback = loopText != nullptr && std::strcmp(loopText, "1") == 0;
+  return true;
+}
+
+bool paced() {
+  return playbackSpeed > 0;
+}
+
+std::chrono::steady_clock::duration playbackOffset(std::size_t sample) {
+  return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(ibt->sampleSeconds(sample) / playbackSpeed));
+}
+
+// Re-anchors the playback clock so the next sample is due now.
+void rebasePlaybackClock() {
+  if (paced()) {
+    playbackStart = std::chrono::steady_clock::now() - playbackOffset(nextSample);
+  }
+  hasLastFramePublish = false;
+}
+
+void resetPublishedData() {
+  header = ibt->header();
+  header.status = irsdk_stConnected;
+  header.varBuf[0].tickCount = -1;
+  header.sessionInfoUpdate = std::max(header.sessionInfoUpdate, 0);
+
+  const auto sessionLength = ibt->sessionInfoLength();
+  session.assign(sessionLength + 1, '\0');
+  if (sessionLength > 0) {
+    std::memcpy(session.data(), ibt->sessionInfo(), sessionLength);
+  }
+  header.sessionInfoLen = static_cast<int>(sessionLength);
+
+  frame.assign(static_cast<std::size_t>(header.bufLen), 0);
+  nextSample = 0;
+  publishedSample = kNoSample;
+  seekFramePending = false;
+  hasLastFramePublish = false;
+  playbackStart = std::chrono::steady_clock::now();
+  state = PlaybackState::Playing;
+}
+
+bool openLog(std::string& error) {
+  const char* input = std::getenv("IRDASHIES_TELEMETRY_IBT");
+  if (input == nullptr || input[0] == '\0') {
+    error = "IRDASHIES_TELEMETRY_IBT is not set";
+    return false;
+  }
+  if (!parsePlaybackOptions(error)) {
+    return false;
+  }
+
+  auto candidate = std::make_unique<replay::IbtReader>();
+  if (!candidate->open(std::filesystem::path(input), error)) {
+    return false;
+  }
+  if (candidate->sampleCount() == 0) {
+    error = "The .ibt file does not contain any samples";
+    return false;
+  }
+  ibt = std::move(candidate);
+  publishLateness.reset();
+  frameInterval.reset();
+  resetPublishedData();
+  return true;
+}
+
+void finishPlayback(bool frameWillBePublished) {
+  header.status = 0;
+  if (!loopPlayback) {
+    state = PlaybackState::Finished;
+  } else {
+    state = frameWillBePublished
+        ? PlaybackState::NeedsDisconnectSignal
+        : PlaybackState::ReadyToLoop;
+  }
+}
+
+std::uint64_t elapsedNanoseconds(std::chrono::steady_clock::duration elapsed) {
+  const auto nanoseconds =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  return nanoseconds < 0 ? 0 : static_cast<std::uint64_t>(nanoseconds);
+}
+
+void recordFrameTiming(std::size_t sample) {
+  const auto now = std::chrono::steady_clock::now();
+  if (paced()) {
+    publishLateness.record(
+        elapsedNanoseconds(now - (playbackStart + playbackOffset(sample))));
+  }
+  if (hasLastFramePublish) {
+    frameInterval.record(elapsedNanoseconds(now - lastFramePublish));
+  }
+  lastFramePublish = now;
+  hasLastFramePublish = true;
+}
+
+void printSummary(const char* label, const replay::LatencySummary& summary) {
+  std::cerr << "  " << label << " ms: p50 " << summary.p50Ns / 1e6
+            << ", p99 " << summary.p99Ns / 1e6
+            << ", p99.9 " << summary.p999Ns / 1e6
+            << ", max " << summary.maxNs / 1e6 << '\n';
+}
+
+void printPlaybackStats() {
+  if (frameInterval.count() == 0) {
+    return;
+  }
+  std::cerr << "Telemetry .ibt playback timing over "
+            << frameInterval.count() + 1 << " frames\n";
+  if (publishLateness.count() > 0) {
+    printSummary("lateness", publishLateness.summary());
+  }
+  printSummary("frame interval", frameInterval.summary());
+}
+
+void publishSample(std::size_t sample, char* destination) {
+  std::memcpy(frame.data(), ibt->sample(sample), frame.size());
+  if (destination != nullptr) {
+    std::memcpy(destination, frame.data(), frame.size());
+  }
+  header.varBuf[0].tickCount = static_cast<int>(sample);
+  publishedSample = sample;
+  nextSample = sample + 1;
+}
+
+bool readTimedFrame(int timeoutMs, char* destination) {
+  const auto deadline = std::chrono::steady_clock::now() +
+      std::chrono::milliseconds(std::max(timeoutMs, 0));
+
+  if (state == PlaybackState::Playing && seekFramePending) {
+    seekFramePending = false;
+    if (destination != nullptr) {
+      std::memcpy(destination, frame.data(), frame.size());
+    }
+    return true;
+  }
+  if (state == PlaybackState::Playing && paused) {
+    std::this_thread::sleep_until(deadline);
+    return false;
+  }
+
+  while (state == PlaybackState::Playing) {
+    if (nextSample >= ibt->sampleCount()) {
+      finishPlayback(false);
+      return false;
+    }
+    if (!paced()) {
+      publishSample(nextSample, destination);
+      recordFrameTiming(publishedSample);
+      return true;
+    }
+
+    const auto target = playbackStart + playbackOffset(nextSample);
+    const auto now = std::chrono::steady_clock::now();
+    if (target > now) {
+      if (now >= deadline) {
+        return false;
+      }
+      std::this_thread::sleep_for(std::min(target - now, deadline - now));
+      continue;
+    }
+
+    // Samples are random access, so a late reader jumps straight to the
+    // newest due sample instead of copying each one it missed.
+    const double dueSeconds =
+        std::chrono::duration<double>(now - playbackStart).count() *
+        playbackSpeed;
+    const auto due = std::clamp(
+        ibt->sampleAt(dueSeconds), nextSample, ibt->sampleCount() - 1);
+    publishSample(due, destination);
+    recordFrameTiming(due);
+    return true;
+  }
+  return false;
+}
+
+bool ensurePlaying(std::string& error) {
+  if (ibt == nullptr || state == PlaybackState::Stopped ||
+      state == PlaybackState::Failed) {
+    error = "Telemetry .ibt playback is not running";
+    return false;
+  }
+  return true;
+}
+
+bool publishSeekSample(std::size_t sample) {
+  publishSample(sample, nullptr);
+  header.status = irsdk_stConnected;
+  state = PlaybackState::Playing;
+  seekFramePending = true;
+  frameWaiting = false;
+  rebasePlaybackClock();
+  return true;
+}
+
+bool ensurePlaybackEvents(std::string& error) {
+  if (!ensurePlaying(error)) {
+    return false;
+  }
+  if (!eventsScanned) {
+    replay::TapeEventDetector detector(ibt->variables());
+    for (std::size_t sample = 0;
+         detector.tracking() && sample < ibt->sampleCount();
+         ++sample) {
+      detector.observe(
+          ibt->sample(sample),
+          sample,
+          sample,
+          static_cast<std::int32_t>(sample),
+          events);
+    }
+    eventsScanned = true;
+  }
+  if (events.empty()) {
+    error = "The .ibt file has none of the variables events are built from";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+namespace irdashies::irsdk_replay {
+
+bool setPlaybackPaused(bool pause, std::string& error) {
+  if (ibt == nullptr || state == PlaybackState::Failed) {
+    error = "Telemetry .ibt playback is not running";
+    return false;
+  }
+  if (paused && !pause) {
+    rebasePlaybackClock();
+  }
+  paused = pause;
+  return true;
+}
+
+bool stepPlayback(int frames, std::string& error) {
+  if (!ensurePlaying(error)) {
+    return false;
+  }
+  const auto current = publishedSample == kNoSample
+      ? std::int64_t{0}
+      : static_cast<std::int64_t>(publishedSample);
+  const auto last = static_cast<std::int64_t>(ibt->sampleCount()) - 1;
+  return publishSeekSample(static_cast<std::size_t>(
+      std::clamp<std::int64_t>(current + frames, 0, last)));
+}
+
+bool seekPlayback(double seconds, std::string& error) {
+  if (!std::isfinite(seconds)) {
+    error = "Seek offset must be a finite number of seconds";
+    return false;
+  }
+  if (!ensurePlaying(error)) {
+    return false;
+  }
+  const auto current = publishedSample == kNoSample ? 0 : publishedSample;
+  return publishSeekSample(
+      ibt->sampleAt(ibt->sampleSeconds(current) + seconds));
+}
+
+bool playbackEvents(std::vector<PlaybackEvent>& list, std::string& error) {
+  list.clear();
+  if (!ensurePlaybackEvents(error)) {
+    return false;
+  }
+  list.reserve(events.size());
+  for (const auto& event : events) {
+    list.push_back(
+        {static_cast<TapeEventKind>(event.kind),
+         event.value,
+         ibt->sampleSeconds(static_cast<std::size_t>(event.recordOffset)),
+         event.sourceTick});
+  }
+  return true;
+}
+
+bool seekPlaybackEvent(
+    TapeEventKind kind,
+    std::int32_t value,
+    std::string& error) {
+  if (!ensurePlaybackEvents(error)) {
+    return false;
+  }
+  const auto match = findTapeEvent(events, kind, value);
+  if (match == events.size()) {
+    error = std::string("No ") + tapeEventKindName(kind) +
+        " event matches " + std::to_string(value);
+    return false;
+  }
+  return publishSeekSample(static_cast<std::size_t>(events[match].recordOffset));
+}
+
+PlaybackStats playbackStats() {
+  return {publishLateness.summary(), frameInterval.summary()};
+}
+
+}  // namespace irdashies::irsdk_replay
+
+bool irsdk_startup() {
+  if (state == PlaybackState::Playing) {
+    return true;
+  }
+  if (state == PlaybackState::NeedsDisconnectSignal) {
+    state = loopPlayback
+        ? PlaybackState::ReadyToLoop
+        : PlaybackState::Finished;
+    return false;
+  }
+
+  std::string error;
+  if (state == PlaybackState::ReadyToLoop) {
+    resetPublishedData();
+    return true;
+  }
+  if (state == PlaybackState::Stopped) {
+    if (openLog(error)) {
+      return true;
+    }
+  } else {
+    return false;
+  }
+
+  std::cerr << "Could not start telemetry .ibt playback: " << error << '\n';
+  state = PlaybackState::Failed;
+  return false;
+}
+
+void irsdk_shutdown() {
+  if (ibt != nullptr) {
+    printPlaybackStats();
+  }
+  ibt.reset();
+  frame.clear();
+  session.clear();
+  events.clear();
+  eventsScanned = false;
+  seekFramePending = false;
+  frameWaiting = false;
+  paused = false;
+  header = {};
+  state = PlaybackState::Stopped;
+}
+
+bool irsdk_getNewData(char* data) {
+  if (frameWaiting) {
+    frameWaiting = false;
+    if (data != nullptr) {
+      std::memcpy(data, frame.data(), frame.size());
+    }
+    return true;
+  }
+  return readTimedFrame(1, data);
+}
+
+bool irsdk_waitForDataReady(int timeoutMs, char* data) {
+  if (state != PlaybackState::Playing && !irsdk_startup()) {
+    return false;
+  }
+  if (frameWaiting) {
+    return irsdk_getNewData(data);
+  }
+  return readTimedFrame(timeoutMs, data);
+}
+
+irsdk_waitResult irsdk_waitForNewTick(int timeoutMs) {
+  if (state != PlaybackState::Playing && !irsdk_startup()) {
+    return irsdk_waitDisconnected;
+  }
+  if (frameWaiting || readTimedFrame(timeoutMs, nullptr)) {
+    frameWaiting = true;
+    return irsdk_waitNewData;
+  }
+  return irsdk_isConnected() ? irsdk_waitTimeout : irsdk_waitDisconnected;
+}
+
+bool irsdk_isConnected() {
+  return state == PlaybackState::Playing &&
+      (header.status & irsdk_stConnected) != 0;
+}
+
+irsdk_connectionState irsdk_getConnectionState() {
+  return irsdk_isConnected() ? irsdk_connConnected : irsdk_connDisconnected;
+}
+
+const irsdk_header* irsdk_getHeader() {
+  return ibt == nullptr ? nullptr : &header;
+}
+
+const char* irsdk_getData(int index) {
+  if (index < 0 || index >= header.numBuf || frame.empty()) {
+    return nullptr;
+  }
+  return frame.data();
+}
+
+const char* irsdk_getSessionInfoStr() {
+  return session.empty() ? nullptr : session.data();
+}
+
+int irsdk_getSessionInfoStrUpdate() {
+  return session.size() <= 1 ? -1 : header.sessionInfoUpdate;
+}
+
+const irsdk_varHeader* irsdk_getVarHeaderPtr() {
+  if (ibt == nullptr || ibt->variables().empty()) {
+    return nullptr;
+  }
+  return ibt->variables().data();
+}
+
+const irsdk_varHeader* irsdk_getVarHeaderEntry(int index) {
+  if (ibt == nullptr || index < 0 ||
+      index >= static_cast<int>(ibt->variables().size())) {
+    return nullptr;
+  }
+  return &ibt->variables()[static_cast<std::size_t>(index)];
+}
+
+int irsdk_varNameToIndex(const char* name) {
+  if (name == nullptr || ibt == nullptr) {
+    return -1;
+  }
+  const auto& variables = ibt->variables();
+  for (std::size_t index = 0; index < variables.size(); ++index) {
+    if (std::strncmp(name, variables[index].name, IRSDK_MAX_STRING) == 0) {
+      return static_cast<int>(index);
+    }
+  }
+  return -1;
+}
+
+int irsdk_varNameToOffset(const char* name) {
+  const int index = irsdk_varNameToIndex(name);
+  const auto* variable = irsdk_getVarHeaderEntry(index);
+  return variable == nullptr ? -1 : variable->offset;
+}
+
+void irsdk_broadcastMsg(irsdk_BroadcastMsg, int, int, int) {}
+void irsdk_broadcastMsg(irsdk_BroadcastMsg, int, int) {}
+void irsdk_broadcastMsg(irsdk_BroadcastMsg, int, float) {}
+
+int irsdk_padCarNum(int num, int zero) {
+  int places = num > 99 ? 3 : (num > 9 ? 2 : 1);
+  if (zero == 0) {
+    return num;
+  }
+  places += zero;
+  return num + 1000 * places;
+}
@@ -0,0 +1,95 @@
+#include "./irsdk_latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace irdashies::irsdk_replay {
+namespace {
+
+int highestBit(std::uint64_t value) {
+  int bit = 63;
+  while ((value & (1ULL << bit)) == 0) {
+    --bit;
+  }
+  return bit;
+}
+
+}  // namespace
+
+std::size_t LatencyHistogram::bucketIndex(std::uint64_t value) {
+  if (value < kSubBucketCount) {
+    return static_cast<std::size_t>(value);
+  }
+  // Shift so the value lands in [kSubBucketHalf, kSubBucketCount).
+  const int shift = highestBit(value) - (kSubBucketBits - 1);
+  return static_cast<std::size_t>(
+      kSubBucketCount + static_cast<std::uint64_t>(shift - 1) * kSubBucketHalf +
+      ((value >> shift) - kSubBucketHalf));
+}
+
+std::uint64_t LatencyHistogram::bucketUpperBound(std::size_t index) {
+  if (index < kSubBucketCount) {
+    return index;
+  }
+  const auto offset = static_cast<std::uint64_t>(index) - kSubBucketCount;
+  const int shift = static_cast<int>(offset / kSubBucketHalf) + 1;
+  const auto subBucket = offset % kSubBucketHalf + kSubBucketHalf;
+  const auto lower = subBucket << shift;
+  return lower + ((1ULL << shift) - 1);
+}
+
+void LatencyHistogram::record(std::uint64_t nanoseconds) {
+  ++counts_[bucketIndex(nanoseconds)];
+  if (count_ == 0 || nanoseconds < min_) {
+    min_ = nanoseconds;
+  }
+  max_ = std::max(max_, nanoseconds);
+  sum_ += static_cast<long double>(nanoseconds);
+  ++count_;
+}
+
+void LatencyHistogram::reset() {
+  counts_.fill(0);
+  count_ = 0;
+  min_ = 0;
+  max_ = 0;
+  sum_ = 0;
+}
+
+std::uint64_t LatencyHistogram::valueAtPercentile(double percentile) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  const double clamped = std::clamp(percentile, 0.0, 100.0);
+  const auto rank = std::max<std::uint64_t>(
+      1,
+      static_cast<std::uint64_t>(
+          std::ceil(clamped / 100.0 * static_cast<double>(count_))));
+
+  std::uint64_t seen = 0;
+  for (std::size_t index = 0; index < counts_.size(); ++index) {
+    seen += counts_[index];
+    if (seen >= rank) {
+      return std::min(bucketUpperBound(index), max_);
+    }
+  }
+  return max_;
+}
+
+LatencySummary LatencyHistogram::summary() const {
+  LatencySummary result;
+  result.count = count_;
+  if (count_ == 0) {
+    return result;
+  }
+  result.minNs = min_;
+  result.maxNs = max_;
+  result.meanNs = static_cast<double>(sum_ / static_cast<long double>(count_));
+  result.p50Ns = valueAtPercentile(50);
+  result.p90Ns = valueAtPercentile(90);
+  result.p99Ns = valueAtPercentile(99);
+  result.p999Ns = valueAtPercentile(99.9);
+  return result;
+}
+
+}  // namespace irdashies::irsdk_replay
@@ -0,0 +1,57 @@
+#ifndef IRDASHIES_IRSDK_LATENCY_HISTOGRAM_H
+#define IRDASHIES_IRSDK_LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <cstdint>
+
+namespace irdashies::irsdk_replay {
+
+struct LatencySummary {
+  std::uint64_t count = 0;
+  std::uint64_t minNs = 0;
+  std::uint64_t maxNs = 0;
+  double meanNs = 0;
+  std::uint64_t p50Ns = 0;
+  std::uint64_t p90Ns = 0;
+  std::uint64_t p99Ns = 0;
+  std::uint64_t p999Ns = 0;
+};
+
+// Log-linear histogram in the HdrHistogram layout: values below 128 ns get
+// their own bucket, and every larger power of two is split into 64 linear
+// buckets. Any nanosecond value fits, each is kept within 1/64 of its true
+// value, and recording is a few shifts with no allocation.
+class LatencyHistogram {
+ public:
+  void record(std::uint64_t nanoseconds);
+  void reset();
+
+  std::uint64_t count() const {
+    return count_;
+  }
+
+  // Highest value equivalent to the one at the given percentile (0-100).
+  std::uint64_t valueAtPercentile(double percentile) const;
+
+  LatencySummary summary() const;
+
+ private:
+  static constexpr int kSubBucketBits = 7;
+  static constexpr std::uint64_t kSubBucketCount = 1ULL << kSubBucketBits;
+  static constexpr std::uint64_t kSubBucketHalf = kSubBucketCount / 2;
+  static constexpr std::size_t kBucketCount =
+      kSubBucketCount + (64 - kSubBucketBits) * kSubBucketHalf;
+
+  static std::size_t bucketIndex(std::uint64_t value);
+  static std::uint64_t bucketUpperBound(std::size_t index);
+
+  std::array<std::uint64_t, kBucketCount> counts_{};
+  std::uint64_t count_ = 0;
+  std::uint64_t min_ = 0;
+  std::uint64_t max_ = 0;
+  long double sum_ = 0;
+};
+
+}  // namespace irdashies::irsdk_replay
+
+#endif
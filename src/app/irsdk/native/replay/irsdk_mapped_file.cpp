@@ -0,0 +1,126 @@
+#include "./irsdk_mapped_file.h"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace irdashies::irsdk_replay {
+
+MappedFile::~MappedFile() {
+  close();
+}
+
+#if defined(_WIN32)
+bool MappedFile::open(
+    const std::filesystem::path& path,
+    std::string& error) {
+  close();
+  HANDLE file = CreateFileW(
+      path.c_str(),
+      GENERIC_READ,
+      FILE_SHARE_READ,
+      nullptr,
+      OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL,
+      nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    error = "Could not open " + path.string();
+    return false;
+  }
+  LARGE_INTEGER fileSize{};
+  if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) {
+    CloseHandle(file);
+    error = "File is empty: " + path.string();
+    return false;
+  }
+
+  HANDLE mapping =
+      CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping == nullptr) {
+    CloseHandle(file);
+    error = "Could not map " + path.string();
+    return false;
+  }
+  const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (view == nullptr) {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    error = "Could not map " + path.string();
+    return false;
+  }
+
+  fileHandle_ = file;
+  mappingHandle_ = mapping;
+  data_ = static_cast<const char*>(view);
+  size_ = static_cast<std::uint64_t>(fileSize.QuadPart);
+  return true;
+}
+
+void MappedFile::close() {
+  if (data_ != nullptr) {
+    UnmapViewOfFile(data_);
+  }
+  if (mappingHandle_ != nullptr) {
+    CloseHandle(static_cast<HANDLE>(mappingHandle_));
+  }
+  if (fileHandle_ != nullptr) {
+    CloseHandle(static_cast<HANDLE>(fileHandle_));
+  }
+  data_ = nullptr;
+  size_ = 0;
+  mappingHandle_ = nullptr;
+  fileHandle_ = nullptr;
+}
+#else
+bool MappedFile::open(
+    const std::filesystem::path& path,
+    std::string& error) {
+  close();
+  const int descriptor = ::open(path.c_str(), O_RDONLY);
+  if (descriptor < 0) {
+    error = "Could not open " + path.string();
+    return false;
+  }
+  struct stat status {};
+  if (fstat(descriptor, &status) != 0 || status.st_size <= 0) {
+    ::close(descriptor);
+    error = "File is empty: " + path.string();
+    return false;
+  }
+
+  void* view = mmap(
+      nullptr,
+      static_cast<std::size_t>(status.st_size),
+      PROT_READ,
+      MAP_SHARED,
+      descriptor,
+      0);
+  ::close(descriptor);
+  if (view == MAP_FAILED) {
+    error = "Could not map " + path.string();
+    return false;
+  }
+
+  data_ = static_cast<const char*>(view);
+  size_ = static_cast<std::uint64_t>(status.st_size);
+  return true;
+}
+
+void MappedFile::close() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), static_cast<std::size_t>(size_));
+  }
+  data_ = nullptr;
+  size_ = 0;
+}
+#endif
+
+}  // namespace irdashies::irsdk_replay
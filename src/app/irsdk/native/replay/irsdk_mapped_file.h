@@ -0,0 +1,46 @@
+#ifndef IRDASHIES_IRSDK_MAPPED_FILE_H
+#define IRDASHIES_IRSDK_MAPPED_FILE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace irdashies::irsdk_replay {
+
+// Read-only view of a whole file. Pages are loaded on first touch, so random
+// access into large logs costs only the pages actually read.
+class MappedFile {
+ public:
+  MappedFile() = default;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  bool open(const std::filesystem::path& path, std::string& error);
+  void close();
+
+  const char* data() const {
+    return data_;
+  }
+
+  std::uint64_t size() const {
+    return size_;
+  }
+
+  // True when [offset, offset + length) lies inside the file.
+  bool contains(std::uint64_t offset, std::uint64_t length) const {
+    return offset <= size_ && length <= size_ - offset;
+  }
+
+ private:
+  const char* data_ = nullptr;
+  std::uint64_t size_ = 0;
+#if defined(_WIN32)
+  void* fileHandle_ = nullptr;
+  void* mappingHandle_ = nullptr;
+#endif
+};
+
+}  // namespace irdashies::irsdk_replay
+
+#endif
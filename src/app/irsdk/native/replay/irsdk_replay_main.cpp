@@ -1,3 +1,4 @@
+#if defined(_WIN32)
 #ifndef NOMINMAX
 #define NOMINMAX
 #endif
@@ -5,6 +6,13 @@
 #define _UNICODE
 
 #include <windows.h>
+#else
+#include <signal.h>
+#include <unistd.h>
+
+#include <clocale>
+#include <cstdlib>
+#endif
 
 #include <algorithm>
 #include <array>
@@ -16,6 +24,7 @@
 #include <cstdint>
 #include <cstring>
 #include <filesystem>
+#include <iomanip>
 #include <iostream>
 #include <limits>
 #include <optional>
@@ -24,8 +33,14 @@
 #include <thread>
 #include <vector>
 
+#if defined(_WIN32)
 #include "../lib/irsdk_shared_objects.h"
+#else
+#include "../lib/irsdk_posix_shm.h"
+#endif
 #include "./irsdk_tape.h"
+#include "./irsdk_tape_events.h"
+#include "./irsdk_tape_stats.h"
 
 namespace replay = irdashies::irsdk_replay;
 
@@ -33,12 +48,19 @@ namespace {
 
 std::atomic_bool stopRequested = false;
 
+#if defined(_WIN32)
+using ObjectName = const wchar_t*;
+#else
+using ObjectName = const char*;
+#endif
+
 struct SharedObjectNames {
-  const wchar_t* mapping;
-  const wchar_t* event;
+  ObjectName mapping;
+  ObjectName event;
   const char* owner;
 };
 
+#if defined(_WIN32)
 constexpr SharedObjectNames kIRacingObjectNames = {
     IRDASHIES_IRSDK_PRODUCTION_MAPPING_NAME,
     IRDASHIES_IRSDK_PRODUCTION_EVENT_NAME,
@@ -64,6 +86,29 @@ std::string windowsError(const char* operation) {
   return message.str();
 }
 
+void memoryBarrier() {
+  MemoryBarrier();
+}
+#else
+constexpr SharedObjectNames kIRacingObjectNames = {
+    IRDASHIES_IRSDK_POSIX_PRODUCTION_MAPPING_NAME,
+    IRDASHIES_IRSDK_POSIX_PRODUCTION_EVENT_NAME,
+    "iRacing"};
+
+constexpr SharedObjectNames kIsolatedReplayObjectNames = {
+    IRDASHIES_IRSDK_POSIX_REPLAY_MAPPING_NAME,
+    IRDASHIES_IRSDK_POSIX_REPLAY_EVENT_NAME,
+    "irDashies replay"};
+
+void handleTerminationSignal(int) {
+  stopRequested.store(true);
+}
+
+void memoryBarrier() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+#endif
+
 std::optional<std::wstring> optionValue(
     const std::vector<std::wstring>& arguments,
     const std::wstring& name) {
@@ -121,6 +166,7 @@ bool sameLayout(
   return true;
 }
 
+#if defined(_WIN32)
 bool readableMappedRange(
     const char* mappingBase,
     std::uint64_t offset,
@@ -162,63 +208,17 @@ bool readableMappedRange(
   return true;
 }
 
-std::uint64_t elapsedCounter(const LARGE_INTEGER& start) {
-  LARGE_INTEGER now{};
-  QueryPerformanceCounter(&now);
-  return static_cast<std::uint64_t>(now.QuadPart - start.QuadPart);
+// Tape timestamps count QueryPerformanceCounter ticks.
+std::uint64_t counterFrequency() {
+  LARGE_INTEGER frequency{};
+  QueryPerformanceFrequency(&frequency);
+  return static_cast<std::uint64_t>(frequency.QuadPart);
 }
 
-bool copySessionInfo(
-    const char* mapping,
-    const irsdk_header* sharedHeader,
-    int previousUpdate,
-    std::vector<char>& session,
-    int& update,
-    std::uint64_t& requiredMappingSize,
-    std::string& error) {
-  for (int attempt = 0; attempt < 3; ++attempt) {
-    const int beforeUpdate = sharedHeader->sessionInfoUpdate;
-    const int beforeLength = sharedHeader->sessionInfoLen;
-    const int beforeOffset = sharedHeader->sessionInfoOffset;
-
-    if (beforeUpdate == previousUpdate) {
-      update = previousUpdate;
-      return true;
-    }
-    if (beforeLength < 0 ||
-        static_cast<std::uint32_t>(beforeLength) > replay::kMaxPayloadSize ||
-        beforeOffset < 0 ||
-        !readableMappedRange(
-            mapping,
-            static_cast<std::uint64_t>(beforeOffset),
-            static_cast<std::uint64_t>(beforeLength))) {
-      error = "iRacing published invalid session-info metadata";
-      return false;
-    }
-
-    session.resize(static_cast<std::size_t>(beforeLength));
-    if (beforeLength > 0) {
-      std::memcpy(
-          session.data(),
-          mapping + beforeOffset,
-          static_cast<std::size_t>(beforeLength));
-    }
-    MemoryBarrier();
-
-    if (beforeUpdate == sharedHeader->sessionInfoUpdate &&
-        beforeLength == sharedHeader->sessionInfoLen &&
-        beforeOffset == sharedHeader->sessionInfoOffset) {
-      update = beforeUpdate;
-      requiredMappingSize = std::max(
-          requiredMappingSize,
-          static_cast<std::uint64_t>(beforeOffset) +
-              static_cast<std::uint64_t>(beforeLength));
-      return true;
-    }
-  }
-
-  error = "Session info changed repeatedly while it was being copied";
-  return false;
+std::uint64_t counterNow() {
+  LARGE_INTEGER now{};
+  QueryPerformanceCounter(&now);
+  return static_cast<std::uint64_t>(now.QuadPart);
 }
 
 struct MappingReader {
@@ -272,8 +272,124 @@ struct MappingReader {
     }
     return true;
   }
+
+  bool readable(std::uint64_t offset, std::uint64_t length) const {
+    return readableMappedRange(mapping, offset, length);
+  }
+
+  void wait(DWORD timeoutMs) const {
+    WaitForSingleObject(eventHandle, timeoutMs);
+  }
 };
+#else
+// Tape timestamps count CLOCK_MONOTONIC nanoseconds.
+std::uint64_t counterFrequency() {
+  return 1000000000ULL;
+}
+
+std::uint64_t counterNow() {
+  return irdashies::irsdk_posix::monotonicNanoseconds();
+}
+
+// Maps the objects a POSIX publisher created, read-only, the way the POSIX
+// backend of the addon does.
+struct MappingReader {
+  explicit MappingReader(const SharedObjectNames& objectNames)
+      : names(objectNames) {}
 
+  const SharedObjectNames& names;
+  irdashies::irsdk_posix::SharedMapping mappingObject;
+  irdashies::irsdk_posix::SharedMapping eventObject;
+  const irdashies::irsdk_posix::DataValidEvent* event = nullptr;
+  const char* mapping = nullptr;
+  std::uint32_t observedSequence = 0;
+
+  bool connect() {
+    std::string error;
+    if (!mappingObject.open(names.mapping, false, error) ||
+        mappingObject.size() < sizeof(irsdk_header) ||
+        !eventObject.open(names.event, false, error) ||
+        eventObject.size() < sizeof(irdashies::irsdk_posix::DataValidEvent)) {
+      eventObject.close();
+      mappingObject.close();
+      return false;
+    }
+    event = reinterpret_cast<const irdashies::irsdk_posix::DataValidEvent*>(
+        eventObject.data());
+    observedSequence = event->sequence.load();
+    mapping = mappingObject.data();
+    return true;
+  }
+
+  bool readable(std::uint64_t offset, std::uint64_t length) const {
+    return offset <= mappingObject.size() &&
+        length <= mappingObject.size() - offset;
+  }
+
+  void wait(int timeoutMs) {
+    if (irdashies::irsdk_posix::waitForDataValid(
+            *event,
+            observedSequence,
+            timeoutMs)) {
+      observedSequence = event->sequence.load();
+    }
+  }
+};
+#endif
+
+bool copySessionInfo(
+    const MappingReader& reader,
+    const irsdk_header* sharedHeader,
+    int previousUpdate,
+    std::vector<char>& session,
+    int& update,
+    std::uint64_t& requiredMappingSize,
+    std::string& error) {
+  for (int attempt = 0; attempt < 3; ++attempt) {
+    const int beforeUpdate = sharedHeader->sessionInfoUpdate;
+    const int beforeLength = sharedHeader->sessionInfoLen;
+    const int beforeOffset = sharedHeader->sessionInfoOffset;
+
+    if (beforeUpdate == previousUpdate) {
+      update = previousUpdate;
+      return true;
+    }
+    if (beforeLength < 0 ||
+        static_cast<std::uint32_t>(beforeLength) > replay::kMaxPayloadSize ||
+        beforeOffset < 0 ||
+        !reader.readable(
+            static_cast<std::uint64_t>(beforeOffset),
+            static_cast<std::uint64_t>(beforeLength))) {
+      error = "iRacing published invalid session-info metadata";
+      return false;
+    }
+
+    session.resize(static_cast<std::size_t>(beforeLength));
+    if (beforeLength > 0) {
+      std::memcpy(
+          session.data(),
+          reader.mapping + beforeOffset,
+          static_cast<std::size_t>(beforeLength));
+    }
+    memoryBarrier();
+
+    if (beforeUpdate == sharedHeader->sessionInfoUpdate &&
+        beforeLength == sharedHeader->sessionInfoLen &&
+        beforeOffset == sharedHeader->sessionInfoOffset) {
+      update = beforeUpdate;
+      requiredMappingSize = std::max(
+          requiredMappingSize,
+          static_cast<std::uint64_t>(beforeOffset) +
+              static_cast<std::uint64_t>(beforeLength));
+      return true;
+    }
+  }
+
+  error = "Session info changed repeatedly while it was being copied";
+  return false;
+}
+
+// Accepts "Speed,RPM,Gear" or "@names.txt" with one name per line.
 int recordTelemetry(const std::vector<std::wstring>& arguments) {
   const auto output = optionValue(arguments, L"--output");
   if (!output.has_value()) {
@@ -290,6 +406,15 @@ int recordTelemetry(const std::vector<std::wstring>& arguments) {
     return 2;
   }
 
+  std::vector<std::string> variableNames;
+  const auto varsOption = optionValue(arguments, L"--vars");
+  const bool compact = varsOption.has_value();
+  if (compact &&
+      !replay::parseVariableList(*varsOption, variableNames, error)) {
+    std::cerr << error << '\n';
+    return 2;
+  }
+
   std::cout << "Waiting for iRacing shared memory...\n";
   std::cout.flush();
 
@@ -305,7 +430,7 @@ int recordTelemetry(const std::vector<std::wstring>& arguments) {
       reinterpret_cast<const irsdk_header*>(reader.mapping);
   while (!stopRequested.load() &&
          (sharedHeader->status & irsdk_stConnected) == 0) {
-    WaitForSingleObject(reader.eventHandle, 250);
+    reader.wait(250);
   }
   if (stopRequested.load()) {
     return 130;
@@ -320,12 +445,11 @@ int recordTelemetry(const std::vector<std::wstring>& arguments) {
     std::memcpy(&header, sharedHeader, sizeof(header));
     if (header.numVars <= 0 || header.numVars > 4096 ||
         header.varHeaderOffset < 0 ||
-        !readableMappedRange(
-            reader.mapping,
+        !reader.readable(
             static_cast<std::uint64_t>(header.varHeaderOffset),
             static_cast<std::uint64_t>(header.numVars) *
                 sizeof(irsdk_varHeader))) {
-      WaitForSingleObject(reader.eventHandle, 16);
+      reader.wait(16);
       continue;
     }
 
@@ -334,7 +458,7 @@ int recordTelemetry(const std::vector<std::wstring>& arguments) {
         variables.data(),
         reader.mapping + header.varHeaderOffset,
         variables.size() * sizeof(irsdk_varHeader));
-    MemoryBarrier();
+    memoryBarrier();
 
     irsdk_header after{};
     std::memcpy(&after, sharedHeader, sizeof(after));
@@ -342,7 +466,7 @@ int recordTelemetry(const std::vector<std::wstring>& arguments) {
         sameLayout(header, after) &&
         replay::validateSdkLayout(header, variables, mappingSize, error);
     if (!capturedLayout) {
-      WaitForSingleObject(reader.eventHandle, 16);
+      reader.wait(16);
     }
   }
 
@@ -356,28 +480,35 @@ int recordTelemetry(const std::vector<std::wstring>& arguments) {
   }
   error.clear();
 
-  LARGE_INTEGER frequency{};
-  LARGE_INTEGER start{};
-  QueryPerformanceFrequency(&frequency);
-  QueryPerformanceCounter(&start);
+  // With --vars, the tape carries a compacted schema and every frame is
+  // repacked to it before writing.
+  replay::SchemaSubset subset;
+  if (compact && !subset.build(header, variables, variableNames, error)) {
+    std::cerr << error << '\n';
+    return 2;
+  }
+  std::uint64_t compactMappingSize = compact ? subset.mappingSize(0) : 0;
+
+  const std::uint64_t frequency = counterFrequency();
+  const std::uint64_t start = counterNow();
 
   replay::TapeWriter writer;
+  writer.enableFrameRepeats();
   if (!writer.open(
           std::filesystem::path(*output),
-          header,
-          variables,
-          mappingSize,
-          static_cast<std::uint64_t>(frequency.QuadPart),
+          compact ? subset.header() : header,
+          compact ? subset.variables() : variables,
+          compact ? compactMappingSize : mappingSize,
+          frequency,
           error)) {
     std::cerr << error << '\n';
     return 1;
   }
-
   std::vector<char> session;
   int lastSessionUpdate = std::numeric_limits<int>::min();
   int currentSessionUpdate = lastSessionUpdate;
   if (!copySessionInfo(
-          reader.mapping,
+          reader,
           sharedHeader,
           lastSessionUpdate,
           session,
@@ -386,7 +517,7 @@ int recordTelemetry(const std::vector<std::wstring>& arguments) {
           error) ||
       !writer.append(
           replay::RecordKind::SessionInfo,
-          elapsedCounter(start),
+          counterNow() - start,
           -1,
           currentSessionUpdate,
           session.empty() ? nullptr : session.data(),
@@ -396,17 +527,41 @@ int recordTelemetry(const std::vector<std::wstring>& arguments) {
     return 1;
   }
   lastSessionUpdate = currentSessionUpdate;
+  if (compact) {
+    compactMappingSize =
+        std::max(compactMappingSize, subset.mappingSize(session.size()));
+  }
 
   int lastTick = std::numeric_limits<int>::min();
   for (int i = 0; i < header.numBuf; ++i) {
     lastTick = std::max(lastTick, sharedHeader->varBuf[i].tickCount);
   }
 
+  // Ticks published from here on are recorded.
+  if (compact) {
+    std::cout << "Recording " << subset.variables().size() << " of "
+              << variables.size() << " variables, "
+              << subset.header().bufLen << " of " << header.bufLen
+              << " bytes per frame\n";
+  } else {
+    std::cout << "Recording " << variables.size() << " variables, "
+              << header.bufLen << " bytes per frame\n";
+  }
+  std::cout.flush();
+
   std::vector<char> frame(static_cast<std::size_t>(header.bufLen));
+  std::vector<char> compactFrame(
+      compact ? static_cast<std::size_t>(subset.header().bufLen) : 0);
   std::uint64_t frameCount = 0;
   std::uint64_t gapCount = 0;
   auto lastProgress = std::chrono::steady_clock::now();
 
+  // Lap, session, flag, and pit transitions, written after the End record
+  // so playback and probes can seek to them without scanning frames.
+  replay::TapeEventDetector eventDetector(
+      compact ? subset.variables() : variables);
+  std::vector<replay::TapeEvent> events;
+
   struct Candidate {
     int index;
     int tick;
@@ -417,41 +572,44 @@ int recordTelemetry(const std::vector<std::wstring>& arguments) {
   while (!stopRequested.load()) {
     if (durationSeconds > 0) {
       const auto elapsedSeconds =
-          static_cast<double>(elapsedCounter(start)) /
-          static_cast<double>(frequency.QuadPart);
+          static_cast<double>(counterNow() - start) /
+          static_cast<double>(frequency);
       if (elapsedSeconds >= durationSeconds) {
         break;
       }
     }
 
-    WaitForSingleObject(reader.eventHandle, 16);
-    MemoryBarrier();
+    reader.wait(16);
+    memoryBarrier();
 
+    // A disconnect leaves the last published buffers in place, so frames
+    // published just before it are still taken before it is recorded.
     irsdk_header currentHeader{};
     std::memcpy(&currentHeader, sharedHeader, sizeof(currentHeader));
-    if ((currentHeader.status & irsdk_stConnected) == 0) {
-      if (!writer.append(
-              replay::RecordKind::Disconnect,
-              elapsedCounter(start),
-              lastTick,
-              0,
-              nullptr,
-              0,
-              error)) {
+    const bool connected = (currentHeader.status & irsdk_stConnected) != 0;
+    if (!sameLayout(header, currentHeader)) {
+      if (!connected) {
+        if (writer.append(
+                replay::RecordKind::Disconnect,
+                counterNow() - start,
+                lastTick,
+                0,
+                nullptr,
+                0,
+                error)) {
+          disconnected = true;
+        }
         break;
       }
-      disconnected = true;
-      break;
-    }
-    if (!sameLayout(header, currentHeader)) {
       error =
           "The SDK layout changed during recording; start a new capture for "
           "the new connection";
       break;
     }
 
-    if (!copySessionInfo(
-            reader.mapping,
+    if (connected &&
+        !copySessionInfo(
+            reader,
             sharedHeader,
             lastSessionUpdate,
             session,
@@ -460,10 +618,10 @@ int recordTelemetry(const std::vector<std::wstring>& arguments) {
             error)) {
       break;
     }
-    if (currentSessionUpdate != lastSessionUpdate) {
+    if (connected && currentSessionUpdate != lastSessionUpdate) {
       if (!writer.append(
               replay::RecordKind::SessionInfo,
-              elapsedCounter(start),
+              counterNow() - start,
               lastTick,
               currentSessionUpdate,
               session.empty() ? nullptr : session.data(),
@@ -472,6 +630,10 @@ int recordTelemetry(const std::vector<std::wstring>& arguments) {
         break;
       }
       lastSessionUpdate = currentSessionUpdate;
+      if (compact) {
+        compactMappingSize =
+            std::max(compactMappingSize, subset.mappingSize(session.size()));
+      }
     }
 
     int candidateCount = 0;
@@ -503,8 +665,7 @@ int recordTelemetry(const std::vector<std::wstring>& arguments) {
         const int beforeTick = buffer.tickCount;
         if (beforeTick != candidate.tick ||
             buffer.bufOffset < 0 ||
-            !readableMappedRange(
-                reader.mapping,
+            !reader.readable(
                 static_cast<std::uint64_t>(buffer.bufOffset),
                 frame.size())) {
           break;
@@ -513,7 +674,7 @@ int recordTelemetry(const std::vector<std::wstring>& arguments) {
             frame.data(),
             reader.mapping + buffer.bufOffset,
             frame.size());
-        MemoryBarrier();
+        memoryBarrier();
         if (beforeTick == buffer.tickCount) {
           copied = true;
           break;
@@ -528,7 +689,7 @@ int recordTelemetry(const std::vector<std::wstring>& arguments) {
         const int missed = candidate.tick - lastTick - 1;
         if (!writer.append(
                 replay::RecordKind::Gap,
-                elapsedCounter(start),
+                counterNow() - start,
                 candidate.tick,
                 missed,
                 nullptr,
@@ -539,22 +700,43 @@ int recordTelemetry(const std::vector<std::wstring>& arguments) {
         gapCount += static_cast<std::uint64_t>(missed);
       }
 
+      if (compact) {
+        subset.compactFrame(frame.data(), compactFrame.data());
+      }
+      const auto& recorded = compact ? compactFrame : frame;
+      const auto frameOffset = writer.nextRecordOffset();
+      const auto frameTicks = counterNow() - start;
       if (!writer.append(
               replay::RecordKind::Frame,
-              elapsedCounter(start),
+              frameTicks,
               candidate.tick,
               candidate.index,
-              frame.data(),
-              static_cast<std::uint32_t>(frame.size()),
+              recorded.data(),
+              static_cast<std::uint32_t>(recorded.size()),
               error)) {
         break;
       }
+      eventDetector.observe(
+          recorded.data(), frameOffset, frameTicks, candidate.tick, events);
       lastTick = candidate.tick;
       ++frameCount;
     }
     if (!error.empty()) {
       break;
     }
+    if (!connected) {
+      if (writer.append(
+              replay::RecordKind::Disconnect,
+              counterNow() - start,
+              lastTick,
+              0,
+              nullptr,
+              0,
+              error)) {
+        disconnected = true;
+      }
+      break;
+    }
 
     const auto now = std::chrono::steady_clock::now();
     if (now - lastProgress >= std::chrono::seconds(1)) {
@@ -568,15 +750,17 @@ int recordTelemetry(const std::vector<std::wstring>& arguments) {
     }
   }
 
+  const auto endTicks = counterNow() - start;
   if (!writer.append(
           replay::RecordKind::End,
-          elapsedCounter(start),
+          endTicks,
           lastTick,
           disconnected ? 1 : 0,
           nullptr,
           0,
           error) ||
-      !writer.finish(mappingSize, error)) {
+      !writer.appendEventIndex(events, endTicks, error) ||
+      !writer.finish(compact ? compactMappingSize : mappingSize, error)) {
     std::cerr << '\n' << error << '\n';
     return 1;
   }
@@ -587,7 +771,9 @@ int recordTelemetry(const std::vector<std::wstring>& arguments) {
   }
   std::cout << "\nCapture complete: " << frameCount << " frames, "
             << gapCount << " missed source ticks, "
-            << writer.recordCount() << " records\n";
+            << writer.recordCount() << " records, "
+            << writer.repeatedFrames() << " repeated frames, "
+            << events.size() << " indexed events\n";
   return 0;
 }
 
@@ -595,68 +781,15 @@ class SharedPublisher {
  public:
   ~SharedPublisher() {
     disconnect();
-    if (mapping_ != nullptr) {
-      UnmapViewOfFile(mapping_);
-    }
-    if (eventHandle_ != nullptr) {
-      CloseHandle(eventHandle_);
-    }
-    if (mappingHandle_ != nullptr) {
-      CloseHandle(mappingHandle_);
-    }
+    releaseObjects();
   }
 
   bool initialize(
       const replay::TapeReader& tape,
       const SharedObjectNames& names,
       std::string& error) {
-    HANDLE existingMapping = OpenFileMappingW(
-        FILE_MAP_READ,
-        FALSE,
-        names.mapping);
-    if (existingMapping != nullptr) {
-      CloseHandle(existingMapping);
-      error = std::string("The ") + names.owner +
-          " shared-memory name is already in use";
-      return false;
-    }
-
     const auto mappingSize = tape.fileHeader().mappingSize;
-    mappingHandle_ = CreateFileMappingW(
-        INVALID_HANDLE_VALUE,
-        nullptr,
-        PAGE_READWRITE,
-        static_cast<DWORD>(mappingSize >> 32U),
-        static_cast<DWORD>(mappingSize & 0xffffffffU),
-        names.mapping);
-    if (mappingHandle_ == nullptr) {
-      error = windowsError("CreateFileMapping");
-      return false;
-    }
-    if (GetLastError() == ERROR_ALREADY_EXISTS) {
-      error = "The iRacing shared-memory mapping appeared during startup";
-      return false;
-    }
-
-    mapping_ = static_cast<char*>(
-        MapViewOfFile(mappingHandle_, FILE_MAP_ALL_ACCESS, 0, 0, 0));
-    if (mapping_ == nullptr) {
-      error = windowsError("MapViewOfFile");
-      return false;
-    }
-
-    eventHandle_ = CreateEventW(
-        nullptr,
-        FALSE,
-        FALSE,
-        names.event);
-    if (eventHandle_ == nullptr) {
-      error = windowsError("CreateEvent");
-      return false;
-    }
-    if (GetLastError() == ERROR_ALREADY_EXISTS) {
-      error = std::string("The ") + names.owner +
-          " data-valid event is already in use";
+    if (!createObjects(names, mappingSize, error)) {
       return false;
     }
 
@@ -674,7 +807,7 @@ class SharedPublisher {
         mapping_ + header_->varHeaderOffset,
         tape.variables().data(),
         tape.variables().size() * sizeof(irsdk_varHeader));
-    MemoryBarrier();
+    memoryBarrier();
     return true;
   }
 
@@ -705,10 +838,10 @@ class SharedPublisher {
           payload.data(),
           payload.size());
     }
-    MemoryBarrier();
+    memoryBarrier();
     header_->sessionInfoLen = static_cast<int>(payload.size());
     header_->sessionInfoUpdate = record.value;
-    MemoryBarrier();
+    memoryBarrier();
     return true;
   }
 
@@ -734,10 +867,10 @@ class SharedPublisher {
       header_->status = irsdk_stConnected;
       connected_ = true;
     }
-    MemoryBarrier();
+    memoryBarrier();
     buffer.tickCount = nextPublishedTick_++;
-    MemoryBarrier();
-    SetEvent(eventHandle_);
+    memoryBarrier();
+    signalDataValid();
     nextBuffer_ = (nextBuffer_ + 1) % header_->numBuf;
     return true;
   }
@@ -745,10 +878,8 @@ class SharedPublisher {
   void disconnect() {
     if (header_ != nullptr && connected_) {
       header_->status = 0;
-      MemoryBarrier();
-      if (eventHandle_ != nullptr) {
-        SetEvent(eventHandle_);
-      }
+      memoryBarrier();
+      signalDataValid();
       connected_ = false;
     }
   }
@@ -801,8 +932,145 @@ class SharedPublisher {
     return false;
   }
 
+#if defined(_WIN32)
+  bool createObjects(
+      const SharedObjectNames& names,
+      std::uint64_t mappingSize,
+      std::string& error) {
+    HANDLE existingMapping = OpenFileMappingW(
+        FILE_MAP_READ,
+        FALSE,
+        names.mapping);
+    if (existingMapping != nullptr) {
+      CloseHandle(existingMapping);
+      error = std::string("The ") + names.owner +
+          " shared-memory name is already in use";
+      return false;
+    }
+
+    mappingHandle_ = CreateFileMappingW(
+        INVALID_HANDLE_VALUE,
+        nullptr,
+        PAGE_READWRITE,
+        static_cast<DWORD>(mappingSize >> 32U),
+        static_cast<DWORD>(mappingSize & 0xffffffffU),
+        names.mapping);
+    if (mappingHandle_ == nullptr) {
+      error = windowsError("CreateFileMapping");
+      return false;
+    }
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+      error = "The iRacing shared-memory mapping appeared during startup";
+      return false;
+    }
+
+    mapping_ = static_cast<char*>(
+        MapViewOfFile(mappingHandle_, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+    if (mapping_ == nullptr) {
+      error = windowsError("MapViewOfFile");
+      return false;
+    }
+
+    eventHandle_ = CreateEventW(
+        nullptr,
+        FALSE,
+        FALSE,
+        names.event);
+    if (eventHandle_ == nullptr) {
+      error = windowsError("CreateEvent");
+      return false;
+    }
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+      error = std::string("The ") + names.owner +
+          " data-valid event is already in use";
+      return false;
+    }
+    return true;
+  }
+
+  void signalDataValid() {
+    if (eventHandle_ != nullptr) {
+      SetEvent(eventHandle_);
+    }
+  }
+
+  void releaseObjects() {
+    if (mapping_ != nullptr) {
+      UnmapViewOfFile(mapping_);
+      mapping_ = nullptr;
+    }
+    if (eventHandle_ != nullptr) {
+      CloseHandle(eventHandle_);
+      eventHandle_ = nullptr;
+    }
+    if (mappingHandle_ != nullptr) {
+      CloseHandle(mappingHandle_);
+      mappingHandle_ = nullptr;
+    }
+  }
+
   HANDLE mappingHandle_ = nullptr;
   HANDLE eventHandle_ = nullptr;
+#else
+  bool createObjects(
+      const SharedObjectNames& names,
+      std::uint64_t mappingSize,
+      std::string& error) {
+    // POSIX names outlive their creator, so a publisher that was killed
+    // leaves its objects behind. Reclaim them only when that process is gone.
+    bool existed = false;
+    if (!mappingObject_.create(names.mapping, mappingSize, existed, error) &&
+        (!existed ||
+         !irdashies::irsdk_posix::unlinkAbandonedObjects(
+             names.mapping,
+             names.event) ||
+         !mappingObject_.create(
+             names.mapping,
+             mappingSize,
+             existed,
+             error))) {
+      if (existed) {
+        error = std::string("The ") + names.owner +
+            " shared-memory name is already in use";
+      }
+      return false;
+    }
+    mapping_ = mappingObject_.data();
+
+    if (!eventObject_.create(
+            names.event,
+            sizeof(irdashies::irsdk_posix::DataValidEvent),
+            existed,
+            error)) {
+      if (existed) {
+        error = std::string("The ") + names.owner +
+            " data-valid event is already in use";
+      }
+      return false;
+    }
+    event_ = reinterpret_cast<irdashies::irsdk_posix::DataValidEvent*>(
+        eventObject_.data());
+    event_->publisherPid = static_cast<std::int32_t>(getpid());
+    return true;
+  }
+
+  void signalDataValid() {
+    if (event_ != nullptr) {
+      irdashies::irsdk_posix::signalDataValid(*event_);
+    }
+  }
+
+  void releaseObjects() {
+    event_ = nullptr;
+    mapping_ = nullptr;
+    eventObject_.close();
+    mappingObject_.close();
+  }
+
+  irdashies::irsdk_posix::SharedMapping mappingObject_;
+  irdashies::irsdk_posix::SharedMapping eventObject_;
+  irdashies::irsdk_posix::DataValidEvent* event_ = nullptr;
+#endif
   char* mapping_ = nullptr;
   irsdk_header* header_ = nullptr;
   std::uint64_t mappingSize_ = 0;
@@ -846,7 +1114,7 @@ void waitForPlaybackTime(
 int playTelemetry(const std::vector<std::wstring>& arguments) {
   const auto input = optionValue(arguments, L"--input");
   if (!input.has_value()) {
-    std::cerr << "play requires --input <capture.irdt>\n";
+    std::cerr << "play requires --input <capture.irdt|->\n";
     return 2;
   }
 
@@ -863,8 +1131,18 @@ int playTelemetry(const std::vector<std::wstring>& arguments) {
       ? kIRacingObjectNames
       : kIsolatedReplayObjectNames;
 
+  // "-" or a named pipe is read front to back as it arrives, which rules out
+  // --loop.
+  const std::filesystem::path inputPath(*input);
+  const bool stream = replay::isTapeStreamPath(inputPath);
+  if (stream && loop) {
+    std::cerr << "--loop needs a seekable tape, not a stream\n";
+    return 2;
+  }
   replay::TapeReader tape;
-  if (!tape.open(std::filesystem::path(*input), error)) {
+  if (stream ? !tape.openStream(
+                   inputPath, replay::kDefaultReadAheadBytes, error)
+             : !tape.open(inputPath, error)) {
     std::cerr << error << '\n';
     return 1;
   }
@@ -959,6 +1237,11 @@ int playTelemetry(const std::vector<std::wstring>& arguments) {
           }
           break;
 
+        case replay::RecordKind::EventIndex:
+        // TapeReader expands Repeat records into frames.
+        case replay::RecordKind::Repeat:
+          break;
+
         case replay::RecordKind::Gap:
           std::cerr << "Capture gap: " << record.value
                     << " source ticks before " << record.sourceTick << '\n';
@@ -1030,6 +1313,10 @@ int createFixture(const std::vector<std::wstring>& arguments) {
     return 2;
   }
 
+  // Like a live session, the fixture publishes every car slot. Only the
+  // first three hold cars; the others read -1.
+  constexpr int kCarCount = 3;
+  constexpr int kMarkerOffset = 24 + IRSDK_MAX_CARS * 4;
   std::vector<irsdk_varHeader> variables(7);
   setVariable(
       variables[0],
@@ -1075,20 +1362,20 @@ int createFixture(const std::vector<std::wstring>& arguments) {
       variables[5],
       irsdk_float,
       24,
-      3,
+      IRSDK_MAX_CARS,
       "CarIdxLapDistPct",
       "Car positions",
       "%");
   setVariable(
       variables[6],
       irsdk_char,
-      36,
+      kMarkerOffset,
       4,
       "ReplayMarker",
       "Synthetic marker bytes",
       "");
 
-  constexpr int kFrameLength = 48;
+  constexpr int kFrameLength = kMarkerOffset + 8;
   constexpr int kSessionCapacity = 1024;
   const int variableOffset = static_cast<int>(sizeof(irsdk_header));
   const int sessionOffset =
@@ -1153,7 +1440,7 @@ int createFixture(const std::vector<std::wstring>& arguments) {
   }
 
   std::vector<char> frame(kFrameLength);
-  const std::array<std::array<float, 3>, 3> positions = {{
+  const std::array<std::array<float, kCarCount>, 3> positions = {{
       {{0.10F, 0.20F, 0.30F}},
       {{0.11F, 0.21F, 0.31F}},
       {{0.12F, 0.22F, 0.32F}},
@@ -1170,13 +1457,17 @@ int createFixture(const std::vector<std::wstring>& arguments) {
     writeValue(frame, 12, isOnTrack);
     writeValue(frame, 16, flags);
     writeValue(frame, 20, speed);
-    std::memcpy(
-        frame.data() + 24,
-        positions[static_cast<std::size_t>(index)].data(),
-        sizeof(float) * 3);
+    for (int car = 0; car < IRSDK_MAX_CARS; ++car) {
+      writeValue(
+          frame,
+          24 + car * 4,
+          car < kCarCount ? positions[static_cast<std::size_t>(index)]
+                                     [static_cast<std::size_t>(car)]
+                          : -1.0F);
+    }
     const std::array<char, 4> marker = {
         'T', '0', static_cast<char>('0' + index), '\0'};
-    std::memcpy(frame.data() + 36, marker.data(), marker.size());
+    std::memcpy(frame.data() + kMarkerOffset, marker.data(), marker.size());
 
     if (index == 2 &&
         !writer.append(
@@ -1223,37 +1514,105 @@ int createFixture(const std::vector<std::wstring>& arguments) {
   return 0;
 }
 
-int inspectTape(const std::vector<std::wstring>& arguments) {
-  const auto input = optionValue(arguments, L"--input");
-  if (!input.has_value()) {
-    std::cerr << "inspect requires --input <capture.irdt>\n";
-    return 2;
+const char* variableTypeName(int type) {
+  switch (type) {
+    case irsdk_char:
+      return "char";
+    case irsdk_bool:
+      return "bool";
+    case irsdk_int:
+      return "int";
+    case irsdk_bitField:
+      return "bitfield";
+    case irsdk_float:
+      return "float";
+    default:
+      return "double";
   }
+}
 
-  replay::TapeReader tape;
-  std::string error;
-  if (!tape.open(std::filesystem::path(*input), error)) {
-    std::cerr << error << '\n';
-    return 1;
-  }
+std::string fixedString(const char* text, std::size_t capacity) {
+  const auto* end = static_cast<const char*>(std::memchr(text, '\0', capacity));
+  return std::string(text, end == nullptr ? text + capacity : end);
+}
 
-  std::array<std::uint64_t, 6> counts{};
-  replay::TapeRecordHeader record{};
-  std::vector<char> payload;
-  while (true) {
-    const auto result = tape.readNext(record, payload, error);
-    if (result == replay::TapeReadResult::EndOfFile) {
-      break;
-    }
-    if (result == replay::TapeReadResult::Error) {
-      std::cerr << error << '\n';
-      return 1;
-    }
-    if (record.kind < counts.size()) {
-      ++counts[record.kind];
+void writeJsonString(std::ostream& output, const std::string& text) {
+  output << '"';
+  for (const char character : text) {
+    if (character == '"' || character == '\\') {
+      output << '\\' << character;
+    } else if (static_cast<unsigned char>(character) < 0x20) {
+      output << "\\u00" << "0123456789abcdef"[(character >> 4) & 0xf]
+             << "0123456789abcdef"[character & 0xf];
+    } else {
+      output << character;
     }
   }
+  output << '"';
+}
+
+void writeJsonNumber(std::ostream& output, double value) {
+  if (std::isfinite(value)) {
+    output << value;
+  } else {
+    output << "null";
+  }
+}
 
+void printStatsJson(
+    const replay::TapeReader& tape,
+    const replay::TapeStats& stats) {
+  const auto count = [&stats](replay::RecordKind kind) {
+    return stats.recordCounts[static_cast<std::size_t>(kind)];
+  };
+  std::cout << std::setprecision(std::numeric_limits<double>::max_digits10)
+            << "{\"formatVersion\":" << tape.fileHeader().formatVersion
+            << ",\"sdkVersion\":" << tape.sdkHeader().ver
+            << ",\"tickRate\":" << tape.sdkHeader().tickRate
+            << ",\"frameBytes\":" << tape.sdkHeader().bufLen
+            << ",\"mappingBytes\":" << tape.fileHeader().mappingSize
+            << ",\"records\":" << tape.fileHeader().recordCount
+            << ",\"frames\":" << stats.frames
+            << ",\"repeatedFrames\":" << stats.repeatedFrames
+            << ",\"sessionUpdates\":"
+            << count(replay::RecordKind::SessionInfo)
+            << ",\"gapRecords\":" << count(replay::RecordKind::Gap)
+            << ",\"variables\":[";
+  const auto& variables = tape.variables();
+  for (std::size_t i = 0; i < variables.size(); ++i) {
+    const auto& variable = variables[i];
+    const auto& variableStats = stats.variables[i];
+    std::cout << (i == 0 ? "" : ",") << "{\"name\":";
+    writeJsonString(std::cout, fixedString(variable.name, IRSDK_MAX_STRING));
+    std::cout << ",\"unit\":";
+    writeJsonString(std::cout, fixedString(variable.unit, IRSDK_MAX_STRING));
+    std::cout << ",\"type\":\"" << variableTypeName(variable.type)
+              << "\",\"count\":" << variable.count
+              << ",\"samples\":" << variableStats.samples
+              << ",\"nanCount\":" << variableStats.nanCount << ",\"min\":";
+    writeJsonNumber(std::cout, variableStats.min);
+    std::cout << ",\"max\":";
+    writeJsonNumber(std::cout, variableStats.max);
+    std::cout << ",\"mean\":";
+    writeJsonNumber(std::cout, variableStats.mean);
+    std::cout << ",\"stddev\":";
+    writeJsonNumber(std::cout, variableStats.stddev);
+    std::cout << ",\"changes\":" << variableStats.changes
+              << ",\"firstChangeSeconds\":";
+    writeJsonNumber(std::cout, variableStats.firstChangeSeconds);
+    std::cout << ",\"lastChangeSeconds\":";
+    writeJsonNumber(std::cout, variableStats.lastChangeSeconds);
+    std::cout << '}';
+  }
+  std::cout << "]}\n";
+}
+
+void printStatsTable(
+    const replay::TapeReader& tape,
+    const replay::TapeStats& stats) {
+  const auto count = [&stats](replay::RecordKind kind) {
+    return stats.recordCounts[static_cast<std::size_t>(kind)];
+  };
   std::cout << "Format version: " << tape.fileHeader().formatVersion << '\n'
             << "SDK version: " << tape.sdkHeader().ver << '\n'
             << "Tick rate: " << tape.sdkHeader().tickRate << " Hz\n"
@@ -1261,17 +1620,83 @@ int inspectTape(const std::vector<std::wstring>& arguments) {
             << "Frame bytes: " << tape.sdkHeader().bufLen << '\n'
             << "Mapping bytes: " << tape.fileHeader().mappingSize << '\n'
             << "Records: " << tape.fileHeader().recordCount << '\n'
-            << "Frames: "
-            << counts[static_cast<std::size_t>(replay::RecordKind::Frame)]
-            << '\n'
+            << "Frames: " << stats.frames << '\n'
+            << "Repeated frames: " << stats.repeatedFrames << '\n'
             << "Session updates: "
-            << counts[
-                   static_cast<std::size_t>(
-                       replay::RecordKind::SessionInfo)]
-            << '\n'
-            << "Gap records: "
-            << counts[static_cast<std::size_t>(replay::RecordKind::Gap)]
+            << count(replay::RecordKind::SessionInfo) << '\n'
+            << "Gap records: " << count(replay::RecordKind::Gap) << "\n\n";
+
+  auto cell = [](double value) {
+    std::ostringstream text;
+    if (std::isnan(value)) {
+      text << '-';
+    } else {
+      text << std::setprecision(6) << value;
+    }
+    return text.str();
+  };
+  std::cout << std::left << std::setw(36) << "Variable" << std::right
+            << std::setw(13) << "Min" << std::setw(13) << "Max"
+            << std::setw(13) << "Mean" << std::setw(13) << "Stddev"
+            << std::setw(9) << "Changes" << std::setw(9) << "NaNs"
+            << std::setw(11) << "First s" << std::setw(11) << "Last s"
             << '\n';
+  const auto& variables = tape.variables();
+  for (std::size_t i = 0; i < variables.size(); ++i) {
+    const auto& variable = variables[i];
+    const auto& variableStats = stats.variables[i];
+    auto name = fixedString(variable.name, IRSDK_MAX_STRING);
+    if (variable.count > 1) {
+      name += "[" + std::to_string(variable.count) + "]";
+    }
+    std::cout << std::left << std::setw(36) << name << std::right
+              << std::setw(13) << cell(variableStats.min)
+              << std::setw(13) << cell(variableStats.max)
+              << std::setw(13) << cell(variableStats.mean)
+              << std::setw(13) << cell(variableStats.stddev)
+              << std::setw(9) << variableStats.changes
+              << std::setw(9) << variableStats.nanCount
+              << std::setw(11) << cell(variableStats.firstChangeSeconds)
+              << std::setw(11) << cell(variableStats.lastChangeSeconds)
+              << '\n';
+  }
+}
+
+int inspectTape(const std::vector<std::wstring>& arguments) {
+  const auto input = optionValue(arguments, L"--input");
+  if (!input.has_value()) {
+    std::cerr << "inspect requires --input <capture.irdt>\n";
+    return 2;
+  }
+  double jobs = 0;
+  std::string error;
+  if (!parsePositiveDouble(
+          optionValue(arguments, L"--jobs"),
+          std::max(1U, std::thread::hardware_concurrency()),
+          jobs,
+          error) ||
+      jobs != std::floor(jobs) || jobs > 256) {
+    std::cerr << "--jobs must be a whole number between 1 and 256\n";
+    return 2;
+  }
+
+  replay::TapeReader tape;
+  replay::TapeStats stats;
+  if (!tape.open(std::filesystem::path(*input), error) ||
+      !replay::computeTapeStats(
+          std::filesystem::path(*input),
+          static_cast<std::size_t>(jobs),
+          stats,
+          error)) {
+    std::cerr << error << '\n';
+    return 1;
+  }
+
+  if (hasOption(arguments, L"--json")) {
+    printStatsJson(tape, stats);
+  } else {
+    printStatsTable(tape, stats);
+  }
   return 0;
 }
 
@@ -1279,25 +1704,16 @@ void printUsage() {
   std::cout
       << "irDashies iRacing telemetry record/replay tool\n\n"
       << "Commands:\n"
-      << "  record  --output <capture.irdt> [--duration <seconds>]\n"
-      << "  play    --input <capture.irdt> [--speed <factor>] [--loop] "
+      << "  record  --output <capture.irdt> [--duration <seconds>] "
+         "[--vars <name,name,...|@names.txt>]\n"
+      << "  play    --input <capture.irdt|-> [--speed <factor>] [--loop] "
          "[--step] [--iracing-names]\n"
-      << "  inspect --input <capture.irdt>\n"
+      << "  inspect --input <capture.irdt> [--json] [--jobs <n>]\n"
       << "  fixture --output <fixture.irdt>\n\n"
       << "Step mode reads 'next' and 'quit' commands from stdin.\n";
 }
 
-}  // namespace
-
-int wmain(int argc, wchar_t* argv[]) {
-  SetConsoleCtrlHandler(handleConsoleSignal, TRUE);
-
-  std::vector<std::wstring> arguments;
-  arguments.reserve(static_cast<std::size_t>(argc));
-  for (int i = 0; i < argc; ++i) {
-    arguments.emplace_back(argv[i]);
-  }
-
+int runCommand(const std::vector<std::wstring>& arguments) {
   if (arguments.size() < 2 || arguments[1] == L"--help" ||
       arguments[1] == L"-h") {
     printUsage();
@@ -1320,3 +1736,47 @@ int wmain(int argc, wchar_t* argv[]) {
   printUsage();
   return 2;
 }
+
+#if !defined(_WIN32)
+std::wstring widenArgument(const char* argument) {
+  const auto length = std::mbstowcs(nullptr, argument, 0);
+  if (length == static_cast<std::size_t>(-1)) {
+    return std::wstring(argument, argument + std::strlen(argument));
+  }
+  std::wstring widened(length, L'\0');
+  std::mbstowcs(widened.data(), argument, length);
+  return widened;
+}
+#endif
+
+}  // namespace
+
+#if defined(_WIN32)
+int wmain(int argc, wchar_t* argv[]) {
+  SetConsoleCtrlHandler(handleConsoleSignal, TRUE);
+
+  std::vector<std::wstring> arguments;
+  arguments.reserve(static_cast<std::size_t>(argc));
+  for (int i = 0; i < argc; ++i) {
+    arguments.emplace_back(argv[i]);
+  }
+  return runCommand(arguments);
+}
+#else
+int main(int argc, char* argv[]) {
+  std::setlocale(LC_ALL, "");
+
+  struct sigaction action {};
+  action.sa_handler = handleTerminationSignal;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGINT, &action, nullptr);
+  sigaction(SIGTERM, &action, nullptr);
+
+  std::vector<std::wstring> arguments;
+  arguments.reserve(static_cast<std::size_t>(argc));
+  for (int i = 0; i < argc; ++i) {
+    arguments.push_back(widenArgument(argv[i]));
+  }
+  return runCommand(arguments);
+}
+#endif
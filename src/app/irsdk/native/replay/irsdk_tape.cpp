@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <array>
 #include <cstring>
+#include <iterator>
 #include <limits>
 #include <system_error>
 
@@ -49,6 +50,17 @@ bool readExact(
   return true;
 }
 
+bool validRecordHeader(
+    const TapeRecordHeader& record,
+    std::uint32_t formatVersion) {
+  const auto lastKind =
+      formatVersion == 1 ? RecordKind::End : RecordKind::Repeat;
+  return record.recordHeaderSize == sizeof(TapeRecordHeader) &&
+      record.payloadSize <= kMaxPayloadSize &&
+      record.kind >= static_cast<std::uint32_t>(RecordKind::Frame) &&
+      record.kind <= static_cast<std::uint32_t>(lastKind);
+}
+
 }  // namespace
 
 std::uint32_t checksum(const void* data, std::size_t size) {
@@ -163,6 +175,157 @@ bool validateSdkLayout(
   return true;
 }
 
+bool sameFrameLayout(const irsdk_header& left, const irsdk_header& right) {
+  return left.ver == right.ver &&
+      left.tickRate == right.tickRate &&
+      left.numVars == right.numVars &&
+      left.varHeaderOffset == right.varHeaderOffset &&
+      left.numBuf == right.numBuf &&
+      left.bufLen == right.bufLen;
+}
+
+bool parseVariableList(
+    const std::wstring& input,
+    std::vector<std::string>& names,
+    std::string& error) {
+  std::wstring text = input;
+  if (!text.empty() && text.front() == L'@') {
+    std::ifstream file(std::filesystem::path(text.substr(1)), std::ios::binary);
+    if (!file) {
+      error = "Could not read the variable list file";
+      return false;
+    }
+    const std::string contents(
+        (std::istreambuf_iterator<char>(file)),
+        std::istreambuf_iterator<char>());
+    text.assign(contents.begin(), contents.end());
+  }
+
+  std::string current;
+  auto flush = [&]() {
+    if (!current.empty()) {
+      names.push_back(current);
+      current.clear();
+    }
+  };
+  for (const wchar_t character : text) {
+    if (character == L',' || character == L'\n' || character == L'\r' ||
+        character == L' ' || character == L'\t') {
+      flush();
+    } else if (character > 0x7f) {
+      error = "Telemetry variable names must be ASCII";
+      return false;
+    } else {
+      current.push_back(static_cast<char>(character));
+    }
+  }
+  flush();
+
+  if (names.empty()) {
+    error = "--vars requires at least one variable name";
+    return false;
+  }
+  return true;
+}
+
+bool SchemaSubset::build(
+    const irsdk_header& source,
+    const std::vector<irsdk_varHeader>& variables,
+    const std::vector<std::string>& names,
+    std::string& error) {
+  std::uint64_t sourceSize = 0;
+  if (!validateSdkLayout(source, variables, sourceSize, error)) {
+    return false;
+  }
+  if (names.empty()) {
+    error = "The variable allowlist is empty";
+    return false;
+  }
+
+  std::vector<bool> selected(variables.size(), false);
+  for (const auto& name : names) {
+    const auto match = std::find_if(
+        variables.begin(),
+        variables.end(),
+        [&name](const irsdk_varHeader& variable) {
+          return std::strncmp(
+                     variable.name,
+                     name.c_str(),
+                     IRSDK_MAX_STRING) == 0;
+        });
+    if (match == variables.end()) {
+      error = "Telemetry variable not found: " + name;
+      return false;
+    }
+    selected[static_cast<std::size_t>(match - variables.begin())] = true;
+  }
+
+  variables_.clear();
+  spans_.clear();
+  std::uint32_t offset = 0;
+  for (std::size_t index = 0; index < variables.size(); ++index) {
+    if (!selected[index]) {
+      continue;
+    }
+    auto variable = variables[index];
+    const auto elementSize =
+        static_cast<std::uint32_t>(irsdk_VarTypeBytes[variable.type]);
+    const auto length =
+        elementSize * static_cast<std::uint32_t>(variable.count);
+    offset = (offset + elementSize - 1) / elementSize * elementSize;
+
+    const auto sourceOffset = static_cast<std::uint32_t>(variable.offset);
+    if (!spans_.empty() &&
+        spans_.back().sourceOffset + spans_.back().length == sourceOffset &&
+        spans_.back().destinationOffset + spans_.back().length == offset) {
+      spans_.back().length += length;
+    } else {
+      spans_.push_back({sourceOffset, offset, length});
+    }
+
+    variable.offset = static_cast<int>(offset);
+    variables_.push_back(variable);
+    offset += length;
+  }
+
+  // Matches the 16-byte alignment iRacing uses between its own regions.
+  auto align16 = [](std::uint64_t value) { return (value + 15) / 16 * 16; };
+
+  header_ = source;
+  header_.numVars = static_cast<int>(variables_.size());
+  header_.bufLen = static_cast<int>(align16(std::max<std::uint32_t>(offset, 1)));
+  header_.varHeaderOffset = static_cast<int>(align16(sizeof(irsdk_header)));
+  std::uint64_t next =
+      align16(static_cast<std::uint64_t>(header_.varHeaderOffset) +
+              variables_.size() * sizeof(irsdk_varHeader));
+  for (int i = 0; i < header_.numBuf; ++i) {
+    header_.varBuf[i].bufOffset = static_cast<int>(next);
+    next = align16(next + static_cast<std::uint64_t>(header_.bufLen));
+  }
+  header_.sessionInfoOffset = static_cast<int>(next);
+  header_.sessionInfoLen = 0;
+
+  std::uint64_t compactSize = 0;
+  return validateSdkLayout(header_, variables_, compactSize, error);
+}
+
+void SchemaSubset::compactFrame(
+    const char* source,
+    char* destination) const {
+  std::memset(destination, 0, static_cast<std::size_t>(header_.bufLen));
+  for (const auto& span : spans_) {
+    std::memcpy(
+        destination + span.destinationOffset,
+        source + span.sourceOffset,
+        span.length);
+  }
+}
+
+std::uint64_t SchemaSubset::mappingSize(std::uint64_t sessionLength) const {
+  return static_cast<std::uint64_t>(header_.sessionInfoOffset) +
+      std::max<std::uint64_t>(sessionLength, 1);
+}
+
 bool TapeWriter::open(
     const std::filesystem::path& path,
     const irsdk_header& sdkHeader,
@@ -216,6 +379,8 @@ bool TapeWriter::open(
   header_.schemaChecksum =
       checksum(variables.data(), variables.size() * sizeof(irsdk_varHeader));
 
+  nextOffset_ = sizeof(header_) + sizeof(sdkHeader) +
+      variables.size() * sizeof(irsdk_varHeader);
   return writeExact(stream_, &header_, sizeof(header_), error) &&
       writeExact(stream_, &sdkHeader, sizeof(sdkHeader), error) &&
       writeExact(
@@ -243,6 +408,76 @@ bool TapeWriter::append(
     return false;
   }
 
+  const auto payloadChecksum =
+      payloadSize == 0 ? checksum(nullptr, 0) : checksum(payload, payloadSize);
+  if (!frameRepeats_ || kind != RecordKind::Frame) {
+    if (kind == RecordKind::Disconnect) {
+      hasLastFrame_ = false;
+    }
+    return flushRepeats(error) &&
+        writeRecord(
+            kind,
+            elapsedTicks,
+            sourceTick,
+            value,
+            payload,
+            payloadSize,
+            payloadChecksum,
+            error);
+  }
+
+  const auto previousTick = repeatCount_ > 0
+      ? repeatFirstTick_ + static_cast<std::int32_t>(repeatCount_) - 1
+      : lastFrameTick_;
+  if (hasLastFrame_ && payloadChecksum == lastFrameChecksum_ &&
+      payloadSize == lastFrame_.size() &&
+      previousTick < std::numeric_limits<std::int32_t>::max() &&
+      sourceTick == previousTick + 1 &&
+      repeatCount_ <
+          static_cast<std::uint32_t>(std::numeric_limits<std::int32_t>::max()) &&
+      std::memcmp(payload, lastFrame_.data(), payloadSize) == 0) {
+    if (repeatCount_ == 0) {
+      repeatFirstElapsed_ = elapsedTicks;
+      repeatFirstTick_ = sourceTick;
+    }
+    repeatLastElapsed_ = elapsedTicks;
+    ++repeatCount_;
+    ++repeatedFrames_;
+    return true;
+  }
+
+  if (!flushRepeats(error)) {
+    return false;
+  }
+  lastFrameOffset_ = nextOffset_;
+  if (!writeRecord(
+          kind,
+          elapsedTicks,
+          sourceTick,
+          value,
+          payload,
+          payloadSize,
+          payloadChecksum,
+          error)) {
+    return false;
+  }
+  const auto* bytes = static_cast<const char*>(payload);
+  lastFrame_.assign(bytes, bytes + payloadSize);
+  lastFrameChecksum_ = payloadChecksum;
+  lastFrameTick_ = sourceTick;
+  hasLastFrame_ = true;
+  return true;
+}
+
+bool TapeWriter::writeRecord(
+    RecordKind kind,
+    std::uint64_t elapsedTicks,
+    std::int32_t sourceTick,
+    std::int32_t value,
+    const void* payload,
+    std::uint32_t payloadSize,
+    std::uint32_t payloadChecksum,
+    std::string& error) {
   TapeRecordHeader record{};
   record.kind = static_cast<std::uint32_t>(kind);
   record.recordHeaderSize = sizeof(TapeRecordHeader);
@@ -250,8 +485,7 @@ bool TapeWriter::append(
   record.elapsedTicks = elapsedTicks;
   record.sourceTick = sourceTick;
   record.value = value;
-  record.payloadChecksum =
-      payloadSize == 0 ? checksum(nullptr, 0) : checksum(payload, payloadSize);
+  record.payloadChecksum = payloadChecksum;
 
   if (!writeExact(stream_, &record, sizeof(record), error) ||
       (payloadSize > 0 &&
@@ -260,6 +494,55 @@ bool TapeWriter::append(
   }
 
   ++header_.recordCount;
+  nextOffset_ += sizeof(record) + payloadSize;
+  return true;
+}
+
+bool TapeWriter::flushRepeats(std::string& error) {
+  if (repeatCount_ == 0) {
+    return true;
+  }
+  TapeRepeat repeat{};
+  repeat.frameOffset = lastFrameOffset_;
+  repeat.lastElapsedTicks = repeatLastElapsed_;
+  repeat.lastSourceTick =
+      repeatFirstTick_ + static_cast<std::int32_t>(repeatCount_) - 1;
+  const auto count = static_cast<std::int32_t>(repeatCount_);
+  repeatCount_ = 0;
+  return writeRecord(
+      RecordKind::Repeat,
+      repeatFirstElapsed_,
+      repeatFirstTick_,
+      count,
+      &repeat,
+      sizeof(repeat),
+      checksum(&repeat, sizeof(repeat)),
+      error);
+}
+
+bool TapeWriter::appendEventIndex(
+    const std::vector<TapeEvent>& events,
+    std::uint64_t elapsedTicks,
+    std::string& error) {
+  if (events.empty()) {
+    return true;
+  }
+  if (events.size() > kMaxPayloadSize / sizeof(TapeEvent)) {
+    error = "Telemetry tape event index is too large";
+    return false;
+  }
+  const auto offset = nextRecordOffset();
+  if (!append(
+          RecordKind::EventIndex,
+          elapsedTicks,
+          -1,
+          static_cast<std::int32_t>(events.size()),
+          events.data(),
+          static_cast<std::uint32_t>(events.size() * sizeof(TapeEvent)),
+          error)) {
+    return false;
+  }
+  header_.eventIndexOffset = offset;
   return true;
 }
 
@@ -276,6 +559,9 @@ bool TapeWriter::finish(std::uint64_t mappingSize, std::string& error) {
     return false;
   }
 
+  if (!flushRepeats(error)) {
+    return false;
+  }
   header_.mappingSize = std::max(header_.mappingSize, mappingSize);
   stream_.seekp(0);
   if (!writeExact(stream_, &header_, sizeof(header_), error)) {
@@ -293,12 +579,38 @@ bool TapeWriter::finish(std::uint64_t mappingSize, std::string& error) {
 bool TapeReader::open(
     const std::filesystem::path& path,
     std::string& error) {
-  stream_.open(path, std::ios::binary);
-  if (!stream_) {
+  file_.open(path, std::ios::binary);
+  if (!file_) {
     error = "Could not open the telemetry tape";
     return false;
   }
+  stream_.rdbuf(file_.rdbuf());
+  stream_.clear();
+  return readHeaders(error);
+}
 
+bool TapeReader::openStream(
+    const std::filesystem::path& path,
+    std::size_t readAheadBytes,
+    std::string& error) {
+  auto readAhead = std::make_unique<ReadAheadBuffer>();
+  if (!readAhead->open(path, readAheadBytes, error)) {
+    return false;
+  }
+  readAhead_ = std::move(readAhead);
+  stream_.rdbuf(readAhead_.get());
+  stream_.clear();
+  if (!readHeaders(error)) {
+    const auto readError = readAhead_->readError();
+    if (!readError.empty()) {
+      error = readError;
+    }
+    return false;
+  }
+  return true;
+}
+
+bool TapeReader::readHeaders(std::string& error) {
   if (!readExact(stream_, &fileHeader_, sizeof(fileHeader_), error)) {
     return false;
   }
@@ -309,7 +621,14 @@ bool TapeReader::open(
     error = "File is not an irDashies telemetry tape";
     return false;
   }
-  if (fileHeader_.formatVersion != kTapeFormatVersion ||
+  if (fileHeader_.formatVersion > kTapeFormatVersion) {
+    error = "Telemetry tape format version " +
+        std::to_string(fileHeader_.formatVersion) +
+        " is newer than this build supports";
+    return false;
+  }
+  if (fileHeader_.formatVersion == 0 ||
+      (fileHeader_.formatVersion == 1 && fileHeader_.eventIndexOffset != 0) ||
       fileHeader_.endianMarker != kEndianMarker ||
       fileHeader_.fileHeaderSize != sizeof(TapeFileHeader) ||
       fileHeader_.sdkHeaderSize != sizeof(irsdk_header) ||
@@ -348,7 +667,9 @@ bool TapeReader::open(
     return false;
   }
 
-  recordsOffset_ = stream_.tellg();
+  position_ = sizeof(fileHeader_) + sizeof(sdkHeader_) +
+      variables_.size() * sizeof(irsdk_varHeader);
+  recordsOffset_ = static_cast<std::streamoff>(position_);
   return true;
 }
 
@@ -356,9 +677,21 @@ TapeReadResult TapeReader::readNext(
     TapeRecordHeader& record,
     std::vector<char>& payload,
     std::string& error) {
+  if (repeatNext_ < static_cast<std::uint32_t>(repeatRecord_.value)) {
+    expandRepeat(record, payload);
+    return TapeReadResult::Record;
+  }
+
+  const auto recordOffset = position_;
   stream_.read(
       reinterpret_cast<char*>(&record),
       static_cast<std::streamsize>(sizeof(record)));
+  if (readAhead_ != nullptr && !stream_) {
+    error = readAhead_->readError();
+    if (!error.empty()) {
+      return TapeReadResult::Error;
+    }
+  }
   if (stream_.eof() && stream_.gcount() == 0) {
     return TapeReadResult::EndOfFile;
   }
@@ -366,10 +699,7 @@ TapeReadResult TapeReader::readNext(
     error = "Telemetry tape record header is truncated";
     return TapeReadResult::Error;
   }
-  if (record.recordHeaderSize != sizeof(TapeRecordHeader) ||
-      record.payloadSize > kMaxPayloadSize ||
-      record.kind < static_cast<std::uint32_t>(RecordKind::Frame) ||
-      record.kind > static_cast<std::uint32_t>(RecordKind::End)) {
+  if (!validRecordHeader(record, fileHeader_.formatVersion)) {
     error = "Invalid telemetry tape record";
     return TapeReadResult::Error;
   }
@@ -386,17 +716,342 @@ TapeReadResult TapeReader::readNext(
     error = "Telemetry tape record checksum mismatch";
     return TapeReadResult::Error;
   }
+  position_ += sizeof(record) + record.payloadSize;
+
+  const auto kind = static_cast<RecordKind>(record.kind);
+  if (kind == RecordKind::Frame && !seekable()) {
+    repeatFrame_ = payload;
+    repeatFrameOffset_ = recordOffset;
+    repeatFrameChecksum_ = record.payloadChecksum;
+    repeatFrameValue_ = record.value;
+  }
+  if (kind == RecordKind::Repeat) {
+    if (!loadRepeat(record, payload, recordOffset, error)) {
+      return TapeReadResult::Error;
+    }
+    expandRepeat(record, payload);
+    return TapeReadResult::Record;
+  }
 
+  repeatStart_ = 0;
+  ++nextRecordIndex_;
   return TapeReadResult::Record;
 }
 
+bool TapeReader::loadRepeat(
+    const TapeRecordHeader& record,
+    const std::vector<char>& payload,
+    std::uint64_t recordOffset,
+    std::string& error) {
+  TapeRepeat repeat{};
+  if (payload.size() != sizeof(repeat) || record.value < 1) {
+    error = "Invalid telemetry tape repeat record";
+    return false;
+  }
+  std::memcpy(&repeat, payload.data(), sizeof(repeat));
+  const auto lastTick = static_cast<std::int64_t>(record.sourceTick) +
+      record.value - 1;
+  if (repeat.lastSourceTick != lastTick ||
+      repeat.lastElapsedTicks < record.elapsedTicks ||
+      repeat.frameOffset < static_cast<std::uint64_t>(recordsOffset_) ||
+      repeat.frameOffset >= recordOffset) {
+    error = "Invalid telemetry tape repeat record";
+    return false;
+  }
+
+  if (repeat.frameOffset != repeatFrameOffset_ &&
+      !loadRepeatedFrame(repeat.frameOffset, error)) {
+    return false;
+  }
+
+  repeatRecord_ = record;
+  repeat_ = repeat;
+  repeatNext_ = std::min(
+      repeatStart_, static_cast<std::uint32_t>(record.value) - 1);
+  repeatStart_ = 0;
+  return true;
+}
+
+bool TapeReader::loadRepeatedFrame(
+    std::uint64_t frameOffset,
+    std::string& error) {
+  if (!seekable()) {
+    error = "Telemetry tape stream repeats a frame it no longer holds";
+    return false;
+  }
+  repeatFrameOffset_ = 0;
+  stream_.seekg(static_cast<std::streamoff>(frameOffset));
+  TapeRecordHeader frame{};
+  if (!stream_ || !readExact(stream_, &frame, sizeof(frame), error)) {
+    error = "Telemetry tape repeated frame is truncated";
+    return false;
+  }
+  if (!validRecordHeader(frame, fileHeader_.formatVersion) ||
+      static_cast<RecordKind>(frame.kind) != RecordKind::Frame) {
+    error = "Telemetry tape repeat does not refer to a frame";
+    return false;
+  }
+  repeatFrame_.resize(frame.payloadSize);
+  if (frame.payloadSize > 0 &&
+      !readExact(stream_, repeatFrame_.data(), repeatFrame_.size(), error)) {
+    return false;
+  }
+  const auto frameChecksum = frame.payloadSize == 0
+      ? checksum(nullptr, 0)
+      : checksum(repeatFrame_.data(), repeatFrame_.size());
+  if (frameChecksum != frame.payloadChecksum) {
+    error = "Telemetry tape record checksum mismatch";
+    return false;
+  }
+  stream_.seekg(static_cast<std::streamoff>(position_));
+  if (!stream_) {
+    error = "Could not restore the telemetry tape position";
+    return false;
+  }
+
+  repeatFrameOffset_ = frameOffset;
+  repeatFrameChecksum_ = frameChecksum;
+  repeatFrameValue_ = frame.value;
+  return true;
+}
+
+void TapeReader::expandRepeat(
+    TapeRecordHeader& record,
+    std::vector<char>& payload) {
+  // Elapsed times inside a run are spread evenly between its first and last
+  // frame; the recorder only keeps those two.
+  const auto count = static_cast<std::uint32_t>(repeatRecord_.value);
+  const auto first = repeatRecord_.elapsedTicks;
+  const auto span = repeat_.lastElapsedTicks - first;
+  const auto position = repeatNext_++;
+
+  record = {};
+  record.kind = static_cast<std::uint32_t>(RecordKind::Frame);
+  record.recordHeaderSize = sizeof(TapeRecordHeader);
+  record.payloadSize = static_cast<std::uint32_t>(repeatFrame_.size());
+  record.flags = kRecordFlagRepeated;
+  record.elapsedTicks = count > 1 ? first + span * position / (count - 1)
+                                  : first;
+  record.sourceTick = repeatRecord_.sourceTick + static_cast<std::int32_t>(position);
+  record.value = repeatFrameValue_;
+  record.payloadChecksum = repeatFrameChecksum_;
+  payload = repeatFrame_;
+  ++nextRecordIndex_;
+
+  if (repeatNext_ >= count) {
+    repeatRecord_ = {};
+    repeatNext_ = 0;
+  }
+}
+
 bool TapeReader::rewindRecords(std::string& error) {
+  if (!seekable()) {
+    error = "A streamed telemetry tape cannot be rewound";
+    return false;
+  }
   stream_.clear();
   stream_.seekg(recordsOffset_);
   if (!stream_) {
     error = "Could not rewind telemetry tape";
     return false;
   }
+  position_ = static_cast<std::uint64_t>(recordsOffset_);
+  nextRecordIndex_ = 0;
+  repeatRecord_ = {};
+  repeatNext_ = 0;
+  repeatStart_ = 0;
+  return true;
+}
+
+bool TapeReader::buildIndex(std::string& error) {
+  if (indexed_) {
+    return true;
+  }
+  if (!seekable()) {
+    error = "A streamed telemetry tape cannot be indexed";
+    return false;
+  }
+
+  stream_.clear();
+  const auto resumeOffset = stream_.tellg();
+  stream_.seekg(recordsOffset_);
+  if (!stream_ || resumeOffset < 0) {
+    error = "Could not index telemetry tape";
+    return false;
+  }
+
+  std::vector<TapeIndexEntry> entries;
+  entries.reserve(static_cast<std::size_t>(fileHeader_.recordCount));
+  auto offset = static_cast<std::uint64_t>(recordsOffset_);
+  while (true) {
+    TapeRecordHeader record{};
+    stream_.read(
+        reinterpret_cast<char*>(&record),
+        static_cast<std::streamsize>(sizeof(record)));
+    if (stream_.eof() && stream_.gcount() == 0) {
+      break;
+    }
+    if (!stream_ || !validRecordHeader(record, fileHeader_.formatVersion)) {
+      error = "Invalid telemetry tape record";
+      return false;
+    }
+    if (static_cast<RecordKind>(record.kind) == RecordKind::Repeat) {
+      if (!indexRepeat(record, offset, entries, error)) {
+        return false;
+      }
+    } else {
+      entries.push_back(
+          {offset,
+           record.elapsedTicks,
+           record.sourceTick,
+           record.value,
+           static_cast<RecordKind>(record.kind),
+           0,
+           offset});
+    }
+
+    offset += sizeof(TapeRecordHeader) + record.payloadSize;
+    stream_.seekg(static_cast<std::streamoff>(offset));
+    if (!stream_) {
+      error = "Telemetry tape record payload is truncated";
+      return false;
+    }
+  }
+
+  stream_.clear();
+  stream_.seekg(resumeOffset);
+  if (!stream_) {
+    error = "Could not restore the telemetry tape position";
+    return false;
+  }
+  index_ = std::move(entries);
+  indexed_ = true;
+  return true;
+}
+
+bool TapeReader::indexRepeat(
+    const TapeRecordHeader& record,
+    std::uint64_t offset,
+    std::vector<TapeIndexEntry>& entries,
+    std::string& error) {
+  TapeRepeat repeat{};
+  if (record.payloadSize != sizeof(repeat) || record.value < 1 ||
+      !readExact(stream_, &repeat, sizeof(repeat), error)) {
+    error = "Invalid telemetry tape repeat record";
+    return false;
+  }
+  // The repeated Frame record is always indexed already, since it precedes
+  // the repeat; its entry supplies the value every repeated frame shares.
+  const auto source = std::lower_bound(
+      entries.begin(),
+      entries.end(),
+      repeat.frameOffset,
+      [](const TapeIndexEntry& entry, std::uint64_t frameOffset) {
+        return entry.offset < frameOffset;
+      });
+  if (source == entries.end() || source->offset != repeat.frameOffset ||
+      source->kind != RecordKind::Frame || source->repeat != 0 ||
+      repeat.lastElapsedTicks < record.elapsedTicks) {
+    error = "Telemetry tape repeat does not refer to a frame";
+    return false;
+  }
+
+  const auto value = source->value;
+  const auto count = static_cast<std::uint32_t>(record.value);
+  const auto span = repeat.lastElapsedTicks - record.elapsedTicks;
+  for (std::uint32_t i = 0; i < count; ++i) {
+    entries.push_back(
+        {offset,
+         record.elapsedTicks + (count > 1 ? span * i / (count - 1) : 0),
+         record.sourceTick + static_cast<std::int32_t>(i),
+         value,
+         RecordKind::Frame,
+         i + 1,
+         repeat.frameOffset});
+  }
+  return true;
+}
+
+void TapeReader::useIndex(std::vector<TapeIndexEntry> index) {
+  index_ = std::move(index);
+  indexed_ = true;
+}
+
+bool TapeReader::readEvents(
+    std::vector<TapeEvent>& events,
+    std::string& error) {
+  events.clear();
+  if (!hasEventIndex()) {
+    return true;
+  }
+  if (!seekable()) {
+    error = "The event index of a streamed telemetry tape cannot be read";
+    return false;
+  }
+
+  stream_.clear();
+  const auto resumeOffset = stream_.tellg();
+  stream_.seekg(static_cast<std::streamoff>(fileHeader_.eventIndexOffset));
+  TapeRecordHeader record{};
+  if (!stream_ || resumeOffset < 0 ||
+      !readExact(stream_, &record, sizeof(record), error)) {
+    error = "Telemetry tape event index is truncated";
+    return false;
+  }
+  if (!validRecordHeader(record, fileHeader_.formatVersion) ||
+      static_cast<RecordKind>(record.kind) != RecordKind::EventIndex ||
+      record.payloadSize % sizeof(TapeEvent) != 0) {
+    error = "Invalid telemetry tape event index";
+    return false;
+  }
+  events.resize(record.payloadSize / sizeof(TapeEvent));
+  if (!events.empty() &&
+      !readExact(stream_, events.data(), record.payloadSize, error)) {
+    return false;
+  }
+  const auto actualChecksum = events.empty()
+      ? checksum(nullptr, 0)
+      : checksum(events.data(), record.payloadSize);
+  if (actualChecksum != record.payloadChecksum) {
+    events.clear();
+    error = "Telemetry tape event index checksum mismatch";
+    return false;
+  }
+
+  stream_.clear();
+  stream_.seekg(resumeOffset);
+  if (!stream_) {
+    error = "Could not restore the telemetry tape position";
+    return false;
+  }
+  return true;
+}
+
+bool TapeReader::seekRecord(std::size_t recordIndex, std::string& error) {
+  if (!seekable()) {
+    error = "A streamed telemetry tape cannot seek";
+    return false;
+  }
+  if (!indexed_ && !buildIndex(error)) {
+    return false;
+  }
+  if (recordIndex >= index_.size()) {
+    error = "Telemetry tape record index is out of range";
+    return false;
+  }
+
+  const auto& entry = index_[recordIndex];
+  stream_.clear();
+  stream_.seekg(static_cast<std::streamoff>(entry.offset));
+  if (!stream_) {
+    error = "Could not seek within telemetry tape";
+    return false;
+  }
+  position_ = entry.offset;
+  nextRecordIndex_ = recordIndex;
+  repeatRecord_ = {};
+  repeatNext_ = 0;
+  repeatStart_ = entry.repeat > 0 ? entry.repeat - 1 : 0;
   return true;
 }
 
@@ -4,14 +4,18 @@
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "../lib/irsdk_defines.h"
+#include "./irsdk_tape_stream.h"
 
 namespace irdashies::irsdk_replay {
 
-constexpr std::uint32_t kTapeFormatVersion = 1;
+// Version 2 added the EventIndex and Repeat records. Readers accept version 1
+// tapes, which hold only Frame through End records, and reject newer ones.
+constexpr std::uint32_t kTapeFormatVersion = 2;
 constexpr std::uint32_t kEndianMarker = 0x01020304;
 constexpr std::uint64_t kMaxMappingSize = 512ULL * 1024ULL * 1024ULL;
 constexpr std::uint32_t kMaxPayloadSize = 64U * 1024U * 1024U;
@@ -22,6 +26,30 @@ enum class RecordKind : std::uint32_t {
   Gap = 3,
   Disconnect = 4,
   End = 5,
+  // Optional trailing record whose payload is TapeEvent[]; located through
+  // TapeFileHeader::eventIndexOffset.
+  EventIndex = 6,
+  // A run of frames byte-identical to an earlier Frame record. The payload is
+  // a TapeRepeat; the header's elapsedTicks and sourceTick describe the first
+  // repeated frame and value holds the run length.
+  Repeat = 7,
+};
+
+// TapeRecordHeader::flags bit set on Frame records that TapeReader expanded
+// from a Repeat record.
+constexpr std::uint32_t kRecordFlagRepeated = 1;
+
+// Telemetry transitions listed in an EventIndex record.
+enum class TapeEventKind : std::uint32_t {
+  // value: the new Lap.
+  Lap = 1,
+  // value: the new SessionNum.
+  Session = 2,
+  // value: the new SessionFlags bits.
+  Flags = 3,
+  // value: the Lap on which PlayerCarIdx entered or left pit road.
+  PitEntry = 4,
+  PitExit = 5,
 };
 
 #pragma pack(push, 1)
@@ -37,7 +65,9 @@ struct TapeFileHeader {
   std::uint64_t qpcFrequency;
   std::uint64_t recordCount;
   std::uint32_t schemaChecksum;
-  std::uint32_t reserved[9];
+  // Offset of the EventIndex record, or zero when the tape has none.
+  std::uint64_t eventIndexOffset;
+  std::uint32_t reserved[7];
 };
 
 struct TapeRecordHeader {
@@ -51,10 +81,35 @@ struct TapeRecordHeader {
   std::uint32_t payloadChecksum;
   std::uint32_t reserved;
 };
+
+// One event, pointing at the Frame record on which the transition is first
+// visible. The first frame of a tape, and the first after a disconnect,
+// records the starting lap, session, and flags, plus a PitEntry when the car
+// starts on pit road.
+struct TapeEvent {
+  std::uint32_t kind;
+  std::int32_t value;
+  std::uint64_t recordOffset;
+  std::uint64_t elapsedTicks;
+  std::int32_t sourceTick;
+  std::uint32_t reserved;
+};
+
+// Repeated frames take their payload from the Frame record at frameOffset.
+// Their ticks are consecutive from the header's sourceTick to lastSourceTick,
+// and their elapsed times are spread evenly up to lastElapsedTicks.
+struct TapeRepeat {
+  std::uint64_t frameOffset;
+  std::uint64_t lastElapsedTicks;
+  std::int32_t lastSourceTick;
+  std::uint32_t reserved;
+};
 #pragma pack(pop)
 
 static_assert(sizeof(TapeFileHeader) == 96, "TapeFileHeader layout changed");
 static_assert(sizeof(TapeRecordHeader) == 40, "TapeRecordHeader layout changed");
+static_assert(sizeof(TapeEvent) == 32, "TapeEvent layout changed");
+static_assert(sizeof(TapeRepeat) == 24, "TapeRepeat layout changed");
 
 std::uint32_t checksum(const void* data, std::size_t size);
 
@@ -64,6 +119,58 @@ bool validateSdkLayout(
     std::uint64_t& requiredSize,
     std::string& error);
 
+// True when both headers describe the same variables and frame buffers, so
+// frames published under either fit one tape.
+bool sameFrameLayout(const irsdk_header& left, const irsdk_header& right);
+
+// Parses a --vars value: names separated by commas or whitespace, or
+// @path to read the same list from a file.
+bool parseVariableList(
+    const std::wstring& input,
+    std::vector<std::string>& names,
+    std::string& error);
+
+// Packs an allowlisted subset of variables into a smaller SDK layout.
+// Selected variables keep their source order at naturally aligned offsets,
+// and the compacted mapping is laid out as header, variable headers, frame
+// buffers, then session info, so the session can grow without moving the
+// rest. The result passes validateSdkLayout like any recorded layout.
+class SchemaSubset {
+ public:
+  bool build(
+      const irsdk_header& source,
+      const std::vector<irsdk_varHeader>& variables,
+      const std::vector<std::string>& names,
+      std::string& error);
+
+  // Copies the selected variables from a source bufLen frame into a
+  // compacted frame of header().bufLen bytes.
+  void compactFrame(const char* source, char* destination) const;
+
+  // Mapping size needed to hold the compacted layout plus a session string
+  // of the given length.
+  std::uint64_t mappingSize(std::uint64_t sessionLength) const;
+
+  const irsdk_header& header() const {
+    return header_;
+  }
+
+  const std::vector<irsdk_varHeader>& variables() const {
+    return variables_;
+  }
+
+ private:
+  struct CopySpan {
+    std::uint32_t sourceOffset;
+    std::uint32_t destinationOffset;
+    std::uint32_t length;
+  };
+
+  irsdk_header header_{};
+  std::vector<irsdk_varHeader> variables_;
+  std::vector<CopySpan> spans_;
+};
+
 class TapeWriter {
  public:
   bool open(
@@ -83,16 +190,85 @@ class TapeWriter {
       std::uint32_t payloadSize,
       std::string& error);
 
+  // Holds back Frame records whose payload matches the previous frame's, by
+  // checksum and then byte for byte, and whose tick follows on. The run is
+  // written as one Repeat record before the next record of any other kind
+  // or content.
+  void enableFrameRepeats() {
+    frameRepeats_ = true;
+  }
+
+  // Appends the EventIndex record and points the file header at it. Call it
+  // after the End record; an empty list writes nothing.
+  bool appendEventIndex(
+      const std::vector<TapeEvent>& events,
+      std::uint64_t elapsedTicks,
+      std::string& error);
+
   bool finish(std::uint64_t mappingSize, std::string& error);
 
   std::uint64_t recordCount() const {
     return header_.recordCount;
   }
 
+  // File offset at which the next appended record that is not a repeat
+  // will start.
+  std::uint64_t nextRecordOffset() const {
+    return nextOffset_ +
+        (repeatCount_ > 0 ? sizeof(TapeRecordHeader) + sizeof(TapeRepeat) : 0);
+  }
+
+  // Frames folded into Repeat records so far.
+  std::uint64_t repeatedFrames() const {
+    return repeatedFrames_;
+  }
+
  private:
+  bool writeRecord(
+      RecordKind kind,
+      std::uint64_t elapsedTicks,
+      std::int32_t sourceTick,
+      std::int32_t value,
+      const void* payload,
+      std::uint32_t payloadSize,
+      std::uint32_t payloadChecksum,
+      std::string& error);
+  bool flushRepeats(std::string& error);
+
   std::fstream stream_;
   TapeFileHeader header_{};
+  std::uint64_t nextOffset_ = 0;
   bool finished_ = false;
+
+  // The last Frame record written, and the run of repeats held back after it.
+  bool frameRepeats_ = false;
+  std::vector<char> lastFrame_;
+  std::uint32_t lastFrameChecksum_ = 0;
+  std::uint64_t lastFrameOffset_ = 0;
+  std::int32_t lastFrameTick_ = 0;
+  bool hasLastFrame_ = false;
+  std::uint32_t repeatCount_ = 0;
+  std::uint64_t repeatFirstElapsed_ = 0;
+  std::uint64_t repeatLastElapsed_ = 0;
+  std::int32_t repeatFirstTick_ = 0;
+  std::uint64_t repeatedFrames_ = 0;
+};
+
+// Location of one record in a seekable tape. Every Frame record holds a
+// complete bufLen payload, so any indexed frame can be published directly
+// without replaying the records before it. A Repeat record is indexed as one
+// Frame entry per repeated frame, each at the Repeat record's offset.
+struct TapeIndexEntry {
+  std::uint64_t offset;
+  std::uint64_t elapsedTicks;
+  std::int32_t sourceTick;
+  std::int32_t value;
+  RecordKind kind;
+  // Position within a Repeat record's run, counting from 1, or 0.
+  std::uint32_t repeat;
+  // Frame record holding this frame's payload; equal to offset unless the
+  // frame is repeated.
+  std::uint64_t frameOffset;
 };
 
 enum class TapeReadResult {
@@ -105,6 +281,21 @@ class TapeReader {
  public:
   bool open(const std::filesystem::path& path, std::string& error);
 
+  // Reads a tape front to back from a pipe, FIFO, or standard input ("-"),
+  // buffering at most readAheadBytes ahead of readNext(). A stream cannot be
+  // rewound, indexed, or seeked, and its event index cannot be read; those
+  // calls fail with an error instead.
+  bool openStream(
+      const std::filesystem::path& path,
+      std::size_t readAheadBytes,
+      std::string& error);
+
+  bool seekable() const {
+    return readAhead_ == nullptr;
+  }
+
+  // Returns Repeat records as the Frame records they stand for, flagged with
+  // kRecordFlagRepeated, so readers see every recorded frame.
   TapeReadResult readNext(
       TapeRecordHeader& record,
       std::vector<char>& payload,
@@ -112,6 +303,38 @@ class TapeReader {
 
   bool rewindRecords(std::string& error);
 
+  // Scans every record header once, skipping payloads, and restores the
+  // current read position afterwards.
+  bool buildIndex(std::string& error);
+
+  // Adopts an index built by another reader of the same file, so parallel
+  // readers pay for the header scan once.
+  void useIndex(std::vector<TapeIndexEntry> index);
+
+  // Positions the reader so the next readNext() returns the indexed record.
+  bool seekRecord(std::size_t recordIndex, std::string& error);
+
+  bool hasEventIndex() const {
+    return fileHeader_.eventIndexOffset != 0;
+  }
+
+  // Reads the EventIndex record without moving the current read position.
+  // Tapes without one yield an empty list.
+  bool readEvents(std::vector<TapeEvent>& events, std::string& error);
+
+  bool indexed() const {
+    return indexed_;
+  }
+
+  const std::vector<TapeIndexEntry>& index() const {
+    return index_;
+  }
+
+  // Index of the record the next readNext() call will return.
+  std::size_t nextRecordIndex() const {
+    return nextRecordIndex_;
+  }
+
   const TapeFileHeader& fileHeader() const {
     return fileHeader_;
   }
@@ -125,11 +348,46 @@ class TapeReader {
   }
 
  private:
-  std::ifstream stream_;
+  bool readHeaders(std::string& error);
+  bool loadRepeat(
+      const TapeRecordHeader& record,
+      const std::vector<char>& payload,
+      std::uint64_t recordOffset,
+      std::string& error);
+  bool loadRepeatedFrame(std::uint64_t frameOffset, std::string& error);
+  void expandRepeat(TapeRecordHeader& record, std::vector<char>& payload);
+  bool indexRepeat(
+      const TapeRecordHeader& record,
+      std::uint64_t offset,
+      std::vector<TapeIndexEntry>& entries,
+      std::string& error);
+
+  std::ifstream file_;
+  std::unique_ptr<ReadAheadBuffer> readAhead_;
+  // Reads through file_ or readAhead_, whichever was opened.
+  std::istream stream_{nullptr};
+  // File offset of the next physical record.
+  std::uint64_t position_ = 0;
   TapeFileHeader fileHeader_{};
   irsdk_header sdkHeader_{};
   std::vector<irsdk_varHeader> variables_;
   std::streampos recordsOffset_{};
+  std::vector<TapeIndexEntry> index_;
+  std::size_t nextRecordIndex_ = 0;
+  bool indexed_ = false;
+
+  // Expansion state of the Repeat record being read.
+  TapeRecordHeader repeatRecord_{};
+  TapeRepeat repeat_{};
+  // The Frame record repeats refer to. A stream keeps its latest frame here,
+  // since repeats only ever refer to the frame just before them.
+  std::vector<char> repeatFrame_;
+  std::uint64_t repeatFrameOffset_ = 0;
+  std::uint32_t repeatFrameChecksum_ = 0;
+  std::int32_t repeatFrameValue_ = 0;
+  std::uint32_t repeatNext_ = 0;
+  // Run position a seekRecord() into a repeat starts from.
+  std::uint32_t repeatStart_ = 0;
 };
 
 }  // namespace irdashies::irsdk_replay
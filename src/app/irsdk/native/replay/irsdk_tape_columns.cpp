@@ -0,0 +1,340 @@
+#include "./irsdk_tape_columns.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+#include "./irsdk_tape.h"
+
+namespace irdashies::irsdk_replay {
+namespace {
+
+constexpr std::array<char, 8> kColumnMagic = {
+    'I', 'R', 'D', 'C', 'O', 'L', 'S', '\0'};
+
+// A selected variable's place in the frames being transposed.
+struct ColumnSource {
+  std::uint32_t frameOffset;
+  std::uint32_t width;
+  std::uint32_t type;
+};
+
+template <typename T>
+void accumulateRange(
+    const char* data,
+    std::size_t elements,
+    double& minimum,
+    double& maximum) {
+  // Plain loops over a contiguous column let the compiler vectorize the
+  // reduction. The argument order of std::min/max drops NaNs.
+  T low = std::numeric_limits<T>::max();
+  T high = std::numeric_limits<T>::lowest();
+  if constexpr (std::is_floating_point_v<T>) {
+    low = std::numeric_limits<T>::infinity();
+    high = -std::numeric_limits<T>::infinity();
+  }
+  for (std::size_t i = 0; i < elements; ++i) {
+    T value;
+    std::memcpy(&value, data + i * sizeof(T), sizeof(T));
+    low = std::min(low, value);
+    high = std::max(high, value);
+  }
+  if (elements == 0 || low > high) {
+    minimum = std::numeric_limits<double>::quiet_NaN();
+    maximum = std::numeric_limits<double>::quiet_NaN();
+    return;
+  }
+  minimum = static_cast<double>(low);
+  maximum = static_cast<double>(high);
+}
+
+ColumnChunkStats columnRange(
+    std::uint32_t type,
+    const char* data,
+    std::size_t elements) {
+  ColumnChunkStats stats{};
+  switch (type) {
+    case irsdk_char:
+    case irsdk_bool:
+      accumulateRange<std::uint8_t>(data, elements, stats.min, stats.max);
+      break;
+    case irsdk_int:
+      accumulateRange<std::int32_t>(data, elements, stats.min, stats.max);
+      break;
+    case irsdk_bitField:
+      accumulateRange<std::uint32_t>(data, elements, stats.min, stats.max);
+      break;
+    case irsdk_float:
+      accumulateRange<float>(data, elements, stats.min, stats.max);
+      break;
+    default:
+      accumulateRange<double>(data, elements, stats.min, stats.max);
+      break;
+  }
+  return stats;
+}
+
+// Names and units are fixed IRSDK_MAX_STRING fields that may lack a NUL.
+void copyName(char* destination, const char* source) {
+  const auto* end = static_cast<const char*>(
+      std::memchr(source, '\0', IRSDK_MAX_STRING - 1));
+  const auto length = end == nullptr
+      ? static_cast<std::size_t>(IRSDK_MAX_STRING - 1)
+      : static_cast<std::size_t>(end - source);
+  std::memcpy(destination, source, length);
+  destination[length] = '\0';
+}
+
+}  // namespace
+
+bool exportColumns(
+    const std::filesystem::path& input,
+    const std::filesystem::path& output,
+    const ColumnExportOptions& options,
+    ColumnExportSummary& summary,
+    std::string& error) {
+  summary = {};
+  if (options.chunkRows == 0 || options.jobs == 0) {
+    error = "Column export needs at least one row per chunk and one job";
+    return false;
+  }
+
+  TapeReader tape;
+  if (!tape.open(input, error) || !tape.buildIndex(error)) {
+    return false;
+  }
+
+  // An allowlist is applied with the recorder's compaction, so workers
+  // transpose the smaller compacted frame instead of the full buffer.
+  SchemaSubset subset;
+  const bool compact = !options.variables.empty();
+  if (compact &&
+      !subset.build(
+          tape.sdkHeader(), tape.variables(), options.variables, error)) {
+    return false;
+  }
+  const auto& variables = compact ? subset.variables() : tape.variables();
+  const auto compactBufLen =
+      compact ? static_cast<std::size_t>(subset.header().bufLen) : 0;
+
+  std::vector<ColumnHeader> columns(variables.size() + 1);
+  std::vector<ColumnSource> sources;
+  sources.reserve(variables.size());
+  copyName(columns[0].name, "_TapeTime");
+  copyName(columns[0].unit, "s");
+  columns[0].type = irsdk_double;
+  columns[0].count = 1;
+  columns[0].elementSize = sizeof(double);
+  std::uint64_t rowBytes = sizeof(double);
+  for (std::size_t i = 0; i < variables.size(); ++i) {
+    const auto& variable = variables[i];
+    auto& column = columns[i + 1];
+    copyName(column.name, variable.name);
+    copyName(column.unit, variable.unit);
+    column.type = static_cast<std::uint32_t>(variable.type);
+    column.count = static_cast<std::uint32_t>(variable.count);
+    column.elementSize =
+        static_cast<std::uint32_t>(irsdk_VarTypeBytes[variable.type]);
+    const auto width = column.count * column.elementSize;
+    sources.push_back(
+        {static_cast<std::uint32_t>(variable.offset), width, column.type});
+    rowBytes += width;
+  }
+
+  std::vector<std::size_t> frameRecords;
+  const auto& index = tape.index();
+  for (std::size_t i = 0; i < index.size(); ++i) {
+    if (index[i].kind == RecordKind::Frame) {
+      frameRecords.push_back(i);
+    }
+  }
+
+  const auto rowCount = static_cast<std::uint64_t>(frameRecords.size());
+  const auto chunkCount =
+      (rowCount + options.chunkRows - 1) / options.chunkRows;
+  ColumnFileHeader header{};
+  std::memcpy(header.magic, kColumnMagic.data(), kColumnMagic.size());
+  header.formatVersion = kColumnFormatVersion;
+  header.fileHeaderSize = sizeof(ColumnFileHeader);
+  header.columnHeaderSize = sizeof(ColumnHeader);
+  header.columnCount = static_cast<std::uint32_t>(columns.size());
+  header.chunkRows = options.chunkRows;
+  header.rowCount = rowCount;
+  header.chunkCount = chunkCount;
+  header.dataOffset =
+      sizeof(ColumnFileHeader) + columns.size() * sizeof(ColumnHeader);
+  header.statsOffset = header.dataOffset + rowCount * rowBytes;
+  const auto fileSize = header.statsOffset +
+      chunkCount * columns.size() * sizeof(ColumnChunkStats);
+
+  std::error_code fileError;
+  if (!output.parent_path().empty()) {
+    std::filesystem::create_directories(output.parent_path(), fileError);
+    if (fileError) {
+      error = "Could not create the column export directory";
+      return false;
+    }
+  }
+  {
+    std::ofstream stream(output, std::ios::binary | std::ios::trunc);
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.write(
+        reinterpret_cast<const char*>(columns.data()),
+        static_cast<std::streamsize>(columns.size() * sizeof(ColumnHeader)));
+    if (!stream) {
+      error = "Could not write the column export";
+      return false;
+    }
+  }
+  std::filesystem::resize_file(output, fileSize, fileError);
+  if (fileError) {
+    error = "Could not size the column export";
+    return false;
+  }
+
+  std::vector<ColumnChunkStats> stats(chunkCount * columns.size());
+  std::atomic<std::uint64_t> nextChunk = 0;
+  std::atomic_bool failed = false;
+  std::mutex errorMutex;
+  const auto sharedIndex = tape.index();
+  const auto frequency = static_cast<double>(tape.fileHeader().qpcFrequency);
+  const auto bufLen = static_cast<std::size_t>(tape.sdkHeader().bufLen);
+
+  auto fail = [&](const std::string& message) {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    if (!failed.exchange(true)) {
+      error = message;
+    }
+  };
+
+  auto worker = [&]() {
+    TapeReader reader;
+    std::string workerError;
+    if (!reader.open(input, workerError)) {
+      fail(workerError);
+      return;
+    }
+    reader.useIndex(sharedIndex);
+    std::fstream stream(
+        output, std::ios::binary | std::ios::in | std::ios::out);
+    if (!stream) {
+      fail("Could not open the column export for writing");
+      return;
+    }
+
+    TapeRecordHeader record{};
+    std::vector<char> payload;
+    std::vector<char> compacted(compactBufLen);
+    std::vector<char> chunk;
+    while (!failed.load()) {
+      const auto chunkIndex = nextChunk.fetch_add(1);
+      if (chunkIndex >= chunkCount) {
+        return;
+      }
+      const auto firstRow = chunkIndex * options.chunkRows;
+      const auto rows = static_cast<std::size_t>(
+          std::min<std::uint64_t>(options.chunkRows, rowCount - firstRow));
+      chunk.resize(rows * rowBytes);
+      if (!reader.seekRecord(frameRecords[firstRow], workerError)) {
+        fail(workerError);
+        return;
+      }
+
+      for (std::size_t row = 0; row < rows;) {
+        const auto result = reader.readNext(record, payload, workerError);
+        if (result != TapeReadResult::Record) {
+          fail(
+              result == TapeReadResult::Error
+                  ? workerError
+                  : "Telemetry tape ended before its indexed frames");
+          return;
+        }
+        if (static_cast<RecordKind>(record.kind) != RecordKind::Frame) {
+          continue;
+        }
+        if (payload.size() != bufLen) {
+          fail("Tape frame does not match the recorded buffer length");
+          return;
+        }
+        const char* frame = payload.data();
+        if (compact) {
+          subset.compactFrame(payload.data(), compacted.data());
+          frame = compacted.data();
+        }
+
+        const double seconds =
+            static_cast<double>(record.elapsedTicks) / frequency;
+        std::memcpy(
+            chunk.data() + row * sizeof(double),
+            &seconds,
+            sizeof(seconds));
+        std::size_t columnStart = rows * sizeof(double);
+        for (const auto& source : sources) {
+          std::memcpy(
+              chunk.data() + columnStart + row * source.width,
+              frame + source.frameOffset,
+              source.width);
+          columnStart += rows * source.width;
+        }
+        ++row;
+      }
+
+      auto* chunkStats = stats.data() + chunkIndex * columns.size();
+      std::size_t columnStart = 0;
+      for (std::size_t column = 0; column < columns.size(); ++column) {
+        const auto& description = columns[column];
+        chunkStats[column] = columnRange(
+            description.type,
+            chunk.data() + columnStart,
+            rows * description.count);
+        columnStart += rows * description.count * description.elementSize;
+      }
+
+      stream.seekp(static_cast<std::streamoff>(
+          header.dataOffset + firstRow * rowBytes));
+      stream.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+      if (!stream) {
+        fail("Could not write the column export");
+        return;
+      }
+    }
+  };
+
+  const auto workerCount = static_cast<std::size_t>(std::min<std::uint64_t>(
+      options.jobs, std::max<std::uint64_t>(chunkCount, 1)));
+  std::vector<std::thread> workers;
+  workers.reserve(workerCount);
+  for (std::size_t i = 0; i < workerCount; ++i) {
+    workers.emplace_back(worker);
+  }
+  for (auto& thread : workers) {
+    thread.join();
+  }
+  if (failed.load()) {
+    return false;
+  }
+
+  std::fstream stream(output, std::ios::binary | std::ios::in | std::ios::out);
+  stream.seekp(static_cast<std::streamoff>(header.statsOffset));
+  stream.write(
+      reinterpret_cast<const char*>(stats.data()),
+      static_cast<std::streamsize>(stats.size() * sizeof(ColumnChunkStats)));
+  if (!stream) {
+    error = "Could not write the column statistics";
+    return false;
+  }
+
+  summary.rows = rowCount;
+  summary.chunks = chunkCount;
+  summary.columns = header.columnCount;
+  return true;
+}
+
+}  // namespace irdashies::irsdk_replay
@@ -0,0 +1,91 @@
+#ifndef IRDASHIES_IRSDK_TAPE_COLUMNS_H
+#define IRDASHIES_IRSDK_TAPE_COLUMNS_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "../lib/irsdk_defines.h"
+
+namespace irdashies::irsdk_replay {
+
+constexpr std::uint32_t kColumnFormatVersion = 1;
+constexpr std::uint32_t kDefaultChunkRows = 4096;
+
+// Column file (.irdc) layout, all little-endian:
+//   ColumnFileHeader
+//   ColumnHeader[columnCount]
+//   data at dataOffset: chunks in row order; within a chunk, each column's
+//     rows * count * elementSize bytes in column order
+//   ColumnChunkStats[chunkCount][columnCount] at statsOffset
+// Every chunk except the last holds chunkRows rows, so chunk c starts at
+// dataOffset + c * chunkRows * rowBytes, where rowBytes is the sum of each
+// column's count * elementSize. Column 0 is "_TapeTime", the frame's elapsed
+// tape time in seconds as a double; the remaining columns are telemetry
+// variables in schema order with their irsdk_VarType.
+#pragma pack(push, 1)
+struct ColumnFileHeader {
+  char magic[8];
+  std::uint32_t formatVersion;
+  std::uint32_t fileHeaderSize;
+  std::uint32_t columnHeaderSize;
+  std::uint32_t columnCount;
+  std::uint32_t chunkRows;
+  std::uint32_t reserved0;
+  std::uint64_t rowCount;
+  std::uint64_t chunkCount;
+  std::uint64_t dataOffset;
+  std::uint64_t statsOffset;
+  std::uint32_t reserved[4];
+};
+
+struct ColumnHeader {
+  char name[IRSDK_MAX_STRING];
+  char unit[IRSDK_MAX_STRING];
+  std::uint32_t type;
+  std::uint32_t count;
+  std::uint32_t elementSize;
+  std::uint32_t reserved;
+};
+
+// Range over every element of one column in one chunk. NaNs are skipped;
+// both values are NaN when the chunk holds no comparable element.
+struct ColumnChunkStats {
+  double min;
+  double max;
+};
+#pragma pack(pop)
+
+static_assert(
+    sizeof(ColumnFileHeader) == 80,
+    "ColumnFileHeader layout changed");
+static_assert(sizeof(ColumnHeader) == 80, "ColumnHeader layout changed");
+
+struct ColumnExportOptions {
+  // Empty exports every variable.
+  std::vector<std::string> variables;
+  std::uint32_t chunkRows = kDefaultChunkRows;
+  std::size_t jobs = 1;
+};
+
+struct ColumnExportSummary {
+  std::uint64_t rows = 0;
+  std::uint64_t chunks = 0;
+  std::uint32_t columns = 0;
+};
+
+// Transposes a tape's Frame records into an .irdc column file. Chunks are
+// independent, so workers each read, transpose, and write whole chunks at
+// their precomputed offsets. Gap and session records are not exported; gaps
+// show up as jumps in _TapeTime.
+bool exportColumns(
+    const std::filesystem::path& input,
+    const std::filesystem::path& output,
+    const ColumnExportOptions& options,
+    ColumnExportSummary& summary,
+    std::string& error);
+
+}  // namespace irdashies::irsdk_replay
+
+#endif
@@ -0,0 +1,485 @@
+#include "./irsdk_tape_convert.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "./irsdk_ibt.h"
+#include "./irsdk_tape.h"
+#include "./irsdk_tape_events.h"
+#include "./irsdk_telemetry_wire.h"
+
+namespace irdashies::irsdk_replay {
+
+namespace {
+
+// Offset of SessionTime within a frame, or -1 when the schema lacks it.
+int sessionTimeOffset(
+    const irsdk_header& header,
+    const std::vector<irsdk_varHeader>& variables) {
+  for (const auto& variable : variables) {
+    if (std::strncmp(variable.name, "SessionTime", IRSDK_MAX_STRING) == 0 &&
+        variable.type == irsdk_double && variable.count >= 1 &&
+        variable.offset >= 0 &&
+        variable.offset + static_cast<int>(sizeof(double)) <= header.bufLen) {
+      return variable.offset;
+    }
+  }
+  return -1;
+}
+
+// Offset of SessionTick within a frame, or -1 when the schema lacks it.
+int sessionTickOffset(
+    const irsdk_header& header,
+    const std::vector<irsdk_varHeader>& variables) {
+  for (const auto& variable : variables) {
+    if (std::strncmp(variable.name, "SessionTick", IRSDK_MAX_STRING) == 0 &&
+        variable.type == irsdk_int && variable.count >= 1 &&
+        variable.offset >= 0 &&
+        variable.offset + static_cast<int>(sizeof(std::int32_t)) <=
+            header.bufLen) {
+      return variable.offset;
+    }
+  }
+  return -1;
+}
+
+std::string variableName(const char* text) {
+  const auto* end =
+      static_cast<const char*>(std::memchr(text, '\0', IRSDK_MAX_STRING));
+  return std::string(text, end == nullptr ? text + IRSDK_MAX_STRING : end);
+}
+
+bool writeBytes(
+    std::ofstream& stream,
+    const void* data,
+    std::size_t size,
+    std::string& error) {
+  stream.write(
+      static_cast<const char*>(data),
+      static_cast<std::streamsize>(size));
+  if (!stream) {
+    error = "Could not write the .ibt file";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+bool convertIbtToTape(
+    const std::filesystem::path& input,
+    const std::filesystem::path& output,
+    std::uint64_t& frames,
+    std::string& error) {
+  frames = 0;
+  IbtReader ibt;
+  if (!ibt.open(input, error)) {
+    return false;
+  }
+
+  irsdk_header header = ibt.header();
+  header.status = irsdk_stConnected;
+  header.varBuf[0].tickCount = 0;
+  std::uint64_t mappingSize = 0;
+  if (!validateSdkLayout(header, ibt.variables(), mappingSize, error)) {
+    return false;
+  }
+
+  // The session payload keeps its terminator when the reserved area has room
+  // for one, matching what a live capture records.
+  const auto sessionLength = ibt.sessionInfoLength();
+  std::vector<char> session(
+      std::min<std::size_t>(
+          sessionLength + 1,
+          static_cast<std::size_t>(header.sessionInfoLen)),
+      '\0');
+  std::memcpy(
+      session.data(),
+      ibt.sessionInfo(),
+      std::min(sessionLength, session.size()));
+
+  TapeWriter writer;
+  writer.enableFrameRepeats();
+  const auto sampleCount = ibt.sampleCount();
+  if (!writer.open(
+          output,
+          header,
+          ibt.variables(),
+          mappingSize,
+          static_cast<std::uint64_t>(header.tickRate),
+          error) ||
+      !writer.append(
+          RecordKind::SessionInfo,
+          0,
+          -1,
+          std::max(header.sessionInfoUpdate, 0),
+          session.empty() ? nullptr : session.data(),
+          static_cast<std::uint32_t>(session.size()),
+          error)) {
+    return false;
+  }
+
+  // Samples carry the SessionTick iRacing published them at, so a tape made
+  // from an .ibt aligns by tick with a live capture of the same session. Files
+  // without the variable fall back to the sample index.
+  const int tickOffset = sessionTickOffset(header, ibt.variables());
+  TapeEventDetector detector(ibt.variables());
+  std::vector<TapeEvent> events;
+  std::int32_t lastTick = -1;
+  for (std::size_t index = 0; index < sampleCount; ++index) {
+    const char* sample = ibt.sample(index);
+    auto sourceTick = static_cast<std::int32_t>(index);
+    if (tickOffset >= 0) {
+      std::memcpy(&sourceTick, sample + tickOffset, sizeof(sourceTick));
+    }
+    const auto offset = writer.nextRecordOffset();
+    if (!writer.append(
+            RecordKind::Frame,
+            index,
+            sourceTick,
+            0,
+            sample,
+            static_cast<std::uint32_t>(header.bufLen),
+            error)) {
+      return false;
+    }
+    detector.observe(sample, offset, index, sourceTick, events);
+    lastTick = sourceTick;
+  }
+
+  if (!writer.append(
+          RecordKind::End, sampleCount, lastTick, 0, nullptr, 0, error) ||
+      !writer.appendEventIndex(events, sampleCount, error) ||
+      !writer.finish(mappingSize, error)) {
+    return false;
+  }
+  frames = sampleCount;
+  return true;
+}
+
+bool convertTapeToIbt(
+    const std::filesystem::path& input,
+    const std::filesystem::path& output,
+    std::uint64_t& frames,
+    std::string& error) {
+  frames = 0;
+  TapeReader tape;
+  if (!tape.open(input, error) || !tape.buildIndex(error)) {
+    return false;
+  }
+
+  // The header scan finds the final session revision without reading any
+  // frame payloads, so the frames below are streamed in a single pass.
+  const auto& index = tape.index();
+  std::vector<char> session;
+  std::int32_t sessionUpdate = 0;
+  for (std::size_t i = index.size(); i > 0; --i) {
+    if (index[i - 1].kind != RecordKind::SessionInfo) {
+      continue;
+    }
+    TapeRecordHeader record{};
+    if (!tape.seekRecord(i - 1, error) ||
+        tape.readNext(record, session, error) != TapeReadResult::Record) {
+      if (error.empty()) {
+        error = "Could not read the final session record";
+      }
+      return false;
+    }
+    sessionUpdate = record.value;
+    break;
+  }
+  const auto sessionEnd = std::find(session.begin(), session.end(), '\0');
+  session.erase(sessionEnd, session.end());
+  session.push_back('\0');
+
+  const auto& variables = tape.variables();
+  const auto variableBytes = variables.size() * sizeof(irsdk_varHeader);
+  const auto bufLen = tape.sdkHeader().bufLen;
+  irsdk_header header = tape.sdkHeader();
+  header.status = irsdk_stConnected;
+  header.numBuf = 1;
+  header.varHeaderOffset =
+      static_cast<int>(sizeof(irsdk_header) + sizeof(irsdk_diskSubHeader));
+  header.sessionInfoOffset =
+      header.varHeaderOffset + static_cast<int>(variableBytes);
+  header.sessionInfoLen = static_cast<int>(session.size());
+  header.sessionInfoUpdate = sessionUpdate;
+  for (auto& buffer : header.varBuf) {
+    buffer = {};
+  }
+  header.varBuf[0].bufOffset =
+      header.sessionInfoOffset + header.sessionInfoLen;
+
+  std::error_code directoryError;
+  if (!output.parent_path().empty()) {
+    std::filesystem::create_directories(output.parent_path(), directoryError);
+    if (directoryError) {
+      error = "Could not create the .ibt output directory";
+      return false;
+    }
+  }
+  std::ofstream stream(output, std::ios::binary | std::ios::trunc);
+  if (!stream) {
+    error = "Could not create the .ibt file";
+    return false;
+  }
+
+  // The disk header is rewritten once the frame count and end time are known.
+  irsdk_diskSubHeader diskHeader{};
+  if (!writeBytes(stream, &header, sizeof(header), error) ||
+      !writeBytes(stream, &diskHeader, sizeof(diskHeader), error) ||
+      !writeBytes(stream, variables.data(), variableBytes, error) ||
+      !writeBytes(stream, session.data(), session.size(), error) ||
+      !tape.rewindRecords(error)) {
+    return false;
+  }
+
+  const int timeOffset = sessionTimeOffset(header, variables);
+  TapeRecordHeader record{};
+  std::vector<char> payload;
+  while (true) {
+    const auto result = tape.readNext(record, payload, error);
+    if (result == TapeReadResult::EndOfFile) {
+      break;
+    }
+    if (result == TapeReadResult::Error) {
+      return false;
+    }
+    if (static_cast<RecordKind>(record.kind) != RecordKind::Frame) {
+      continue;
+    }
+    if (payload.size() != static_cast<std::size_t>(bufLen)) {
+      error = "Tape frame does not match the recorded buffer length";
+      return false;
+    }
+    if (timeOffset >= 0) {
+      double sessionTime = 0;
+      std::memcpy(
+          &sessionTime,
+          payload.data() + timeOffset,
+          sizeof(sessionTime));
+      if (frames == 0) {
+        diskHeader.sessionStartTime = sessionTime;
+      }
+      diskHeader.sessionEndTime = sessionTime;
+    }
+    if (!writeBytes(stream, payload.data(), payload.size(), error)) {
+      return false;
+    }
+    ++frames;
+  }
+
+  if (frames == 0) {
+    error = "The tape does not contain any frames";
+    return false;
+  }
+  diskHeader.sessionRecordCount = static_cast<int>(frames);
+  stream.seekp(static_cast<std::streamoff>(sizeof(irsdk_header)));
+  if (!writeBytes(stream, &diskHeader, sizeof(diskHeader), error)) {
+    return false;
+  }
+  stream.close();
+  if (!stream) {
+    error = "Could not finish the .ibt file";
+    return false;
+  }
+  return true;
+}
+
+bool compactTape(
+    const std::filesystem::path& input,
+    const std::filesystem::path& output,
+    std::uint64_t& frames,
+    std::uint64_t& repeatedFrames,
+    std::string& error) {
+  frames = 0;
+  repeatedFrames = 0;
+  TapeReader tape;
+  if (!tape.open(input, error)) {
+    return false;
+  }
+
+  const auto& fileHeader = tape.fileHeader();
+  TapeWriter writer;
+  writer.enableFrameRepeats();
+  if (!writer.open(
+          output,
+          tape.sdkHeader(),
+          tape.variables(),
+          fileHeader.mappingSize,
+          fileHeader.qpcFrequency,
+          error)) {
+    return false;
+  }
+
+  // Record offsets change, so the event index is rebuilt rather than copied.
+  const bool indexEvents = tape.hasEventIndex();
+  const auto bufLen = static_cast<std::size_t>(tape.sdkHeader().bufLen);
+  TapeEventDetector detector(tape.variables());
+  std::vector<TapeEvent> events;
+  std::uint64_t indexTicks = 0;
+  TapeRecordHeader record{};
+  std::vector<char> payload;
+  while (true) {
+    const auto result = tape.readNext(record, payload, error);
+    if (result == TapeReadResult::EndOfFile) {
+      break;
+    }
+    if (result == TapeReadResult::Error) {
+      return false;
+    }
+    const auto kind = static_cast<RecordKind>(record.kind);
+    if (kind == RecordKind::EventIndex) {
+      indexTicks = record.elapsedTicks;
+      continue;
+    }
+
+    const auto offset = writer.nextRecordOffset();
+    if (!writer.append(
+            kind,
+            record.elapsedTicks,
+            record.sourceTick,
+            record.value,
+            payload.empty() ? nullptr : payload.data(),
+            static_cast<std::uint32_t>(payload.size()),
+            error)) {
+      return false;
+    }
+    if (kind == RecordKind::Disconnect) {
+      detector.reset();
+    } else if (kind == RecordKind::Frame) {
+      ++frames;
+      if (indexEvents && payload.size() == bufLen) {
+        detector.observe(
+            payload.data(),
+            offset,
+            record.elapsedTicks,
+            record.sourceTick,
+            events);
+      }
+    }
+  }
+
+  if ((indexEvents &&
+       !writer.appendEventIndex(events, indexTicks, error)) ||
+      !writer.finish(fileHeader.mappingSize, error)) {
+    return false;
+  }
+  repeatedFrames = writer.repeatedFrames();
+  return true;
+}
+
+bool exportTelemetryWire(
+    const std::filesystem::path& input,
+    const std::filesystem::path& output,
+    const std::vector<std::string>& names,
+    std::uint64_t& messages,
+    std::uint64_t& bytes,
+    std::string& error) {
+  messages = 0;
+  bytes = 0;
+  TapeReader tape;
+  if (!tape.open(input, error)) {
+    return false;
+  }
+
+  // An allowlist is applied with the recorder's compaction, so each channel's
+  // source is its offset in the compacted frame.
+  SchemaSubset subset;
+  const bool compact = !names.empty();
+  if (compact &&
+      !subset.build(tape.sdkHeader(), tape.variables(), names, error)) {
+    return false;
+  }
+  const auto& variables = compact ? subset.variables() : tape.variables();
+  std::vector<TelemetryWireChannel> channels;
+  channels.reserve(variables.size());
+  for (const auto& variable : variables) {
+    channels.push_back(
+        {variableName(variable.name),
+         variable.type,
+         variable.count,
+         variable.offset});
+  }
+  TelemetryWireEncoder encoder;
+  encoder.setChannels(1, std::move(channels));
+
+  std::error_code directoryError;
+  if (!output.parent_path().empty()) {
+    std::filesystem::create_directories(output.parent_path(), directoryError);
+    if (directoryError) {
+      error = "Could not create the wire output directory";
+      return false;
+    }
+  }
+  std::ofstream stream(output, std::ios::binary | std::ios::trunc);
+  if (!stream) {
+    error = "Could not create the wire output";
+    return false;
+  }
+
+  const auto bufLen = static_cast<std::size_t>(tape.sdkHeader().bufLen);
+  std::vector<char> compacted(
+      compact ? static_cast<std::size_t>(subset.header().bufLen) : 0);
+  std::vector<std::uint8_t> message;
+  bool keyframe = true;
+  TapeRecordHeader record{};
+  std::vector<char> payload;
+  while (true) {
+    const auto result = tape.readNext(record, payload, error);
+    if (result == TapeReadResult::EndOfFile) {
+      break;
+    }
+    if (result == TapeReadResult::Error) {
+      return false;
+    }
+    const auto kind = static_cast<RecordKind>(record.kind);
+    if (kind == RecordKind::Disconnect) {
+      keyframe = true;
+      continue;
+    }
+    if (kind != RecordKind::Frame) {
+      continue;
+    }
+    if (payload.size() != bufLen) {
+      error = "Tape frame does not match the recorded buffer length";
+      return false;
+    }
+
+    const char* frame = payload.data();
+    if (compact) {
+      subset.compactFrame(frame, compacted.data());
+      frame = compacted.data();
+    }
+    encoder.encode(frame, keyframe, message);
+    keyframe = false;
+    const auto length = static_cast<std::uint32_t>(message.size());
+    const char prefix[4] = {
+        static_cast<char>(length & 0xFFU),
+        static_cast<char>((length >> 8U) & 0xFFU),
+        static_cast<char>((length >> 16U) & 0xFFU),
+        static_cast<char>((length >> 24U) & 0xFFU)};
+    stream.write(prefix, sizeof(prefix));
+    stream.write(
+        reinterpret_cast<const char*>(message.data()),
+        static_cast<std::streamsize>(message.size()));
+    if (!stream) {
+      error = "Could not write the wire output";
+      return false;
+    }
+    ++messages;
+    bytes += message.size();
+  }
+
+  stream.close();
+  if (!stream) {
+    error = "Could not finish the wire output";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace irdashies::irsdk_replay
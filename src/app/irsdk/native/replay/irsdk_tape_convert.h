@@ -0,0 +1,54 @@
+#ifndef IRDASHIES_IRSDK_TAPE_CONVERT_H
+#define IRDASHIES_IRSDK_TAPE_CONVERT_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace irdashies::irsdk_replay {
+
+// Streams an .ibt log into a tape. The tape keeps the log's schema and
+// offsets, records the embedded session string once before the first frame,
+// and timestamps sample N at N elapsed ticks with qpcFrequency = tickRate.
+bool convertIbtToTape(
+    const std::filesystem::path& input,
+    const std::filesystem::path& output,
+    std::uint64_t& frames,
+    std::string& error);
+
+// Streams a tape's frames into an .ibt log. An .ibt holds a single session
+// string, so the last recorded revision is embedded; gaps and disconnects
+// have no .ibt representation and the surrounding frames become adjacent
+// samples.
+bool convertTapeToIbt(
+    const std::filesystem::path& input,
+    const std::filesystem::path& output,
+    std::uint64_t& frames,
+    std::string& error);
+
+// Rewrites a tape with runs of identical frames folded into Repeat records.
+// Every other record is copied as recorded, and the event index is rebuilt
+// when the input has one. Tapes already compacted come out unchanged.
+bool compactTape(
+    const std::filesystem::path& input,
+    const std::filesystem::path& output,
+    std::uint64_t& frames,
+    std::uint64_t& repeatedFrames,
+    std::string& error);
+
+// Encodes each frame as the telemetry wire message the bridge would publish
+// for it, starting with a keyframe and sending one after every disconnect.
+// Messages are written back to back, each after its u32 little-endian byte
+// count. An empty names list encodes every variable.
+bool exportTelemetryWire(
+    const std::filesystem::path& input,
+    const std::filesystem::path& output,
+    const std::vector<std::string>& names,
+    std::uint64_t& messages,
+    std::uint64_t& bytes,
+    std::string& error);
+
+}  // namespace irdashies::irsdk_replay
+
+#endif
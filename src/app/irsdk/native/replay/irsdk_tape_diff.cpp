@@ -0,0 +1,374 @@
+#include "./irsdk_tape_diff.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <thread>
+
+#include "./irsdk_mapped_file.h"
+#include "./irsdk_tape.h"
+
+namespace irdashies::irsdk_replay {
+namespace {
+
+struct FrameRef {
+  const char* data;
+  std::uint64_t elapsedTicks;
+  std::int32_t sourceTick;
+};
+
+// A tape whose frame payloads are read in place from a read-only mapping.
+// TapeReader validates the header and schema and supplies record offsets.
+struct MappedTape {
+  TapeReader reader;
+  MappedFile file;
+  std::vector<FrameRef> frames;
+
+  bool open(const std::filesystem::path& path, std::string& error) {
+    if (!reader.open(path, error) || !reader.buildIndex(error) ||
+        !file.open(path, error)) {
+      return false;
+    }
+    const auto bufLen = static_cast<std::uint32_t>(reader.sdkHeader().bufLen);
+    for (const auto& entry : reader.index()) {
+      if (entry.kind != RecordKind::Frame) {
+        continue;
+      }
+      // Repeated frames point at the Frame record they repeat, so a run of
+      // identical frames shares one payload in the mapping.
+      TapeRecordHeader record{};
+      const auto payloadOffset = entry.frameOffset + sizeof(TapeRecordHeader);
+      if (!file.contains(entry.frameOffset, sizeof(TapeRecordHeader))) {
+        error = "Telemetry tape record header is truncated";
+        return false;
+      }
+      std::memcpy(&record, file.data() + entry.frameOffset, sizeof(record));
+      if (record.payloadSize != bufLen ||
+          !file.contains(payloadOffset, bufLen)) {
+        error = "Tape frame does not match the recorded buffer length";
+        return false;
+      }
+      frames.push_back(
+          {file.data() + payloadOffset, entry.elapsedTicks, entry.sourceTick});
+    }
+    return true;
+  }
+
+  double seconds(const FrameRef& frame) const {
+    return static_cast<double>(frame.elapsedTicks) /
+        static_cast<double>(reader.fileHeader().qpcFrequency);
+  }
+};
+
+// A variable present in both tapes with the same type and count.
+struct SharedVariable {
+  std::string name;
+  int type;
+  int count;
+  int offsetA;
+  int offsetB;
+  double tolerance;
+};
+
+struct ChunkResult {
+  std::vector<std::uint64_t> counts;
+  std::uint64_t divergentFrames = 0;
+  std::size_t firstPair = std::numeric_limits<std::size_t>::max();
+};
+
+std::string fixedString(const char* text) {
+  const auto* end =
+      static_cast<const char*>(std::memchr(text, '\0', IRSDK_MAX_STRING));
+  return std::string(text, end == nullptr ? text + IRSDK_MAX_STRING : end);
+}
+
+std::string describeType(const irsdk_varHeader& variable) {
+  static const char* const names[] = {
+      "char", "bool", "int", "bitfield", "float", "double"};
+  return std::string(names[variable.type]) + "[" +
+      std::to_string(variable.count) + "]";
+}
+
+template <typename T>
+bool valuesEqual(const char* a, const char* b, int count, double tolerance) {
+  // No early exit, so the loop over array variables vectorizes.
+  bool differs = false;
+  for (int i = 0; i < count; ++i) {
+    T x;
+    T y;
+    std::memcpy(&x, a + static_cast<std::size_t>(i) * sizeof(T), sizeof(T));
+    std::memcpy(&y, b + static_cast<std::size_t>(i) * sizeof(T), sizeof(T));
+    const bool bothNaN = x != x && y != y;
+    differs |= !(x == y || bothNaN ||
+                 std::fabs(static_cast<double>(x) - y) <= tolerance);
+  }
+  return !differs;
+}
+
+bool variableEqual(
+    const SharedVariable& variable,
+    const char* frameA,
+    const char* frameB) {
+  const char* a = frameA + variable.offsetA;
+  const char* b = frameB + variable.offsetB;
+  switch (variable.type) {
+    case irsdk_float:
+      return valuesEqual<float>(a, b, variable.count, variable.tolerance);
+    case irsdk_double:
+      return valuesEqual<double>(a, b, variable.count, variable.tolerance);
+    default:
+      return std::memcmp(
+                 a,
+                 b,
+                 static_cast<std::size_t>(irsdk_VarTypeBytes[variable.type]) *
+                     static_cast<std::size_t>(variable.count)) == 0;
+  }
+}
+
+std::string formatElement(int type, const char* data, int element) {
+  const char* value =
+      data + static_cast<std::size_t>(element) * irsdk_VarTypeBytes[type];
+  std::ostringstream text;
+  text.precision(9);
+  switch (type) {
+    case irsdk_char:
+    case irsdk_bool:
+      text << static_cast<int>(static_cast<unsigned char>(*value));
+      break;
+    case irsdk_int: {
+      std::int32_t number;
+      std::memcpy(&number, value, sizeof(number));
+      text << number;
+      break;
+    }
+    case irsdk_bitField: {
+      std::uint32_t bits;
+      std::memcpy(&bits, value, sizeof(bits));
+      text << "0x" << std::hex << bits;
+      break;
+    }
+    case irsdk_float: {
+      float number;
+      std::memcpy(&number, value, sizeof(number));
+      text << number;
+      break;
+    }
+    default: {
+      double number;
+      std::memcpy(&number, value, sizeof(number));
+      text << number;
+      break;
+    }
+  }
+  return text.str();
+}
+
+void compareSchemas(
+    const MappedTape& a,
+    const MappedTape& b,
+    const DiffOptions& options,
+    TapeDiff& diff,
+    std::vector<SharedVariable>& shared) {
+  const auto& headerA = a.reader.sdkHeader();
+  const auto& headerB = b.reader.sdkHeader();
+  if (headerA.tickRate != headerB.tickRate) {
+    diff.schema.push_back(
+        {"tickRate",
+         std::to_string(headerA.tickRate) + " vs " +
+             std::to_string(headerB.tickRate)});
+  }
+
+  const auto& variablesA = a.reader.variables();
+  const auto& variablesB = b.reader.variables();
+  std::vector<bool> matchedB(variablesB.size(), false);
+  for (const auto& variable : variablesA) {
+    const auto name = fixedString(variable.name);
+    const auto match = std::find_if(
+        variablesB.begin(),
+        variablesB.end(),
+        [&name](const irsdk_varHeader& candidate) {
+          return fixedString(candidate.name) == name;
+        });
+    if (match == variablesB.end()) {
+      diff.schema.push_back({name, "only in the first tape"});
+      continue;
+    }
+    matchedB[static_cast<std::size_t>(match - variablesB.begin())] = true;
+    if (match->type != variable.type || match->count != variable.count) {
+      diff.schema.push_back(
+          {name, describeType(variable) + " vs " + describeType(*match)});
+      continue;
+    }
+    if (fixedString(variable.unit) != fixedString(match->unit)) {
+      diff.schema.push_back(
+          {name,
+           "unit '" + fixedString(variable.unit) + "' vs '" +
+               fixedString(match->unit) + "'"});
+    }
+    double tolerance = 0;
+    if (variable.type == irsdk_float) {
+      tolerance = options.floatTolerance;
+    } else if (variable.type == irsdk_double) {
+      tolerance = options.doubleTolerance;
+    }
+    shared.push_back(
+        {name,
+         variable.type,
+         variable.count,
+         variable.offset,
+         match->offset,
+         tolerance});
+  }
+  for (std::size_t i = 0; i < variablesB.size(); ++i) {
+    if (!matchedB[i]) {
+      diff.schema.push_back(
+          {fixedString(variablesB[i].name), "only in the second tape"});
+    }
+  }
+}
+
+// Walks both frame lists in order, pairing frames with equal keys. Unpaired
+// frames are counted on the side that holds them.
+std::vector<std::pair<std::size_t, std::size_t>> alignFrames(
+    const MappedTape& a,
+    const MappedTape& b,
+    DiffAlignment alignment,
+    TapeDiff& diff) {
+  std::vector<std::pair<std::size_t, std::size_t>> pairs;
+  pairs.reserve(std::min(a.frames.size(), b.frames.size()));
+  const double halfTick =
+      0.5 / static_cast<double>(std::max(a.reader.sdkHeader().tickRate, 1));
+  std::size_t i = 0;
+  std::size_t j = 0;
+  while (i < a.frames.size() && j < b.frames.size()) {
+    int order = 0;
+    if (alignment == DiffAlignment::SourceTick) {
+      const auto tickA = a.frames[i].sourceTick;
+      const auto tickB = b.frames[j].sourceTick;
+      order = tickA < tickB ? -1 : (tickA > tickB ? 1 : 0);
+    } else {
+      const double delta = a.seconds(a.frames[i]) - b.seconds(b.frames[j]);
+      order = delta < -halfTick ? -1 : (delta > halfTick ? 1 : 0);
+    }
+    if (order == 0) {
+      pairs.emplace_back(i++, j++);
+    } else if (order < 0) {
+      ++diff.onlyInA;
+      ++i;
+    } else {
+      ++diff.onlyInB;
+      ++j;
+    }
+  }
+  diff.onlyInA += a.frames.size() - i;
+  diff.onlyInB += b.frames.size() - j;
+  return pairs;
+}
+
+}  // namespace
+
+bool diffTapes(
+    const std::filesystem::path& first,
+    const std::filesystem::path& second,
+    const DiffOptions& options,
+    TapeDiff& diff,
+    std::string& error) {
+  diff = {};
+  MappedTape a;
+  MappedTape b;
+  if (!a.open(first, error) || !b.open(second, error)) {
+    return false;
+  }
+  diff.framesA = a.frames.size();
+  diff.framesB = b.frames.size();
+
+  std::vector<SharedVariable> shared;
+  compareSchemas(a, b, options, diff, shared);
+  const auto pairs = alignFrames(a, b, options.alignment, diff);
+  diff.matchedFrames = pairs.size();
+
+  const auto chunkCount = std::max<std::size_t>(
+      1, std::min(std::max<std::size_t>(options.jobs, 1), pairs.size()));
+  std::vector<ChunkResult> chunks(chunkCount);
+  auto compareChunk = [&](std::size_t chunk) {
+    auto& result = chunks[chunk];
+    result.counts.assign(shared.size(), 0);
+    const auto begin = pairs.size() * chunk / chunkCount;
+    const auto end = pairs.size() * (chunk + 1) / chunkCount;
+    for (auto pair = begin; pair < end; ++pair) {
+      const char* frameA = a.frames[pairs[pair].first].data;
+      const char* frameB = b.frames[pairs[pair].second].data;
+      bool divergent = false;
+      for (std::size_t v = 0; v < shared.size(); ++v) {
+        if (!variableEqual(shared[v], frameA, frameB)) {
+          ++result.counts[v];
+          divergent = true;
+        }
+      }
+      if (divergent) {
+        ++result.divergentFrames;
+        result.firstPair = std::min(result.firstPair, pair);
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(chunkCount);
+  for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+    workers.emplace_back(compareChunk, chunk);
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  std::size_t firstPair = std::numeric_limits<std::size_t>::max();
+  diff.variables.reserve(shared.size());
+  for (const auto& variable : shared) {
+    diff.variables.push_back({variable.name, 0});
+  }
+  for (const auto& chunk : chunks) {
+    diff.divergentFrames += chunk.divergentFrames;
+    firstPair = std::min(firstPair, chunk.firstPair);
+    for (std::size_t v = 0; v < chunk.counts.size(); ++v) {
+      diff.variables[v].frames += chunk.counts[v];
+    }
+  }
+
+  if (diff.divergentFrames > 0) {
+    const auto& frameA = a.frames[pairs[firstPair].first];
+    const auto& frameB = b.frames[pairs[firstPair].second];
+    diff.firstTickA = frameA.sourceTick;
+    diff.firstTickB = frameB.sourceTick;
+    diff.firstSecondsA = a.seconds(frameA);
+    diff.firstSecondsB = b.seconds(frameB);
+    for (const auto& variable : shared) {
+      if (variableEqual(variable, frameA.data, frameB.data)) {
+        continue;
+      }
+      // Narrow an array difference down to its first differing element.
+      int element = 0;
+      for (; element < variable.count - 1; ++element) {
+        auto single = variable;
+        single.count = 1;
+        single.offsetA += element * irsdk_VarTypeBytes[variable.type];
+        single.offsetB += element * irsdk_VarTypeBytes[variable.type];
+        if (!variableEqual(single, frameA.data, frameB.data)) {
+          break;
+        }
+      }
+      diff.firstVariable = variable.count > 1
+          ? variable.name + "[" + std::to_string(element) + "]"
+          : variable.name;
+      diff.firstValueA = formatElement(
+          variable.type, frameA.data + variable.offsetA, element);
+      diff.firstValueB = formatElement(
+          variable.type, frameB.data + variable.offsetB, element);
+      break;
+    }
+  }
+  return true;
+}
+
+}  // namespace irdashies::irsdk_replay
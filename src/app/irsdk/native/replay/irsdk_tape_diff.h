@@ -0,0 +1,76 @@
+#ifndef IRDASHIES_IRSDK_TAPE_DIFF_H
+#define IRDASHIES_IRSDK_TAPE_DIFF_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace irdashies::irsdk_replay {
+
+enum class DiffAlignment {
+  // Frames pair up when their recorded tickCount matches.
+  SourceTick,
+  // Frames pair up when their elapsed tape times are within half a tick.
+  ElapsedTime,
+};
+
+struct DiffOptions {
+  DiffAlignment alignment = DiffAlignment::SourceTick;
+  // Largest absolute difference still treated as equal. Integer, bool, char,
+  // and bitfield variables always compare exactly; NaN equals NaN.
+  double floatTolerance = 0;
+  double doubleTolerance = 0;
+  std::size_t jobs = 1;
+};
+
+struct SchemaDifference {
+  std::string name;
+  std::string description;
+};
+
+struct VariableDivergence {
+  std::string name;
+  std::uint64_t frames = 0;
+};
+
+struct TapeDiff {
+  std::uint64_t framesA = 0;
+  std::uint64_t framesB = 0;
+  std::uint64_t matchedFrames = 0;
+  std::uint64_t onlyInA = 0;
+  std::uint64_t onlyInB = 0;
+  std::uint64_t divergentFrames = 0;
+  std::vector<SchemaDifference> schema;
+  // Variables present in both tapes with the same type and count, in the
+  // first tape's order, with the number of matched frames where they differ.
+  std::vector<VariableDivergence> variables;
+
+  // Earliest matched frame with a difference, when divergentFrames > 0.
+  std::int32_t firstTickA = 0;
+  std::int32_t firstTickB = 0;
+  double firstSecondsA = 0;
+  double firstSecondsB = 0;
+  std::string firstVariable;
+  std::string firstValueA;
+  std::string firstValueB;
+
+  bool identical() const {
+    return schema.empty() && onlyInA == 0 && onlyInB == 0 &&
+        divergentFrames == 0;
+  }
+};
+
+// Maps both tapes, pairs their Frame records, and compares the shared
+// variables. The pairs are split into contiguous chunks compared in parallel,
+// and per-chunk counts and first divergences are merged in order.
+bool diffTapes(
+    const std::filesystem::path& first,
+    const std::filesystem::path& second,
+    const DiffOptions& options,
+    TapeDiff& diff,
+    std::string& error);
+
+}  // namespace irdashies::irsdk_replay
+
+#endif
@@ -0,0 +1,261 @@
+#include "./irsdk_tape_events.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace irdashies::irsdk_replay {
+namespace {
+
+constexpr const char* kEventKindNames[] = {
+    "lap", "session", "flags", "pitEntry", "pitExit"};
+
+}  // namespace
+
+TapeEventDetector::TapeEventDetector(
+    const std::vector<irsdk_varHeader>& variables) {
+  auto bind = [](const irsdk_varHeader& variable, Field& field) {
+    field.offset = variable.offset;
+    field.type = variable.type;
+    field.count = variable.count;
+  };
+  for (const auto& variable : variables) {
+    const char* name = variable.name;
+    if (std::strncmp(name, "Lap", IRSDK_MAX_STRING) == 0) {
+      bind(variable, lap_);
+    } else if (std::strncmp(name, "SessionNum", IRSDK_MAX_STRING) == 0) {
+      bind(variable, sessionNum_);
+    } else if (std::strncmp(name, "SessionFlags", IRSDK_MAX_STRING) == 0) {
+      bind(variable, sessionFlags_);
+    } else if (std::strncmp(name, "OnPitRoad", IRSDK_MAX_STRING) == 0) {
+      bind(variable, onPitRoad_);
+    } else if (std::strncmp(name, "CarIdxOnPitRoad", IRSDK_MAX_STRING) == 0) {
+      bind(variable, carIdxOnPitRoad_);
+    } else if (std::strncmp(name, "PlayerCarIdx", IRSDK_MAX_STRING) == 0) {
+      bind(variable, playerCarIdx_);
+    }
+  }
+}
+
+bool TapeEventDetector::tracking() const {
+  return lap_.offset >= 0 || sessionNum_.offset >= 0 ||
+      sessionFlags_.offset >= 0 || onPitRoad_.offset >= 0 ||
+      (carIdxOnPitRoad_.offset >= 0 && playerCarIdx_.offset >= 0);
+}
+
+bool TapeEventDetector::readInt(
+    const Field& field,
+    const char* frame,
+    int element,
+    std::int32_t& value) {
+  if (field.offset < 0 || element < 0 || element >= field.count) {
+    return false;
+  }
+  const char* data = frame + field.offset +
+      static_cast<std::size_t>(element) * irsdk_VarTypeBytes[field.type];
+  switch (field.type) {
+    case irsdk_char:
+    case irsdk_bool:
+      value = static_cast<unsigned char>(*data);
+      return true;
+    case irsdk_int:
+    case irsdk_bitField:
+      std::memcpy(&value, data, sizeof(value));
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool TapeEventDetector::onPitRoad(const char* frame) const {
+  std::int32_t value = 0;
+  if (readInt(onPitRoad_, frame, 0, value)) {
+    return value != 0;
+  }
+  std::int32_t playerCarIdx = -1;
+  return readInt(playerCarIdx_, frame, 0, playerCarIdx) &&
+      readInt(carIdxOnPitRoad_, frame, playerCarIdx, value) && value != 0;
+}
+
+void TapeEventDetector::observe(
+    const char* frame,
+    std::uint64_t recordOffset,
+    std::uint64_t elapsedTicks,
+    std::int32_t sourceTick,
+    std::vector<TapeEvent>& events) {
+  auto emit = [&](TapeEventKind kind, std::int32_t value) {
+    events.push_back(
+        {static_cast<std::uint32_t>(kind),
+         value,
+         recordOffset,
+         elapsedTicks,
+         sourceTick,
+         0});
+  };
+
+  std::int32_t lap = 0;
+  const bool hasLap = readInt(lap_, frame, 0, lap);
+  if (hasLap && (!primed_ || lap != lastLap_)) {
+    emit(TapeEventKind::Lap, lap);
+  }
+  lastLap_ = lap;
+
+  std::int32_t sessionNum = 0;
+  if (readInt(sessionNum_, frame, 0, sessionNum) &&
+      (!primed_ || sessionNum != lastSessionNum_)) {
+    emit(TapeEventKind::Session, sessionNum);
+  }
+  lastSessionNum_ = sessionNum;
+
+  std::int32_t sessionFlags = 0;
+  if (readInt(sessionFlags_, frame, 0, sessionFlags) &&
+      (!primed_ || sessionFlags != lastSessionFlags_)) {
+    emit(TapeEventKind::Flags, sessionFlags);
+  }
+  lastSessionFlags_ = sessionFlags;
+
+  const bool pitRoad = onPitRoad(frame);
+  if (pitRoad && (!primed_ || !lastOnPitRoad_)) {
+    emit(TapeEventKind::PitEntry, lap);
+  } else if (primed_ && !pitRoad && lastOnPitRoad_) {
+    emit(TapeEventKind::PitExit, lap);
+  }
+  lastOnPitRoad_ = pitRoad;
+  primed_ = true;
+}
+
+const char* tapeEventKindName(TapeEventKind kind) {
+  const auto index = static_cast<std::uint32_t>(kind);
+  if (index < 1 || index > std::size(kEventKindNames)) {
+    return "unknown";
+  }
+  return kEventKindNames[index - 1];
+}
+
+bool parseTapeEventKind(const std::string& name, TapeEventKind& kind) {
+  for (std::uint32_t i = 0; i < std::size(kEventKindNames); ++i) {
+    if (name == kEventKindNames[i]) {
+      kind = static_cast<TapeEventKind>(i + 1);
+      return true;
+    }
+  }
+  return false;
+}
+
+std::size_t findTapeEvent(
+    const std::vector<TapeEvent>& events,
+    TapeEventKind kind,
+    std::int32_t value) {
+  for (std::size_t i = 0; i < events.size(); ++i) {
+    const auto& event = events[i];
+    if (event.kind != static_cast<std::uint32_t>(kind)) {
+      continue;
+    }
+    const bool matches = kind == TapeEventKind::Flags
+        ? (static_cast<std::uint32_t>(event.value) &
+           static_cast<std::uint32_t>(value)) != 0
+        : event.value == value;
+    if (matches) {
+      return i;
+    }
+  }
+  return events.size();
+}
+
+bool indexTapeEvents(
+    const std::filesystem::path& path,
+    std::uint64_t& eventCount,
+    std::string& error) {
+  eventCount = 0;
+  TapeFileHeader fileHeader{};
+  std::vector<TapeEvent> events;
+  std::uint64_t lastElapsedTicks = 0;
+  {
+    TapeReader reader;
+    if (!reader.open(path, error) || !reader.buildIndex(error)) {
+      return false;
+    }
+    if (reader.hasEventIndex()) {
+      error = "Telemetry tape already has an event index";
+      return false;
+    }
+    fileHeader = reader.fileHeader();
+
+    TapeEventDetector detector(reader.variables());
+    if (!detector.tracking()) {
+      error = "Telemetry tape has none of the variables the event index uses";
+      return false;
+    }
+    const auto bufLen = static_cast<std::size_t>(reader.sdkHeader().bufLen);
+    TapeRecordHeader record{};
+    std::vector<char> payload;
+    while (true) {
+      const auto recordIndex = reader.nextRecordIndex();
+      const auto result = reader.readNext(record, payload, error);
+      if (result == TapeReadResult::EndOfFile) {
+        break;
+      }
+      if (result == TapeReadResult::Error) {
+        return false;
+      }
+      lastElapsedTicks = record.elapsedTicks;
+      const auto kind = static_cast<RecordKind>(record.kind);
+      if (kind == RecordKind::Disconnect) {
+        detector.reset();
+      } else if (kind == RecordKind::Frame && payload.size() == bufLen) {
+        detector.observe(
+            payload.data(),
+            reader.index()[recordIndex].offset,
+            record.elapsedTicks,
+            record.sourceTick,
+            events);
+      }
+    }
+  }
+  if (events.empty()) {
+    error = "Telemetry tape does not contain any frames";
+    return false;
+  }
+  if (events.size() > kMaxPayloadSize / sizeof(TapeEvent)) {
+    error = "Telemetry tape event index is too large";
+    return false;
+  }
+
+  std::fstream stream(path, std::ios::binary | std::ios::in | std::ios::out);
+  stream.seekp(0, std::ios::end);
+  const auto offset = stream.tellp();
+  if (!stream || offset < 0) {
+    error = "Could not open the telemetry tape for writing";
+    return false;
+  }
+
+  const auto payloadSize =
+      static_cast<std::uint32_t>(events.size() * sizeof(TapeEvent));
+  TapeRecordHeader record{};
+  record.kind = static_cast<std::uint32_t>(RecordKind::EventIndex);
+  record.recordHeaderSize = sizeof(TapeRecordHeader);
+  record.payloadSize = payloadSize;
+  record.elapsedTicks = lastElapsedTicks;
+  record.sourceTick = -1;
+  record.value = static_cast<std::int32_t>(events.size());
+  record.payloadChecksum = checksum(events.data(), payloadSize);
+  stream.write(reinterpret_cast<const char*>(&record), sizeof(record));
+  stream.write(reinterpret_cast<const char*>(events.data()), payloadSize);
+
+  // The header is rewritten last, so an interrupted pass leaves a tape whose
+  // header still describes only the original records.
+  ++fileHeader.recordCount;
+  fileHeader.eventIndexOffset = static_cast<std::uint64_t>(offset);
+  stream.flush();
+  stream.seekp(0);
+  stream.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+  stream.flush();
+  if (!stream) {
+    error = "Failed to write the telemetry tape event index";
+    return false;
+  }
+  eventCount = events.size();
+  return true;
+}
+
+}  // namespace irdashies::irsdk_replay
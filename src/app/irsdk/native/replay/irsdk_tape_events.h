@@ -0,0 +1,84 @@
+#ifndef IRDASHIES_IRSDK_TAPE_EVENTS_H
+#define IRDASHIES_IRSDK_TAPE_EVENTS_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "./irsdk_tape.h"
+
+namespace irdashies::irsdk_replay {
+
+// Watches Lap, SessionNum, SessionFlags, and the player's pit road state
+// frame by frame. Pit road comes from OnPitRoad, or from
+// CarIdxOnPitRoad[PlayerCarIdx] when a compacted tape only kept the per-car
+// array. Variables missing from the schema produce no events.
+class TapeEventDetector {
+ public:
+  explicit TapeEventDetector(const std::vector<irsdk_varHeader>& variables);
+
+  // True when the schema holds at least one tracked variable.
+  bool tracking() const;
+
+  // The next frame is compared against nothing, as at the start of a tape.
+  void reset() {
+    primed_ = false;
+  }
+
+  void observe(
+      const char* frame,
+      std::uint64_t recordOffset,
+      std::uint64_t elapsedTicks,
+      std::int32_t sourceTick,
+      std::vector<TapeEvent>& events);
+
+ private:
+  struct Field {
+    int offset = -1;
+    int type = -1;
+    int count = 0;
+  };
+
+  static bool readInt(
+      const Field& field,
+      const char* frame,
+      int element,
+      std::int32_t& value);
+  bool onPitRoad(const char* frame) const;
+
+  Field lap_;
+  Field sessionNum_;
+  Field sessionFlags_;
+  Field onPitRoad_;
+  Field carIdxOnPitRoad_;
+  Field playerCarIdx_;
+  bool primed_ = false;
+  std::int32_t lastLap_ = 0;
+  std::int32_t lastSessionNum_ = 0;
+  std::int32_t lastSessionFlags_ = 0;
+  bool lastOnPitRoad_ = false;
+};
+
+const char* tapeEventKindName(TapeEventKind kind);
+bool parseTapeEventKind(const std::string& name, TapeEventKind& kind);
+
+// First event of the given kind whose value matches: Flags events match when
+// they share any bit with value, the other kinds match it exactly. Returns
+// events.size() when nothing matches.
+std::size_t findTapeEvent(
+    const std::vector<TapeEvent>& events,
+    TapeEventKind kind,
+    std::int32_t value);
+
+// Post-pass for tapes recorded without an event index: scans every frame and
+// appends the EventIndex record in place. A tape that already has one is
+// left untouched and reported as an error.
+bool indexTapeEvents(
+    const std::filesystem::path& path,
+    std::uint64_t& eventCount,
+    std::string& error);
+
+}  // namespace irdashies::irsdk_replay
+
+#endif
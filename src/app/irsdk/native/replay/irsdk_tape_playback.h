@@ -0,0 +1,59 @@
+#ifndef IRDASHIES_IRSDK_TAPE_PLAYBACK_H
+#define IRDASHIES_IRSDK_TAPE_PLAYBACK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "./irsdk_latency_histogram.h"
+#include "./irsdk_tape.h"
+
+// Playback controls implemented by the tape and .ibt backends in addition to
+// the irsdk_* surface. Tape seeks use the record index, so moving to any frame
+// reads at most one session record and the target frame; .ibt samples are
+// fixed-stride and seek by offset.
+namespace irdashies::irsdk_replay {
+
+// A paused tape keeps the connection open and republishes nothing until it
+// is resumed or moved with stepPlayback/seekPlayback.
+bool setPlaybackPaused(bool paused, std::string& error);
+
+// Moves the published frame by a signed number of frames.
+bool stepPlayback(int frames, std::string& error);
+
+// Moves the published frame by a signed number of recorded seconds.
+bool seekPlayback(double seconds, std::string& error);
+
+struct PlaybackEvent {
+  TapeEventKind kind;
+  std::int32_t value;
+  double seconds;
+  std::int32_t sourceTick;
+};
+
+// Lap, session, flag, and pit events in recorded order. Tapes read their
+// EventIndex record, and tapes without one report an error; .ibt samples
+// are scanned once on the first call.
+bool playbackEvents(std::vector<PlaybackEvent>& events, std::string& error);
+
+// Publishes the frame of the first event matching kind and value, using the
+// matching rules of findTapeEvent.
+bool seekPlaybackEvent(
+    TapeEventKind kind,
+    std::int32_t value,
+    std::string& error);
+
+// Frame timing since the tape was opened. Lateness is the publish time minus
+// the frame's scheduled time; interval is the time between consecutive
+// published frames. Frames delivered by a step or seek are not timed, and a
+// pause, seek, or loop starts a new interval chain.
+struct PlaybackStats {
+  LatencySummary lateness;
+  LatencySummary frameInterval;
+};
+
+PlaybackStats playbackStats();
+
+}  // namespace irdashies::irsdk_replay
+
+#endif
@@ -0,0 +1,325 @@
+#include "./irsdk_tape_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <thread>
+
+#include "./irsdk_tape.h"
+
+namespace irdashies::irsdk_replay {
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+// Sums are kept relative to a shift taken from the range's first value, so
+// the variance of large, slowly changing values such as SessionTime does not
+// cancel out.
+struct Accumulator {
+  std::uint64_t samples = 0;
+  std::uint64_t nanCount = 0;
+  bool shifted = false;
+  double shift = 0;
+  double sum = 0;
+  double sumSquares = 0;
+  double min = std::numeric_limits<double>::infinity();
+  double max = -std::numeric_limits<double>::infinity();
+  std::uint64_t changes = 0;
+  double firstChangeSeconds = kNaN;
+  double lastChangeSeconds = kNaN;
+};
+
+struct RangeResult {
+  std::vector<Accumulator> variables;
+  std::vector<char> firstFrame;
+  std::vector<char> lastFrame;
+  double firstSeconds = 0;
+  std::uint64_t frames = 0;
+  std::string error;
+};
+
+template <typename T>
+void accumulateValues(const char* data, int count, Accumulator& accumulator) {
+  if (!accumulator.shifted) {
+    T first;
+    std::memcpy(&first, data, sizeof(T));
+    const auto value = static_cast<double>(first);
+    accumulator.shift = std::isnan(value) ? 0 : value;
+    accumulator.shifted = true;
+  }
+
+  // Branch-free body so the element loop over arrays vectorizes.
+  const double shift = accumulator.shift;
+  double sum = 0;
+  double sumSquares = 0;
+  double low = accumulator.min;
+  double high = accumulator.max;
+  std::uint64_t nanCount = 0;
+  for (int i = 0; i < count; ++i) {
+    T raw;
+    std::memcpy(
+        &raw, data + static_cast<std::size_t>(i) * sizeof(T), sizeof(T));
+    const auto value = static_cast<double>(raw);
+    const bool isNaN = value != value;
+    const double delta = isNaN ? 0 : value - shift;
+    nanCount += isNaN ? 1 : 0;
+    sum += delta;
+    sumSquares += delta * delta;
+    low = isNaN ? low : std::min(low, value);
+    high = isNaN ? high : std::max(high, value);
+  }
+  accumulator.samples += static_cast<std::uint64_t>(count) - nanCount;
+  accumulator.nanCount += nanCount;
+  accumulator.sum += sum;
+  accumulator.sumSquares += sumSquares;
+  accumulator.min = low;
+  accumulator.max = high;
+}
+
+void accumulateVariable(
+    const irsdk_varHeader& variable,
+    const char* frame,
+    Accumulator& accumulator) {
+  const char* data = frame + variable.offset;
+  switch (variable.type) {
+    case irsdk_char:
+    case irsdk_bool:
+      accumulateValues<std::uint8_t>(data, variable.count, accumulator);
+      break;
+    case irsdk_int:
+      accumulateValues<std::int32_t>(data, variable.count, accumulator);
+      break;
+    case irsdk_bitField:
+      accumulateValues<std::uint32_t>(data, variable.count, accumulator);
+      break;
+    case irsdk_float:
+      accumulateValues<float>(data, variable.count, accumulator);
+      break;
+    default:
+      accumulateValues<double>(data, variable.count, accumulator);
+      break;
+  }
+}
+
+std::size_t variableBytes(const irsdk_varHeader& variable) {
+  return static_cast<std::size_t>(irsdk_VarTypeBytes[variable.type]) *
+      static_cast<std::size_t>(variable.count);
+}
+
+void recordChange(Accumulator& accumulator, double seconds) {
+  ++accumulator.changes;
+  if (std::isnan(accumulator.firstChangeSeconds)) {
+    accumulator.firstChangeSeconds = seconds;
+  }
+  accumulator.lastChangeSeconds = seconds;
+}
+
+void processRange(
+    const std::filesystem::path& input,
+    const std::vector<TapeIndexEntry>& index,
+    std::size_t firstRecord,
+    std::uint64_t frameCount,
+    RangeResult& result) {
+  TapeReader reader;
+  if (!reader.open(input, result.error)) {
+    return;
+  }
+  reader.useIndex(index);
+  if (!reader.seekRecord(firstRecord, result.error)) {
+    return;
+  }
+
+  const auto& variables = reader.variables();
+  const auto bufLen = static_cast<std::size_t>(reader.sdkHeader().bufLen);
+  const auto frequency =
+      static_cast<double>(reader.fileHeader().qpcFrequency);
+  result.variables.assign(variables.size(), Accumulator{});
+
+  TapeRecordHeader record{};
+  std::vector<char> current;
+  std::vector<char> previous;
+  while (result.frames < frameCount) {
+    const auto readResult = reader.readNext(record, current, result.error);
+    if (readResult != TapeReadResult::Record) {
+      if (readResult == TapeReadResult::EndOfFile) {
+        result.error = "Telemetry tape ended before its indexed frames";
+      }
+      return;
+    }
+    if (static_cast<RecordKind>(record.kind) != RecordKind::Frame) {
+      continue;
+    }
+    if (current.size() != bufLen) {
+      result.error = "Tape frame does not match the recorded buffer length";
+      return;
+    }
+
+    const double seconds =
+        static_cast<double>(record.elapsedTicks) / frequency;
+    if (result.frames == 0) {
+      result.firstFrame = current;
+      result.firstSeconds = seconds;
+    }
+    for (std::size_t i = 0; i < variables.size(); ++i) {
+      const auto& variable = variables[i];
+      accumulateVariable(variable, current.data(), result.variables[i]);
+      if (result.frames > 0 &&
+          std::memcmp(
+              previous.data() + variable.offset,
+              current.data() + variable.offset,
+              variableBytes(variable)) != 0) {
+        recordChange(result.variables[i], seconds);
+      }
+    }
+    previous.swap(current);
+    ++result.frames;
+  }
+  result.lastFrame = std::move(previous);
+}
+
+// Chan et al.'s pairwise update for count, mean, and sum of squared
+// deviations.
+void mergeMoments(
+    double& count,
+    double& mean,
+    double& m2,
+    double otherCount,
+    double otherMean,
+    double otherM2) {
+  if (otherCount == 0) {
+    return;
+  }
+  const double total = count + otherCount;
+  const double delta = otherMean - mean;
+  mean += delta * otherCount / total;
+  m2 += otherM2 + delta * delta * count * otherCount / total;
+  count = total;
+}
+
+}  // namespace
+
+bool computeTapeStats(
+    const std::filesystem::path& input,
+    std::size_t jobs,
+    TapeStats& stats,
+    std::string& error) {
+  stats = {};
+  TapeReader tape;
+  if (!tape.open(input, error) || !tape.buildIndex(error)) {
+    return false;
+  }
+
+  std::vector<std::size_t> frameRecords;
+  const auto& index = tape.index();
+  for (std::size_t i = 0; i < index.size(); ++i) {
+    const auto kind = static_cast<std::size_t>(index[i].kind);
+    if (kind < stats.recordCounts.size()) {
+      ++stats.recordCounts[kind];
+    }
+    if (index[i].repeat == 1) {
+      ++stats.recordCounts[static_cast<std::size_t>(RecordKind::Repeat)];
+    }
+    if (index[i].repeat > 0) {
+      ++stats.repeatedFrames;
+    }
+    if (index[i].kind == RecordKind::Frame) {
+      frameRecords.push_back(i);
+    }
+  }
+  stats.frames = frameRecords.size();
+
+  const auto rangeCount = std::max<std::size_t>(
+      1, std::min(std::max<std::size_t>(jobs, 1), frameRecords.size()));
+  std::vector<RangeResult> ranges(rangeCount);
+  std::vector<std::thread> workers;
+  workers.reserve(rangeCount);
+  for (std::size_t range = 0; range < rangeCount && !frameRecords.empty();
+       ++range) {
+    const auto begin = frameRecords.size() * range / rangeCount;
+    const auto end = frameRecords.size() * (range + 1) / rangeCount;
+    workers.emplace_back(
+        processRange,
+        std::cref(input),
+        std::cref(index),
+        frameRecords[begin],
+        static_cast<std::uint64_t>(end - begin),
+        std::ref(ranges[range]));
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  for (const auto& range : ranges) {
+    if (!range.error.empty()) {
+      error = range.error;
+      return false;
+    }
+  }
+
+  const auto& variables = tape.variables();
+  stats.variables.assign(variables.size(), VariableStats{});
+  for (std::size_t i = 0; i < variables.size(); ++i) {
+    const auto& variable = variables[i];
+    auto& merged = stats.variables[i];
+    double count = 0;
+    double mean = 0;
+    double m2 = 0;
+    double low = std::numeric_limits<double>::infinity();
+    double high = -std::numeric_limits<double>::infinity();
+    merged.firstChangeSeconds = kNaN;
+    merged.lastChangeSeconds = kNaN;
+    const RangeResult* previous = nullptr;
+
+    for (const auto& range : ranges) {
+      if (range.frames == 0) {
+        continue;
+      }
+      const auto& part = range.variables[i];
+      // A change on the first frame of a range is only visible against the
+      // previous range's last frame.
+      if (previous != nullptr &&
+          std::memcmp(
+              previous->lastFrame.data() + variable.offset,
+              range.firstFrame.data() + variable.offset,
+              variableBytes(variable)) != 0) {
+        ++merged.changes;
+        if (std::isnan(merged.firstChangeSeconds)) {
+          merged.firstChangeSeconds = range.firstSeconds;
+        }
+        merged.lastChangeSeconds = range.firstSeconds;
+      }
+      merged.changes += part.changes;
+      if (std::isnan(merged.firstChangeSeconds)) {
+        merged.firstChangeSeconds = part.firstChangeSeconds;
+      }
+      if (!std::isnan(part.lastChangeSeconds)) {
+        merged.lastChangeSeconds = part.lastChangeSeconds;
+      }
+
+      merged.nanCount += part.nanCount;
+      merged.samples += part.samples;
+      low = std::min(low, part.min);
+      high = std::max(high, part.max);
+      if (part.samples > 0) {
+        const double partCount = static_cast<double>(part.samples);
+        const double partMean = part.shift + part.sum / partCount;
+        const double partM2 = std::max(
+            0.0, part.sumSquares - part.sum * part.sum / partCount);
+        mergeMoments(count, mean, m2, partCount, partMean, partM2);
+      }
+      previous = &range;
+    }
+
+    const bool numeric =
+        variable.type != irsdk_bitField && variable.type != irsdk_char;
+    merged.min = merged.samples > 0 ? low : kNaN;
+    merged.max = merged.samples > 0 ? high : kNaN;
+    merged.mean = merged.samples > 0 && numeric ? mean : kNaN;
+    merged.stddev =
+        merged.samples > 0 && numeric ? std::sqrt(m2 / count) : kNaN;
+  }
+  return true;
+}
+
+}  // namespace irdashies::irsdk_replay
@@ -0,0 +1,51 @@
+#ifndef IRDASHIES_IRSDK_TAPE_STATS_H
+#define IRDASHIES_IRSDK_TAPE_STATS_H
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace irdashies::irsdk_replay {
+
+// Statistics over every element of one variable across all Frame records.
+// Array variables such as CarIdxLapDistPct pool their elements. A change is
+// a frame whose bytes for the variable differ from the previous frame's; its
+// time is the frame's elapsed tape time in seconds. Values that cannot be
+// computed (no samples, no changes, or mean/stddev of bitfields and chars)
+// are NaN.
+struct VariableStats {
+  std::uint64_t samples = 0;
+  std::uint64_t nanCount = 0;
+  double min = 0;
+  double max = 0;
+  double mean = 0;
+  double stddev = 0;
+  std::uint64_t changes = 0;
+  double firstChangeSeconds = 0;
+  double lastChangeSeconds = 0;
+};
+
+struct TapeStats {
+  // Record counts indexed by RecordKind. Frames expanded from Repeat records
+  // count as Frame records, and each Repeat record counts once as well.
+  std::array<std::uint64_t, 8> recordCounts{};
+  std::uint64_t frames = 0;
+  // Frames stored as repeats of an earlier frame.
+  std::uint64_t repeatedFrames = 0;
+  std::vector<VariableStats> variables;
+};
+
+// Reads each record once. The tape's frames are split into contiguous ranges,
+// one per job, and the per-range results are merged in order, including the
+// changes that fall on range boundaries.
+bool computeTapeStats(
+    const std::filesystem::path& input,
+    std::size_t jobs,
+    TapeStats& stats,
+    std::string& error);
+
+}  // namespace irdashies::irsdk_replay
+
+#endif
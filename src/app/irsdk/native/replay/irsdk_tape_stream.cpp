@@ -0,0 +1,171 @@
+#include "./irsdk_tape_stream.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace irdashies::irsdk_replay {
+namespace {
+
+// Largest single read from the source, so the consumer sees data promptly
+// even when the ring is large.
+constexpr std::size_t kReadChunkBytes = 256U * 1024U;
+
+}  // namespace
+
+// State shared with the reader thread. The thread can sit in a blocking read
+// on a pipe whose writer never closes it, so the buffer detaches instead of
+// joining, and whichever side finishes last frees this.
+struct ReadAheadBuffer::Shared {
+  std::FILE* file = nullptr;
+  bool ownsFile = false;
+  std::vector<char> ring;
+
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::size_t head = 0;
+  std::size_t size = 0;
+  // Bytes at head handed to the consumer as its get area.
+  std::size_t lent = 0;
+  bool finished = false;
+  bool stopped = false;
+  std::string error;
+
+  void run() {
+    while (true) {
+      std::size_t tail = 0;
+      std::size_t span = 0;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return stopped || size < ring.size(); });
+        if (stopped) {
+          break;
+        }
+        tail = (head + size) % ring.size();
+        span = std::min(
+            {ring.size() - size, ring.size() - tail, kReadChunkBytes});
+      }
+
+      // Only this thread writes [tail, tail + span), and the consumer never
+      // reads past head + size, so the read runs without the lock.
+      const auto count = std::fread(ring.data() + tail, 1, span, file);
+      std::lock_guard<std::mutex> lock(mutex);
+      size += count;
+      if (count < span) {
+        if (std::ferror(file) != 0) {
+          error = "Could not read the telemetry tape stream";
+        }
+        finished = true;
+        changed.notify_all();
+        break;
+      }
+      changed.notify_all();
+    }
+    if (ownsFile) {
+      std::fclose(file);
+    }
+  }
+};
+
+bool isTapeStreamPath(const std::filesystem::path& path) {
+  if (path == "-") {
+    return true;
+  }
+  std::error_code statusError;
+  const auto status = std::filesystem::status(path, statusError);
+  return !statusError && std::filesystem::exists(status) &&
+      !std::filesystem::is_regular_file(status) &&
+      !std::filesystem::is_directory(status);
+}
+
+ReadAheadBuffer::~ReadAheadBuffer() {
+  if (shared_ == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(shared_->mutex);
+  shared_->stopped = true;
+  shared_->changed.notify_all();
+}
+
+bool ReadAheadBuffer::open(
+    const std::filesystem::path& path,
+    std::size_t readAheadBytes,
+    std::string& error) {
+  if (shared_ != nullptr) {
+    error = "Telemetry tape stream is already open";
+    return false;
+  }
+  auto shared = std::make_shared<Shared>();
+  if (path == "-") {
+#if defined(_WIN32)
+    _setmode(_fileno(stdin), _O_BINARY);
+#endif
+    shared->file = stdin;
+  } else {
+#if defined(_WIN32)
+    shared->file = _wfopen(path.c_str(), L"rb");
+#else
+    shared->file = std::fopen(path.c_str(), "rb");
+#endif
+    shared->ownsFile = true;
+  }
+  if (shared->file == nullptr) {
+    error = "Could not open " + path.string();
+    return false;
+  }
+  // The file has its own buffering off, since the ring already is one.
+  std::setvbuf(shared->file, nullptr, _IONBF, 0);
+  shared->ring.resize(std::max(readAheadBytes, kReadChunkBytes));
+
+  shared_ = shared;
+  std::thread([shared] { shared->run(); }).detach();
+  return true;
+}
+
+std::string ReadAheadBuffer::readError() const {
+  if (shared_ == nullptr) {
+    return {};
+  }
+  std::lock_guard<std::mutex> lock(shared_->mutex);
+  return shared_->error;
+}
+
+ReadAheadBuffer::int_type ReadAheadBuffer::underflow() {
+  if (gptr() < egptr()) {
+    return traits_type::to_int_type(*gptr());
+  }
+  if (shared_ == nullptr) {
+    return traits_type::eof();
+  }
+
+  auto& shared = *shared_;
+  std::unique_lock<std::mutex> lock(shared.mutex);
+  // Everything lent last time has been consumed; give it back to the reader.
+  shared.head = (shared.head + shared.lent) % shared.ring.size();
+  shared.size -= shared.lent;
+  shared.lent = 0;
+  shared.changed.notify_all();
+
+  shared.changed.wait(lock, [&shared] {
+    return shared.size > 0 || shared.finished;
+  });
+  if (shared.size == 0) {
+    setg(nullptr, nullptr, nullptr);
+    return traits_type::eof();
+  }
+  shared.lent = std::min(shared.size, shared.ring.size() - shared.head);
+  char* begin = shared.ring.data() + shared.head;
+  setg(begin, begin, begin + shared.lent);
+  return traits_type::to_int_type(*gptr());
+}
+
+}  // namespace irdashies::irsdk_replay
@@ -0,0 +1,49 @@
+#ifndef IRDASHIES_IRSDK_TAPE_STREAM_H
+#define IRDASHIES_IRSDK_TAPE_STREAM_H
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <streambuf>
+#include <string>
+
+namespace irdashies::irsdk_replay {
+
+constexpr std::size_t kDefaultReadAheadBytes = 16U * 1024U * 1024U;
+
+// True for "-" (standard input) and for paths that exist but are not regular
+// files, such as named pipes, which can only be read front to back.
+bool isTapeStreamPath(const std::filesystem::path& path);
+
+// Sequential input from a pipe, FIFO, or standard input. A background thread
+// reads up to readAheadBytes ahead of the consumer, so a producer such as a
+// decompressor keeps running while records are parsed. The get area points
+// straight into the ring, so bytes are copied once, from the source into the
+// ring. Seeking is unsupported and fails like any unseekable streambuf.
+class ReadAheadBuffer : public std::streambuf {
+ public:
+  ReadAheadBuffer() = default;
+  ReadAheadBuffer(const ReadAheadBuffer&) = delete;
+  ReadAheadBuffer& operator=(const ReadAheadBuffer&) = delete;
+  ~ReadAheadBuffer() override;
+
+  bool open(
+      const std::filesystem::path& path,
+      std::size_t readAheadBytes,
+      std::string& error);
+
+  // Set once the source failed; the consumer then sees end of input.
+  std::string readError() const;
+
+ protected:
+  int_type underflow() override;
+
+ private:
+  struct Shared;
+
+  std::shared_ptr<Shared> shared_;
+};
+
+}  // namespace irdashies::irsdk_replay
+
+#endif
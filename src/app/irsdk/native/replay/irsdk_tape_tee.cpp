@@ -0,0 +1,405 @@
+#include "./irsdk_tape_tee.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "./irsdk_tape.h"
+#include "./irsdk_tape_events.h"
+
+namespace irdashies::irsdk_replay {
+namespace {
+
+constexpr std::uint64_t kNanosecondsPerSecond = 1000000000ULL;
+
+enum class TeeItemKind {
+  Begin,
+  SessionInfo,
+  Frame,
+  Finish,
+};
+
+struct TeeItem {
+  TeeItemKind kind = TeeItemKind::Frame;
+  std::uint64_t elapsedTicks = 0;
+  std::int32_t tick = 0;
+  // Buffer index for frames, update count for session info, and 1 for a
+  // Finish caused by a disconnect.
+  std::int32_t value = 0;
+  std::vector<char> payload;
+  // Begin only.
+  irsdk_header header{};
+  std::vector<irsdk_varHeader> variables;
+};
+
+// live-20260118-193012.irdt in UTC, with a suffix if that name is taken.
+std::filesystem::path nextTapePath(const std::filesystem::path& directory) {
+  const std::time_t now = std::time(nullptr);
+  std::tm utc{};
+#if defined(_WIN32)
+  gmtime_s(&utc, &now);
+#else
+  gmtime_r(&now, &utc);
+#endif
+  char stamp[32] = {};
+  std::strftime(stamp, sizeof(stamp), "live-%Y%m%d-%H%M%S", &utc);
+
+  auto path = directory / (std::string(stamp) + ".irdt");
+  std::error_code existsError;
+  for (int suffix = 2; std::filesystem::exists(path, existsError); ++suffix) {
+    path = directory /
+        (std::string(stamp) + "-" + std::to_string(suffix) + ".irdt");
+  }
+  return path;
+}
+
+}  // namespace
+
+struct TapeTee::Shared {
+  std::filesystem::path directory;
+  std::thread thread;
+
+  mutable std::mutex mutex;
+  std::condition_variable changed;
+  std::deque<TeeItem> queue;
+  std::size_t queuedFrames = 0;
+  // Frame payloads the writer is done with, reused by the addon thread.
+  std::vector<std::vector<char>> spare;
+  bool stopping = false;
+  TapeTeeStats stats;
+
+  // Owned by the writer thread.
+  std::unique_ptr<TapeWriter> writer;
+  std::unique_ptr<TapeEventDetector> detector;
+  std::vector<TapeEvent> events;
+  std::uint64_t mappingSize = 0;
+  std::int32_t sessionInfoOffset = 0;
+  std::int32_t lastTick = std::numeric_limits<std::int32_t>::min();
+
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      changed.wait(lock, [this] { return stopping || !queue.empty(); });
+      if (queue.empty()) {
+        break;
+      }
+      TeeItem item = std::move(queue.front());
+      queue.pop_front();
+      if (item.kind == TeeItemKind::Frame) {
+        --queuedFrames;
+      }
+      lock.unlock();
+
+      std::string error;
+      const bool written = write(item, error);
+
+      lock.lock();
+      if (!written) {
+        stats.error = error;
+        stats.path.clear();
+      }
+      if (item.kind == TeeItemKind::Frame) {
+        if (written && writer != nullptr) {
+          ++stats.frames;
+        }
+        spare.push_back(std::move(item.payload));
+      }
+    }
+  }
+
+  // A failed write abandons the tape; items up to the next Begin are
+  // discarded.
+  bool write(const TeeItem& item, std::string& error) {
+    if (item.kind == TeeItemKind::Begin) {
+      writer.reset();
+      return begin(item, error);
+    }
+    if (writer == nullptr) {
+      return true;
+    }
+
+    bool written = true;
+    switch (item.kind) {
+      case TeeItemKind::SessionInfo:
+        written = writer->append(
+            RecordKind::SessionInfo,
+            item.elapsedTicks,
+            lastTick == std::numeric_limits<std::int32_t>::min()
+                ? -1
+                : lastTick,
+            item.value,
+            item.payload.empty() ? nullptr : item.payload.data(),
+            static_cast<std::uint32_t>(item.payload.size()),
+            error);
+        mappingSize = std::max(
+            mappingSize,
+            static_cast<std::uint64_t>(sessionInfoOffset) +
+                item.payload.size());
+        break;
+      case TeeItemKind::Frame:
+        written = appendFrame(item, error);
+        break;
+      case TeeItemKind::Finish: {
+        const bool disconnected = item.value != 0;
+        written =
+            (!disconnected ||
+             writer->append(
+                 RecordKind::Disconnect,
+                 item.elapsedTicks,
+                 lastTick,
+                 0,
+                 nullptr,
+                 0,
+                 error)) &&
+            writer->append(
+                RecordKind::End,
+                item.elapsedTicks,
+                lastTick,
+                disconnected ? 1 : 0,
+                nullptr,
+                0,
+                error) &&
+            writer->appendEventIndex(events, item.elapsedTicks, error) &&
+            writer->finish(mappingSize, error);
+        writer.reset();
+        std::lock_guard<std::mutex> guard(mutex);
+        stats.path.clear();
+        break;
+      }
+      case TeeItemKind::Begin:
+        break;
+    }
+    if (!written) {
+      writer.reset();
+    }
+    return written;
+  }
+
+  bool begin(const TeeItem& item, std::string& error) {
+    if (!validateSdkLayout(item.header, item.variables, mappingSize, error)) {
+      return false;
+    }
+    const auto path = nextTapePath(directory);
+    auto next = std::make_unique<TapeWriter>();
+    next->enableFrameRepeats();
+    if (!next->open(
+            path,
+            item.header,
+            item.variables,
+            mappingSize,
+            kNanosecondsPerSecond,
+            error)) {
+      return false;
+    }
+    writer = std::move(next);
+    detector = std::make_unique<TapeEventDetector>(item.variables);
+    events.clear();
+    sessionInfoOffset = item.header.sessionInfoOffset;
+    lastTick = std::numeric_limits<std::int32_t>::min();
+
+    std::lock_guard<std::mutex> guard(mutex);
+    stats.path = path.string();
+    ++stats.tapes;
+    return true;
+  }
+
+  bool appendFrame(const TeeItem& item, std::string& error) {
+    if (item.tick <= lastTick &&
+        lastTick != std::numeric_limits<std::int32_t>::min()) {
+      return true;
+    }
+    if (lastTick != std::numeric_limits<std::int32_t>::min() &&
+        item.tick > lastTick + 1 &&
+        !writer->append(
+            RecordKind::Gap,
+            item.elapsedTicks,
+            item.tick,
+            item.tick - lastTick - 1,
+            nullptr,
+            0,
+            error)) {
+      return false;
+    }
+    const auto frameOffset = writer->nextRecordOffset();
+    if (!writer->append(
+            RecordKind::Frame,
+            item.elapsedTicks,
+            item.tick,
+            item.value,
+            item.payload.data(),
+            static_cast<std::uint32_t>(item.payload.size()),
+            error)) {
+      return false;
+    }
+    detector->observe(
+        item.payload.data(), frameOffset, item.elapsedTicks, item.tick, events);
+    lastTick = item.tick;
+    return true;
+  }
+};
+
+TapeTee::TapeTee() = default;
+
+TapeTee::~TapeTee() {
+  stop();
+}
+
+bool TapeTee::start(const std::filesystem::path& directory, std::string& error) {
+  if (shared_ != nullptr) {
+    error = "The telemetry tee is already recording";
+    return false;
+  }
+  std::error_code directoryError;
+  std::filesystem::create_directories(directory, directoryError);
+  if (directoryError) {
+    error = "Could not create " + directory.string() + ": " +
+        directoryError.message();
+    return false;
+  }
+
+  shared_ = std::make_unique<Shared>();
+  shared_->directory = directory;
+  shared_->thread = std::thread([shared = shared_.get()] { shared->run(); });
+  active_ = false;
+  return true;
+}
+
+void TapeTee::stop() {
+  if (shared_ == nullptr) {
+    return;
+  }
+  if (active_) {
+    finishTape(false);
+  }
+  {
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    shared_->stopping = true;
+  }
+  shared_->changed.notify_all();
+  shared_->thread.join();
+  stoppedStats_ = shared_->stats;
+  shared_.reset();
+}
+
+bool TapeTee::running() const {
+  return shared_ != nullptr;
+}
+
+void TapeTee::frame(
+    const irsdk_header& header,
+    const irsdk_varHeader* variables,
+    const char* sessionInfo,
+    const char* frame,
+    int tick) {
+  if (shared_ == nullptr || frame == nullptr) {
+    return;
+  }
+
+  irsdk_header current{};
+  std::memcpy(&current, &header, sizeof(current));
+  if (active_ && !sameFrameLayout(layout_, current)) {
+    finishTape(false);
+  }
+
+  std::vector<TeeItem> items;
+  if (!active_) {
+    if (variables == nullptr || current.numVars <= 0 ||
+        current.numVars > 4096 || current.bufLen <= 0) {
+      return;
+    }
+    TeeItem begin;
+    begin.kind = TeeItemKind::Begin;
+    begin.header = current;
+    begin.variables.assign(variables, variables + current.numVars);
+    items.push_back(std::move(begin));
+    active_ = true;
+    layout_ = current;
+    lastSessionUpdate_ = std::numeric_limits<int>::min();
+    start_ = std::chrono::steady_clock::now();
+  }
+
+  const auto elapsedTicks = elapsedNanoseconds();
+  if (current.sessionInfoUpdate != lastSessionUpdate_ &&
+      sessionInfo != nullptr && current.sessionInfoLen >= 0 &&
+      static_cast<std::uint32_t>(current.sessionInfoLen) <= kMaxPayloadSize) {
+    TeeItem session;
+    session.kind = TeeItemKind::SessionInfo;
+    session.elapsedTicks = elapsedTicks;
+    session.value = current.sessionInfoUpdate;
+    session.payload.assign(sessionInfo, sessionInfo + current.sessionInfoLen);
+    items.push_back(std::move(session));
+    lastSessionUpdate_ = current.sessionInfoUpdate;
+  }
+
+  int latest = 0;
+  for (int i = 1; i < current.numBuf && i < IRSDK_MAX_BUFS; ++i) {
+    if (current.varBuf[i].tickCount > current.varBuf[latest].tickCount) {
+      latest = i;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(shared_->mutex);
+  for (auto& item : items) {
+    shared_->queue.push_back(std::move(item));
+  }
+  if (shared_->queuedFrames >= kTeeQueuedFrames) {
+    ++shared_->stats.droppedFrames;
+  } else {
+    TeeItem item;
+    item.kind = TeeItemKind::Frame;
+    item.elapsedTicks = elapsedTicks;
+    item.tick = tick;
+    item.value = latest;
+    if (!shared_->spare.empty()) {
+      item.payload = std::move(shared_->spare.back());
+      shared_->spare.pop_back();
+    }
+    item.payload.assign(frame, frame + current.bufLen);
+    shared_->queue.push_back(std::move(item));
+    ++shared_->queuedFrames;
+  }
+  shared_->changed.notify_one();
+}
+
+void TapeTee::disconnect() {
+  if (shared_ != nullptr && active_) {
+    finishTape(true);
+  }
+}
+
+TapeTeeStats TapeTee::stats() const {
+  if (shared_ == nullptr) {
+    return stoppedStats_;
+  }
+  std::lock_guard<std::mutex> lock(shared_->mutex);
+  return shared_->stats;
+}
+
+std::uint64_t TapeTee::elapsedNanoseconds() const {
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start_)
+          .count());
+}
+
+void TapeTee::finishTape(bool disconnected) {
+  TeeItem item;
+  item.kind = TeeItemKind::Finish;
+  item.elapsedTicks = elapsedNanoseconds();
+  item.value = disconnected ? 1 : 0;
+  active_ = false;
+
+  std::lock_guard<std::mutex> lock(shared_->mutex);
+  shared_->queue.push_back(std::move(item));
+  shared_->changed.notify_one();
+}
+
+}  // namespace irdashies::irsdk_replay
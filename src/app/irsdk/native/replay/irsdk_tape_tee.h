@@ -0,0 +1,82 @@
+#ifndef IRDASHIES_IRSDK_TAPE_TEE_H
+#define IRDASHIES_IRSDK_TAPE_TEE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "../lib/irsdk_defines.h"
+
+namespace irdashies::irsdk_replay {
+
+// Frames the writer thread may fall behind by before new frames are dropped.
+// Dropped frames show up in the tape as gaps.
+constexpr std::size_t kTeeQueuedFrames = 600;
+
+struct TapeTeeStats {
+  // Tape currently being written; empty between connections.
+  std::string path;
+  std::uint64_t tapes = 0;
+  std::uint64_t frames = 0;
+  std::uint64_t droppedFrames = 0;
+  // Last error from the writer thread. The tape it was writing is abandoned
+  // and the tee resumes with the next connection.
+  std::string error;
+};
+
+// Records the frames and session revisions the live addon already copies out
+// of shared memory, so capturing costs no extra shared-memory read. The addon
+// thread only copies into a queue; a background thread owns the TapeWriter.
+// Each connection, or each SDK layout within one, becomes its own tape in the
+// output directory.
+class TapeTee {
+ public:
+  TapeTee();
+  TapeTee(const TapeTee&) = delete;
+  TapeTee& operator=(const TapeTee&) = delete;
+  // Finishes the current tape.
+  ~TapeTee();
+
+  bool start(const std::filesystem::path& directory, std::string& error);
+  // Finishes the current tape and waits for the writer thread.
+  void stop();
+  bool running() const;
+
+  // Call after each copy into frame. header, variables, and sessionInfo point
+  // at the live mapping; the layout is compared on every frame and the
+  // session string is copied only when sessionInfoUpdate changes.
+  void frame(
+      const irsdk_header& header,
+      const irsdk_varHeader* variables,
+      const char* sessionInfo,
+      const char* frame,
+      int tick);
+  // The sim disconnected: the current tape gets a Disconnect record and is
+  // finished.
+  void disconnect();
+
+  // Counts since start(); after stop() they describe the finished run.
+  TapeTeeStats stats() const;
+
+ private:
+  struct Shared;
+
+  std::uint64_t elapsedNanoseconds() const;
+  void finishTape(bool disconnected);
+
+  std::unique_ptr<Shared> shared_;
+  TapeTeeStats stoppedStats_;
+
+  // Owned by the addon thread.
+  bool active_ = false;
+  irsdk_header layout_{};
+  int lastSessionUpdate_ = 0;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace irdashies::irsdk_replay
+
+#endif
@@ -0,0 +1,545 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <clocale>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <cwctype>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "./irsdk_tape.h"
+#include "./irsdk_tape_columns.h"
+#include "./irsdk_tape_convert.h"
+#include "./irsdk_tape_diff.h"
+#include "./irsdk_tape_events.h"
+
+namespace replay = irdashies::irsdk_replay;
+
+// Offline tape utilities. Unlike irsdk_replay, nothing here touches shared
+// memory, so the tool builds from the tape library alone on every platform.
+namespace {
+
+std::optional<std::wstring> optionValue(
+    const std::vector<std::wstring>& arguments,
+    const std::wstring& name) {
+  for (std::size_t i = 0; i + 1 < arguments.size(); ++i) {
+    if (arguments[i] == name) {
+      return arguments[i + 1];
+    }
+  }
+  return std::nullopt;
+}
+
+bool parseJobCount(
+    const std::optional<std::wstring>& input,
+    std::size_t& jobs,
+    std::string& error) {
+  if (!input.has_value()) {
+    jobs = std::max(1U, std::thread::hardware_concurrency());
+    return true;
+  }
+  errno = 0;
+  wchar_t* end = nullptr;
+  const long parsed = std::wcstol(input->c_str(), &end, 10);
+  if (errno != 0 || end == input->c_str() || end == nullptr || *end != L'\0' ||
+      parsed <= 0 || parsed > 256) {
+    error = "--jobs must be between 1 and 256";
+    return false;
+  }
+  jobs = static_cast<std::size_t>(parsed);
+  return true;
+}
+
+bool hasExtension(const std::filesystem::path& path, const wchar_t* extension) {
+  auto actual = path.extension().wstring();
+  std::transform(actual.begin(), actual.end(), actual.begin(), [](wchar_t c) {
+    return static_cast<wchar_t>(std::towlower(c));
+  });
+  return actual == extension;
+}
+
+std::vector<std::filesystem::path> positionalPaths(
+    const std::vector<std::wstring>& arguments) {
+  std::vector<std::filesystem::path> paths;
+  for (std::size_t i = 2; i < arguments.size(); ++i) {
+    if (arguments[i].rfind(L"--", 0) == 0) {
+      ++i;
+      continue;
+    }
+    paths.emplace_back(arguments[i]);
+  }
+  return paths;
+}
+
+struct ConversionJob {
+  std::filesystem::path input;
+  std::filesystem::path output;
+  bool toTape;
+};
+
+// Files are independent, so workers claim whole files from a shared counter.
+// Each conversion streams its input, keeping memory flat per worker.
+int convertFiles(const std::vector<std::wstring>& arguments) {
+  std::string error;
+  std::size_t jobs = 0;
+  if (!parseJobCount(optionValue(arguments, L"--jobs"), jobs, error)) {
+    std::cerr << error << '\n';
+    return 2;
+  }
+  const auto outputDirectory = optionValue(arguments, L"--output-dir");
+
+  std::vector<ConversionJob> conversions;
+  for (std::size_t i = 2; i < arguments.size(); ++i) {
+    if (arguments[i] == L"--jobs" || arguments[i] == L"--output-dir") {
+      ++i;
+      continue;
+    }
+    const std::filesystem::path input(arguments[i]);
+    const bool toTape = hasExtension(input, L".ibt");
+    if (!toTape && !hasExtension(input, L".irdt")) {
+      std::cerr << "convert accepts .ibt and .irdt inputs: "
+                << input.string() << '\n';
+      return 2;
+    }
+    auto output = input;
+    output.replace_extension(toTape ? L".irdt" : L".ibt");
+    if (outputDirectory.has_value()) {
+      output = std::filesystem::path(*outputDirectory) / output.filename();
+    }
+    conversions.push_back({input, output, toTape});
+  }
+  if (conversions.empty()) {
+    std::cerr << "convert requires at least one .ibt or .irdt input\n";
+    return 2;
+  }
+
+  std::atomic<std::size_t> next = 0;
+  std::atomic<std::size_t> failures = 0;
+  std::mutex outputMutex;
+  auto worker = [&]() {
+    while (true) {
+      const auto index = next.fetch_add(1);
+      if (index >= conversions.size()) {
+        return;
+      }
+      const auto& conversion = conversions[index];
+      std::uint64_t frames = 0;
+      std::string conversionError;
+      const bool converted = conversion.toTape
+          ? replay::convertIbtToTape(
+                conversion.input, conversion.output, frames, conversionError)
+          : replay::convertTapeToIbt(
+                conversion.input, conversion.output, frames, conversionError);
+      if (!converted) {
+        std::error_code removeError;
+        std::filesystem::remove(conversion.output, removeError);
+        ++failures;
+      }
+
+      std::lock_guard<std::mutex> lock(outputMutex);
+      if (converted) {
+        std::cout << conversion.input.string() << " -> "
+                  << conversion.output.string() << " (" << frames
+                  << " frames)\n";
+      } else {
+        std::cerr << conversion.input.string() << ": " << conversionError
+                  << '\n';
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  const auto workerCount = std::min(jobs, conversions.size());
+  workers.reserve(workerCount);
+  for (std::size_t i = 0; i < workerCount; ++i) {
+    workers.emplace_back(worker);
+  }
+  for (auto& thread : workers) {
+    thread.join();
+  }
+
+  if (failures.load() > 0) {
+    std::cerr << failures.load() << " of " << conversions.size()
+              << " conversions failed\n";
+    return 1;
+  }
+  return 0;
+}
+
+int exportTape(const std::vector<std::wstring>& arguments) {
+  const auto input = optionValue(arguments, L"--input");
+  if (!input.has_value()) {
+    std::cerr << "export requires --input <capture.irdt>\n";
+    return 2;
+  }
+
+  std::string error;
+  replay::ColumnExportOptions options;
+  if (!parseJobCount(optionValue(arguments, L"--jobs"), options.jobs, error)) {
+    std::cerr << error << '\n';
+    return 2;
+  }
+  const auto chunkRows = optionValue(arguments, L"--chunk-rows");
+  if (chunkRows.has_value()) {
+    errno = 0;
+    wchar_t* end = nullptr;
+    const long parsed = std::wcstol(chunkRows->c_str(), &end, 10);
+    if (errno != 0 || end == chunkRows->c_str() || end == nullptr ||
+        *end != L'\0' || parsed <= 0 || parsed > 1048576) {
+      std::cerr << "--chunk-rows must be between 1 and 1048576\n";
+      return 2;
+    }
+    options.chunkRows = static_cast<std::uint32_t>(parsed);
+  }
+  const auto varsOption = optionValue(arguments, L"--vars");
+  if (varsOption.has_value() &&
+      !replay::parseVariableList(*varsOption, options.variables, error)) {
+    std::cerr << error << '\n';
+    return 2;
+  }
+
+  std::filesystem::path output(*input);
+  output.replace_extension(L".irdc");
+  const auto outputOption = optionValue(arguments, L"--output");
+  if (outputOption.has_value()) {
+    output = std::filesystem::path(*outputOption);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  replay::ColumnExportSummary summary;
+  if (!replay::exportColumns(
+          std::filesystem::path(*input), output, options, summary, error)) {
+    std::error_code removeError;
+    std::filesystem::remove(output, removeError);
+    std::cerr << error << '\n';
+    return 1;
+  }
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::cout << "Exported " << summary.rows << " frames x " << summary.columns
+            << " columns in " << summary.chunks << " chunks to "
+            << output.string() << " (" << elapsed.count() << " s)\n";
+  return 0;
+}
+
+int exportWire(const std::vector<std::wstring>& arguments) {
+  const auto input = optionValue(arguments, L"--input");
+  if (!input.has_value()) {
+    std::cerr << "wire requires --input <capture.irdt>\n";
+    return 2;
+  }
+
+  std::string error;
+  std::vector<std::string> names;
+  const auto varsOption = optionValue(arguments, L"--vars");
+  if (varsOption.has_value() &&
+      !replay::parseVariableList(*varsOption, names, error)) {
+    std::cerr << error << '\n';
+    return 2;
+  }
+
+  std::filesystem::path output(*input);
+  output.replace_extension(L".irdw");
+  const auto outputOption = optionValue(arguments, L"--output");
+  if (outputOption.has_value()) {
+    output = std::filesystem::path(*outputOption);
+  }
+
+  std::uint64_t messages = 0;
+  std::uint64_t bytes = 0;
+  if (!replay::exportTelemetryWire(
+          std::filesystem::path(*input), output, names, messages, bytes,
+          error)) {
+    std::error_code removeError;
+    std::filesystem::remove(output, removeError);
+    std::cerr << error << '\n';
+    return 1;
+  }
+  std::cout << "Encoded " << messages << " frames as " << bytes
+            << " wire bytes to " << output.string() << '\n';
+  return 0;
+}
+
+bool parseTolerance(
+    const std::optional<std::wstring>& input,
+    double& tolerance) {
+  if (!input.has_value()) {
+    return true;
+  }
+  errno = 0;
+  wchar_t* end = nullptr;
+  tolerance = std::wcstod(input->c_str(), &end);
+  return errno == 0 && end != input->c_str() && end != nullptr &&
+      *end == L'\0' && std::isfinite(tolerance) && tolerance >= 0;
+}
+
+int diffTapeFiles(const std::vector<std::wstring>& arguments) {
+  const auto inputs = positionalPaths(arguments);
+  if (inputs.size() != 2) {
+    std::cerr << "diff requires two tapes\n";
+    return 2;
+  }
+
+  std::string error;
+  replay::DiffOptions options;
+  const auto align = optionValue(arguments, L"--align");
+  if (align.has_value() && *align == L"time") {
+    options.alignment = replay::DiffAlignment::ElapsedTime;
+  } else if (align.has_value() && *align != L"tick") {
+    std::cerr << "--align must be tick or time\n";
+    return 2;
+  }
+  if (!parseTolerance(
+          optionValue(arguments, L"--float-tolerance"),
+          options.floatTolerance) ||
+      !parseTolerance(
+          optionValue(arguments, L"--double-tolerance"),
+          options.doubleTolerance)) {
+    std::cerr << "Tolerances must be non-negative numbers\n";
+    return 2;
+  }
+  if (!parseJobCount(optionValue(arguments, L"--jobs"), options.jobs, error)) {
+    std::cerr << error << '\n';
+    return 2;
+  }
+
+  replay::TapeDiff diff;
+  if (!replay::diffTapes(inputs[0], inputs[1], options, diff, error)) {
+    std::cerr << error << '\n';
+    return 2;
+  }
+
+  std::cout << "Frames: " << diff.framesA << " vs " << diff.framesB
+            << " (" << diff.matchedFrames << " aligned, " << diff.onlyInA
+            << " only in first, " << diff.onlyInB << " only in second)\n";
+  for (const auto& difference : diff.schema) {
+    std::cout << "Schema: " << difference.name << ": "
+              << difference.description << '\n';
+  }
+  if (diff.divergentFrames > 0) {
+    std::cout << "Divergent frames: " << diff.divergentFrames << '\n'
+              << "First divergence: tick " << diff.firstTickA << " / "
+              << diff.firstTickB << " at " << diff.firstSecondsA << " s / "
+              << diff.firstSecondsB << " s, " << diff.firstVariable << " "
+              << diff.firstValueA << " vs " << diff.firstValueB << '\n';
+    for (const auto& variable : diff.variables) {
+      if (variable.frames > 0) {
+        std::cout << "  " << variable.name << ": " << variable.frames
+                  << " frames\n";
+      }
+    }
+  }
+  if (diff.identical()) {
+    std::cout << "Tapes match\n";
+    return 0;
+  }
+  return 1;
+}
+
+int indexTapes(const std::vector<std::wstring>& arguments) {
+  const auto inputs = positionalPaths(arguments);
+  if (inputs.empty()) {
+    std::cerr << "index requires at least one tape\n";
+    return 2;
+  }
+
+  std::size_t failures = 0;
+  for (const auto& input : inputs) {
+    std::uint64_t events = 0;
+    std::string error;
+    if (replay::indexTapeEvents(input, events, error)) {
+      std::cout << input.string() << ": " << events << " events\n";
+    } else {
+      std::cerr << input.string() << ": " << error << '\n';
+      ++failures;
+    }
+  }
+  return failures == 0 ? 0 : 1;
+}
+
+int listEvents(const std::vector<std::wstring>& arguments) {
+  const auto inputs = positionalPaths(arguments);
+  if (inputs.size() != 1) {
+    std::cerr << "events requires one tape\n";
+    return 2;
+  }
+
+  std::string error;
+  replay::TapeReader tape;
+  std::vector<replay::TapeEvent> events;
+  if (!tape.open(inputs[0], error) || !tape.readEvents(events, error)) {
+    std::cerr << error << '\n';
+    return 1;
+  }
+  if (!tape.hasEventIndex()) {
+    std::cerr << "Telemetry tape has no event index; run index on it first\n";
+    return 1;
+  }
+
+  const auto frequency = static_cast<double>(tape.fileHeader().qpcFrequency);
+  for (const auto& event : events) {
+    const auto kind = static_cast<replay::TapeEventKind>(event.kind);
+    std::cout << static_cast<double>(event.elapsedTicks) / frequency << " s"
+              << "\ttick " << event.sourceTick << '\t'
+              << replay::tapeEventKindName(kind) << ' ';
+    if (kind == replay::TapeEventKind::Flags) {
+      std::cout << "0x" << std::hex << static_cast<std::uint32_t>(event.value)
+                << std::dec;
+    } else {
+      std::cout << event.value;
+    }
+    std::cout << "\t@" << event.recordOffset << '\n';
+  }
+  return 0;
+}
+
+// Compacts each tape into a temporary file beside its destination, so an
+// in-place pass only replaces the original once the rewrite is complete.
+int compactTapes(const std::vector<std::wstring>& arguments) {
+  const auto inputs = positionalPaths(arguments);
+  if (inputs.empty()) {
+    std::cerr << "compact requires at least one tape\n";
+    return 2;
+  }
+  const auto outputDirectory = optionValue(arguments, L"--output-dir");
+
+  std::size_t failures = 0;
+  for (const auto& input : inputs) {
+    auto output = input;
+    if (outputDirectory.has_value()) {
+      output = std::filesystem::path(*outputDirectory) / input.filename();
+    }
+    auto temporary = output;
+    temporary += L".tmp";
+
+    std::uint64_t frames = 0;
+    std::uint64_t repeated = 0;
+    std::string error;
+    std::error_code fileError;
+    bool compacted =
+        replay::compactTape(input, temporary, frames, repeated, error);
+    if (compacted) {
+      std::filesystem::rename(temporary, output, fileError);
+      if (fileError) {
+        error = "Could not replace " + output.string() + ": " +
+            fileError.message();
+        compacted = false;
+      }
+    }
+    if (!compacted) {
+      std::filesystem::remove(temporary, fileError);
+      std::cerr << input.string() << ": " << error << '\n';
+      ++failures;
+      continue;
+    }
+    std::cout << output.string() << ": " << frames << " frames, " << repeated
+              << " stored as repeats\n";
+  }
+  return failures == 0 ? 0 : 1;
+}
+
+void printUsage() {
+  std::cout
+      << "irDashies telemetry tape tool\n\n"
+      << "Commands:\n"
+      << "  convert [--jobs <n>] [--output-dir <dir>] "
+         "<file.ibt|file.irdt>...\n"
+      << "  export  --input <capture.irdt> [--output <columns.irdc>] "
+         "[--vars <name,name,...|@names.txt>] [--jobs <n>] "
+         "[--chunk-rows <n>]\n"
+      << "  wire    --input <capture.irdt> [--output <messages.irdw>] "
+         "[--vars <name,name,...|@names.txt>]\n"
+      << "  diff    <first.irdt> <second.irdt> [--align tick|time] "
+         "[--float-tolerance <x>] [--double-tolerance <x>] [--jobs <n>]\n"
+      << "  index   <capture.irdt>...\n"
+      << "  events  <capture.irdt>\n"
+      << "  compact [--output-dir <dir>] <capture.irdt>...\n\n"
+      << "convert turns each .ibt into an .irdt and each .irdt into an .ibt,\n"
+      << "writing next to the input unless --output-dir is given.\n"
+      << "diff exits with 0 when the tapes match and 1 when they differ.\n"
+      << "index adds a lap, session, flag, and pit event index to tapes\n"
+      << "recorded without one; events lists it.\n"
+      << "wire encodes each frame as a telemetry inspector IPC message,\n"
+      << "each written after its u32 little-endian length.\n"
+      << "compact folds runs of identical frames into repeat records,\n"
+      << "rewriting each tape in place unless --output-dir is given.\n";
+}
+
+int runCommand(const std::vector<std::wstring>& arguments) {
+  if (arguments.size() < 2 || arguments[1] == L"--help" ||
+      arguments[1] == L"-h") {
+    printUsage();
+    return arguments.size() < 2 ? 2 : 0;
+  }
+
+  if (arguments[1] == L"convert") {
+    return convertFiles(arguments);
+  }
+  if (arguments[1] == L"export") {
+    return exportTape(arguments);
+  }
+  if (arguments[1] == L"wire") {
+    return exportWire(arguments);
+  }
+  if (arguments[1] == L"diff") {
+    return diffTapeFiles(arguments);
+  }
+  if (arguments[1] == L"index") {
+    return indexTapes(arguments);
+  }
+  if (arguments[1] == L"events") {
+    return listEvents(arguments);
+  }
+  if (arguments[1] == L"compact") {
+    return compactTapes(arguments);
+  }
+
+  printUsage();
+  return 2;
+}
+
+#if !defined(_WIN32)
+std::wstring widenArgument(const char* argument) {
+  const auto length = std::mbstowcs(nullptr, argument, 0);
+  if (length == static_cast<std::size_t>(-1)) {
+    return std::wstring(argument, argument + std::strlen(argument));
+  }
+  std::wstring widened(length, L'\0');
+  std::mbstowcs(widened.data(), argument, length);
+  return widened;
+}
+#endif
+
+}  // namespace
+
+#if defined(_WIN32)
+int wmain(int argc, wchar_t* argv[]) {
+  std::vector<std::wstring> arguments;
+  arguments.reserve(static_cast<std::size_t>(argc));
+  for (int i = 0; i < argc; ++i) {
+    arguments.emplace_back(argv[i]);
+  }
+  return runCommand(arguments);
+}
+#else
+int main(int argc, char* argv[]) {
+  std::setlocale(LC_ALL, "");
+
+  std::vector<std::wstring> arguments;
+  arguments.reserve(static_cast<std::size_t>(argc));
+  for (int i = 0; i < argc; ++i) {
+    arguments.push_back(widenArgument(argv[i]));
+  }
+  return runCommand(arguments);
+}
+#endif
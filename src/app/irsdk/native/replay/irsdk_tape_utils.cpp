@@ -1,4 +1,6 @@
 #include "./irsdk_tape.h"
+#include "./irsdk_tape_events.h"
+#include "./irsdk_tape_playback.h"
 
 #include <algorithm>
 #include <chrono>
@@ -16,6 +18,8 @@ namespace replay = irdashies::irsdk_replay;
 
 namespace {
 
+constexpr std::size_t kNoRecord = std::numeric_limits<std::size_t>::max();
+
 enum class PlaybackState {
   Stopped,
   Playing,
@@ -31,12 +35,36 @@ std::vector<char> frame;
 std::vector<char> session;
 replay::TapeRecordHeader pendingRecord{};
 std::vector<char> pendingPayload;
+std::size_t pendingRecordIndex = kNoRecord;
 bool hasPendingRecord = false;
 PlaybackState state = PlaybackState::Stopped;
 std::chrono::steady_clock::time_point playbackStart;
 double playbackSpeed = 1.0;
 bool loopPlayback = false;
 
+// Scrubbing state. The frame and session lists hold record indices into the
+// tape index and are built on the first seek.
+std::vector<std::size_t> frameRecords;
+std::vector<std::size_t> sessionRecords;
+std::size_t publishedRecord = kNoRecord;
+std::uint64_t publishedElapsedTicks = 0;
+std::size_t appliedSessionRecord = kNoRecord;
+bool seekFramePending = false;
+// Set when irsdk_waitForNewTick() published a frame that irsdk_getNewData()
+// has not copied out yet.
+bool frameWaiting = false;
+bool paused = false;
+
+// Contents of the tape's EventIndex record, read on the first event query.
+std::vector<replay::TapeEvent> events;
+bool eventsLoaded = false;
+
+// Publish timing, reported by playbackStats() and on shutdown.
+replay::LatencyHistogram publishLateness;
+replay::LatencyHistogram frameInterval;
+std::chrono::steady_clock::time_point lastFramePublish;
+bool hasLastFramePublish = false;
+
 bool parsePlaybackOptions(std::string& error) {
   const char* speedText = std::getenv("IRDASHIES_TELEMETRY_REPLAY_SPEED");
   if (speedText != nullptr && speedText[0] != '\0') {
@@ -69,6 +97,12 @@ void resetPublishedData() {
   session.assign(1, '\0');
   hasPendingRecord = false;
   pendingPayload.clear();
+  pendingRecordIndex = kNoRecord;
+  publishedRecord = kNoRecord;
+  publishedElapsedTicks = 0;
+  appliedSessionRecord = kNoRecord;
+  seekFramePending = false;
+  hasLastFramePublish = false;
   playbackStart = std::chrono::steady_clock::now();
   state = PlaybackState::Playing;
 }
@@ -83,11 +117,23 @@ bool openTape(std::string& error) {
     return false;
   }
 
+  // A pipe or FIFO plays front to back once; seeking, stepping back, and
+  // events need the record index, which only a file can provide.
+  const std::filesystem::path path(input);
+  const bool stream = replay::isTapeStreamPath(path);
+  if (stream && loopPlayback) {
+    error = "IRDASHIES_TELEMETRY_REPLAY_LOOP needs a seekable tape, not a stream";
+    return false;
+  }
   auto candidate = std::make_unique<replay::TapeReader>();
-  if (!candidate->open(std::filesystem::path(input), error)) {
+  if (stream ? !candidate->openStream(
+                   path, replay::kDefaultReadAheadBytes, error)
+             : !candidate->open(path, error)) {
     return false;
   }
   tape = std::move(candidate);
+  publishLateness.reset();
+  frameInterval.reset();
   resetPublishedData();
   return true;
 }
@@ -117,6 +163,7 @@ bool loadPendingRecord(bool frameWillBePublished, std::string& error) {
   }
   const auto result = tape->readNext(pendingRecord, pendingPayload, error);
   if (result == replay::TapeReadResult::Record) {
+    pendingRecordIndex = tape->nextRecordIndex() - 1;
     hasPendingRecord = true;
     return true;
   }
@@ -129,14 +176,58 @@ bool loadPendingRecord(bool frameWillBePublished, std::string& error) {
   return false;
 }
 
-std::chrono::steady_clock::time_point pendingTargetTime() {
+std::chrono::steady_clock::duration playbackOffset(
+    std::uint64_t elapsedTicks) {
   const double seconds =
-      static_cast<double>(pendingRecord.elapsedTicks) /
+      static_cast<double>(elapsedTicks) /
       static_cast<double>(tape->fileHeader().qpcFrequency) /
       playbackSpeed;
-  return playbackStart +
-      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
-          std::chrono::duration<double>(seconds));
+  return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(seconds));
+}
+
+std::chrono::steady_clock::time_point pendingTargetTime() {
+  return playbackStart + playbackOffset(pendingRecord.elapsedTicks);
+}
+
+// Re-anchors the playback clock so the published frame is "now".
+void rebasePlaybackClock() {
+  playbackStart =
+      std::chrono::steady_clock::now() - playbackOffset(publishedElapsedTicks);
+  hasLastFramePublish = false;
+}
+
+std::uint64_t elapsedNanoseconds(std::chrono::steady_clock::duration elapsed) {
+  const auto nanoseconds =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  return nanoseconds < 0 ? 0 : static_cast<std::uint64_t>(nanoseconds);
+}
+
+void recordFrameTiming(std::chrono::steady_clock::time_point target) {
+  const auto now = std::chrono::steady_clock::now();
+  publishLateness.record(elapsedNanoseconds(now - target));
+  if (hasLastFramePublish) {
+    frameInterval.record(elapsedNanoseconds(now - lastFramePublish));
+  }
+  lastFramePublish = now;
+  hasLastFramePublish = true;
+}
+
+void printSummary(const char* label, const replay::LatencySummary& summary) {
+  std::cerr << "  " << label << " ms: p50 " << summary.p50Ns / 1e6
+            << ", p99 " << summary.p99Ns / 1e6
+            << ", p99.9 " << summary.p999Ns / 1e6
+            << ", max " << summary.maxNs / 1e6 << '\n';
+}
+
+void printPlaybackStats() {
+  if (publishLateness.count() == 0) {
+    return;
+  }
+  std::cerr << "Telemetry tape playback timing over "
+            << publishLateness.count() << " frames\n";
+  printSummary("lateness", publishLateness.summary());
+  printSummary("frame interval", frameInterval.summary());
 }
 
 void applySessionRecord() {
@@ -147,6 +238,7 @@ void applySessionRecord() {
   session.back() = '\0';
   header.sessionInfoLen = static_cast<int>(pendingPayload.size());
   header.sessionInfoUpdate = pendingRecord.value;
+  appliedSessionRecord = pendingRecordIndex;
 }
 
 bool publishFrameRecord(char* destination, std::string& error) {
@@ -160,6 +252,140 @@ bool publishFrameRecord(char* destination, std::string& error) {
   if (destination != nullptr) {
     std::memcpy(destination, frame.data(), frame.size());
   }
+  publishedRecord = pendingRecordIndex;
+  publishedElapsedTicks = pendingRecord.elapsedTicks;
+  return true;
+}
+
+bool ensurePlaybackIndex(std::string& error) {
+  if (tape == nullptr || state == PlaybackState::Stopped ||
+      state == PlaybackState::Failed) {
+    error = "Telemetry tape playback is not running";
+    return false;
+  }
+  if (!frameRecords.empty()) {
+    return true;
+  }
+  if (!tape->buildIndex(error)) {
+    return false;
+  }
+
+  const auto& entries = tape->index();
+  for (std::size_t index = 0; index < entries.size(); ++index) {
+    if (entries[index].kind == replay::RecordKind::Frame) {
+      frameRecords.push_back(index);
+    } else if (entries[index].kind == replay::RecordKind::SessionInfo) {
+      sessionRecords.push_back(index);
+    }
+  }
+  if (frameRecords.empty()) {
+    sessionRecords.clear();
+    error = "Telemetry tape does not contain any frames";
+    return false;
+  }
+  return true;
+}
+
+bool readIndexedRecord(std::size_t recordIndex, std::string& error) {
+  if (!tape->seekRecord(recordIndex, error)) {
+    return false;
+  }
+  if (tape->readNext(pendingRecord, pendingPayload, error) !=
+      replay::TapeReadResult::Record) {
+    if (error.empty()) {
+      error = "Indexed telemetry tape record is missing";
+    }
+    return false;
+  }
+  pendingRecordIndex = recordIndex;
+  return true;
+}
+
+// Publishes frameRecords[position] with the session revision that was valid
+// when it was recorded. The reader is left positioned after the frame, so
+// normal playback resumes from there.
+bool publishIndexedFrame(std::size_t position, std::string& error) {
+  const auto recordIndex = frameRecords[position];
+  hasPendingRecord = false;
+
+  const auto nextSession = std::lower_bound(
+      sessionRecords.begin(), sessionRecords.end(), recordIndex);
+  if (nextSession == sessionRecords.begin()) {
+    session.assign(1, '\0');
+    header.sessionInfoLen = 0;
+    header.sessionInfoUpdate = -1;
+    appliedSessionRecord = kNoRecord;
+  } else if (*(nextSession - 1) != appliedSessionRecord) {
+    if (!readIndexedRecord(*(nextSession - 1), error)) {
+      return false;
+    }
+    applySessionRecord();
+  }
+
+  if (!readIndexedRecord(recordIndex, error) ||
+      pendingRecord.kind != static_cast<std::uint32_t>(replay::RecordKind::Frame) ||
+      !publishFrameRecord(nullptr, error)) {
+    if (error.empty()) {
+      error = "Indexed telemetry tape record is not a frame";
+    }
+    return false;
+  }
+
+  header.status = irsdk_stConnected;
+  state = PlaybackState::Playing;
+  seekFramePending = true;
+  frameWaiting = false;
+  rebasePlaybackClock();
+  return true;
+}
+
+std::size_t publishedFramePosition() {
+  if (publishedRecord == kNoRecord) {
+    return 0;
+  }
+  const auto position = std::lower_bound(
+      frameRecords.begin(), frameRecords.end(), publishedRecord);
+  return static_cast<std::size_t>(position - frameRecords.begin());
+}
+
+bool ensurePlaybackEvents(std::string& error) {
+  if (!ensurePlaybackIndex(error)) {
+    return false;
+  }
+  if (!eventsLoaded) {
+    if (!tape->readEvents(events, error)) {
+      return false;
+    }
+    eventsLoaded = true;
+  }
+  if (events.empty()) {
+    error =
+        "Telemetry tape has no event index; run irsdk_tape_tool index on it";
+    return false;
+  }
+  return true;
+}
+
+// Position in frameRecords of the Frame record starting at a file offset.
+bool framePositionAt(std::uint64_t offset, std::size_t& position) {
+  const auto& entries = tape->index();
+  const auto record = std::lower_bound(
+      entries.begin(),
+      entries.end(),
+      offset,
+      [](const replay::TapeIndexEntry& entry, std::uint64_t value) {
+        return entry.offset < value;
+      });
+  if (record == entries.end() || record->offset != offset) {
+    return false;
+  }
+  const auto recordIndex = static_cast<std::size_t>(record - entries.begin());
+  const auto frame = std::lower_bound(
+      frameRecords.begin(), frameRecords.end(), recordIndex);
+  if (frame == frameRecords.end() || *frame != recordIndex) {
+    return false;
+  }
+  position = static_cast<std::size_t>(frame - frameRecords.begin());
   return true;
 }
 
@@ -169,6 +395,18 @@ bool readTimedFrame(int timeoutMs, char* destination) {
   const auto deadline = std::chrono::steady_clock::now() +
       std::chrono::milliseconds(std::max(timeoutMs, 0));
 
+  if (state == PlaybackState::Playing && seekFramePending) {
+    seekFramePending = false;
+    if (destination != nullptr) {
+      std::memcpy(destination, frame.data(), frame.size());
+    }
+    return true;
+  }
+  if (state == PlaybackState::Playing && paused) {
+    std::this_thread::sleep_until(deadline);
+    return false;
+  }
+
   while (state == PlaybackState::Playing) {
     if (!loadPendingRecord(foundFrame, error)) {
       if (!error.empty()) {
@@ -194,6 +432,7 @@ bool readTimedFrame(int timeoutMs, char* destination) {
           std::cerr << "Telemetry tape playback failed: " << error << '\n';
           return false;
         }
+        recordFrameTiming(target);
         foundFrame = true;
         break;
 
@@ -201,6 +440,11 @@ bool readTimedFrame(int timeoutMs, char* destination) {
         applySessionRecord();
         break;
 
+      case replay::RecordKind::EventIndex:
+      // TapeReader expands Repeat records into frames.
+      case replay::RecordKind::Repeat:
+        break;
+
       case replay::RecordKind::Gap:
         std::cerr << "Telemetry tape capture gap: " << pendingRecord.value
                   << " source ticks\n";
@@ -219,6 +463,102 @@ bool readTimedFrame(int timeoutMs, char* destination) {
 
 }  // namespace
 
+namespace irdashies::irsdk_replay {
+
+bool setPlaybackPaused(bool pause, std::string& error) {
+  if (tape == nullptr || state == PlaybackState::Failed) {
+    error = "Telemetry tape playback is not running";
+    return false;
+  }
+  if (paused && !pause) {
+    rebasePlaybackClock();
+  }
+  paused = pause;
+  return true;
+}
+
+bool stepPlayback(int frames, std::string& error) {
+  if (!ensurePlaybackIndex(error)) {
+    return false;
+  }
+  const auto last = static_cast<std::int64_t>(frameRecords.size()) - 1;
+  const auto target = std::clamp<std::int64_t>(
+      static_cast<std::int64_t>(publishedFramePosition()) + frames, 0, last);
+  return publishIndexedFrame(static_cast<std::size_t>(target), error);
+}
+
+bool seekPlayback(double seconds, std::string& error) {
+  if (!std::isfinite(seconds)) {
+    error = "Seek offset must be a finite number of seconds";
+    return false;
+  }
+  if (!ensurePlaybackIndex(error)) {
+    return false;
+  }
+
+  const double target = std::max(
+      0.0,
+      static_cast<double>(publishedElapsedTicks) +
+          seconds * static_cast<double>(tape->fileHeader().qpcFrequency));
+  const auto& entries = tape->index();
+  const auto after = std::upper_bound(
+      frameRecords.begin(),
+      frameRecords.end(),
+      target,
+      [&entries](double elapsed, std::size_t recordIndex) {
+        return elapsed < static_cast<double>(entries[recordIndex].elapsedTicks);
+      });
+  const auto position = after == frameRecords.begin()
+      ? 0
+      : static_cast<std::size_t>(after - frameRecords.begin()) - 1;
+  return publishIndexedFrame(position, error);
+}
+
+bool playbackEvents(std::vector<PlaybackEvent>& list, std::string& error) {
+  list.clear();
+  if (!ensurePlaybackEvents(error)) {
+    return false;
+  }
+  const auto frequency =
+      static_cast<double>(tape->fileHeader().qpcFrequency);
+  list.reserve(events.size());
+  for (const auto& event : events) {
+    list.push_back(
+        {static_cast<TapeEventKind>(event.kind),
+         event.value,
+         static_cast<double>(event.elapsedTicks) / frequency,
+         event.sourceTick});
+  }
+  return true;
+}
+
+bool seekPlaybackEvent(
+    TapeEventKind kind,
+    std::int32_t value,
+    std::string& error) {
+  if (!ensurePlaybackEvents(error)) {
+    return false;
+  }
+  const auto match = findTapeEvent(events, kind, value);
+  if (match == events.size()) {
+    error = std::string("No ") + tapeEventKindName(kind) +
+        " event matches " + std::to_string(value);
+    return false;
+  }
+  std::size_t position = 0;
+  if (!framePositionAt(events[match].recordOffset, position)) {
+    error = "Telemetry tape event does not point at a frame";
+    return false;
+  }
+  return publishIndexedFrame(position, error);
+}
+
+PlaybackStats playbackStats() {
+  return {publishLateness.summary(), frameInterval.summary()};
+}
+
+}  // namespace irdashies::irsdk_replay
+
 bool irsdk_startup() {
   if (state == PlaybackState::Playing) {
     return true;
@@ -249,16 +589,33 @@ bool irsdk_startup() {
 }
 
 void irsdk_shutdown() {
+  if (tape != nullptr) {
+    printPlaybackStats();
+  }
   tape.reset();
   frame.clear();
   session.clear();
   pendingPayload.clear();
   hasPendingRecord = false;
+  frameRecords.clear();
+  sessionRecords.clear();
+  events.clear();
+  eventsLoaded = false;
+  seekFramePending = false;
+  frameWaiting = false;
+  paused = false;
   header = {};
   state = PlaybackState::Stopped;
 }
 
 bool irsdk_getNewData(char* data) {
+  if (frameWaiting) {
+    frameWaiting = false;
+    if (data != nullptr) {
+      std::memcpy(data, frame.data(), frame.size());
+    }
+    return true;
+  }
   return readTimedFrame(1, data);
 }
 
@@ -266,14 +623,32 @@ bool irsdk_waitForDataReady(int timeoutMs, char* data) {
   if (state != PlaybackState::Playing && !irsdk_startup()) {
     return false;
   }
+  if (frameWaiting) {
+    return irsdk_getNewData(data);
+  }
   return readTimedFrame(timeoutMs, data);
 }
 
+irsdk_waitResult irsdk_waitForNewTick(int timeoutMs) {
+  if (state != PlaybackState::Playing && !irsdk_startup()) {
+    return irsdk_waitDisconnected;
+  }
+  if (frameWaiting || readTimedFrame(timeoutMs, nullptr)) {
+    frameWaiting = true;
+    return irsdk_waitNewData;
+  }
+  return irsdk_isConnected() ? irsdk_waitTimeout : irsdk_waitDisconnected;
+}
+
 bool irsdk_isConnected() {
   return state == PlaybackState::Playing &&
       (header.status & irsdk_stConnected) != 0;
 }
 
+irsdk_connectionState irsdk_getConnectionState() {
+  return irsdk_isConnected() ? irsdk_connConnected : irsdk_connDisconnected;
+}
+
 const irsdk_header* irsdk_getHeader() {
   return tape == nullptr ? nullptr : &header;
 }
@@ -0,0 +1,155 @@
+#include "./irsdk_telemetry_wire.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "../lib/irsdk_defines.h"
+
+namespace irdashies::irsdk_replay {
+namespace {
+
+void appendVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+  while (value >= 0x80U) {
+    out.push_back(static_cast<std::uint8_t>(value | 0x80U));
+    value >>= 7U;
+  }
+  out.push_back(static_cast<std::uint8_t>(value));
+}
+
+template <typename T>
+T loadBits(const char* bytes) {
+  T value;
+  std::memcpy(&value, bytes, sizeof(value));
+  return value;
+}
+
+// Keyframe values are relative to zero, so a float's or double's XOR is its
+// own bits. A varint of those would nearly always take more bytes than the
+// value, so they are sent as they are.
+void appendValue(
+    std::vector<std::uint8_t>& out,
+    int type,
+    const char* value,
+    const char* previous,
+    bool keyframe) {
+  switch (type) {
+    case irsdk_int: {
+      const auto difference = static_cast<std::int32_t>(
+          loadBits<std::uint32_t>(value) - loadBits<std::uint32_t>(previous));
+      appendVarint(
+          out,
+          (static_cast<std::uint32_t>(difference) << 1U) ^
+              static_cast<std::uint32_t>(difference >> 31));
+      break;
+    }
+    case irsdk_bitField:
+    case irsdk_float:
+      if (keyframe) {
+        out.insert(out.end(), value, value + sizeof(std::uint32_t));
+        break;
+      }
+      appendVarint(
+          out,
+          loadBits<std::uint32_t>(value) ^ loadBits<std::uint32_t>(previous));
+      break;
+    case irsdk_double:
+      if (keyframe) {
+        out.insert(out.end(), value, value + sizeof(std::uint64_t));
+        break;
+      }
+      appendVarint(
+          out,
+          loadBits<std::uint64_t>(value) ^ loadBits<std::uint64_t>(previous));
+      break;
+    default:
+      out.push_back(static_cast<std::uint8_t>(*value));
+      break;
+  }
+}
+
+}  // namespace
+
+void TelemetryWireEncoder::setChannels(
+    std::uint32_t version,
+    std::vector<TelemetryWireChannel> channels) {
+  std::size_t bytes = 0;
+  for (const auto& channel : channels) {
+    bytes += static_cast<std::size_t>(channel.count) *
+        irsdk_VarTypeBytes[channel.type];
+  }
+  channels_ = std::move(channels);
+  previous_.assign(bytes, 0);
+  version_ = version;
+  keyframeDue_ = true;
+}
+
+std::uint32_t TelemetryWireEncoder::version() const {
+  return version_;
+}
+
+void TelemetryWireEncoder::encode(
+    const char* frame,
+    bool keyframe,
+    std::vector<std::uint8_t>& out) {
+  keyframe = keyframe || keyframeDue_ ||
+      sinceKeyframe_ >= kTelemetryWireKeyframeInterval;
+  if (keyframe) {
+    std::fill(previous_.begin(), previous_.end(), 0);
+    keyframeDue_ = false;
+    sinceKeyframe_ = 0;
+  }
+  sinceKeyframe_++;
+
+  out.clear();
+  out.push_back(kTelemetryWireFormat);
+  out.push_back(keyframe ? kTelemetryWireKeyframe : 0);
+  appendVarint(out, version_);
+  appendVarint(out, ++sequence_);
+  if (keyframe) {
+    appendVarint(out, channels_.size());
+    for (const auto& channel : channels_) {
+      appendVarint(out, channel.name.size());
+      out.insert(out.end(), channel.name.begin(), channel.name.end());
+      out.push_back(static_cast<std::uint8_t>(channel.type));
+      appendVarint(out, static_cast<std::uint64_t>(channel.count));
+    }
+  }
+
+  const std::size_t channelBitmap = out.size();
+  out.resize(channelBitmap + (channels_.size() + 7) / 8, 0);
+  values_.clear();
+  char* previous = previous_.data();
+  for (std::size_t i = 0; i < channels_.size(); i++) {
+    const auto& channel = channels_[i];
+    const int size = irsdk_VarTypeBytes[channel.type];
+    const std::size_t bytes = static_cast<std::size_t>(channel.count) * size;
+    const char* current = frame + channel.source;
+    if (std::memcmp(current, previous, bytes) == 0) {
+      previous += bytes;
+      continue;
+    }
+
+    out[channelBitmap + i / 8] |= static_cast<std::uint8_t>(1U << (i % 8));
+    std::size_t entryBitmap = 0;
+    if (channel.count > 1) {
+      entryBitmap = out.size();
+      out.resize(entryBitmap + (channel.count + 7) / 8, 0);
+    }
+    for (int entry = 0; entry < channel.count; entry++) {
+      const char* value = current + entry * size;
+      char* last = previous + entry * size;
+      if (std::memcmp(value, last, size) == 0) continue;
+      if (channel.count > 1) {
+        out[entryBitmap + entry / 8] |=
+            static_cast<std::uint8_t>(1U << (entry % 8));
+      }
+      appendValue(values_, channel.type, value, last, keyframe);
+      std::memcpy(last, value, size);
+    }
+    previous += bytes;
+  }
+  out.insert(out.end(), values_.begin(), values_.end());
+}
+
+}  // namespace irdashies::irsdk_replay
@@ -0,0 +1,67 @@
+#ifndef IRDASHIES_IRSDK_TELEMETRY_WIRE_H
+#define IRDASHIES_IRSDK_TELEMETRY_WIRE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace irdashies::irsdk_replay {
+
+// Message layout, decoded by src/shared/telemetryWire.ts. Varints are
+// unsigned LEB128 and bitmaps hold one bit per entry, lowest bit first.
+//
+//   u8      format (kTelemetryWireFormat)
+//   u8      flags; bit 0 marks a keyframe
+//   varint  channel set version
+//   varint  message sequence, one more than the message before
+//   keyframes only: varint channel count, then per channel a varint name
+//           length, the name, a u8 irsdk_VarType and a varint entry count
+//   bitmap  channels with a changed entry
+//   bitmap  per changed channel with more than one entry: changed entries
+//   values  per changed entry, in channel order:
+//           char, bool  the byte
+//           int         zigzag varint of the difference from the last value
+//           bitField, float, double
+//                       varint of the bits XOR the last value's bits, or
+//                       in a keyframe the value's own little-endian bytes
+//
+// Values are relative to the previous message, or to zero in a keyframe,
+// so a decoder that misses a message waits for the next keyframe.
+constexpr std::uint8_t kTelemetryWireFormat = 2;
+constexpr std::uint8_t kTelemetryWireKeyframe = 1;
+// At the inspector's 10 Hz, a reader that joins late waits at most 2 s.
+constexpr std::uint32_t kTelemetryWireKeyframeInterval = 20;
+
+struct TelemetryWireChannel {
+  std::string name;
+  int type = 0;
+  int count = 0;
+  // Offset of the values in each frame.
+  int source = 0;
+};
+
+class TelemetryWireEncoder {
+ public:
+  // Replaces the channels. The next message is a keyframe carrying them.
+  void setChannels(
+      std::uint32_t version,
+      std::vector<TelemetryWireChannel> channels);
+  std::uint32_t version() const;
+
+  // Replaces out with the message for frame.
+  void encode(const char* frame, bool keyframe, std::vector<std::uint8_t>& out);
+
+ private:
+  std::vector<TelemetryWireChannel> channels_;
+  // Each channel's values as last sent, packed in channel order.
+  std::vector<char> previous_;
+  std::vector<std::uint8_t> values_;
+  std::uint32_t version_ = 0;
+  std::uint64_t sequence_ = 0;
+  std::uint32_t sinceKeyframe_ = 0;
+  bool keyframeDue_ = true;
+};
+
+}  // namespace irdashies::irsdk_replay
+
+#endif
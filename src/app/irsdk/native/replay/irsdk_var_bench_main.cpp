@@ -0,0 +1,276 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../lib/irsdk_defines.h"
+#include "../lib/irsdk_client.h"
+
+// Times one variable read through irsdkCVar against the same read through
+// irsdkVar. Frames come from a tape through the tape-backed irsdk functions,
+// so no sim or shared memory is involved and only the read path is measured.
+// With --threads it instead plays the tape to several consumer threads at
+// once and checks what each of them received.
+namespace {
+
+constexpr std::uint64_t kDefaultReads = 10000000;
+constexpr int kMaxThreads = 64;
+// Consecutive empty waits before a consumer gives up on a stalled tape.
+constexpr int kMaxIdleWaits = 5;
+// Live sessions and the synthetic fixture publish every car slot.
+constexpr int kArrayEntries = IRSDK_MAX_CARS;
+
+const char* optionValue(int argc, char* argv[], const char* name) {
+  for (int i = 1; i + 1 < argc; ++i) {
+    if (std::strcmp(argv[i], name) == 0) {
+      return argv[i + 1];
+    }
+  }
+  return nullptr;
+}
+
+bool setTapeInput(const char* path) {
+#if defined(_WIN32)
+  return _putenv_s("IRDASHIES_TELEMETRY_REPLAY", path) == 0;
+#else
+  return setenv("IRDASHIES_TELEMETRY_REPLAY", path, 1) == 0;
+#endif
+}
+
+template <typename Read>
+double nanosecondsPerRead(std::uint64_t reads, double& sink, Read read) {
+  const auto start = std::chrono::steady_clock::now();
+  double sum = 0;
+  for (std::uint64_t i = 0; i < reads; ++i) {
+    sum += read();
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  sink = sum;
+  return std::chrono::duration<double, std::nano>(elapsed).count() /
+      static_cast<double>(reads);
+}
+
+void printResult(
+    const std::string& name,
+    double cvarNanoseconds,
+    double varNanoseconds) {
+  std::cout << std::left << std::setw(28) << name << std::right << std::fixed
+            << std::setprecision(2) << "irsdkCVar " << std::setw(7)
+            << cvarNanoseconds << " ns/read  irsdkVar " << std::setw(7)
+            << varNanoseconds << " ns/read  " << std::setprecision(1)
+            << cvarNanoseconds / varNanoseconds << "x\n";
+}
+
+// What one consumer thread received: the scalar at each tick, in order.
+struct ConsumerLog {
+  std::map<int, float> scalarByTick;
+  std::string error;
+};
+
+// Reads frames through this thread's irsdkClient until playback ends. The
+// handles are shared by every consumer, and each read comes from the
+// calling thread's own frame. irsdkSharedReader only hands out frames newer
+// than the one a client holds, so ticks must increase.
+void consumeFrames(
+    const std::atomic<bool>& started,
+    irsdkVar<int>& tickVar,
+    irsdkVar<float>& scalarVar,
+    ConsumerLog& log) {
+  while (!started.load()) {
+    std::this_thread::yield();
+  }
+  irsdkClient& client = irsdkClient::instance();
+  int lastTick = -1;
+  for (int idle = 0; idle < kMaxIdleWaits;) {
+    if (!client.waitForData(1000)) {
+      if (!log.scalarByTick.empty() && !client.isConnected()) {
+        return;
+      }
+      ++idle;
+      continue;
+    }
+    idle = 0;
+    if (!tickVar.isValid() || !scalarVar.isValid()) {
+      log.error = "needs an int SessionTick and a float scalar";
+      return;
+    }
+    const int tick = tickVar.get();
+    if (tick <= lastTick) {
+      log.error = "received tick " + std::to_string(tick) + " after " +
+          std::to_string(lastTick);
+      return;
+    }
+    lastTick = tick;
+    log.scalarByTick[tick] = scalarVar.get();
+  }
+  log.error = "playback stalled";
+}
+
+// Plays the tape to several consumers. Every published frame reaches the
+// thread that read it from the tape, so together the threads see every
+// frame, and threads that received the same tick must agree on its values.
+int runConsumers(const char* input, const char* scalarName, int threadCount) {
+  irsdkVar<int> tickVar("SessionTick");
+  irsdkVar<float> scalarVar(scalarName);
+  std::vector<ConsumerLog> logs(threadCount);
+  std::vector<std::thread> threads;
+  std::atomic<bool> started(false);
+  for (int i = 0; i < threadCount; ++i) {
+    threads.emplace_back(
+        consumeFrames,
+        std::cref(started),
+        std::ref(tickVar),
+        std::ref(scalarVar),
+        std::ref(logs[i]));
+  }
+  started = true;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  irsdkSharedReader::instance().shutdown();
+
+  std::map<int, float> scalarByTick;
+  std::size_t fewestFrames = SIZE_MAX;
+  for (int i = 0; i < threadCount; ++i) {
+    const ConsumerLog& log = logs[i];
+    const std::string error = log.error.empty() && log.scalarByTick.empty()
+        ? "received no frames"
+        : log.error;
+    if (!error.empty()) {
+      std::cerr << input << ": thread " << i + 1 << " " << error << '\n';
+      return 1;
+    }
+    fewestFrames = std::min(fewestFrames, log.scalarByTick.size());
+    for (const auto& [tick, value] : log.scalarByTick) {
+      const auto seen = scalarByTick.emplace(tick, value);
+      if (seen.first->second != value) {
+        std::cerr << input << ": threads read " << seen.first->second
+                  << " and " << value << " for " << scalarName << " at tick "
+                  << tick << '\n';
+        return 1;
+      }
+    }
+  }
+
+  std::cout << threadCount << " threads read " << scalarByTick.size()
+            << " frames, ticks " << scalarByTick.begin()->first << " to "
+            << scalarByTick.rbegin()->first << ", at least " << fewestFrames
+            << " per thread\n";
+  return 0;
+}
+
+int runBenchmark(int argc, char* argv[]) {
+  const char* input = optionValue(argc, argv, "--input");
+  if (input == nullptr) {
+    std::cerr << "usage: irsdk_var_bench --input <capture.irdt> "
+                 "[--reads <n>] [--scalar <float>] [--array <float array>] "
+                 "[--threads <n>]\n";
+    return 2;
+  }
+  std::uint64_t reads = kDefaultReads;
+  if (const char* text = optionValue(argc, argv, "--reads")) {
+    reads = std::strtoull(text, nullptr, 10);
+    if (reads == 0) {
+      std::cerr << "--reads must be a positive number\n";
+      return 2;
+    }
+  }
+  const char* scalarName = optionValue(argc, argv, "--scalar");
+  const char* arrayName = optionValue(argc, argv, "--array");
+  if (scalarName == nullptr) {
+    scalarName = "Speed";
+  }
+  if (arrayName == nullptr) {
+    arrayName = "CarIdxLapDistPct";
+  }
+
+  int threadCount = 0;
+  if (const char* text = optionValue(argc, argv, "--threads")) {
+    threadCount = std::atoi(text);
+    if (threadCount < 1 || threadCount > kMaxThreads) {
+      std::cerr << "--threads must be between 1 and " << kMaxThreads << '\n';
+      return 2;
+    }
+  }
+
+  if (!setTapeInput(input)) {
+    std::cerr << "Could not select the tape\n";
+    return 1;
+  }
+  if (threadCount > 0) {
+    return runConsumers(input, scalarName, threadCount);
+  }
+  irsdkClient& client = irsdkClient::instance();
+  bool ready = false;
+  for (int attempt = 0; attempt < 5 && !ready; ++attempt) {
+    ready = client.waitForData(1000);
+  }
+  if (!ready) {
+    std::cerr << input << ": no frame arrived\n";
+    irsdkSharedReader::instance().shutdown();
+    return 1;
+  }
+
+  irsdkCVar scalarCVar(scalarName);
+  irsdkVar<float> scalarVar(scalarName);
+  irsdkCVar arrayCVar(arrayName);
+  irsdkVar<float, kArrayEntries> arrayVar(arrayName);
+  if (!scalarVar.isValid() || !arrayVar.isValid()) {
+    std::cerr << input << ": needs a float " << scalarName << " and a float "
+              << arrayName << " with at least " << kArrayEntries
+              << " entries\n";
+    irsdkSharedReader::instance().shutdown();
+    return 1;
+  }
+
+  double cvarSum = 0;
+  double varSum = 0;
+  const double scalarCVarNanoseconds = nanosecondsPerRead(
+      reads, cvarSum, [&] { return scalarCVar.getFloat(); });
+  const double scalarVarNanoseconds =
+      nanosecondsPerRead(reads, varSum, [&] { return scalarVar.get(); });
+  bool matched = cvarSum == varSum;
+  printResult(scalarName, scalarCVarNanoseconds, scalarVarNanoseconds);
+
+  const double arrayCVarNanoseconds = nanosecondsPerRead(reads, cvarSum, [&] {
+    float sum = 0;
+    for (int entry = 0; entry < kArrayEntries; ++entry) {
+      sum += arrayCVar.getFloat(entry);
+    }
+    return sum;
+  });
+  const double arrayVarNanoseconds = nanosecondsPerRead(reads, varSum, [&] {
+    const float* entries = arrayVar.span();
+    float sum = 0;
+    for (int entry = 0; entry < kArrayEntries; ++entry) {
+      sum += entries[entry];
+    }
+    return sum;
+  });
+  matched = matched && cvarSum == varSum;
+  printResult(
+      std::string(arrayName) + "[" + std::to_string(kArrayEntries) + "]",
+      arrayCVarNanoseconds,
+      arrayVarNanoseconds);
+
+  irsdkSharedReader::instance().shutdown();
+  if (!matched) {
+    std::cerr << "irsdkCVar and irsdkVar read different values\n";
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  return runBenchmark(argc, argv);
+}
@@ -295,4 +295,73 @@ DriverInfo:
     expect(result?.DriverInfo?.Drivers[0]?.AbbrevName).toBe('Anonymous');
     expect(result?.DriverInfo?.Drivers[0]?.Initials).toBe('A');
   });
+
+  it('should report connection state changes seen by waitForData', () => {
+    const states = ['connected', 'connected', 'stale', 'disconnected'] as const;
+    let call = 0;
+    mockSdk.getConnectionState = vi.fn(() => states[call++]);
+    const listener = vi.fn();
+    const remove = sdk.onConnectionStateChange(listener);
+
+    try {
+      for (let i = 0; i < states.length; i++) sdk.waitForData(16);
+    } finally {
+      remove();
+      delete mockSdk.getConnectionState;
+    }
+
+    expect(sdk.connectionState).toBe('disconnected');
+    expect(listener.mock.calls).toEqual([
+      ['connected', 'disconnected'],
+      ['stale', 'connected'],
+      ['disconnected', 'stale'],
+    ]);
+  });
+
+  it('should read packed values and fetch the schema once per version', () => {
+    const variable = (
+      name: string,
+      varType: number,
+      offset: number,
+      length = 1
+    ) => ({
+      name,
+      description: '',
+      unit: '',
+      countAsTime: false,
+      length,
+      varType,
+      offset,
+    });
+    const schema = {
+      version: 3,
+      variables: [
+        variable('IsOnTrack', 1, 0),
+        variable('Gear', 2, 4),
+        variable('CarIdxLapDistPct', 4, 8, 2),
+        variable('SessionTime', 5, 16),
+      ],
+    };
+    const data = new ArrayBuffer(24);
+    new Int8Array(data)[0] = 1;
+    new Int32Array(data, 4, 1)[0] = 3;
+    new Float32Array(data, 8, 2).set([0.25, 0.5]);
+    new Float64Array(data, 16, 1)[0] = 12.5;
+    mockSdk.getTelemetrySchema = vi.fn(() => schema);
+    mockSdk.getTelemetryValues = vi.fn(() => ({ version: 3, data }));
+
+    try {
+      sdk.getTelemetry();
+      const telemetry = sdk.getTelemetry();
+
+      expect(telemetry.IsOnTrack.value).toEqual([true]);
+      expect(telemetry.Gear.value).toEqual([3]);
+      expect(telemetry.CarIdxLapDistPct.value).toEqual([0.25, 0.5]);
+      expect(telemetry.SessionTime.value).toEqual([12.5]);
+      expect(mockSdk.getTelemetrySchema).toHaveBeenCalledTimes(1);
+    } finally {
+      delete mockSdk.getTelemetrySchema;
+      delete mockSdk.getTelemetryValues;
+    }
+  });
 });
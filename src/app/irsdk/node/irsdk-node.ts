@@ -22,7 +22,13 @@ import {
   WeekendInfo,
   SessionData,
 } from '../types';
-import type { INativeSDK } from '../native';
+import type {
+  ConnectionState,
+  INativeSDK,
+  TelemetrySchema,
+  TelemetryVariableInfo,
+  TelemetryView,
+} from '../native';
 
 import { getSimStatus } from './utils';
 import { getSdkOrMock } from './get-sdk';
@@ -114,6 +120,28 @@ function copyTelemData<
   }
 }
 
+// A view of one variable in a getTelemetryValues() buffer, in the form
+// getTelemetryData() reports the value
+function packedValue(
+  variable: TelemetryVariableInfo,
+  data: ArrayBuffer
+): ArrayBuffer | ArrayBufferView {
+  const { offset, length } = variable;
+  switch (variable.varType) {
+    case 1:
+      return new Int8Array(data, offset, length);
+    case 2:
+    case 3:
+      return new Int32Array(data, offset, length);
+    case 4:
+      return new Float32Array(data, offset, length);
+    case 5:
+      return new Float64Array(data, offset, length);
+    default:
+      return data.slice(offset, offset + length);
+  }
+}
+
 export class IRacingSDK {
   // Public
   /**
@@ -134,6 +162,15 @@ export class IRacingSDK {
   // Cache for telemetry data to avoid repeated array allocations
   private _telemetryCache: Partial<TelemetryVarList> = {};
 
+  // Metadata for getTelemetryValues(), fetched again when its version changes
+  private _telemetrySchema: TelemetrySchema | null = null;
+
+  private _connectionState: ConnectionState = 'disconnected';
+
+  private _connectionListeners = new Set<
+    (state: ConnectionState, previous: ConnectionState) => void
+  >();
+
   constructor() {
     this._sdkReq = this._loadSDK();
   }
@@ -189,6 +226,42 @@ export class IRacingSDK {
     return this._sdk?.isRunning() ?? false;
   }
 
+  /**
+   * The connection state as of the last waitForData call. 'stale' means the
+   * sim reports connected but has stopped ticking, as when a replay is paused.
+   * @property {ConnectionState}
+   * @readonly
+   */
+  public get connectionState(): ConnectionState {
+    return this._connectionState;
+  }
+
+  /**
+   * Calls the listener whenever waitForData or stopSDK changes the connection state.
+   * @returns A function that removes the listener.
+   */
+  public onConnectionStateChange(
+    listener: (state: ConnectionState, previous: ConnectionState) => void
+  ): () => void {
+    this._connectionListeners.add(listener);
+    return () => {
+      this._connectionListeners.delete(listener);
+    };
+  }
+
+  private _updateConnectionState(): void {
+    let state: ConnectionState = 'disconnected';
+    if (this._sdk?.getConnectionState) {
+      state = this._sdk.getConnectionState();
+    } else if (this._sdk?.isRunning()) {
+      state = 'connected';
+    }
+    const previous = this._connectionState;
+    if (state === previous) return;
+    this._connectionState = state;
+    this._connectionListeners.forEach((listener) => listener(state, previous));
+  }
+
   /**
    * Merges continuation lines back into the preceding key's value. iRacing
    * occasionally emits values that contain a literal newline (e.g. a
@@ -266,6 +339,7 @@ export class IRacingSDK {
   public stopSDK(): void {
     this._sdk?.stopSDK();
     this._dataVer = -1;
+    this._updateConnectionState();
   }
 
   /**
@@ -278,6 +352,7 @@ export class IRacingSDK {
       this._dataVer = -1;
       this._sessionData = null;
     }
+    this._updateConnectionState();
     return result;
   }
 
@@ -383,6 +458,10 @@ export class IRacingSDK {
    * Get the current value of the telemetry variables.
    */
   public getTelemetry(): TelemetryVarList {
+    if (this._sdk?.getTelemetrySchema && this._sdk.getTelemetryValues) {
+      return this._getPackedTelemetry(this._sdk);
+    }
+
     const rawData = this._sdk?.getTelemetryData();
     const data: Partial<TelemetryVarList> = {};
 
@@ -402,6 +481,38 @@ export class IRacingSDK {
     return data as TelemetryVarList;
   }
 
+  /**
+   * Reads the values alone, so the names, descriptions and units are only
+   * marshalled when the layout or the subscription changes.
+   */
+  private _getPackedTelemetry(sdk: INativeSDK): TelemetryVarList {
+    const data: Partial<TelemetryVarList> = {};
+    const values = sdk.getTelemetryValues?.();
+    if (!values) return data as TelemetryVarList;
+
+    if (this._telemetrySchema?.version !== values.version) {
+      this._telemetrySchema = sdk.getTelemetrySchema?.() ?? null;
+    }
+    const schema = this._telemetrySchema;
+    if (values.data && schema?.version === values.version) {
+      for (const variable of schema.variables) {
+        const key = variable.name as keyof TelemetryVarList;
+        copyTelemData(
+          {
+            varType: variable.varType,
+            value: packedValue(variable, values.data),
+          } as unknown as TelemetryVarList[typeof key],
+          key,
+          data as TelemetryVarList,
+          this._telemetryCache
+        );
+      }
+    }
+    this._telemetryCache = data;
+
+    return data as TelemetryVarList;
+  }
+
   /**
    * Request the value of the given telemetry variable.
    * @param telemVar The variable name or numeric index (use index only if you know what you are doing!)
@@ -425,6 +536,48 @@ export class IRacingSDK {
     >;
   }
 
+  /**
+   * The telemetry as one object whose arrays every waitForData() rewrites in
+   * place, so reading it allocates nothing. Check `state[0]` for a new frame
+   * and fetch the view again once `state[1]` drops to 0. Null without addon
+   * support or before the first frame.
+   */
+  public getTelemetryView(): TelemetryView | null {
+    return this._sdk?.getTelemetryView?.() ?? null;
+  }
+
+  /**
+   * Only copy and report the given telemetry variables, or all of them again
+   * when `null`. Returns false when the addon has no subscription support.
+   * @param names The variables getTelemetry() should report
+   */
+  public setTelemetrySubscription(
+    names: (keyof TelemetryVarList)[] | null
+  ): boolean {
+    return this._sdk?.setTelemetrySubscription?.(names) ?? false;
+  }
+
+  /**
+   * Pick the variables encodeTelemetryWire() sends, or all reported ones
+   * again when `null`. Returns false when the addon has no encoder.
+   * @param names The variables each message should carry
+   */
+  public setTelemetryWireChannels(
+    names: (keyof TelemetryVarList)[] | null
+  ): boolean {
+    return this._sdk?.setTelemetryWireChannels?.(names) ?? false;
+  }
+
+  /**
+   * The current frame as a compact message for TelemetryWireDecoder, holding
+   * only what changed since the previous message unless `keyframe` is set.
+   * Null without addon support or before the first frame.
+   * @param keyframe Send every value, for a decoder that just joined
+   */
+  public encodeTelemetryWire(keyframe = false): ArrayBuffer | null {
+    return this._sdk?.encodeTelemetryWire?.(keyframe) ?? null;
+  }
+
   // Broadcast commands
   public enableTelemetry(enabled: boolean): void {
     const command = enabled ? TelemetryCommand.Start : TelemetryCommand.Stop;
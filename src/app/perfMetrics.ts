@@ -145,6 +145,14 @@ export const getActivePerfMetrics = (): TelemetryPerfMetrics | null =>
   activePerfMetrics;
 
 export class TelemetryPerfMetrics {
+  /** Telemetry variables tick() reads. */
+  static readonly telemetry: readonly (keyof Telemetry)[] = [
+    'CpuUsageBG',
+    'CpuUsageFG',
+    'FrameRate',
+    'GpuUsage',
+  ];
+
   private sections = new Map<string, SectionBuffer>();
   private tickIntervals = new FixedSampleBuffer();
   private iracingFrameRate = new FixedSampleBuffer();
@@ -25,6 +25,11 @@ const copyPositions = (target: number[], frame: Telemetry): boolean => {
 export class BlindSpotProcessor implements TelemetryProcessor<BlindSpotSnapshot> {
   readonly channel = 'blind-spot.snapshot';
   readonly tickRateHz = 25;
+  static readonly telemetry: readonly (keyof Telemetry)[] = [
+    'CarIdxLapDistPct',
+    'CarLeftRight',
+    'IsOnTrack',
+  ];
 
   private readonly latest: BlindSpotSnapshot = {
     carLeftRight: 0,
@@ -40,6 +40,11 @@ const trackLengthFrom = (session: Session): number => {
 export class CarSpeedsProcessor implements TelemetryProcessor<CarSpeedsSnapshot> {
   readonly channel = 'car-speeds.snapshot';
   readonly tickRateHz = 10;
+  static readonly telemetry: readonly (keyof Telemetry)[] = [
+    'CarIdxLapDistPct',
+    'SessionNum',
+    'SessionTime',
+  ];
 
   private trackLength = 0;
   private lastLapDistPct: readonly number[] | null = null;
@@ -23,6 +23,24 @@ const booleanValue = (frame: Telemetry, key: string): boolean | undefined => {
 export class DriverControlsProcessor implements TelemetryProcessor<DriverControlsSnapshot> {
   readonly channel = 'driver-controls.snapshot';
   readonly tickRateHz = 60;
+  static readonly telemetry: readonly (keyof Telemetry)[] = [
+    'Brake',
+    'BrakeABSactive',
+    'BrakeRaw',
+    'Clutch',
+    'ClutchRaw',
+    'DisplayUnits',
+    'EngineWarnings',
+    'Gear',
+    'OilTemp',
+    'RPM',
+    'ShiftGrindRPM',
+    'Speed',
+    'SteeringWheelAngle',
+    'Throttle',
+    'ThrottleRaw',
+    'WaterTemp',
+  ];
 
   private readonly latest: DriverControlsSnapshot = { version: 0 };
 
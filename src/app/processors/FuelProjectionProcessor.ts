@@ -80,6 +80,27 @@ const validateLap = (
 export class FuelProjectionProcessor implements TelemetryProcessor<FuelProjectionSnapshot> {
   readonly channel = 'fuel.projection';
   readonly tickRateHz = 5;
+  static readonly telemetry: readonly (keyof Telemetry)[] = [
+    'CamCarIdx',
+    'CarIdxBestLapTime',
+    'CarIdxLap',
+    'CarIdxLapDistPct',
+    'CarIdxPosition',
+    'FuelLevel',
+    'FuelLevelPct',
+    'IsOnTrack',
+    'Lap',
+    'LapDistPct',
+    'OnPitRoad',
+    'PlayerCarTowTime',
+    'SessionFlags',
+    'SessionLapsRemain',
+    'SessionNum',
+    'SessionState',
+    'SessionTime',
+    'SessionTimeRemain',
+    'SessionTimeTotal',
+  ];
 
   private clockMilliseconds = 0;
   private readonly engine: FuelProjectionEngine;
@@ -33,6 +33,18 @@ export class IncidentProcessor implements TelemetryProcessor<Incident[]> {
   // processor directly, so ProcessorHost never reads either value.
   readonly channel = 'raceControl.incidents';
   readonly tickRateHz = 'event' as const;
+  static readonly telemetry: readonly (keyof Telemetry)[] = [
+    'CarIdxLap',
+    'CarIdxLapDistPct',
+    'CarIdxOnPitRoad',
+    'CarIdxSessionFlags',
+    'CarIdxTrackSurface',
+    'IsReplayPlaying',
+    'ReplayFrameNum',
+    'SessionNum',
+    'SessionState',
+    'SessionTime',
+  ];
 
   private readonly detector: IncidentDetector;
   private trackLengthM = 0;
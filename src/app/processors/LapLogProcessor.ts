@@ -19,6 +19,22 @@ const booleanValue = (frame: Telemetry, key: keyof Telemetry): boolean => {
 export class LapLogProcessor implements TelemetryProcessor<LapLogSnapshot> {
   readonly channel = 'lap-log.snapshot';
   readonly tickRateHz = 25;
+  static readonly telemetry: readonly (keyof Telemetry)[] = [
+    'CarIdxBestLapTime',
+    'LapBestLapTime',
+    'LapCompleted',
+    'LapCurrentLapTime',
+    'LapDeltaToSessionBestLap',
+    'LapDeltaToSessionBestLap_OK',
+    'LapDeltaToSessionLastlLap',
+    'LapDeltaToSessionLastlLap_OK',
+    'LapDistPct',
+    'LapLastLapTime',
+    'PlayerCarMyIncidentCount',
+    'PlayerTrackSurface',
+    'SessionNum',
+    'SessionTime',
+  ];
   private readonly bestLaps: number[] = [];
   private readonly latest = this.empty();
 
@@ -58,6 +58,10 @@ const numericValue = (
 export class LapTimesProcessor implements TelemetryProcessor<LapTimesSnapshot> {
   readonly channel = 'lap-times.snapshot';
   readonly tickRateHz = 'event';
+  static readonly telemetry: readonly (keyof Telemetry)[] = [
+    'CarIdxLastLapTime',
+    'SessionNum',
+  ];
 
   private lastLapTimes: readonly number[] | null = null;
   private history: number[][] = [];
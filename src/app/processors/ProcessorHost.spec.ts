@@ -65,6 +65,7 @@ const definition = <K extends ProcessorChannel>(
   dependencies,
   retainWhenInactive,
   metricsPrefix: channel,
+  telemetry: [],
   create,
 });
 
@@ -300,6 +301,7 @@ describe('ProcessorHost', () => {
       channel: 'relative-gaps.snapshot',
       dependencies: ['reference-laps.snapshot'],
       metricsPrefix: 'relativeGap',
+      telemetry: [],
       create: (context) => {
         order.push('relative');
         expect(context.snapshot('reference-laps.snapshot')).toBeDefined();
@@ -417,4 +419,44 @@ describe('ProcessorHost', () => {
     expect(processor.onFrame).toHaveBeenCalledOnce();
     expect(logError).toHaveBeenCalledOnce();
   });
+
+  it('reports the telemetry of every processor and the frame clock', () => {
+    const radio = {
+      ...definition('radio.snapshot', () =>
+        fakeProcessor('radio.snapshot', 'event')
+      ),
+      telemetry: ['RadioTransmitCarIdx', 'SessionTime'] as const,
+    };
+    const standings = {
+      ...definition('standings.snapshot', () =>
+        fakeProcessor('standings.snapshot', 5)
+      ),
+      telemetry: ['CarIdxPosition'] as const,
+    };
+
+    const host = new ProcessorHost({
+      bus: new ChannelBus(),
+      metrics: metrics(),
+      definitions: [radio, standings],
+    });
+    const clocked = new ProcessorHost({
+      bus: new ChannelBus(),
+      metrics: metrics(),
+      frameClock: () => 0,
+      frameClockTelemetry: ['SessionTick'],
+      definitions: [radio],
+    });
+
+    expect(host.telemetry().sort()).toEqual([
+      'CarIdxPosition',
+      'IsReplayPlaying',
+      'RadioTransmitCarIdx',
+      'SessionTime',
+    ]);
+    expect(clocked.telemetry().sort()).toEqual([
+      'RadioTransmitCarIdx',
+      'SessionTick',
+      'SessionTime',
+    ]);
+  });
 });
@@ -29,6 +29,8 @@ export interface ProcessorDefinition<K extends ProcessorChannel> {
   readonly dependencies?: readonly ProcessorChannel[];
   readonly retainWhenInactive?: boolean;
   readonly metricsPrefix: string;
+  /** Telemetry variables the processor reads, so the SDK copies only those. */
+  readonly telemetry: readonly (keyof Telemetry)[];
   create(
     context: ProcessorFactoryContext
   ): TelemetryProcessor<ChannelPayloads[K], K>;
@@ -55,6 +57,8 @@ interface ProcessorHostOptions {
   definitions: readonly AnyProcessorDefinition[];
   aggregateReplay?: boolean;
   frameClock?: (frame: Telemetry) => number | undefined;
+  /** Telemetry variables a custom frameClock reads. */
+  frameClockTelemetry?: readonly (keyof Telemetry)[];
   /**
    * Where processor failures are reported. Defaults to discarding them so this
    * module stays free of the main-process logger and can run in a browser;
@@ -63,6 +67,11 @@ interface ProcessorHostOptions {
   logError?: (message: string, error: unknown) => void;
 }
 
+const defaultFrameClockTelemetry: readonly (keyof Telemetry)[] = [
+  'IsReplayPlaying',
+  'SessionTime',
+];
+
 const defaultFrameClock = (frame: Telemetry): number | undefined => {
   const isReplayPlaying = frame.IsReplayPlaying?.value?.[0];
   if (isReplayPlaying === true) {
@@ -87,6 +96,7 @@ export class ProcessorHost {
   private readonly metrics: ProcessorMetrics;
   private readonly aggregateReplay: boolean;
   private readonly frameClock: (frame: Telemetry) => number | undefined;
+  private readonly frameClockTelemetry: readonly (keyof Telemetry)[];
   private readonly logError: (message: string, error: unknown) => void;
   private readonly states: readonly RuntimeState[];
   private readonly statesByChannel = new Map<ProcessorChannel, RuntimeState>();
@@ -103,6 +113,9 @@ export class ProcessorHost {
     this.metrics = options.metrics;
     this.aggregateReplay = options.aggregateReplay ?? false;
     this.frameClock = options.frameClock ?? defaultFrameClock;
+    this.frameClockTelemetry = options.frameClock
+      ? (options.frameClockTelemetry ?? [])
+      : defaultFrameClockTelemetry;
     this.logError = options.logError ?? (() => undefined);
 
     const definitions = this.sortDefinitions(options.definitions);
@@ -190,6 +203,21 @@ export class ProcessorHost {
     }
   }
 
+  /**
+   * Every telemetry variable onFrame can read: the frame clock's and those of
+   * each defined processor, active or not, so demand changes never need a new
+   * SDK subscription.
+   */
+  telemetry(): (keyof Telemetry)[] {
+    const variables = new Set(this.frameClockTelemetry);
+    for (const state of this.states) {
+      for (const variable of state.definition.telemetry) {
+        variables.add(variable);
+      }
+    }
+    return [...variables];
+  }
+
   snapshot<K extends ProcessorChannel>(
     channel: K
   ): ChannelPayloads[K] | undefined {
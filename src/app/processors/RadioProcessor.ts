@@ -9,6 +9,9 @@ import type { TelemetryProcessor } from './TelemetryProcessor';
 export class RadioProcessor implements TelemetryProcessor<RadioSnapshot> {
   readonly channel = 'radio.snapshot';
   readonly tickRateHz = 'event';
+  static readonly telemetry: readonly (keyof Telemetry)[] = [
+    'RadioTransmitCarIdx',
+  ];
 
   private enabled = true;
   private readonly candidateCarIdxs: number[] = [];
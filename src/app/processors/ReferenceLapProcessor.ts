@@ -110,6 +110,13 @@ const precomputeTangents = (lap: ReferenceLap): void => {
 export class ReferenceLapProcessor implements TelemetryProcessor<ReferenceLapsSnapshot> {
   readonly channel = 'reference-laps.snapshot';
   readonly tickRateHz = 'event';
+  static readonly telemetry: readonly (keyof Telemetry)[] = [
+    'CarIdxLapDistPct',
+    'CarIdxOnPitRoad',
+    'SessionNum',
+    'SessionTime',
+    'Speed',
+  ];
 
   private activeLaps = new Map<number, ReferenceLap>();
   private bestLaps = new Map<number, ReferenceLap>();
@@ -71,6 +71,15 @@ const interpolateAtPoint = (lap: ReferenceLap, trackPct: number): number => {
 export class RelativeGapProcessor implements TelemetryProcessor<RelativeGapsSnapshot> {
   readonly channel = 'relative-gaps.snapshot';
   readonly tickRateHz = 5;
+  static readonly telemetry: readonly (keyof Telemetry)[] = [
+    'CamCarIdx',
+    'CarIdxEstTime',
+    'CarIdxLap',
+    'CarIdxLapDistPct',
+    'CarIdxOnPitRoad',
+    'SessionNum',
+    'SessionTime',
+  ];
 
   private drivers: readonly (Driver | undefined)[] = [];
   private driversByCarIdx = new Map<number, Driver>();
@@ -70,6 +70,12 @@ const cloneResult = (
 export class SectorTimingProcessor implements TelemetryProcessor<SectorTimingSnapshot> {
   readonly channel = 'sector-timing.snapshot';
   readonly tickRateHz = 'event';
+  static readonly telemetry: readonly (keyof Telemetry)[] = [
+    'IsOnTrack',
+    'LapDistPct',
+    'SessionNum',
+    'SessionTime',
+  ];
 
   private lastLapDistPct = -1;
   private lastSessionTime = -1;
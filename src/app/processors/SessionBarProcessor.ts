@@ -28,6 +28,31 @@ export class SessionBarProcessor implements TelemetryProcessor<SessionBarSnapsho
   // Sample every source frame so the per-lap top speed remains accurate. The
   // channel bus still limits renderer delivery to its configured 5 Hz.
   readonly tickRateHz = 25;
+  static readonly telemetry: readonly (keyof Telemetry)[] = [
+    'AirTemp',
+    'CarIdxBestLapTime',
+    'CarIdxClassPosition',
+    'CarIdxPosition',
+    'DisplayUnits',
+    'FuelLevel',
+    'Lap',
+    'LapBestLapTime',
+    'LapLastLapTime',
+    'PlayerCarTeamIncidentCount',
+    'Precipitation',
+    'RelativeHumidity',
+    'SessionNum',
+    'SessionTime',
+    'SessionTimeOfDay',
+    'Speed',
+    'TrackTempCrew',
+    'TrackWetness',
+    'WindDir',
+    'WindVel',
+    'YawNorth',
+    'dcBrakeBias',
+    'dcPeakBrakeBias',
+  ];
   private session?: Session;
   private lastTime = -Infinity;
   private lap = -1;
@@ -29,6 +29,19 @@ const finiteAt = (values: unknown[], index: number | null): number => {
 export class SessionTimingProcessor implements TelemetryProcessor<SessionTimingSnapshot> {
   readonly channel = 'session-timing.snapshot';
   readonly tickRateHz = 5;
+  static readonly telemetry: readonly (keyof Telemetry)[] = [
+    'CamCarIdx',
+    'CarIdxBestLapTime',
+    'CarIdxLap',
+    'CarIdxLapDistPct',
+    'CarIdxPosition',
+    'LapDistPct',
+    'SessionNum',
+    'SessionState',
+    'SessionTime',
+    'SessionTimeRemain',
+    'SessionTimeTotal',
+  ];
 
   private session?: Session;
   private driverCarIdx: number | null = null;
@@ -49,6 +49,29 @@ const copyBooleanArray = (
 export class StandingsProcessor implements TelemetryProcessor<StandingsSnapshot> {
   readonly channel = 'standings.snapshot';
   readonly tickRateHz = 5;
+  static readonly telemetry: readonly (keyof Telemetry)[] = [
+    'CamCarIdx',
+    'CarIdxBestLapTime',
+    'CarIdxClass',
+    'CarIdxClassPosition',
+    'CarIdxEstTime',
+    'CarIdxF2Time',
+    'CarIdxLap',
+    'CarIdxLapCompleted',
+    'CarIdxLapDistPct',
+    'CarIdxLastLapTime',
+    'CarIdxOnPitRoad',
+    'CarIdxP2P_Count',
+    'CarIdxP2P_Status',
+    'CarIdxPosition',
+    'CarIdxSessionFlags',
+    'CarIdxTireCompound',
+    'CarIdxTrackSurface',
+    'SessionNum',
+    'SessionState',
+    'SessionTime',
+    'SessionUniqueID',
+  ];
 
   private driverCarIdx: number | null = null;
   private session?: Session;
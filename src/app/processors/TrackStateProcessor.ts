@@ -68,6 +68,31 @@ const copyRoundedPositionArray = (
 export class TrackStateProcessor implements TelemetryProcessor<TrackStateSnapshot> {
   readonly channel = 'track-state.snapshot';
   readonly tickRateHz = 25;
+  static readonly telemetry: readonly (keyof Telemetry)[] = [
+    'CamCarIdx',
+    'CarIdxClassPosition',
+    'CarIdxLapDistPct',
+    'CarIdxOnPitRoad',
+    'CarIdxTrackSurface',
+    'CarLeftRight',
+    'DisplayUnits',
+    'EngineWarnings',
+    'IsGarageVisible',
+    'IsInGarage',
+    'IsOnTrack',
+    'IsReplayPlaying',
+    'LapDistPct',
+    'OnPitRoad',
+    'PitstopActive',
+    'PlayerCarInPitStall',
+    'PlayerTrackSurface',
+    'SessionFlags',
+    'SessionNum',
+    'SessionState',
+    'SessionTime',
+    'Speed',
+    'dcPitSpeedLimiterToggle',
+  ];
 
   private readonly latest: TrackStateSnapshot = {
     focusCarIdx: null,
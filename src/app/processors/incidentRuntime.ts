@@ -23,6 +23,7 @@ export interface IncidentRuntimeOptions {
 }
 
 export class IncidentRuntime {
+  readonly telemetry = IncidentProcessor.telemetry;
   private readonly processor: IncidentProcessor;
   private enabled = true;
   private currentSessionId = '';
@@ -1,7 +1,81 @@
 import { describe, expect, it } from 'vitest';
 import { channelRegistry } from '@irdashies/types';
+import type { Session, Telemetry } from '@irdashies/types';
+import recordedSession from '../../../test-data/1747384033336/session.json';
+import recordedFrame from '../../../test-data/1747384033336/telemetry.json';
+import { IncidentProcessor } from './IncidentProcessor';
 import { createProcessorDefinitions } from './processorRegistry';
 
+const FRAME_COUNT = 240;
+
+const setValue = (
+  frame: Telemetry,
+  name: keyof Telemetry,
+  value: unknown[]
+): void => {
+  (frame[name] as { value: unknown[] }).value = value;
+};
+
+// Four seconds of the recorded frame at 60 Hz, with the clock, the lap
+// distance and the car positions moving and the lap rolling over once.
+const recordedFrames = (): Telemetry[] => {
+  const base = recordedFrame as unknown as Telemetry;
+  const sessionTime = Number(base.SessionTime.value[0]);
+  const lap = Number(base.Lap.value[0]);
+  return Array.from({ length: FRAME_COUNT }, (_, index) => {
+    const distance = (0.9 + index / FRAME_COUNT / 2) % 1;
+    const frame = structuredClone(base);
+    setValue(frame, 'SessionTime', [sessionTime + index / 60]);
+    setValue(frame, 'Lap', [distance < 0.9 ? lap + 1 : lap]);
+    setValue(frame, 'LapDistPct', [distance]);
+    setValue(
+      frame,
+      'CarIdxLapDistPct',
+      base.CarIdxLapDistPct.value.map((position) =>
+        position < 0 ? position : (position + index / FRAME_COUNT / 2) % 1
+      )
+    );
+    return frame;
+  });
+};
+
+// The frame as the SDK delivers it once subscribed: only the declared
+// variables are present. Reads of anything else are collected.
+const restrictTo = (
+  frame: Telemetry,
+  declared: ReadonlySet<string>,
+  undeclared: Set<string>
+): Telemetry => {
+  const restricted = Object.fromEntries(
+    Object.entries(frame).filter(([name]) => declared.has(name))
+  );
+  return new Proxy(restricted, {
+    get: (target, name) => {
+      if (typeof name === 'string' && !declared.has(name)) {
+        undeclared.add(name);
+      }
+      return Reflect.get(target, name);
+    },
+    has: (target, name) => {
+      if (typeof name === 'string' && !declared.has(name)) {
+        undeclared.add(name);
+      }
+      return Reflect.has(target, name);
+    },
+  }) as unknown as Telemetry;
+};
+
+// The recorded session with the player in a Clio, which reads a different
+// brake bias variable.
+const clioSession = (): Session => {
+  const session = structuredClone(recordedSession) as unknown as Session;
+  const player = session.DriverInfo.Drivers.find(
+    ({ CarIdx }) => CarIdx === session.DriverInfo.DriverCarIdx
+  );
+  if (player) player.CarID = 162;
+  return session;
+};
+
 describe('processor registry', () => {
   it('registers every snapshot channel exactly once', () => {
     const definitions = createProcessorDefinitions({
@@ -44,4 +118,53 @@ describe('processor registry', () => {
       'lap-times.snapshot',
     ]);
   });
+
+  it('reads only the telemetry each processor declares', () => {
+    const definitions = createProcessorDefinitions({
+      referenceLapPersistence: {
+        load: () => null,
+        save: () => undefined,
+      },
+    });
+    const processors = [
+      ...definitions.map(({ channel, telemetry, create }) => ({
+        channel,
+        telemetry,
+        create: () =>
+          create({
+            aggregateReplay: false,
+            sourceReplay: false,
+            snapshot: () => undefined,
+          }),
+      })),
+      {
+        channel: 'incidents',
+        telemetry: IncidentProcessor.telemetry,
+        create: () => new IncidentProcessor(),
+      },
+    ];
+    const frames = recordedFrames();
+
+    for (const { channel, telemetry, create } of processors) {
+      const declared = new Set<string>(telemetry);
+      const undeclared = new Set<string>();
+      for (const session of [
+        recordedSession as unknown as Session,
+        clioSession(),
+      ]) {
+        const processor = create();
+        processor.init(session);
+        processor.onLifecycle({ type: 'enter', replay: false });
+        for (const frame of frames) {
+          processor.onFrame(restrictTo(frame, declared, undeclared));
+        }
+        processor.snapshot();
+      }
+
+      expect({ channel, undeclared: [...undeclared].sort() }).toEqual({
+        channel,
+        undeclared: [],
+      });
+    }
+  });
 });
@@ -59,27 +59,32 @@ export const createProcessorDefinitions = ({
   defineProcessor({
     channel: 'blind-spot.snapshot',
     metricsPrefix: 'blindSpot',
+    telemetry: BlindSpotProcessor.telemetry,
     create: () => new BlindSpotProcessor(),
   }),
   defineProcessor({
     channel: 'fuel.projection',
     metricsPrefix: 'fuelProjection',
+    telemetry: FuelProjectionProcessor.telemetry,
     create: ({ sourceReplay }) => new FuelProjectionProcessor({ sourceReplay }),
   }),
   defineProcessor({
     channel: 'lap-times.snapshot',
     metricsPrefix: 'lapTimes',
+    telemetry: LapTimesProcessor.telemetry,
     create: () => new LapTimesProcessor(),
   }),
   defineProcessor({
     channel: 'car-speeds.snapshot',
     metricsPrefix: 'carSpeeds',
+    telemetry: CarSpeedsProcessor.telemetry,
     create: () => new CarSpeedsProcessor(),
   }),
   defineProcessor({
     channel: 'reference-laps.snapshot',
     retainWhenInactive: true,
     metricsPrefix: 'referenceLap',
+    telemetry: ReferenceLapProcessor.telemetry,
     create: ({ aggregateReplay }) =>
       new ReferenceLapProcessor(
         aggregateReplay
@@ -91,6 +96,7 @@ export const createProcessorDefinitions = ({
     channel: 'relative-gaps.snapshot',
     dependencies: ['reference-laps.snapshot'],
     metricsPrefix: 'relativeGap',
+    telemetry: RelativeGapProcessor.telemetry,
     create: ({ snapshot }) =>
       new RelativeGapProcessor({
         snapshot: () => snapshot('reference-laps.snapshot') ?? noReferenceLaps,
@@ -99,22 +105,26 @@ export const createProcessorDefinitions = ({
   defineProcessor({
     channel: 'sector-timing.snapshot',
     metricsPrefix: 'sectorTiming',
+    telemetry: SectorTimingProcessor.telemetry,
     create: () => new SectorTimingProcessor(),
   }),
   defineProcessor({
     channel: 'standings.snapshot',
     metricsPrefix: 'standings',
+    telemetry: StandingsProcessor.telemetry,
     create: () => new StandingsProcessor(),
   }),
   defineProcessor({
     channel: 'radio.snapshot',
     metricsPrefix: 'radio',
+    telemetry: RadioProcessor.telemetry,
     create: () => new RadioProcessor(),
   }),
   defineProcessor({
     channel: 'session-timing.snapshot',
     dependencies: ['lap-times.snapshot'],
     metricsPrefix: 'sessionTiming',
+    telemetry: SessionTimingProcessor.telemetry,
     create: ({ snapshot }) =>
       new SessionTimingProcessor(
         () => (snapshot('lap-times.snapshot') ?? noLapTimes).lapTimes
@@ -123,21 +133,25 @@ export const createProcessorDefinitions = ({
   defineProcessor({
     channel: 'session-bar.snapshot',
     metricsPrefix: 'sessionBar',
+    telemetry: SessionBarProcessor.telemetry,
     create: () => new SessionBarProcessor(),
   }),
   defineProcessor({
     channel: 'driver-controls.snapshot',
     metricsPrefix: 'driverControls',
+    telemetry: DriverControlsProcessor.telemetry,
     create: () => new DriverControlsProcessor(),
   }),
   defineProcessor({
     channel: 'track-state.snapshot',
     metricsPrefix: 'trackState',
+    telemetry: TrackStateProcessor.telemetry,
     create: () => new TrackStateProcessor(),
   }),
   defineProcessor({
     channel: 'lap-log.snapshot',
     metricsPrefix: 'lapLog',
+    telemetry: LapLogProcessor.telemetry,
     create: () => new LapLogProcessor(),
   }),
 ];
@@ -1,3 +1,6 @@
-export { createSessionLifecycle } from './sessionLifecycle';
+export {
+  createSessionLifecycle,
+  SESSION_LIFECYCLE_TELEMETRY,
+} from './sessionLifecycle';
 export type { SessionLifecycle } from './sessionLifecycle';
 export type { SessionEnterEvent } from './sessionLifecycle';
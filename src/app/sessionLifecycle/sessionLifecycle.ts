@@ -8,6 +8,11 @@ export interface SessionEnterEvent {
 }
 type EnterCallback = (event: SessionEnterEvent) => void;
 
+/** Telemetry variables _onTelemetry reads. */
+export const SESSION_LIFECYCLE_TELEMETRY: readonly (keyof Telemetry)[] = [
+  'SessionNum',
+];
+
 export interface SessionLifecycle {
   /** Called when a live or recorded telemetry source begins publishing. */
   onEnter: (cb: EnterCallback) => () => void;
@@ -1,3 +1,4 @@
 export * from './gamepadToken';
 export * from './keybindingActions';
 export * from './fuel';
+export * from './telemetryWire';
@@ -0,0 +1,157 @@
+import { describe, expect, it } from 'vitest';
+import { TELEMETRY_WIRE_FORMAT, TelemetryWireDecoder } from './telemetryWire';
+
+const varint = (value: number | bigint): number[] => {
+  let rest = BigInt(value);
+  const bytes: number[] = [];
+  while (rest >= 0x80n) {
+    bytes.push(Number(rest & 0x7fn) | 0x80);
+    rest >>= 7n;
+  }
+  bytes.push(Number(rest));
+  return bytes;
+};
+
+const zigzag = (value: number): number[] =>
+  varint(((value << 1) ^ (value >> 31)) >>> 0);
+
+const floatBytes = (value: number): number[] =>
+  Array.from(new Uint8Array(new Float32Array([value]).buffer));
+
+const doubleBytes = (value: number): number[] =>
+  Array.from(new Uint8Array(new Float64Array([value]).buffer));
+
+// Bits of a float or double as one integer, for the XOR a delta sends.
+const bits = (bytes: number[]): bigint =>
+  bytes.reduceRight((value, byte) => (value << 8n) | BigInt(byte), 0n);
+
+const channel = (name: string, varType: number, count: number): number[] => [
+  ...varint(name.length),
+  ...new TextEncoder().encode(name),
+  varType,
+  ...varint(count),
+];
+
+// Speed (float), Gear (int), OnPitRoad (bool) and CarIdxLap (int[3])
+const keyframe = (sequence: number): Uint8Array =>
+  new Uint8Array([
+    TELEMETRY_WIRE_FORMAT,
+    1,
+    ...varint(3),
+    ...varint(sequence),
+    ...varint(4),
+    ...channel('Speed', 4, 1),
+    ...channel('Gear', 2, 1),
+    ...channel('OnPitRoad', 1, 1),
+    ...channel('CarIdxLap', 2, 3),
+    0b1111,
+    0b111,
+    ...floatBytes(50),
+    ...zigzag(3),
+    1,
+    ...zigzag(4),
+    ...zigzag(5),
+    ...zigzag(6),
+  ]);
+
+describe('TelemetryWireDecoder', () => {
+  it('decodes every channel of a keyframe', () => {
+    const decoder = new TelemetryWireDecoder();
+
+    expect(decoder.decode(keyframe(1))).toEqual({
+      Speed: { value: [50] },
+      Gear: { value: [3] },
+      OnPitRoad: { value: [true] },
+      CarIdxLap: { value: [4, 5, 6] },
+    });
+  });
+
+  it('applies deltas to the values it holds', () => {
+    const decoder = new TelemetryWireDecoder();
+    decoder.decode(keyframe(1));
+
+    // Gear drops by two and only the second car's lap changes.
+    const delta = new Uint8Array([
+      TELEMETRY_WIRE_FORMAT,
+      0,
+      ...varint(3),
+      ...varint(2),
+      0b1010,
+      0b010,
+      ...zigzag(-2),
+      ...zigzag(1),
+    ]);
+
+    expect(decoder.decode(delta.buffer)).toEqual({
+      Speed: { value: [50] },
+      Gear: { value: [1] },
+      OnPitRoad: { value: [true] },
+      CarIdxLap: { value: [4, 6, 6] },
+    });
+  });
+
+  it('restores float and double bits exactly', () => {
+    const decoder = new TelemetryWireDecoder();
+    const sessionTime = 978.1833333345108;
+    const speed = 54.28200149536133;
+    decoder.decode(
+      new Uint8Array([
+        TELEMETRY_WIRE_FORMAT,
+        1,
+        ...varint(1),
+        ...varint(1),
+        ...varint(2),
+        ...channel('SessionTime', 5, 1),
+        ...channel('Speed', 4, 1),
+        0b11,
+        ...doubleBytes(sessionTime),
+        ...floatBytes(speed),
+      ])
+    );
+
+    // Deltas carry the XOR of the bits, here with the sign bit set.
+    const next = new Uint8Array([
+      TELEMETRY_WIRE_FORMAT,
+      0,
+      ...varint(1),
+      ...varint(2),
+      0b11,
+      ...varint(
+        bits(doubleBytes(sessionTime)) ^ bits(doubleBytes(sessionTime + 0.1))
+      ),
+      ...varint(bits(floatBytes(speed)) ^ bits(floatBytes(-speed))),
+    ]);
+
+    expect(decoder.decode(next)).toEqual({
+      SessionTime: { value: [sessionTime + 0.1] },
+      Speed: { value: [Math.fround(-speed)] },
+    });
+  });
+
+  it('waits for a keyframe after a missed message', () => {
+    const decoder = new TelemetryWireDecoder();
+    decoder.decode(keyframe(1));
+
+    const skipped = new Uint8Array([
+      TELEMETRY_WIRE_FORMAT,
+      0,
+      ...varint(3),
+      ...varint(3),
+      0,
+    ]);
+    expect(decoder.decode(skipped)).toBeNull();
+    expect(decoder.decode(keyframe(4))).toMatchObject({
+      Gear: { value: [3] },
+    });
+  });
+
+  it('rejects truncated and unknown messages', () => {
+    const decoder = new TelemetryWireDecoder();
+    const message = keyframe(1);
+
+    expect(decoder.decode(message.subarray(0, message.length - 1))).toBeNull();
+    expect(
+      decoder.decode(new Uint8Array([TELEMETRY_WIRE_FORMAT + 1, 1, 0, 0, 0]))
+    ).toBeNull();
+  });
+});
@@ -0,0 +1,230 @@
+import type { Telemetry } from '@irdashies/types';
+
+// Decodes the messages the native addon's encodeTelemetryWire() builds. The
+// layout is described in irsdk_telemetry_wire.h.
+export const TELEMETRY_WIRE_FORMAT = 2;
+const KEYFRAME_FLAG = 1;
+
+// irsdk_VarType
+const CHAR = 0;
+const BOOL = 1;
+const INT = 2;
+const BIT_FIELD = 3;
+const FLOAT = 4;
+const DOUBLE = 5;
+const TYPE_BYTES = [1, 1, 4, 4, 4, 8];
+
+interface WireChannel {
+  name: string;
+  varType: number;
+  length: number;
+  // Where the decoder keeps the channel's values
+  offset: number;
+}
+
+const textDecoder = new TextDecoder();
+
+export class TelemetryWireDecoder {
+  private channels: WireChannel[] = [];
+  private values = new DataView(new ArrayBuffer(0));
+  private version = -1;
+  private sequence = -1;
+  private bytes = new Uint8Array(0);
+  private position = 0;
+
+  /**
+   * Applies one message and returns every channel's current value, or null
+   * while waiting for a keyframe after a missed or unreadable message.
+   */
+  decode(message: ArrayBuffer | ArrayBufferView): Partial<Telemetry> | null {
+    this.bytes = ArrayBuffer.isView(message)
+      ? new Uint8Array(message.buffer, message.byteOffset, message.byteLength)
+      : new Uint8Array(message);
+    if (this.bytes.length < 2 || this.bytes[0] !== TELEMETRY_WIRE_FORMAT) {
+      return this.resync();
+    }
+    const keyframe = (this.bytes[1] & KEYFRAME_FLAG) !== 0;
+    this.position = 2;
+    const version = this.readVarint();
+    const sequence = this.readVarint();
+    if (keyframe) {
+      this.readChannels();
+    } else if (version !== this.version || sequence !== this.sequence + 1) {
+      return this.resync();
+    }
+
+    this.readValues(keyframe);
+    if (this.position !== this.bytes.length) return this.resync();
+    this.version = version;
+    this.sequence = sequence;
+    return this.telemetry();
+  }
+
+  private resync(): null {
+    this.version = -1;
+    this.sequence = -1;
+    return null;
+  }
+
+  private readVarint(): number {
+    let result = 0;
+    let scale = 1;
+    let byte: number;
+    do {
+      byte = this.bytes[this.position++] ?? 0;
+      result += (byte & 0x7f) * scale;
+      scale *= 128;
+    } while (byte & 0x80);
+    return result;
+  }
+
+  // Keyframes restart from zero, so the values are rebuilt with the channels.
+  private readChannels(): void {
+    const count = this.readVarint();
+    const channels: WireChannel[] = [];
+    let offset = 0;
+    for (let i = 0; i < count; i++) {
+      const nameLength = this.readVarint();
+      const name = textDecoder.decode(
+        this.bytes.subarray(this.position, this.position + nameLength)
+      );
+      this.position += nameLength;
+      const varType = this.bytes[this.position++] ?? CHAR;
+      const length = this.readVarint();
+      channels.push({ name, varType, length, offset });
+      offset += (TYPE_BYTES[varType] ?? 1) * length;
+    }
+    this.channels = channels;
+    this.values = new DataView(new ArrayBuffer(offset));
+  }
+
+  private readValues(keyframe: boolean): void {
+    const channels = this.channels;
+    const channelBitmap = this.position;
+    const changed = (index: number): boolean =>
+      (this.bytes[channelBitmap + (index >> 3)] & (1 << (index & 7))) !== 0;
+
+    // The entry bitmaps of all changed channels come before any value.
+    let valuesStart = channelBitmap + Math.ceil(channels.length / 8);
+    for (let i = 0; i < channels.length; i++) {
+      if (changed(i) && channels[i].length > 1) {
+        valuesStart += Math.ceil(channels[i].length / 8);
+      }
+    }
+
+    let entryBitmap = channelBitmap + Math.ceil(channels.length / 8);
+    this.position = valuesStart;
+    for (let i = 0; i < channels.length; i++) {
+      if (!changed(i)) continue;
+      const { varType, length, offset } = channels[i];
+      const size = TYPE_BYTES[varType] ?? 1;
+      for (let entry = 0; entry < length; entry++) {
+        if (
+          length > 1 &&
+          (this.bytes[entryBitmap + (entry >> 3)] & (1 << (entry & 7))) === 0
+        ) {
+          continue;
+        }
+        this.readValue(varType, offset + entry * size, keyframe);
+      }
+      if (length > 1) entryBitmap += Math.ceil(length / 8);
+    }
+  }
+
+  private readValue(varType: number, offset: number, keyframe: boolean): void {
+    const values = this.values;
+    if (keyframe && varType >= BIT_FIELD && varType <= DOUBLE) {
+      // Keyframes carry these as the value's own bytes.
+      for (let byte = 0; byte < TYPE_BYTES[varType]; byte++) {
+        values.setUint8(offset + byte, this.bytes[this.position++] ?? 0);
+      }
+      return;
+    }
+    switch (varType) {
+      case INT: {
+        const zigzag = this.readVarint();
+        const difference = (zigzag >>> 1) ^ -(zigzag & 1);
+        values.setInt32(
+          offset,
+          (values.getInt32(offset, true) + difference) | 0,
+          true
+        );
+        return;
+      }
+      case BIT_FIELD:
+      case FLOAT:
+        values.setUint32(
+          offset,
+          (values.getUint32(offset, true) ^ this.readVarint()) >>> 0,
+          true
+        );
+        return;
+      case DOUBLE: {
+        // Read in 7-bit groups so the upper 32 bits never pass through a
+        // number that cannot hold them exactly.
+        let low = 0;
+        let high = 0;
+        let shift = 0;
+        let byte: number;
+        do {
+          byte = this.bytes[this.position++] ?? 0;
+          const bits = byte & 0x7f;
+          if (shift < 28) {
+            low |= bits << shift;
+          } else if (shift === 28) {
+            low |= bits << 28;
+            high |= bits >>> 4;
+          } else {
+            high |= bits << (shift - 32);
+          }
+          shift += 7;
+        } while (byte & 0x80);
+        values.setUint32(
+          offset,
+          (values.getUint32(offset, true) ^ low) >>> 0,
+          true
+        );
+        values.setUint32(
+          offset + 4,
+          (values.getUint32(offset + 4, true) ^ high) >>> 0,
+          true
+        );
+        return;
+      }
+      default:
+        values.setUint8(offset, this.bytes[this.position++] ?? 0);
+    }
+  }
+
+  // New arrays on every call, in the shape IRacingSDK.getTelemetry() builds.
+  private telemetry(): Partial<Telemetry> {
+    const values = this.values;
+    const telemetry: Record<string, { value: number[] | boolean[] }> = {};
+    for (const { name, varType, length, offset } of this.channels) {
+      const size = TYPE_BYTES[varType] ?? 1;
+      const value: (number | boolean)[] = [];
+      for (let entry = 0; entry < length; entry++) {
+        const at = offset + entry * size;
+        switch (varType) {
+          case BOOL:
+            value.push(values.getUint8(at) !== 0);
+            break;
+          case INT:
+          case BIT_FIELD:
+            value.push(values.getInt32(at, true));
+            break;
+          case FLOAT:
+            value.push(values.getFloat32(at, true));
+            break;
+          case DOUBLE:
+            value.push(values.getFloat64(at, true));
+            break;
+          default:
+            value.push(values.getUint8(at));
+        }
+      }
+      telemetry[name] = { value: value as number[] | boolean[] };
+    }
+    return telemetry as Partial<Telemetry>;
+  }
+}
@@ -27,8 +27,13 @@ export interface IrSdkBridge {
  * `raceControlBridge`.
  */
 export interface IrSdkSourceBridge extends IrSdkBridge {
+  /**
+   * `variables` lists what the callback reads, letting the SDK skip copying
+   * the rest. Without it the callback receives every variable.
+   */
   onTelemetry: (
-    callback: (value: Telemetry) => void
+    callback: (value: Telemetry) => void,
+    variables?: readonly (keyof Telemetry)[]
   ) => (() => void) | undefined;
   changeCameraNumber: (
     carNumber: string,
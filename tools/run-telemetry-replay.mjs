@@ -10,7 +10,7 @@ const arguments_ = process.argv.slice(2);
 const input = optionValue(arguments_, '--input');
 if (!input) {
   process.stderr.write(
-    'Usage: npm run irsdk:replay:app -- --input <capture.irdt> ' +
+    'Usage: npm run irsdk:replay:app -- --input <capture.irdt|log.ibt> ' +
       '[--speed <0.25-100>] [--loop]\n'
   );
   process.exitCode = 2;
@@ -27,13 +27,19 @@ if (!input) {
   ) {
     process.stderr.write('--speed must be between 0.25 and 100\n');
     process.exitCode = 2;
-  } else if (path.extname(input).toLowerCase() !== '.irdt') {
-    process.stderr.write('--input must be an .irdt telemetry tape\n');
+  } else if (!['.irdt', '.ibt'].includes(path.extname(input).toLowerCase())) {
+    process.stderr.write(
+      '--input must be an .irdt telemetry tape or an .ibt telemetry log\n'
+    );
     process.exitCode = 2;
   } else {
+    const inputVariable =
+      path.extname(input).toLowerCase() === '.ibt'
+        ? 'IRDASHIES_TELEMETRY_IBT'
+        : 'IRDASHIES_TELEMETRY_REPLAY';
     const env = {
       ...process.env,
-      IRDASHIES_TELEMETRY_REPLAY: path.resolve(input),
+      [inputVariable]: path.resolve(input),
       IRDASHIES_TELEMETRY_REPLAY_SPEED: speedText,
       IRDASHIES_TELEMETRY_REPLAY_LOOP: arguments_.includes('--loop')
         ? '1'
@@ -1,7 +1,10 @@
 import {
+  EVENT_SIZE,
   FILE_HEADER_SIZE,
   RECORD_HEADER_SIZE,
+  REPEAT_SIZE,
   SDK_HEADER_SIZE,
+  TAPE_FORMAT_VERSION,
   VARIABLE_HEADER_SIZE,
 } from './tape';
 
@@ -55,7 +58,13 @@ const record = (
   return Buffer.concat([header, Buffer.from(payload)]);
 };
 
-export function createSyntheticTape(): Buffer {
+// With eventIndex, an EventIndex record after End marks lap 2 on the
+// second frame. With repeats, a Repeat record after the second frame stands
+// for two more copies of it at ticks 12 and 13.
+export function createSyntheticTape({
+  eventIndex = false,
+  repeats = false,
+}: { eventIndex?: boolean; repeats?: boolean } = {}): Buffer {
   const variables = Buffer.concat([
     variable(5, 0, 'SessionTime'),
     variable(4, 8, 'FuelLevel'),
@@ -88,11 +97,39 @@ export function createSyntheticTape(): Buffer {
     record(2, 0n, -1, 1, SESSION_PAYLOAD),
     record(1, 0n, 10, 0, frame(1, 20)),
     record(1, 1n, 11, 0, frame(1.5, 19.9)),
-    record(5, 2n, 11, 0),
   ];
+  if (repeats) {
+    const repeat = Buffer.alloc(REPEAT_SIZE);
+    repeat.writeBigUInt64LE(
+      BigInt(SYNTHETIC_SECOND_FRAME_PAYLOAD_OFFSET - RECORD_HEADER_SIZE),
+      0
+    );
+    repeat.writeBigUInt64LE(3n, 8);
+    repeat.writeInt32LE(13, 16);
+    records.push(record(7, 2n, 12, 2, repeat), record(5, 4n, 13, 0));
+  } else {
+    records.push(record(5, 2n, 11, 0));
+  }
+  const recordsOffset = FILE_HEADER_SIZE + SDK_HEADER_SIZE + variables.length;
+  let eventIndexOffset = 0n;
+  if (eventIndex) {
+    const event = Buffer.alloc(EVENT_SIZE);
+    event.writeUInt32LE(1, 0);
+    event.writeInt32LE(2, 4);
+    event.writeBigUInt64LE(
+      BigInt(SYNTHETIC_SECOND_FRAME_PAYLOAD_OFFSET - RECORD_HEADER_SIZE),
+      8
+    );
+    event.writeBigUInt64LE(1n, 16);
+    event.writeInt32LE(11, 24);
+    eventIndexOffset = BigInt(
+      recordsOffset + records.reduce((size, item) => size + item.length, 0)
+    );
+    records.push(record(6, 2n, -1, 1, event));
+  }
   const fileHeader = Buffer.alloc(FILE_HEADER_SIZE);
   fileHeader.write('IRDTRCE\0', 0, 'ascii');
-  fileHeader.writeUInt32LE(1, 8);
+  fileHeader.writeUInt32LE(TAPE_FORMAT_VERSION, 8);
   fileHeader.writeUInt32LE(0x01020304, 12);
   fileHeader.writeUInt32LE(FILE_HEADER_SIZE, 16);
   fileHeader.writeUInt32LE(SDK_HEADER_SIZE, 20);
@@ -102,5 +139,6 @@ export function createSyntheticTape(): Buffer {
   fileHeader.writeBigUInt64LE(2n, 40);
   fileHeader.writeBigUInt64LE(BigInt(records.length), 48);
   fileHeader.writeUInt32LE(checksum(variables), 56);
+  fileHeader.writeBigUInt64LE(eventIndexOffset, 60);
   return Buffer.concat([fileHeader, sdkHeader, variables, ...records]);
 }
@@ -5,13 +5,33 @@ export const FILE_HEADER_SIZE = 96;
 export const SDK_HEADER_SIZE = 112;
 export const VARIABLE_HEADER_SIZE = 144;
 export const RECORD_HEADER_SIZE = 40;
+export const EVENT_SIZE = 32;
+export const REPEAT_SIZE = 24;
+// Version 2 added the eventIndex and repeat records; version 1 tapes hold only
+// frame through end records. Newer tapes are rejected.
+export const TAPE_FORMAT_VERSION = 2;
+const VERSION_1_LAST_KIND = 5;
+export const DEFAULT_READ_AHEAD_BYTES = 16 * 1024 * 1024;
+const STREAM_CHUNK_BYTES = 256 * 1024;
 const MAX_VARIABLES = 4096;
 const MAX_PAYLOAD_SIZE = 64 * 1024 * 1024;
 const FNV_OFFSET = 2166136261;
 const FNV_PRIME = 16777619;
 
 export type TapeRecordKind =
-  'frame' | 'sessionInfo' | 'gap' | 'disconnect' | 'end';
+  | 'frame'
+  | 'sessionInfo'
+  | 'gap'
+  | 'disconnect'
+  | 'end'
+  | 'eventIndex';
+
+export type TapeEventKind =
+  | 'lap'
+  | 'session'
+  | 'flags'
+  | 'pitEntry'
+  | 'pitExit';
 
 export interface TapeHeader {
   formatVersion: number;
@@ -19,6 +39,8 @@ export interface TapeHeader {
   qpcFrequency: bigint;
   recordCount: bigint;
   schemaChecksum: number;
+  // Offset of the EventIndex record, or 0n when the tape has none
+  eventIndexOffset: bigint;
   sdkVersion: number;
   tickRate: number;
   frameSize: number;
@@ -40,6 +62,19 @@ export interface TapeRecord {
   sourceTick: number;
   value: number;
   payload: Buffer;
+  // Position within a Repeat record's run, counting from 1, for frames the
+  // recorder stored as repeats of an earlier frame.
+  repeat?: number;
+}
+
+// A lap, session, flag, or pit transition. recordOffset is the Frame record
+// where it is first visible; pass it to TapeReader.seek to start there.
+export interface TapeEvent {
+  kind: TapeEventKind;
+  value: number;
+  recordOffset: number;
+  elapsedTicks: bigint;
+  sourceTick: number;
 }
 
 export interface TapeSchema {
@@ -76,16 +111,150 @@ const recordKinds: Record<number, TapeRecordKind> = {
   3: 'gap',
   4: 'disconnect',
   5: 'end',
+  6: 'eventIndex',
+};
+const REPEAT_KIND = 7;
+
+interface PendingRepeat {
+  frame: TapeRecord;
+  count: number;
+  next: number;
+  firstElapsedTicks: bigint;
+  lastElapsedTicks: bigint;
+  firstSourceTick: number;
+}
+
+const eventKinds: Record<number, TapeEventKind> = {
+  1: 'lap',
+  2: 'session',
+  3: 'flags',
+  4: 'pitEntry',
+  5: 'pitExit',
 };
 
+// Flags events match when they share any bit with value; the other kinds
+// match it exactly.
+export const findEvent = (
+  events: readonly TapeEvent[],
+  kind: TapeEventKind,
+  value: number
+): TapeEvent | undefined =>
+  events.find(
+    (event) =>
+      event.kind === kind &&
+      (kind === 'flags'
+        ? (event.value & value) !== 0
+        : event.value === value)
+  );
+
+// Where tape bytes come from: a FileHandle for files, or a StreamSource for
+// pipes and standard input.
+interface TapeSource {
+  read(
+    buffer: Buffer,
+    offset: number,
+    length: number,
+    position: number
+  ): Promise<{ bytesRead: number }>;
+  close(): Promise<void>;
+}
+
+export interface StreamOptions {
+  // Most bytes read from the source ahead of the records being parsed.
+  readAheadBytes?: number;
+  // Sees every byte of the tape once, in order, for example to hash it.
+  onData?: (chunk: Buffer) => void;
+}
+
+// Reads a pipe front to back, keeping up to readAheadBytes buffered so the
+// producer is not stalled while records are parsed. Reads must continue
+// exactly where the previous one ended.
+class StreamSource implements TapeSource {
+  private readonly chunks: Buffer[] = [];
+  private buffered = 0;
+  private position = 0;
+  private ended = false;
+  private failure: unknown;
+  private pending: Promise<void> | undefined;
+
+  constructor(
+    private readonly handle: FileHandle,
+    private readonly readAheadBytes: number,
+    private readonly onData?: (chunk: Buffer) => void
+  ) {}
+
+  async read(
+    buffer: Buffer,
+    offset: number,
+    length: number,
+    position: number
+  ): Promise<{ bytesRead: number }> {
+    if (position !== this.position) {
+      throw new Error('A streamed telemetry tape can only be read in order');
+    }
+    let bytesRead = 0;
+    while (bytesRead < length) {
+      if (this.buffered === 0) {
+        if (this.failure !== undefined) throw this.failure;
+        if (this.ended) break;
+        await this.fill();
+        continue;
+      }
+      const chunk = this.chunks[0];
+      const count = Math.min(chunk.length, length - bytesRead);
+      chunk.copy(buffer, offset + bytesRead, 0, count);
+      if (count === chunk.length) this.chunks.shift();
+      else this.chunks[0] = chunk.subarray(count);
+      this.buffered -= count;
+      bytesRead += count;
+    }
+    this.position += bytesRead;
+    if (this.buffered < this.readAheadBytes / 2) void this.fill();
+    return { bytesRead };
+  }
+
+  close(): Promise<void> {
+    return this.handle.close();
+  }
+
+  private fill(): Promise<void> {
+    if (this.ended || this.failure !== undefined) return Promise.resolve();
+    this.pending ??= this.readChunk().finally(() => {
+      this.pending = undefined;
+    });
+    return this.pending;
+  }
+
+  private async readChunk(): Promise<void> {
+    const size = Math.min(
+      STREAM_CHUNK_BYTES,
+      Math.max(this.readAheadBytes - this.buffered, 1)
+    );
+    try {
+      const chunk = Buffer.allocUnsafe(size);
+      const { bytesRead } = await this.handle.read(chunk, 0, size, null);
+      if (bytesRead === 0) {
+        this.ended = true;
+        return;
+      }
+      const data = chunk.subarray(0, bytesRead);
+      this.chunks.push(data);
+      this.buffered += bytesRead;
+      this.onData?.(data);
+    } catch (error) {
+      this.failure = error;
+    }
+  }
+}
+
 async function readExact(
-  handle: FileHandle,
+  source: TapeSource,
   buffer: Buffer,
   position: number
 ): Promise<void> {
   let bytesRead = 0;
   while (bytesRead < buffer.length) {
-    const result = await handle.read(
+    const result = await source.read(
       buffer,
       bytesRead,
       buffer.length - bytesRead,
@@ -100,17 +269,42 @@ async function readExact(
 
 export class TapeReader {
   readonly schema: TapeSchema;
+  private pendingRepeat: PendingRepeat | undefined;
+  private lastFrame: { offset: number; record: TapeRecord } | undefined;
 
   private constructor(
-    private readonly handle: FileHandle,
+    private readonly source: TapeSource,
     schema: TapeSchema,
-    private position: number
+    private position: number,
+    readonly seekable: boolean
   ) {
     this.schema = schema;
   }
 
   static async open(path: string): Promise<TapeReader> {
-    const handle = await open(path, 'r');
+    return TapeReader.fromSource(await open(path, 'r'), true);
+  }
+
+  // Reads a tape from a pipe, FIFO, or standard input ('-') front to back.
+  // seek() and readEvents() throw, since a stream cannot go back.
+  static async openStream(
+    path: string,
+    {
+      readAheadBytes = DEFAULT_READ_AHEAD_BYTES,
+      onData,
+    }: StreamOptions = {}
+  ): Promise<TapeReader> {
+    const handle = await open(path === '-' ? '/dev/stdin' : path, 'r');
+    return TapeReader.fromSource(
+      new StreamSource(handle, readAheadBytes, onData),
+      false
+    );
+  }
+
+  private static async fromSource(
+    handle: TapeSource,
+    seekable: boolean
+  ): Promise<TapeReader> {
     try {
       const fileHeader = Buffer.allocUnsafe(FILE_HEADER_SIZE);
       await readExact(handle, fileHeader, 0);
@@ -124,8 +318,15 @@ export class TapeReader {
       const sdkHeaderSize = fileHeader.readUInt32LE(20);
       const variableHeaderSize = fileHeader.readUInt32LE(24);
       const variableCount = fileHeader.readUInt32LE(28);
+      if (formatVersion > TAPE_FORMAT_VERSION) {
+        throw new Error(
+          `Telemetry tape format version ${formatVersion} is newer than ` +
+            'this reader supports'
+        );
+      }
       if (
-        formatVersion !== 1 ||
+        formatVersion === 0 ||
+        (formatVersion === 1 && fileHeader.readBigUInt64LE(60) !== 0n) ||
         endianMarker !== 0x01020304 ||
         fileHeaderSize !== FILE_HEADER_SIZE ||
         sdkHeaderSize !== SDK_HEADER_SIZE ||
@@ -185,6 +386,7 @@ export class TapeReader {
         qpcFrequency: fileHeader.readBigUInt64LE(40),
         recordCount: fileHeader.readBigUInt64LE(48),
         schemaChecksum,
+        eventIndexOffset: fileHeader.readBigUInt64LE(60),
         sdkVersion: sdkHeader.readInt32LE(0),
         tickRate: sdkHeader.readInt32LE(8),
         frameSize,
@@ -201,7 +403,8 @@ export class TapeReader {
       return new TapeReader(
         handle,
         { header, variables },
-        FILE_HEADER_SIZE + SDK_HEADER_SIZE + variableBytes.length
+        FILE_HEADER_SIZE + SDK_HEADER_SIZE + variableBytes.length,
+        seekable
       );
     } catch (error) {
       await handle.close();
@@ -209,9 +412,13 @@ export class TapeReader {
     }
   }
 
+  // Repeat records come back as the frames they stand for, one per call.
   async readRecord(): Promise<TapeRecord | undefined> {
+    if (this.pendingRepeat) return this.nextRepeatedFrame(this.pendingRepeat);
+
+    const recordOffset = this.position;
     const header = Buffer.allocUnsafe(RECORD_HEADER_SIZE);
-    const result = await this.handle.read(
+    const result = await this.source.read(
       header,
       0,
       header.length,
@@ -223,36 +430,167 @@ export class TapeReader {
     }
     this.position += header.length;
 
-    const kind = recordKinds[header.readUInt32LE(0)];
+    const kindValue = header.readUInt32LE(0);
+    const kind = recordKinds[kindValue];
     const headerSize = header.readUInt32LE(4);
     const payloadSize = header.readUInt32LE(8);
     if (
-      !kind ||
+      (!kind && kindValue !== REPEAT_KIND) ||
+      (this.schema.header.formatVersion === 1 &&
+        kindValue > VERSION_1_LAST_KIND) ||
       headerSize !== RECORD_HEADER_SIZE ||
       payloadSize > MAX_PAYLOAD_SIZE
     ) {
       throw new Error('Invalid telemetry tape record header');
     }
     const payload = Buffer.allocUnsafe(payloadSize);
-    if (payloadSize > 0) await readExact(this.handle, payload, this.position);
+    if (payloadSize > 0) await readExact(this.source, payload, this.position);
     this.position += payloadSize;
     if (checksum(payload) !== header.readUInt32LE(32)) {
       throw new Error('Telemetry tape record checksum mismatch');
     }
+    if (!kind) {
+      return this.nextRepeatedFrame(
+        await this.loadRepeat(header, payload, recordOffset)
+      );
+    }
     if (kind === 'frame' && payloadSize !== this.schema.header.frameSize) {
       throw new Error('Telemetry frame size does not match the SDK schema');
     }
-    return {
+    const record: TapeRecord = {
       kind,
       elapsedTicks: header.readBigUInt64LE(16),
       sourceTick: header.readInt32LE(24),
       value: header.readInt32LE(28),
       payload,
     };
+    if (kind === 'frame' && !this.seekable) {
+      this.lastFrame = { offset: recordOffset, record };
+    }
+    return record;
+  }
+
+  // Moves the read position to a record offset, such as an event's
+  // recordOffset.
+  seek(offset: number): void {
+    if (!this.seekable) {
+      throw new Error('A streamed telemetry tape cannot seek');
+    }
+    this.position = offset;
+    this.pendingRepeat = undefined;
+  }
+
+  private async loadRepeat(
+    header: Buffer,
+    payload: Buffer,
+    recordOffset: number
+  ): Promise<PendingRepeat> {
+    const count = header.readInt32LE(28);
+    const firstSourceTick = header.readInt32LE(24);
+    if (
+      payload.length !== REPEAT_SIZE ||
+      count < 1 ||
+      Number(payload.readBigUInt64LE(0)) >= recordOffset ||
+      payload.readInt32LE(16) !== firstSourceTick + count - 1
+    ) {
+      throw new Error('Invalid telemetry tape repeat record');
+    }
+
+    // Repeats refer to the frame just before them, which a stream still
+    // holds; a file reads it again.
+    const frameOffset = Number(payload.readBigUInt64LE(0));
+    let frame: TapeRecord | undefined;
+    if (this.lastFrame?.offset === frameOffset) {
+      frame = this.lastFrame.record;
+    } else if (this.seekable) {
+      const resumePosition = this.position;
+      this.position = frameOffset;
+      frame = await this.readRecord();
+      this.position = resumePosition;
+    }
+    if (frame?.kind !== 'frame' || frame.repeat) {
+      throw new Error('Telemetry tape repeat does not refer to a frame');
+    }
+    this.pendingRepeat = {
+      frame,
+      count,
+      next: 0,
+      firstElapsedTicks: header.readBigUInt64LE(16),
+      lastElapsedTicks: payload.readBigUInt64LE(8),
+      firstSourceTick,
+    };
+    return this.pendingRepeat;
+  }
+
+  // Elapsed times inside a run are spread evenly between its first and last
+  // frame, as TapeReader does natively.
+  private nextRepeatedFrame(repeat: PendingRepeat): TapeRecord {
+    const position = repeat.next;
+    repeat.next += 1;
+    if (repeat.next >= repeat.count) this.pendingRepeat = undefined;
+    const span = repeat.lastElapsedTicks - repeat.firstElapsedTicks;
+    return {
+      ...repeat.frame,
+      elapsedTicks:
+        repeat.count > 1
+          ? repeat.firstElapsedTicks +
+            (span * BigInt(position)) / BigInt(repeat.count - 1)
+          : repeat.firstElapsedTicks,
+      sourceTick: repeat.firstSourceTick + position,
+      repeat: position + 1,
+    };
+  }
+
+  // Reads the EventIndex record without moving the read position. Tapes
+  // without one return an empty list.
+  async readEvents(): Promise<TapeEvent[]> {
+    const offset = this.schema.header.eventIndexOffset;
+    if (offset === 0n) return [];
+    if (!this.seekable) {
+      throw new Error(
+        'The event index of a streamed telemetry tape cannot be read'
+      );
+    }
+    const header = Buffer.allocUnsafe(RECORD_HEADER_SIZE);
+    await readExact(this.source, header, Number(offset));
+    const payloadSize = header.readUInt32LE(8);
+    if (
+      recordKinds[header.readUInt32LE(0)] !== 'eventIndex' ||
+      header.readUInt32LE(4) !== RECORD_HEADER_SIZE ||
+      payloadSize > MAX_PAYLOAD_SIZE ||
+      payloadSize % EVENT_SIZE !== 0
+    ) {
+      throw new Error('Invalid telemetry tape event index');
+    }
+    const payload = Buffer.allocUnsafe(payloadSize);
+    if (payloadSize > 0) {
+      await readExact(
+        this.source,
+        payload,
+        Number(offset) + RECORD_HEADER_SIZE
+      );
+    }
+    if (checksum(payload) !== header.readUInt32LE(32)) {
+      throw new Error('Telemetry tape event index checksum mismatch');
+    }
+
+    const events: TapeEvent[] = [];
+    for (let base = 0; base < payloadSize; base += EVENT_SIZE) {
+      const kind = eventKinds[payload.readUInt32LE(base)];
+      if (!kind) continue;
+      events.push({
+        kind,
+        value: payload.readInt32LE(base + 4),
+        recordOffset: Number(payload.readBigUInt64LE(base + 8)),
+        elapsedTicks: payload.readBigUInt64LE(base + 16),
+        sourceTick: payload.readInt32LE(base + 24),
+      });
+    }
+    return events;
   }
 
   async close(): Promise<void> {
-    await this.handle.close();
+    await this.source.close();
   }
 }
 
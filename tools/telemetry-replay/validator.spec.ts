@@ -8,7 +8,13 @@ import {
   createSyntheticTape,
   SYNTHETIC_SECOND_FRAME_PAYLOAD_OFFSET,
 } from './fixture';
-import { TapeReader } from './tape';
+import {
+  findEvent,
+  RECORD_HEADER_SIZE,
+  TAPE_FORMAT_VERSION,
+  TapeReader,
+  type TapeRecord,
+} from './tape';
 import { validateReplay, type ReplayProbe } from './validator';
 
 const temporaryDirectories: string[] = [];
@@ -103,6 +109,116 @@ describe('headless telemetry replay validator', () => {
     });
   });
 
+  it('seeks to a frame through the event index', async () => {
+    const directory = await mkdtemp(path.join(tmpdir(), 'irdashies-replay-'));
+    temporaryDirectories.push(directory);
+    const indexedPath = path.join(directory, 'indexed.irdt');
+    await writeFile(indexedPath, createSyntheticTape({ eventIndex: true }));
+
+    const reader = await TapeReader.open(indexedPath);
+    try {
+      const events = await reader.readEvents();
+      expect(events).toEqual([
+        {
+          kind: 'lap',
+          value: 2,
+          recordOffset:
+            SYNTHETIC_SECOND_FRAME_PAYLOAD_OFFSET - RECORD_HEADER_SIZE,
+          elapsedTicks: 1n,
+          sourceTick: 11,
+        },
+      ]);
+      const lap = findEvent(events, 'lap', 2);
+      if (!lap) throw new Error('Lap 2 is not indexed');
+      reader.seek(lap.recordOffset);
+      const record = await reader.readRecord();
+      expect(record).toMatchObject({ kind: 'frame', sourceTick: 11 });
+    } finally {
+      await reader.close();
+    }
+
+    const result = await validateReplay({
+      path: indexedPath,
+      probes: [probe],
+      expected: { recordCount: 5, frameCount: 2 },
+    });
+    expect(result.endCount).toBe(1);
+  });
+
+  it('expands repeated frames', async () => {
+    const directory = await mkdtemp(path.join(tmpdir(), 'irdashies-replay-'));
+    temporaryDirectories.push(directory);
+    const repeatedPath = path.join(directory, 'repeated.irdt');
+    await writeFile(repeatedPath, createSyntheticTape({ repeats: true }));
+
+    const reader = await TapeReader.open(repeatedPath);
+    try {
+      const frames: TapeRecord[] = [];
+      while (true) {
+        const record = await reader.readRecord();
+        if (!record) break;
+        if (record.kind === 'frame') frames.push(record);
+      }
+      expect(
+        frames.map(({ sourceTick, elapsedTicks, repeat }) => ({
+          sourceTick,
+          elapsedTicks,
+          repeat,
+        }))
+      ).toEqual([
+        { sourceTick: 10, elapsedTicks: 0n, repeat: undefined },
+        { sourceTick: 11, elapsedTicks: 1n, repeat: undefined },
+        { sourceTick: 12, elapsedTicks: 2n, repeat: 1 },
+        { sourceTick: 13, elapsedTicks: 3n, repeat: 2 },
+      ]);
+      expect(frames[3].payload).toEqual(frames[1].payload);
+    } finally {
+      await reader.close();
+    }
+
+    const result = await validateReplay({
+      path: repeatedPath,
+      probes: [probe],
+      expected: { recordCount: 5, frameCount: 4 },
+    });
+    expect(result.probes[0].checkpoints.lastFrame).toEqual({
+      fuel: expect.closeTo(19.9),
+      sessionTime: 1.5,
+    });
+  });
+
+  it('reads a tape front to back as a stream', async () => {
+    const directory = await mkdtemp(path.join(tmpdir(), 'irdashies-replay-'));
+    temporaryDirectories.push(directory);
+    const repeatedPath = path.join(directory, 'repeated.irdt');
+    await writeFile(repeatedPath, createSyntheticTape({ repeats: true }));
+
+    const reader = await TapeReader.openStream(repeatedPath, {
+      readAheadBytes: 16,
+    });
+    try {
+      expect(reader.seekable).toBe(false);
+      expect(() => reader.seek(0)).toThrow(
+        'A streamed telemetry tape cannot seek'
+      );
+      let frames = 0;
+      while (true) {
+        const record = await reader.readRecord();
+        if (!record) break;
+        if (record.kind === 'frame') frames += 1;
+      }
+      expect(frames).toBe(4);
+    } finally {
+      await reader.close();
+    }
+
+    const [fromFile, fromStream] = await Promise.all([
+      validateReplay({ path: repeatedPath, probes: [probe] }),
+      validateReplay({ path: repeatedPath, probes: [probe], stream: true }),
+    ]);
+    expect(fromStream).toEqual(fromFile);
+  });
+
   it('rejects a corrupted record payload', async () => {
     const tape = createSyntheticTape();
     tape[SYNTHETIC_SECOND_FRAME_PAYLOAD_OFFSET] ^= 0xff;
@@ -115,4 +231,42 @@ describe('headless telemetry replay validator', () => {
       validateReplay({ path: corruptPath, probes: [probe] })
     ).rejects.toThrow('Telemetry tape record checksum mismatch');
   });
+
+  it('reads version 1 tapes and rejects newer formats', async () => {
+    const directory = await mkdtemp(path.join(tmpdir(), 'irdashies-replay-'));
+    temporaryDirectories.push(directory);
+    const writeTape = async (
+      name: string,
+      formatVersion: number,
+      repeats: boolean
+    ): Promise<string> => {
+      const tape = createSyntheticTape({ repeats });
+      tape.writeUInt32LE(formatVersion, 8);
+      const result = path.join(directory, name);
+      await writeFile(result, tape);
+      return result;
+    };
+
+    const result = await validateReplay({
+      path: await writeTape('version-1.irdt', 1, false),
+      probes: [probe],
+      expected: { recordCount: 4, frameCount: 2 },
+    });
+    expect(result.metadata.formatVersion).toBe(1);
+
+    // Repeat records arrived with version 2.
+    await expect(
+      validateReplay({
+        path: await writeTape('version-1-repeats.irdt', 1, true),
+        probes: [probe],
+      })
+    ).rejects.toThrow('Invalid telemetry tape record header');
+    await expect(
+      TapeReader.open(
+        await writeTape('newer.irdt', TAPE_FORMAT_VERSION + 1, false)
+      )
+    ).rejects.toThrow(
+      `Telemetry tape format version ${TAPE_FORMAT_VERSION + 1} is newer`
+    );
+  });
 });
@@ -128,6 +128,9 @@ export interface ValidateReplayOptions {
   expected?: Partial<ReplayMetadata>;
   probes: readonly ReplayProbe<unknown>[];
   sessionPollMilliseconds?: number;
+  // Reads path front to back as a pipe, FIFO, or standard input ('-'),
+  // hashing the bytes as they pass instead of reading the file twice.
+  stream?: boolean;
 }
 
 export async function validateReplay({
@@ -135,10 +138,16 @@ export async function validateReplay({
   expected,
   probes,
   sessionPollMilliseconds = 500,
+  stream = false,
 }: ValidateReplayOptions): Promise<ReplayValidationResult> {
-  const [sha256, reader] = await Promise.all([
-    sha256File(path),
-    TapeReader.open(path),
+  const streamHash = createHash('sha256');
+  const [fileSha256, reader] = await Promise.all([
+    stream ? undefined : sha256File(path),
+    stream
+      ? TapeReader.openStream(path, {
+          onData: (chunk) => streamHash.update(chunk),
+        })
+      : TapeReader.open(path),
   ]);
   try {
     const { header, variables } = reader.schema;
@@ -195,7 +204,8 @@ export async function validateReplay({
     while (true) {
       const record = await reader.readRecord();
       if (!record) break;
-      records += 1;
+      // A run of repeated frames is stored as a single record.
+      if (!record.repeat || record.repeat === 1) records += 1;
       // Session data is sampled like production: a revision on a poll boundary
       // is visible immediately; between boundaries, only the latest pending
       // revision survives until the next poll.
@@ -260,12 +270,14 @@ export async function validateReplay({
         case 'end':
           ends += 1;
           break;
+        case 'eventIndex':
+          break;
       }
     }
     applyPendingSession(nextSessionPoll);
 
     const metadata: ReplayMetadata = {
-      sha256,
+      sha256: fileSha256 ?? streamHash.digest('hex').toUpperCase(),
       formatVersion: header.formatVersion,
       sdkVersion: header.sdkVersion,
       tickRateHz: header.tickRate,